@@ -29,6 +29,10 @@
 #define CONFIG_LV_MEM_SIZE              (128*1024)
 #define CONFIG_LV_CACHE_DEF_SIZE        (128*1024)
 
+/* Keep decoded glyphs and label line breaks between redraws */
+#define LV_FONT_GLYPH_CACHE_DEF_CNT     128
+#define LV_LABEL_LINE_CACHE             1
+
 /* Please comment LV_USE_DEMO_MUSIC declaration before un-comment below */
 #define LV_USE_DEMO_WIDGETS             1
 //#define LV_USE_DEMO_MUSIC             1
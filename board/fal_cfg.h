@@ -24,15 +24,26 @@
     extern const struct fal_flash_dev Onchip_ldrom_flash;
 #endif
 
+#if defined(FAL_USING_SIM_FLASH)
+    extern const struct fal_flash_dev sim_flash;
+    #define FAL_SIM_FLASH_DEV       &sim_flash,
+    #define FAL_SIM_FLASH_PART      {FAL_PART_MAGIC_WORD,        "sim",       FAL_SIM_FLASH_DEV_NAME,          0, FAL_SIM_FLASH_SIZE, 0},
+#else
+    #define FAL_SIM_FLASH_DEV
+    #define FAL_SIM_FLASH_PART
+#endif
+
 #if defined(BSP_USING_FMC)
 #define FAL_FLASH_DEV_TABLE         \
 {                                   \
     &Onchip_aprom_flash,            \
     &Onchip_ldrom_flash,            \
+    FAL_SIM_FLASH_DEV               \
 }
 #else
 #define FAL_FLASH_DEV_TABLE         \
 {                                   \
+    FAL_SIM_FLASH_DEV               \
 }
 #endif
 
@@ -40,6 +51,7 @@
 {                                                                             \
     {FAL_PART_MAGIC_WORD,        "ldrom",     "OnChip_LDROM",                  0,        (24*1024), 0},  \
     {FAL_PART_MAGIC_WORD,        "aprom",     "OnChip_APROM",            0x60000,        0x20000, 0},  \
+    FAL_SIM_FLASH_PART                                                                                      \
 }
 
 #endif /* FAL_PART_HAS_TABLE_CFG */
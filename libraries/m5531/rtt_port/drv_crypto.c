@@ -690,7 +690,37 @@ static rt_err_t nu_hwcrypto_clone(struct rt_hwcrypto_ctx *des, const struct rt_h
 
     if (des->contex && src->contex)
     {
-        rt_memcpy(des->contex, src->contex, sizeof(struct rt_hwcrypto_ctx));
+        switch (src->type & HWCRYPTO_MAIN_TYPE_MASK)
+        {
+#if defined(BSP_USING_CRYPTO)
+        case HWCRYPTO_TYPE_SHA1:
+        case HWCRYPTO_TYPE_SHA2:
+        {
+            S_SHA_CONTEXT *psDes = (S_SHA_CONTEXT *)des->contex;
+            const S_SHA_CONTEXT *psSrc = (const S_SHA_CONTEXT *)src->contex;
+
+            /* The running digest stays in the engine, only the tail buffer is copied. */
+            if (psDes->pu8SHATempBuf)
+                rt_free(psDes->pu8SHATempBuf);
+
+            rt_memcpy(psDes, psSrc, sizeof(S_SHA_CONTEXT));
+            if (psSrc->pu8SHATempBuf)
+            {
+                psDes->pu8SHATempBuf = rt_malloc(psSrc->u32BlockSize);
+                if (psDes->pu8SHATempBuf == RT_NULL)
+                {
+                    psDes->u32SHATempBufLen = 0;
+                    return -RT_ENOMEM;
+                }
+                rt_memcpy(psDes->pu8SHATempBuf, psSrc->pu8SHATempBuf, psSrc->u32BlockSize);
+            }
+            break;
+        }
+#endif /* BSP_USING_CRYPTO */
+
+        default:
+            break;
+        }
     }
     else
         return -RT_EINVAL;
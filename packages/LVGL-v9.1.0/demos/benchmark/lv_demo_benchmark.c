@@ -42,6 +42,7 @@ typedef struct {
     uint32_t render_avg_time;
     uint32_t flush_avg_time;
     uint32_t measurement_cnt;
+    lv_font_glyph_cache_stats_t glyph_cache_stats;
 } scene_dsc_t;
 
 /**********************
@@ -236,6 +237,33 @@ static void screen_sized_text_cb(void)
     scroll_anim(scr, lv_obj_get_scroll_bottom(scr));
 }
 
+static void text_blocks_cb(void)
+{
+    const char * txt =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Nulla nec rhoncus arcu, in consectetur orci. "
+        "Sed vitae dolor sed nisi ultrices vehicula quis ac dolor.\n"
+        "Vivamus hendrerit hendrerit lectus, sed tempus velit suscipit in. Fusce eu tristique arcu. "
+        "Sed et molestie leo, in lacinia nunc. 0123456789 +-*/ ()[]{}";
+
+    lv_obj_t * scr = lv_screen_active();
+    lv_obj_set_flex_flow(scr, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_flex_align(scr, LV_FLEX_ALIGN_SPACE_EVENLY, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_START);
+
+    /*Many wrapped, center and right aligned texts with different fonts to stress
+     *the glyph decoding and the line break calculation*/
+    uint32_t i;
+    for(i = 0; i < 24; i++) {
+        lv_obj_t * obj = lv_label_create(scr);
+        lv_obj_set_width(obj, i % 3 == 0 ? lv_pct(100) : lv_pct(45));
+        lv_obj_set_style_text_align(obj, i % 2 ? LV_TEXT_ALIGN_CENTER : LV_TEXT_ALIGN_RIGHT, 0);
+        lv_obj_set_style_text_font(obj, i % 4 == 0 ? &lv_font_montserrat_24 : &lv_font_montserrat_14, 0);
+        lv_label_set_text(obj, txt);
+    }
+
+    lv_obj_update_layout(scr);
+    scroll_anim(scr, lv_obj_get_scroll_bottom(scr));
+}
+
 static void multiple_arcs_cb(void)
 {
     lv_obj_set_flex_flow(lv_screen_active(), LV_FLEX_FLOW_ROW_WRAP);
@@ -405,6 +433,7 @@ static scene_dsc_t scenes[] = {
     {.name = "Rotated ARGB images",        .scene_time = 3000, .create_cb = rotated_argb_image_cb},
     {.name = "Multiple labels",            .scene_time = 3000, .create_cb = multiple_labels_cb},
     {.name = "Screen sized text",          .scene_time = 5000, .create_cb = screen_sized_text_cb},
+    {.name = "Multiple text blocks",       .scene_time = 5000, .create_cb = text_blocks_cb},
     {.name = "Multiple arcs",              .scene_time = 3000, .create_cb = multiple_arcs_cb},
 
     {.name = "Containers",                 .scene_time = 3000, .create_cb = containers_cb},
@@ -485,6 +514,7 @@ static void load_scene(uint32_t scene)
     lv_obj_set_style_bg_opa(lv_layer_top(), LV_OPA_TRANSP, 0);
 
     rnd_reset();
+    lv_font_glyph_cache_reset_stats();
     if(scenes[scene].create_cb) scenes[scene].create_cb();
 }
 
@@ -492,6 +522,7 @@ static void next_scene_timer_cb(lv_timer_t * timer)
 {
     LV_UNUSED(timer);
 
+    lv_font_glyph_cache_get_stats(&scenes[scene_act].glyph_cache_stats);
     scene_act++;
 
     load_scene(scene_act);
@@ -638,6 +669,15 @@ static void summary_create(void)
                    render_time,
                    flush_time);
 
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+            const lv_font_glyph_cache_stats_t * gc = &scenes[i].glyph_cache_stats;
+            uint32_t glyph_cnt = gc->hit_cnt + gc->miss_cnt + gc->bypass_cnt;
+            LV_UNUSED(glyph_cnt);
+            LV_LOG("%s, glyph cache: %"LV_PRIu32" hit, %"LV_PRIu32" miss, %"LV_PRIu32" bypass, %"LV_PRIu32"%% hit rate\r\n",
+                   scenes[i].name, gc->hit_cnt, gc->miss_cnt, gc->bypass_cnt,
+                   glyph_cnt ? (uint32_t)((uint64_t)gc->hit_cnt * 100 / glyph_cnt) : 0);
+#endif
+
             valid_scene_cnt++;
             total_avg_cpu += scenes[i].cpu_avg_usage / cnt;
             total_avg_fps += scenes[i].fps_avg / cnt;
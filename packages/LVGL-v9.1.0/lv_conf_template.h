@@ -296,6 +296,21 @@
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/*1: Decode the images in a background thread the first time they are drawn.
+ *A placeholder is drawn until the decoded image is added to the cache.
+ *Requires `LV_USE_OS` and `LV_CACHE_DEF_SIZE > 0`*/
+#define LV_USE_IMAGE_DECODER_ASYNC 0
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*Number of images which can be queued or tracked by the decoder thread*/
+    #define LV_IMAGE_DECODER_ASYNC_JOB_CNT 8
+
+    /*Stack size of the decoder thread [bytes]*/
+    #define LV_IMAGE_DECODER_ASYNC_STACK_SIZE (8 * 1024)
+
+    /*Opacity of the placeholder drawn while the image is decoded*/
+    #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA LV_OPA_20
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS   2
@@ -437,6 +452,11 @@
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
+/*Number of decoded glyph bitmaps to keep in an LRU cache. 0 to disable caching.
+ *Only fonts without their own cache (e.g. the built-in fonts) use it.
+ *Saves decoding (and decompressing) the glyphs on every redraw, but every cached glyph takes box_w * box_h bytes.*/
+#define LV_FONT_GLYPH_CACHE_DEF_CNT 0
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -530,6 +550,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LINE_CACHE 0     /*Store the line breaks and line widths of labels to avoid measuring the text on every redraw*/
     #define LV_LABEL_WAIT_CHAR_COUNT 3  /*The count of wait chart*/
 #endif
 
@@ -688,6 +709,10 @@
 /*RLE decompress library*/
 #define LV_USE_RLE 0
 
+/*Tiled image container decoder (*.timg, see scripts/timg_pack.py).
+ *Only the tiles of the drawn area are read and decompressed (RLE needs LV_USE_RLE, LZ4 needs LV_USE_LZ4_*)*/
+#define LV_USE_TIMG 0
+
 /*QR code library*/
 #define LV_USE_QRCODE 0
 
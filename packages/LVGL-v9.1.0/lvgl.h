@@ -47,6 +47,7 @@ extern "C" {
 #include "src/font/lv_font.h"
 #include "src/font/lv_binfont_loader.h"
 #include "src/font/lv_font_fmt_txt.h"
+#include "src/font/lv_font_glyph_cache.h"
 
 #include "src/widgets/animimage/lv_animimage.h"
 #include "src/widgets/arc/lv_arc.h"
@@ -94,6 +95,7 @@ extern "C" {
 #include "src/libs/bin_decoder/lv_bin_decoder.h"
 #include "src/libs/bmp/lv_bmp.h"
 #include "src/libs/rle/lv_rle.h"
+#include "src/libs/timg/lv_timg.h"
 #include "src/libs/fsdrv/lv_fsdrv.h"
 #include "src/libs/lodepng/lv_lodepng.h"
 #include "src/libs/libpng/lv_libpng.h"
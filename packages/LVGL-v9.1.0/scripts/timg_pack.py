@@ -0,0 +1,276 @@
+#!/usr/bin/env python3
+"""
+Pack PNG images to LVGL's tiled image container (*.timg), see src/libs/timg/lv_timg.h.
+
+The image is split to tiles and every tile is compressed on its own, so the
+decoder reads and decompresses only the tiles of the drawn area.
+Besides the container a footprint report is printed to compare it with the
+plain bin image.
+"""
+import sys
+import logging
+import argparse
+from os import path
+from pathlib import Path
+
+import lz4.block
+
+from LVGLImage import (LVGLImage, LVGLImageHeader, RLEImage, ColorFormat,
+                       CompressMethod, ParameterError, uint16_t, uint32_t)
+
+TIMG_MAGIC = 0x4954564C  # "LVTI"
+TIMG_HEADER_SIZE = 12 + 16  # lv_image_header_t + lv_timg_header_t
+TIMG_TILE_SIZE = 8  # lv_timg_tile_t
+TIMG_TILE_SIZE_MASK = 0x0FFFFFFF
+TIMG_TILE_METHOD_SHIFT = 28
+
+SUPPORTED_CF = ["L8", "A8", "RGB565", "ARGB8565", "RGB888", "ARGB8888",
+                "XRGB8888"]
+
+
+class TiledImage:
+
+    def __init__(self,
+                 img: LVGLImage,
+                 tile_w: int,
+                 tile_h: int,
+                 compress: str = "AUTO",
+                 align: int = 4):
+        if img.cf.name not in SUPPORTED_CF:
+            raise ParameterError(f"color format not supported: {img.cf.name}")
+        if tile_w <= 0 or tile_h <= 0 or tile_w > 0xffff or tile_h > 0xffff:
+            raise ParameterError(f"invalid tile size: {tile_w}x{tile_h}")
+
+        self.img = img
+        self.px_size = img.cf.bpp // 8
+        self.tile_w = tile_w
+        self.tile_h = tile_h
+        self.compress = compress
+        self.align = align
+        self.cols = (img.w + tile_w - 1) // tile_w
+        self.rows = (img.h + tile_h - 1) // tile_h
+        self.tiles = [self._pack_tile(col, row)
+                      for row in range(self.rows)
+                      for col in range(self.cols)]
+
+    def _tile_data(self, col, row) -> bytes:
+        """Pixels of a tile with packed stride, padded to the full tile size"""
+        img = self.img
+        stride = self.tile_w * self.px_size
+        data = bytearray()
+        for y in range(row * self.tile_h, (row + 1) * self.tile_h):
+            if y >= img.h:
+                data += bytes(stride)
+                continue
+            x = col * self.tile_w
+            w = min(self.tile_w, img.w - x)
+            start = y * img.stride + x * self.px_size
+            data += img.data[start:start + w * self.px_size]
+            data += bytes(stride - w * self.px_size)
+        return bytes(data)
+
+    def _pack_tile(self, col, row):
+        raw = self._tile_data(col, row)
+        candidates = {CompressMethod.NONE: raw}
+        if self.compress in ("AUTO", "RLE"):
+            candidates[CompressMethod.RLE] = bytes(
+                RLEImage().rle_compress(bytearray(raw), self.px_size))
+        if self.compress in ("AUTO", "LZ4"):
+            candidates[CompressMethod.LZ4] = lz4.block.compress(
+                raw, store_size=False)
+
+        if self.compress == "AUTO":
+            # Keep a tile uncompressed if compression doesn't save much: it
+            # can be drawn directly from memory mapped flash.
+            method = min(candidates, key=lambda m: len(candidates[m]))
+            if len(candidates[method]) * 8 > len(raw) * 7:
+                method = CompressMethod.NONE
+        else:
+            method = CompressMethod[self.compress]
+
+        return method, candidates[method]
+
+    @property
+    def tile_raw_size(self) -> int:
+        return self.tile_w * self.tile_h * self.px_size
+
+    @property
+    def max_tile_size(self) -> int:
+        return max(len(data) for _, data in self.tiles)
+
+    @property
+    def index_size(self) -> int:
+        return len(self.tiles) * TIMG_TILE_SIZE
+
+    @property
+    def binary(self) -> bytearray:
+        img = self.img
+        header = LVGLImageHeader(img.cf, img.w, img.h)
+
+        binary = bytearray()
+        binary += header.binary
+        binary += uint32_t(TIMG_MAGIC)
+        binary += uint16_t(self.tile_w)
+        binary += uint16_t(self.tile_h)
+        binary += uint32_t(len(self.tiles))
+        binary += uint32_t(self.max_tile_size)
+
+        # Tile data is aligned so that uncompressed tiles can be used directly
+        offset = TIMG_HEADER_SIZE + self.index_size
+        index = bytearray()
+        data = bytearray()
+        for method, tile in self.tiles:
+            pad = -(offset + len(data)) % self.align
+            data += bytes(pad)
+            index += uint32_t(offset + len(data))
+            index += uint32_t(len(tile) | (method.value << TIMG_TILE_METHOD_SHIFT))
+            data += tile
+
+        return binary + index + data
+
+    def to_timg(self, filename: str):
+        with open(filename, "wb") as f:
+            f.write(self.binary)
+        return self
+
+    def to_c_array(self, filename: str):
+        varname = path.basename(filename).split('.')[0]
+        varname = varname.replace("-", "_")
+
+        binary = self.binary
+        with open(filename, "w") as f:
+            f.write(f'''
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+#ifndef LV_ATTRIBUTE_MEM_ALIGN
+#define LV_ATTRIBUTE_MEM_ALIGN
+#endif
+
+/*Tiled image container, {self.img.w}x{self.img.h} {self.img.cf.name}, {self.tile_w}x{self.tile_h} tiles*/
+static const
+LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST
+uint8_t {varname}_map[] = {{''')
+            for i, v in enumerate(binary):
+                if i % 16 == 0:
+                    f.write("\n    ")
+                f.write(f"0x{v:02x},")
+            f.write(f'''
+}};
+
+const lv_image_dsc_t {varname} = {{
+  .header.magic = LV_IMAGE_HEADER_MAGIC,
+  .header.cf = LV_COLOR_FORMAT_RAW,
+  .header.w = {self.img.w},
+  .header.h = {self.img.h},
+  .data_size = sizeof({varname}_map),
+  .data = {varname}_map,
+}};
+''')
+        return self
+
+    def report(self, name: str):
+        """Compare the footprint with the plain bin image"""
+        img = self.img
+        raw = 12 + img.data_len
+        timg = len(self.binary)
+        methods = {}
+        for method, _ in self.tiles:
+            methods[method.name] = methods.get(method.name, 0) + 1
+
+        # Files: read buffer + tile buffer, the index entries are read per tile.
+        # Memory mapped: the index is used in place, uncompressed tiles are
+        # drawn directly so the tile buffer is needed only for compressed ones.
+        ram_file = self.max_tile_size + self.tile_raw_size
+        compressed = any(m != CompressMethod.NONE for m, _ in self.tiles)
+        ram_xip = self.tile_raw_size if compressed else 0
+
+        print(f"{name}: {img.w}x{img.h} {img.cf.name}, "
+              f"{self.tile_w}x{self.tile_h} tiles: {len(self.tiles)} "
+              f"({', '.join(f'{k}: {v}' for k, v in sorted(methods.items()))})")
+        print(f"  storage:  bin {raw} B, timg {timg} B "
+              f"({timg * 100 // raw}%)")
+        print(f"  RAM file: bin (LV_BIN_DECODER_RAM_LOAD) {raw} B, "
+              f"timg {ram_file} B")
+        print(f"  RAM XIP:  bin 0 B (uncompressed only), timg {ram_xip} B")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='LVGL PNG to tiled image container (*.timg) tool.')
+    parser.add_argument('--ofmt',
+                        help="output format, TIMG file or C array",
+                        default="TIMG",
+                        choices=["TIMG", "C"])
+    parser.add_argument('--cf',
+                        help="color format of the tiles",
+                        default="RGB565",
+                        choices=SUPPORTED_CF)
+    parser.add_argument('--tile',
+                        help=("tile size, e.g. 64x32. Use a width whose stride "
+                              "matches LV_DRAW_BUF_STRIDE_ALIGN to draw "
+                              "uncompressed tiles directly"),
+                        default="64x32",
+                        metavar='WxH')
+    parser.add_argument('--compress',
+                        help=("compress method of the tiles, AUTO picks the "
+                              "smallest for each tile"),
+                        default="AUTO",
+                        choices=["AUTO", "NONE", "RLE", "LZ4"])
+    parser.add_argument('--align',
+                        help="alignment of the tiles' data in bytes",
+                        default=4,
+                        type=int,
+                        metavar='byte')
+    parser.add_argument('--background',
+                        help="Background color for formats without alpha",
+                        default=0x00_00_00,
+                        type=lambda x: int(x, 0),
+                        metavar='color')
+    parser.add_argument('-o',
+                        '--output',
+                        default="./output",
+                        help="Select the output folder, default to ./output")
+    parser.add_argument('-v', '--verbose', action='store_true')
+    parser.add_argument(
+        'input', help="the filename or folder to be recursively converted")
+
+    args = parser.parse_args()
+
+    if args.verbose:
+        logging.basicConfig(level=logging.INFO)
+
+    if path.isfile(args.input):
+        files = [args.input]
+    elif path.isdir(args.input):
+        files = list(Path(args.input).rglob("*.[pP][nN][gG]"))
+    else:
+        raise BaseException(f"invalid input: {args.input}")
+
+    try:
+        tile_w, tile_h = (int(v) for v in args.tile.lower().split("x"))
+    except ValueError:
+        raise ParameterError(f"invalid tile size: {args.tile}")
+
+    Path(args.output).mkdir(parents=True, exist_ok=True)
+    ext = ".timg" if args.ofmt == "TIMG" else ".c"
+    for f in files:
+        img = LVGLImage().from_png(str(f), ColorFormat[args.cf],
+                                   background=args.background)
+        timg = TiledImage(img, tile_w, tile_h, args.compress, args.align)
+        name, _ = path.splitext(path.basename(f))
+        output = path.join(args.output, name + ext)
+        if args.ofmt == "TIMG":
+            timg.to_timg(output)
+        else:
+            timg.to_c_array(output)
+        timg.report(output)
+
+    print(f"done {len(files)} files")
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -19,6 +19,7 @@ extern "C" {
 
 #include "../misc/lv_types.h"
 #include "../draw/lv_draw.h"
+#include "../draw/lv_image_decoder_async.h"
 #if LV_USE_DRAW_SW
 #include "../draw/sw/lv_draw_sw.h"
 #endif
@@ -36,6 +37,12 @@ extern "C" {
 #include "../font/lv_font_fmt_txt.h"
 #endif
 
+#include "../font/lv_font_glyph_cache.h"
+
+#if LV_USE_TIMG
+#include "../libs/timg/lv_timg.h"
+#endif
+
 #include "../tick/lv_tick.h"
 #include "../layouts/lv_layout.h"
 
@@ -111,6 +118,12 @@ typedef struct _lv_global_t {
     lv_cache_t * img_header_cache;
 #endif
 
+    lv_image_cache_stats_t img_cache_stats;
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    lv_image_decoder_async_t * img_decoder_async;
+#endif
+
     lv_draw_global_info_t draw_info;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
     lv_draw_sw_shadow_cache_t sw_shadow_cache;
@@ -175,6 +188,15 @@ typedef struct _lv_global_t {
     lv_font_fmt_rle_t font_fmt_rle;
 #endif
 
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    lv_cache_t * font_glyph_cache;
+    lv_font_glyph_cache_stats_t font_glyph_cache_stats;
+#endif
+
+#if LV_USE_TIMG
+    lv_timg_stats_t timg_stats;
+#endif
+
 #if LV_USE_SPAN != 0
     struct _snippet_stack * span_snippet_stack;
 #endif
@@ -7,7 +7,10 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_image.h"
+#include "lv_draw_rect.h"
+#include "lv_image_decoder_async.h"
 #include "../display/lv_display.h"
+#include "../core/lv_global.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_math.h"
 #include "../core/lv_refr.h"
@@ -17,6 +20,7 @@
 /*********************
  *      DEFINES
  *********************/
+#define img_cache_stats (LV_GLOBAL_DEFAULT()->img_cache_stats)
 
 /**********************
  *      TYPEDEFS
@@ -31,6 +35,10 @@ static void img_decode_and_draw(lv_draw_unit_t * draw_unit, const lv_draw_image_
                                 const lv_area_t * img_area, const lv_area_t * clipped_img_area,
                                 lv_draw_image_core_cb draw_core_cb);
 
+#if LV_USE_IMAGE_DECODER_ASYNC
+static void draw_placeholder(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv_area_t * area);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -98,13 +106,26 @@ void lv_draw_image(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv
         return;
     }
 
+    lv_area_t real_area;
+    _lv_image_buf_get_transformed_area(&real_area, lv_area_get_width(coords), lv_area_get_height(coords),
+                                       dsc->rotation, dsc->scale_x, dsc->scale_y, &dsc->pivot);
+    lv_area_move(&real_area, coords->x1, coords->y1);
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*Don't stall the rendering while the image is decoded in the background*/
+    if(_lv_image_decoder_async_request(new_image_dsc->src, &new_image_dsc->header, layer,
+                                       &real_area) == LV_IMAGE_DECODER_ASYNC_PENDING) {
+        draw_placeholder(layer, new_image_dsc, &real_area);
+        lv_free(new_image_dsc);
+        LV_PROFILER_END;
+        return;
+    }
+#endif
+
     lv_draw_task_t * t = lv_draw_add_task(layer, coords);
     t->draw_dsc = new_image_dsc;
     t->type = LV_DRAW_TASK_TYPE_IMAGE;
-
-    _lv_image_buf_get_transformed_area(&t->_real_area, lv_area_get_width(coords), lv_area_get_height(coords),
-                                       dsc->rotation, dsc->scale_x, dsc->scale_y, &dsc->pivot);
-    lv_area_move(&t->_real_area, coords->x1, coords->y1);
+    t->_real_area = real_area;
 
     lv_draw_finalize_task_creation(layer, t);
     LV_PROFILER_END;
@@ -293,3 +314,20 @@ static void img_decode_and_draw(lv_draw_unit_t * draw_unit, const lv_draw_image_
         }
     }
 }
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+static void draw_placeholder(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv_area_t * area)
+{
+    _LV_IMAGE_CACHE_STATS_LOCK();
+    img_cache_stats.placeholder_cnt++;
+    _LV_IMAGE_CACHE_STATS_UNLOCK();
+
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = lv_color_hex3(0x888);
+    rect_dsc.bg_opa = LV_OPA_MIX2(LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA, dsc->opa);
+    if(rect_dsc.bg_opa <= LV_OPA_MIN) return;
+
+    lv_draw_rect(layer, &rect_dsc, area);
+}
+#endif
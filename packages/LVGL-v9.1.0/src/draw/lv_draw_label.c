@@ -9,6 +9,7 @@
 #include "../core/lv_obj.h"
 #include "lv_draw_label.h"
 #include "../misc/lv_math.h"
+#include "../font/lv_font_glyph_cache.h"
 #include "../core/lv_obj_event.h"
 #include "../misc/lv_bidi.h"
 #include "../misc/lv_assert.h"
@@ -30,6 +31,10 @@
  **********************/
 static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,  const lv_point_t * pos,
                         const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb);
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_text_line_cache_t * line_cache,
+                             uint32_t line_start, int32_t w);
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_text_line_cache_t * line_cache,
+                              uint32_t line_start, uint32_t line_end);
 
 /**********************
  *  STATIC VARIABLES
@@ -154,9 +159,20 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     lv_bidi_calculate_align(&align, &base_dir, dsc->text);
 
+    lv_text_line_cache_t * line_cache = NULL;
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
+        if(dsc->line_cache &&
+           lv_text_line_cache_update(dsc->line_cache, dsc->text, font, dsc->letter_space, w, dsc->flag)) {
+            line_cache = dsc->line_cache;
+        }
+    }
+    else if(dsc->line_cache &&
+            lv_text_line_cache_update(dsc->line_cache, dsc->text, font, dsc->letter_space, LV_COORD_MAX, dsc->flag)) {
+        /*With EXPAND the line breaks don't depend on the width so there is no need to measure the text*/
+        w = LV_COORD_MAX;
+        line_cache = dsc->line_cache;
     }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
@@ -198,14 +214,13 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
         pos.y += dsc->hint->y;
     }
 
-    uint32_t line_end = line_start + _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL,
-                                                            dsc->flag);
+    uint32_t line_end = get_line_end(dsc, line_cache, line_start, w);
 
     /*Go the first visible line*/
     while(pos.y + line_height_font < draw_unit->clip_area->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_end = get_line_end(dsc, line_cache, line_start, w);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -220,14 +235,14 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = get_line_width(dsc, line_cache, line_start, line_end);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = get_line_width(dsc, line_cache, line_start, line_end);
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -338,20 +353,18 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        line_end = get_line_end(dsc, line_cache, line_start, w);
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = get_line_width(dsc, line_cache, line_start, line_end);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = get_line_width(dsc, line_cache, line_start, line_end);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -379,6 +392,10 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
         return;
 
     LV_PROFILER_BEGIN;
+    g.entry = NULL;
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    bool glyph_cached = false;
+#endif
     bool g_ret = lv_font_get_glyph_dsc(font, &g, letter, '\0');
     if(g_ret == false) {
         /*Add warning if the dsc is not found*/
@@ -405,23 +422,36 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
     }
 
     if(g.resolved_font) {
-        lv_draw_buf_t * draw_buf = NULL;
-        if(LV_FONT_GLYPH_FORMAT_NONE < g.format && g.format < LV_FONT_GLYPH_FORMAT_IMAGE) {
-            /*Only check draw buf for bitmap glyph*/
-            draw_buf = lv_draw_buf_reshape(dsc->_draw_buf, 0, g.box_w, g.box_h, LV_STRIDE_AUTO);
-            if(draw_buf == NULL) {
-                if(dsc->_draw_buf) lv_draw_buf_destroy(dsc->_draw_buf);
-
-                uint32_t h = g.box_h;
-                if(h * g.box_w < 64) h *= 2; /*Alloc a slightly larger buffer*/
-                draw_buf = lv_draw_buf_create(g.box_w, h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
-                LV_ASSERT_MALLOC(draw_buf);
-                draw_buf->header.h = g.box_h;
-                dsc->_draw_buf = draw_buf;
-            }
+        bool is_bitmap = LV_FONT_GLYPH_FORMAT_NONE < g.format && g.format < LV_FONT_GLYPH_FORMAT_IMAGE;
+        dsc->glyph_data = NULL;
+
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+        /*Fonts with a `release_glyph` callback manage their own cache*/
+        if(is_bitmap && g.resolved_font->release_glyph == NULL) {
+            dsc->glyph_data = (void *)lv_font_glyph_cache_get_bitmap(&g, letter);
+            glyph_cached = dsc->glyph_data != NULL;
         }
+#endif
 
-        dsc->glyph_data = (void *)lv_font_get_glyph_bitmap(&g, letter, draw_buf);
+        if(dsc->glyph_data == NULL) {
+            lv_draw_buf_t * draw_buf = NULL;
+            if(is_bitmap) {
+                /*Only check draw buf for bitmap glyph*/
+                draw_buf = lv_draw_buf_reshape(dsc->_draw_buf, 0, g.box_w, g.box_h, LV_STRIDE_AUTO);
+                if(draw_buf == NULL) {
+                    if(dsc->_draw_buf) lv_draw_buf_destroy(dsc->_draw_buf);
+
+                    uint32_t h = g.box_h;
+                    if(h * g.box_w < 64) h *= 2; /*Alloc a slightly larger buffer*/
+                    draw_buf = lv_draw_buf_create(g.box_w, h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+                    LV_ASSERT_MALLOC(draw_buf);
+                    draw_buf->header.h = g.box_h;
+                    dsc->_draw_buf = draw_buf;
+                }
+            }
+
+            dsc->glyph_data = (void *)lv_font_get_glyph_bitmap(&g, letter, draw_buf);
+        }
         dsc->format = dsc->glyph_data ? g.format : LV_FONT_GLYPH_FORMAT_NONE;
     }
     else {
@@ -432,8 +462,35 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
     dsc->g = &g;
     cb(draw_unit, dsc, NULL, NULL);
 
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    if(glyph_cached) lv_font_glyph_cache_release(&g);
+#endif
+
     if(g.resolved_font && font->release_glyph) {
         font->release_glyph(font, &g);
     }
     LV_PROFILER_END;
 }
+
+static uint32_t get_line_end(const lv_draw_label_dsc_t * dsc, const lv_text_line_cache_t * line_cache,
+                             uint32_t line_start, int32_t w)
+{
+    if(line_cache) {
+        uint32_t i = lv_text_line_cache_find(line_cache, line_start);
+        return i < line_cache->line_cnt ? line_cache->line_start[i + 1] : line_start;
+    }
+
+    return line_start + _lv_text_get_next_line(&dsc->text[line_start], dsc->font, dsc->letter_space, w, NULL,
+                                               dsc->flag);
+}
+
+static int32_t get_line_width(const lv_draw_label_dsc_t * dsc, const lv_text_line_cache_t * line_cache,
+                              uint32_t line_start, uint32_t line_end)
+{
+    if(line_cache) {
+        uint32_t i = lv_text_line_cache_find(line_cache, line_start);
+        return i < line_cache->line_cnt ? line_cache->line_width[i] : 0;
+    }
+
+    return lv_text_get_width(&dsc->text[line_start], line_end - line_start, dsc->font, dsc->letter_space);
+}
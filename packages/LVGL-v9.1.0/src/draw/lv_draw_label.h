@@ -70,6 +70,10 @@ typedef struct {
      * 0: `text` is const and it's pointer will be valid during rendering.*/
     uint8_t text_local : 1;
     lv_draw_label_hint_t * hint;
+
+    /** Line breaks of `text` cached by the widget (e.g. label). Updated during drawing if the parameters changed.
+     * NULL to measure the lines on every redraw.*/
+    lv_text_line_cache_t * line_cache;
 } lv_draw_label_dsc_t;
 
 typedef struct {
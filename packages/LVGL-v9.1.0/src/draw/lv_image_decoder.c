@@ -12,6 +12,7 @@
 #include "../misc/lv_ll.h"
 #include "../stdlib/lv_string.h"
 #include "../core/lv_global.h"
+#include "lv_image_decoder_async.h"
 
 /*********************
  *      DEFINES
@@ -19,6 +20,7 @@
 #define img_decoder_ll_p &(LV_GLOBAL_DEFAULT()->img_decoder_ll)
 #define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
 #define img_header_cache_p (LV_GLOBAL_DEFAULT()->img_header_cache)
+#define img_cache_stats (LV_GLOBAL_DEFAULT()->img_cache_stats)
 
 /**********************
  *      TYPEDEFS
@@ -128,7 +130,12 @@ lv_result_t lv_image_decoder_open(lv_image_decoder_dsc_t * dsc, const void * src
         /*
         * Check the cache first
         * If the image is found in the cache, just return it.*/
-        if(try_cache(dsc) == LV_RESULT_OK) return LV_RESULT_OK;
+        if(try_cache(dsc) == LV_RESULT_OK) {
+            _LV_IMAGE_CACHE_STATS_LOCK();
+            img_cache_stats.hit_cnt++;
+            _LV_IMAGE_CACHE_STATS_UNLOCK();
+            return LV_RESULT_OK;
+        }
     }
 #endif
 
@@ -149,7 +156,22 @@ lv_result_t lv_image_decoder_open(lv_image_decoder_dsc_t * dsc, const void * src
      * If decoder open failed, free the source and return error.
      * If decoder open succeed, add the image to cache if enabled.
      * */
+    uint32_t t_start = lv_tick_get();
     lv_result_t res = dsc->decoder->open_cb(dsc->decoder, dsc);
+    if(res != LV_RESULT_OK) {
+        _LV_IMAGE_CACHE_STATS_LOCK();
+        img_cache_stats.fail_cnt++;
+        _LV_IMAGE_CACHE_STATS_UNLOCK();
+        return res;
+    }
+
+    if(dsc->time_to_open == 0) dsc->time_to_open = lv_tick_elaps(t_start);
+
+    _LV_IMAGE_CACHE_STATS_LOCK();
+    img_cache_stats.miss_cnt++;
+    img_cache_stats.decode_time_sum += dsc->time_to_open;
+    if(dsc->time_to_open > img_cache_stats.decode_time_max) img_cache_stats.decode_time_max = dsc->time_to_open;
+    _LV_IMAGE_CACHE_STATS_UNLOCK();
 
     return res;
 }
@@ -431,6 +453,10 @@ static void image_decoder_cache_free_cb(lv_image_cache_data_t * entry, void * us
     const lv_image_decoder_t * decoder = entry->decoder;
     if(decoder == NULL) return; /* Why ? */
 
+    _LV_IMAGE_CACHE_STATS_LOCK();
+    img_cache_stats.free_cnt++;
+    _LV_IMAGE_CACHE_STATS_UNLOCK();
+
     if(decoder->cache_free_cb) {
         /* Decoder wants to free the cache by itself. */
         decoder->cache_free_cb(entry, user_data);
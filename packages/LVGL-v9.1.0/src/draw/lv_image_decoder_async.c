@@ -0,0 +1,411 @@
+/**
+ * @file lv_image_decoder_async.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_image_decoder_async.h"
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+
+#include "lv_image_decoder.h"
+#include "../core/lv_global.h"
+#include "../core/lv_refr.h"
+#include "../display/lv_display.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_timer.h"
+#include "../osal/lv_os.h"
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+
+#if LV_USE_OS == LV_OS_NONE || LV_CACHE_DEF_SIZE == 0
+    #error "LV_USE_IMAGE_DECODER_ASYNC requires LV_USE_OS and LV_CACHE_DEF_SIZE > 0"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define async_p (LV_GLOBAL_DEFAULT()->img_decoder_async)
+#define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
+#define img_cache_stats (LV_GLOBAL_DEFAULT()->img_cache_stats)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    JOB_STATE_FREE,
+    JOB_STATE_QUEUED,
+    JOB_STATE_RUNNING,
+    JOB_STATE_DONE,
+} job_state_t;
+
+typedef struct {
+    const void * src;       /*Duplicated file name or pointer to the C array*/
+    lv_image_src_t src_type;
+    job_state_t state;
+    uint32_t seq;           /*Order of the requests to decode and to reuse the oldest jobs first*/
+    bool cached;            /*The decoder added the image to the cache*/
+    bool notify;            /*Invalidate `inv_area` when the job is done*/
+    bool inv_full;          /*Invalidate the whole display instead of `inv_area`*/
+    lv_display_t * disp;    /*The display to invalidate or NULL for all displays*/
+    lv_area_t inv_area;
+} decode_job_t;
+
+struct _lv_image_decoder_async_t {
+    lv_thread_t thread;
+    lv_thread_sync_t sync;
+    lv_mutex_t lock;        /*Protects the jobs*/
+    lv_timer_t * timer;     /*Invalidates the areas of the decoded images in LVGL's thread*/
+    uint32_t seq;
+    bool exit_status;
+    decode_job_t jobs[LV_IMAGE_DECODER_ASYNC_JOB_CNT];
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void decode_thread_cb(void * user_data);
+static void done_timer_cb(lv_timer_t * timer);
+static bool image_is_slow(const void * src, lv_image_src_t src_type);
+static bool image_is_cached(const void * src, lv_image_src_t src_type);
+static decode_job_t * job_find(lv_image_decoder_async_t * async, const void * src, lv_image_src_t src_type);
+static decode_job_t * job_alloc(lv_image_decoder_async_t * async);
+static decode_job_t * job_get_next_queued(lv_image_decoder_async_t * async);
+static void job_add_area(decode_job_t * job, lv_layer_t * layer, const lv_area_t * area);
+static void job_invalidate(decode_job_t * job);
+static void job_free(decode_job_t * job);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_image_decoder_async_init(void)
+{
+    lv_image_decoder_async_t * async = lv_malloc_zeroed(sizeof(lv_image_decoder_async_t));
+    LV_ASSERT_MALLOC(async);
+    if(async == NULL) return;
+
+    async->timer = lv_timer_create(done_timer_cb, LV_DEF_REFR_PERIOD, async);
+    if(async->timer == NULL) {
+        lv_free(async);
+        return;
+    }
+    lv_timer_pause(async->timer);
+
+    lv_mutex_init(&async->lock);
+    lv_thread_sync_init(&async->sync);
+
+    /*Decode only when LVGL and the other threads have nothing to do*/
+    if(lv_thread_init(&async->thread, LV_THREAD_PRIO_LOWEST, decode_thread_cb, LV_IMAGE_DECODER_ASYNC_STACK_SIZE,
+                      async) != LV_RESULT_OK) {
+        LV_LOG_WARN("couldn't create the image decoder thread");
+        lv_thread_sync_delete(&async->sync);
+        lv_mutex_delete(&async->lock);
+        lv_timer_delete(async->timer);
+        lv_free(async);
+        return;
+    }
+
+    async_p = async;
+}
+
+void _lv_image_decoder_async_deinit(void)
+{
+    lv_image_decoder_async_t * async = async_p;
+    if(async == NULL) return;
+
+    LV_LOG_INFO("cancel image decoder thread");
+    async->exit_status = true;
+    lv_thread_sync_signal(&async->sync);
+    lv_thread_delete(&async->thread);
+
+    lv_thread_sync_delete(&async->sync);
+    lv_mutex_delete(&async->lock);
+    lv_timer_delete(async->timer);
+
+    uint32_t i;
+    for(i = 0; i < LV_IMAGE_DECODER_ASYNC_JOB_CNT; i++) {
+        job_free(&async->jobs[i]);
+    }
+
+    lv_free(async);
+    async_p = NULL;
+}
+
+lv_image_decoder_async_state_t _lv_image_decoder_async_request(const void * src, const lv_image_header_t * header,
+                                                               lv_layer_t * layer, const lv_area_t * area)
+{
+    LV_ASSERT_NULL(header);
+    LV_UNUSED(header);
+
+    lv_image_decoder_async_t * async = async_p;
+    if(async == NULL) return LV_IMAGE_DECODER_ASYNC_READY;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(!image_is_slow(src, src_type)) return LV_IMAGE_DECODER_ASYNC_READY;
+
+    if(image_is_cached(src, src_type)) return LV_IMAGE_DECODER_ASYNC_READY;
+
+    bool queued = false;
+    lv_mutex_lock(&async->lock);
+
+    decode_job_t * job = job_find(async, src, src_type);
+    if(job && job->state == JOB_STATE_DONE) {
+        /*The decoder doesn't cache this image (e.g. it decodes it line by line) or it was evicted
+         *from the cache since then, e.g. the cache can't hold all the images of the screen.
+         *Decoding it again in the background would only evict an other one, so open it as usual.*/
+        lv_mutex_unlock(&async->lock);
+        return LV_IMAGE_DECODER_ASYNC_READY;
+    }
+    else if(job == NULL) {
+        job = job_alloc(async);
+        if(job) {
+            job->src_type = src_type;
+            job->src = src_type == LV_IMAGE_SRC_FILE ? lv_strdup(src) : src;
+            if(job->src == NULL) job = NULL;
+        }
+
+        if(job == NULL) {
+            lv_mutex_unlock(&async->lock);
+            return LV_IMAGE_DECODER_ASYNC_FULL;
+        }
+
+        job->state = JOB_STATE_QUEUED;
+        job->seq = async->seq++;
+        queued = true;
+    }
+
+    job_add_area(job, layer, area);
+
+    lv_mutex_unlock(&async->lock);
+
+    if(queued) lv_thread_sync_signal(&async->sync);
+    lv_timer_resume(async->timer);
+
+    return LV_IMAGE_DECODER_ASYNC_PENDING;
+}
+
+void _lv_image_decoder_async_stats_lock(void)
+{
+    lv_image_decoder_async_t * async = async_p;
+    if(async) lv_mutex_lock(&async->lock);
+}
+
+void _lv_image_decoder_async_stats_unlock(void)
+{
+    lv_image_decoder_async_t * async = async_p;
+    if(async) lv_mutex_unlock(&async->lock);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void decode_thread_cb(void * user_data)
+{
+    lv_image_decoder_async_t * async = user_data;
+
+    while(1) {
+        lv_thread_sync_wait(&async->sync);
+        if(async->exit_status) break;
+
+        while(1) {
+            lv_mutex_lock(&async->lock);
+            decode_job_t * job = job_get_next_queued(async);
+            if(job) job->state = JOB_STATE_RUNNING;
+            lv_mutex_unlock(&async->lock);
+
+            if(job == NULL || async->exit_status) break;
+
+            /*The source stays valid while running as only free or done jobs are reused.
+             *The decoder adds the decoded image to the cache, so it's not copied here.*/
+            bool cached = false;
+            lv_image_decoder_dsc_t decoder_dsc;
+            lv_result_t res = lv_image_decoder_open(&decoder_dsc, job->src, NULL);
+            if(res == LV_RESULT_OK) {
+                cached = decoder_dsc.cache_entry != NULL;
+                lv_image_decoder_close(&decoder_dsc);
+            }
+
+            lv_mutex_lock(&async->lock);
+            job->cached = cached;
+            job->state = JOB_STATE_DONE;
+            if(res == LV_RESULT_OK) img_cache_stats.async_cnt++;
+            lv_mutex_unlock(&async->lock);
+        }
+    }
+
+    LV_LOG_INFO("exit image decoder thread");
+}
+
+static void done_timer_cb(lv_timer_t * timer)
+{
+    lv_image_decoder_async_t * async = lv_timer_get_user_data(timer);
+    bool busy = false;
+
+    lv_mutex_lock(&async->lock);
+
+    uint32_t i;
+    for(i = 0; i < LV_IMAGE_DECODER_ASYNC_JOB_CNT; i++) {
+        decode_job_t * job = &async->jobs[i];
+        if(job->state == JOB_STATE_QUEUED || job->state == JOB_STATE_RUNNING) {
+            busy = true;
+        }
+        else if(job->state == JOB_STATE_DONE && job->notify) {
+            /*Redraw the placeholders with the decoded image*/
+            job_invalidate(job);
+            job->notify = false;
+        }
+    }
+
+    if(!busy) lv_timer_pause(timer);
+
+    lv_mutex_unlock(&async->lock);
+}
+
+static bool image_is_slow(const void * src, lv_image_src_t src_type)
+{
+    if(src_type == LV_IMAGE_SRC_FILE) return true;
+    if(src_type != LV_IMAGE_SRC_VARIABLE) return false;
+
+    /*Only encoded images (e.g. a PNG in a C array) are slow to open*/
+    const lv_image_dsc_t * img_dsc = src;
+    if(img_dsc->header.cf != LV_COLOR_FORMAT_RAW && img_dsc->header.cf != LV_COLOR_FORMAT_RAW_ALPHA) return false;
+
+    /*The decoders which decode by area (e.g. tiled images) open them quickly.
+     *Pick the decoder in the same order as `lv_image_decoder_get_info()`.*/
+    lv_image_decoder_t * decoder = NULL;
+    while((decoder = lv_image_decoder_get_next(decoder)) != NULL) {
+        if(decoder->info_cb == NULL || decoder->open_cb == NULL) continue;
+
+        lv_image_header_t header;
+        if(decoder->info_cb(decoder, src, &header) == LV_RESULT_OK) return decoder->get_area_cb == NULL;
+    }
+
+    return false;
+}
+
+static bool image_is_cached(const void * src, lv_image_src_t src_type)
+{
+    lv_image_cache_data_t search_key;
+    search_key.src_type = src_type;
+    search_key.src = src;
+
+    lv_cache_entry_t * entry = lv_cache_acquire(img_cache_p, &search_key, NULL);
+    if(entry == NULL) return false;
+
+    lv_cache_release(img_cache_p, entry, NULL);
+    return true;
+}
+
+static decode_job_t * job_find(lv_image_decoder_async_t * async, const void * src, lv_image_src_t src_type)
+{
+    uint32_t i;
+    for(i = 0; i < LV_IMAGE_DECODER_ASYNC_JOB_CNT; i++) {
+        decode_job_t * job = &async->jobs[i];
+        if(job->state == JOB_STATE_FREE || job->src_type != src_type) continue;
+
+        if(src_type == LV_IMAGE_SRC_FILE) {
+            if(lv_strcmp(job->src, src) == 0) return job;
+        }
+        else if(job->src == src) {
+            return job;
+        }
+    }
+
+    return NULL;
+}
+
+static decode_job_t * job_alloc(lv_image_decoder_async_t * async)
+{
+    decode_job_t * oldest = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_IMAGE_DECODER_ASYNC_JOB_CNT; i++) {
+        decode_job_t * job = &async->jobs[i];
+        if(job->state == JOB_STATE_FREE) return job;
+
+        /*Reuse the oldest finished job. The image is in the cache or the decoder doesn't cache it anyway.*/
+        if(job->state == JOB_STATE_DONE && !job->notify) {
+            if(oldest == NULL || async->seq - job->seq > async->seq - oldest->seq) oldest = job;
+        }
+    }
+
+    if(oldest) job_free(oldest);
+    return oldest;
+}
+
+static decode_job_t * job_get_next_queued(lv_image_decoder_async_t * async)
+{
+    decode_job_t * next = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_IMAGE_DECODER_ASYNC_JOB_CNT; i++) {
+        decode_job_t * job = &async->jobs[i];
+        if(job->state != JOB_STATE_QUEUED) continue;
+
+        if(next == NULL || async->seq - job->seq > async->seq - next->seq) next = job;
+    }
+
+    return next;
+}
+
+static void job_add_area(decode_job_t * job, lv_layer_t * layer, const lv_area_t * area)
+{
+    /*Nothing to redraw on prefetch*/
+    if(layer == NULL || area == NULL) return;
+
+    lv_display_t * disp = _lv_refr_get_disp_refreshing();
+
+    if(!job->notify) {
+        job->notify = true;
+        job->disp = disp;
+        job->inv_full = false;
+        job->inv_area = *area;
+    }
+    else if(job->disp != disp) {
+        job->disp = NULL;
+        job->inv_full = true;
+    }
+    else {
+        _lv_area_join(&job->inv_area, &job->inv_area, area);
+    }
+
+    /*On the layers of transformed widgets the coordinates are not the display's coordinates*/
+    if(layer->parent != NULL) job->inv_full = true;
+}
+
+static void job_invalidate(decode_job_t * job)
+{
+    lv_display_t * disp = lv_display_get_next(NULL);
+    while(disp) {
+        if(job->disp == NULL || job->disp == disp) {
+            if(job->inv_full) {
+                lv_area_t disp_area;
+                lv_area_set(&disp_area, 0, 0, lv_display_get_horizontal_resolution(disp) - 1,
+                            lv_display_get_vertical_resolution(disp) - 1);
+                _lv_inv_area(disp, &disp_area);
+            }
+            else {
+                _lv_inv_area(disp, &job->inv_area);
+            }
+        }
+        disp = lv_display_get_next(disp);
+    }
+}
+
+static void job_free(decode_job_t * job)
+{
+    if(job->state != JOB_STATE_FREE && job->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)job->src);
+    lv_memzero(job, sizeof(decode_job_t));
+}
+
+#endif /*LV_USE_IMAGE_DECODER_ASYNC*/
@@ -0,0 +1,97 @@
+/**
+ * @file lv_image_decoder_async.h
+ *
+ */
+
+#ifndef LV_IMAGE_DECODER_ASYNC_H
+#define LV_IMAGE_DECODER_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "../misc/lv_types.h"
+#include "../misc/lv_area.h"
+#include "lv_image_dsc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    LV_IMAGE_DECODER_ASYNC_READY,       /**< Cached or not decoded in the background. Open it as usual.*/
+    LV_IMAGE_DECODER_ASYNC_PENDING,     /**< Queued or being decoded by the background thread*/
+    LV_IMAGE_DECODER_ASYNC_FULL,        /**< No free job slot. Open it as usual.*/
+} lv_image_decoder_async_state_t;
+
+struct _lv_image_decoder_async_t;
+typedef struct _lv_image_decoder_async_t lv_image_decoder_async_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+
+/**
+ * Start the image decoder thread. Called by `lv_init()`.
+ */
+void _lv_image_decoder_async_init(void);
+
+/**
+ * Stop the image decoder thread and free the jobs. Called by `lv_deinit()`.
+ */
+void _lv_image_decoder_async_deinit(void);
+
+/**
+ * Check whether an image is in the cache and if not queue it for the decoder thread.
+ * Files and encoded C arrays (`LV_COLOR_FORMAT_RAW/RAW_ALPHA`) are decoded in the background
+ * unless their decoder decodes them by area, other images are opened as usual.
+ * When the image is decoded the given area is invalidated to redraw it.
+ * Should be called from LVGL's thread.
+ * @param src       the image source
+ * @param header    the header of the image returned by `lv_image_decoder_get_info()`
+ * @param layer     the layer where the image would be drawn or NULL on prefetch
+ * @param area      the area of the image on `layer` or NULL on prefetch
+ * @return          the state of the image. Draw a placeholder on `LV_IMAGE_DECODER_ASYNC_PENDING`.
+ */
+lv_image_decoder_async_state_t _lv_image_decoder_async_request(const void * src, const lv_image_header_t * header,
+                                                               lv_layer_t * layer, const lv_area_t * area);
+
+/**
+ * Lock the statistics of the image cache. The decoder thread updates them too.
+ */
+void _lv_image_decoder_async_stats_lock(void);
+
+/**
+ * Unlock the statistics of the image cache.
+ */
+void _lv_image_decoder_async_stats_unlock(void);
+
+#endif /*LV_USE_IMAGE_DECODER_ASYNC*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+#define _LV_IMAGE_CACHE_STATS_LOCK()      _lv_image_decoder_async_stats_lock()
+#define _LV_IMAGE_CACHE_STATS_UNLOCK()    _lv_image_decoder_async_stats_unlock()
+#else
+#define _LV_IMAGE_CACHE_STATS_LOCK()
+#define _LV_IMAGE_CACHE_STATS_UNLOCK()
+#endif
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMAGE_DECODER_ASYNC_H*/
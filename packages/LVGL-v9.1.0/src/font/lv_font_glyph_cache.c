@@ -0,0 +1,204 @@
+/**
+ * @file lv_font_glyph_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_font_glyph_cache.h"
+#include "../core/lv_global.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_log.h"
+#include "../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define glyph_cache_p (LV_GLOBAL_DEFAULT()->font_glyph_cache)
+#define glyph_cache_stats (LV_GLOBAL_DEFAULT()->font_glyph_cache_stats)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const lv_font_t * font;
+    uint32_t unicode;
+    lv_draw_buf_t * draw_buf;
+} lv_font_glyph_cache_data_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+static bool glyph_cache_create_cb(lv_font_glyph_cache_data_t * node, void * user_data);
+static void glyph_cache_free_cb(lv_font_glyph_cache_data_t * node, void * user_data);
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_font_glyph_cache_data_t * lhs,
+                                                     const lv_font_glyph_cache_data_t * rhs);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_font_glyph_cache_init(void)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    glyph_cache_p = lv_cache_create(&lv_cache_class_lru_rb_count,
+    sizeof(lv_font_glyph_cache_data_t), LV_FONT_GLYPH_CACHE_DEF_CNT, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t)glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t)glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t)glyph_cache_free_cb,
+    });
+    lv_font_glyph_cache_reset_stats();
+#endif
+}
+
+void _lv_font_glyph_cache_deinit(void)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    lv_cache_destroy(glyph_cache_p, NULL);
+    glyph_cache_p = NULL;
+#endif
+}
+
+const lv_draw_buf_t * lv_font_glyph_cache_get_bitmap(lv_font_glyph_dsc_t * g_dsc, uint32_t letter)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    LV_ASSERT_NULL(g_dsc);
+    LV_ASSERT_NULL(g_dsc->resolved_font);
+
+    g_dsc->entry = NULL;
+    if(glyph_cache_p == NULL) return NULL;
+
+    lv_font_glyph_cache_data_t search_key = {
+        .font = g_dsc->resolved_font,
+        .unicode = letter,
+    };
+
+    uint32_t miss_cnt_prev = glyph_cache_stats.miss_cnt;
+    lv_cache_entry_t * entry = lv_cache_acquire_or_create(glyph_cache_p, &search_key, g_dsc);
+    if(entry == NULL) {
+        glyph_cache_stats.bypass_cnt++;
+        return NULL;
+    }
+
+    if(glyph_cache_stats.miss_cnt == miss_cnt_prev) glyph_cache_stats.hit_cnt++;
+
+    g_dsc->entry = entry;
+    lv_font_glyph_cache_data_t * cached_data = lv_cache_entry_get_data(entry);
+    return cached_data->draw_buf;
+#else
+    LV_UNUSED(g_dsc);
+    LV_UNUSED(letter);
+    return NULL;
+#endif
+}
+
+void lv_font_glyph_cache_release(lv_font_glyph_dsc_t * g_dsc)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    LV_ASSERT_NULL(g_dsc);
+    if(g_dsc->entry == NULL) return;
+
+    lv_cache_release(glyph_cache_p, g_dsc->entry, NULL);
+    g_dsc->entry = NULL;
+#else
+    LV_UNUSED(g_dsc);
+#endif
+}
+
+void lv_font_glyph_cache_drop_all(void)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    if(glyph_cache_p == NULL) return;
+    lv_cache_drop_all(glyph_cache_p, NULL);
+#endif
+}
+
+void lv_font_glyph_cache_resize(uint32_t new_cnt, bool evict_now)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    lv_cache_set_max_size(glyph_cache_p, new_cnt, NULL);
+    if(evict_now) {
+        lv_cache_reserve(glyph_cache_p, new_cnt, NULL);
+    }
+#else
+    LV_UNUSED(new_cnt);
+    LV_UNUSED(evict_now);
+#endif
+}
+
+void lv_font_glyph_cache_get_stats(lv_font_glyph_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    *stats = glyph_cache_stats;
+#else
+    lv_memzero(stats, sizeof(lv_font_glyph_cache_stats_t));
+#endif
+}
+
+void lv_font_glyph_cache_reset_stats(void)
+{
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+    lv_memzero(&glyph_cache_stats, sizeof(lv_font_glyph_cache_stats_t));
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_FONT_GLYPH_CACHE_DEF_CNT > 0
+static bool glyph_cache_create_cb(lv_font_glyph_cache_data_t * node, void * user_data)
+{
+    lv_font_glyph_dsc_t * g_dsc = user_data;
+
+    lv_draw_buf_t * draw_buf = lv_draw_buf_create(g_dsc->box_w, g_dsc->box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+    if(draw_buf == NULL) {
+        LV_LOG_WARN("couldn't allocate the glyph buffer of U+%" LV_PRIX32, node->unicode);
+        return false;
+    }
+
+    /*The font decodes (and decompresses) the glyph into the cached buffer only once*/
+    if(node->font->get_glyph_bitmap(g_dsc, node->unicode, draw_buf) == NULL) {
+        lv_draw_buf_destroy(draw_buf);
+        return false;
+    }
+
+    node->draw_buf = draw_buf;
+    glyph_cache_stats.miss_cnt++;
+    return true;
+}
+
+static void glyph_cache_free_cb(lv_font_glyph_cache_data_t * node, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    if(node->draw_buf) lv_draw_buf_destroy(node->draw_buf);
+    node->draw_buf = NULL;
+}
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const lv_font_glyph_cache_data_t * lhs,
+                                                     const lv_font_glyph_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) {
+        return lhs->font > rhs->font ? 1 : -1;
+    }
+
+    if(lhs->unicode != rhs->unicode) {
+        return lhs->unicode > rhs->unicode ? 1 : -1;
+    }
+
+    return 0;
+}
+#endif /*LV_FONT_GLYPH_CACHE_DEF_CNT > 0*/
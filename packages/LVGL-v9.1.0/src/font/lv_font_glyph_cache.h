@@ -0,0 +1,99 @@
+/**
+ * @file lv_font_glyph_cache.h
+ *
+ */
+
+#ifndef LV_FONT_GLYPH_CACHE_H
+#define LV_FONT_GLYPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include "lv_font.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Statistics of the glyph bitmap cache
+ */
+typedef struct {
+    uint32_t hit_cnt;       /**< Number of glyphs served from the cache*/
+    uint32_t miss_cnt;      /**< Number of glyphs decoded and added to the cache*/
+    uint32_t bypass_cnt;    /**< Number of glyphs decoded without caching (cache full or busy)*/
+} lv_font_glyph_cache_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the glyph bitmap cache. Called by `lv_init()`.
+ */
+void _lv_font_glyph_cache_init(void);
+
+/**
+ * Deinitialize the glyph bitmap cache. Called by `lv_deinit()`.
+ */
+void _lv_font_glyph_cache_deinit(void);
+
+/**
+ * Get the A8 bitmap of a glyph from the cache. If the glyph is not cached yet
+ * it's decoded with the font's `get_glyph_bitmap` and added to the cache.
+ * Only fonts without their own cache (`release_glyph == NULL`, e.g. `lv_font_fmt_txt`) should use it.
+ * @param g_dsc     the glyph descriptor returned by `lv_font_get_glyph_dsc()`.
+ *                  On success `g_dsc->entry` holds the acquired cache entry.
+ * @param letter    the unicode letter
+ * @return          the cached draw buffer or NULL if the glyph couldn't be cached
+ */
+const lv_draw_buf_t * lv_font_glyph_cache_get_bitmap(lv_font_glyph_dsc_t * g_dsc, uint32_t letter);
+
+/**
+ * Release the cache entry acquired by `lv_font_glyph_cache_get_bitmap()`.
+ * @param g_dsc     the glyph descriptor. Nothing happens if `g_dsc->entry` is NULL.
+ */
+void lv_font_glyph_cache_release(lv_font_glyph_dsc_t * g_dsc);
+
+/**
+ * Drop all the cached glyphs. Needs to be called before freeing a font
+ * which might have been used with the cache (e.g. in `lv_binfont_destroy()`).
+ */
+void lv_font_glyph_cache_drop_all(void);
+
+/**
+ * Resize the glyph bitmap cache.
+ * @param new_cnt   new number of glyphs to keep
+ * @param evict_now true: evict the glyphs now, false: wait for the next cache cleanup.
+ */
+void lv_font_glyph_cache_resize(uint32_t new_cnt, bool evict_now);
+
+/**
+ * Get the statistics of the glyph bitmap cache.
+ * @param stats     pointer to a variable to store the result
+ */
+void lv_font_glyph_cache_get_stats(lv_font_glyph_cache_stats_t * stats);
+
+/**
+ * Reset the statistics of the glyph bitmap cache. (E.g. when a new benchmark scene starts)
+ */
+void lv_font_glyph_cache_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_FONT_GLYPH_CACHE_H*/
@@ -5307,8 +5307,11 @@ static void decodeGeneric(unsigned char ** out, unsigned * w, unsigned * h,
     lodepng_free(idat);
 
     if(!state->error) {
-        lv_draw_buf_t * decoded = lv_draw_buf_create(*w, *h, LV_COLOR_FORMAT_ARGB8888, 4 * *w);
+        /*Allocate for the aligned stride but decode with packed rows,
+         *so that `lv_image_decoder_post_process()` can align the rows in place without a copy*/
+        lv_draw_buf_t * decoded = lv_draw_buf_create(*w, *h, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
         if(decoded) {
+            decoded->header.stride = 4 * *w;
             *out = (unsigned char*)decoded;
             outsize = decoded->data_size;
         }
@@ -5348,11 +5351,12 @@ unsigned lodepng_decode(unsigned char ** out, unsigned * w, unsigned * h,
             return 56; /*unsupported color mode conversion*/
         }
 
-        lv_draw_buf_t * new_buf = lv_draw_buf_create(*w, *h, LV_COLOR_FORMAT_ARGB8888, 4 * *w);
+        lv_draw_buf_t * new_buf = lv_draw_buf_create(*w, *h, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
         if(new_buf == NULL) {
             state->error = 83; /*alloc fail*/
         }
         else {
+            new_buf->header.stride = 4 * *w;
             state->error = lodepng_convert(new_buf->data, old_buf->data, 
                                             &state->info_raw, &state->info_png.color, *w, *h);
             
@@ -0,0 +1,513 @@
+/**
+ * @file lv_timg.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../../lvgl.h"
+#if LV_USE_TIMG
+
+#include "../../core/lv_global.h"
+#include "../../libs/rle/lv_rle.h"
+
+#if LV_USE_LZ4_EXTERNAL
+    #include <lz4.h>
+#endif
+
+#if LV_USE_LZ4_INTERNAL
+    #include "../../libs/lz4/lz4.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define timg_stats (LV_GLOBAL_DEFAULT()->timg_stats)
+
+/*Offset of the tile index in the container*/
+#define TIMG_INDEX_OFFSET   (sizeof(lv_image_header_t) + sizeof(lv_timg_header_t))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*Opened for each draw task, so only what its tiles need is loaded*/
+typedef struct {
+    lv_fs_file_t f;                 /*The opened file or unused if `data != NULL`*/
+    const uint8_t * data;           /*The container in memory (e.g. XIP flash) or NULL for files*/
+    uint32_t data_size;
+    lv_timg_header_t timg;
+    const lv_timg_tile_t * index;   /*Points into `data` or NULL for files*/
+    uint8_t * read_buf;             /*Compressed data of a tile read from the file*/
+    lv_draw_buf_t * tile_buf;       /*The decompressed tile*/
+    lv_draw_buf_t tile_direct;      /*An uncompressed tile in `data`, used without copying*/
+    uint32_t col_cnt;
+} timg_dsc_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_result_t decoder_info(lv_image_decoder_t * decoder, const void * src, lv_image_header_t * header);
+static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area);
+
+static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+
+static lv_result_t header_check(const lv_image_header_t * header, const lv_timg_header_t * timg);
+static lv_result_t tile_get_index(timg_dsc_t * timg, uint32_t tile_id, lv_timg_tile_t * tile);
+static const lv_draw_buf_t * tile_load(lv_image_decoder_dsc_t * dsc, uint32_t tile_id);
+static lv_result_t tile_decompress(lv_image_compress_t method, const uint8_t * input, uint32_t input_len,
+                                   uint8_t * output, uint32_t output_len, uint32_t px_size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void lv_timg_init(void)
+{
+    lv_image_decoder_t * dec = lv_image_decoder_create();
+    lv_image_decoder_set_info_cb(dec, decoder_info);
+    lv_image_decoder_set_open_cb(dec, decoder_open);
+    lv_image_decoder_set_get_area_cb(dec, decoder_get_area);
+    lv_image_decoder_set_close_cb(dec, decoder_close);
+
+    lv_timg_reset_stats();
+}
+
+void lv_timg_deinit(void)
+{
+    lv_image_decoder_t * dec = NULL;
+    while((dec = lv_image_decoder_get_next(dec)) != NULL) {
+        if(dec->info_cb == decoder_info) {
+            lv_image_decoder_delete(dec);
+            break;
+        }
+    }
+}
+
+lv_result_t lv_timg_dsc_init(lv_image_dsc_t * dsc, const void * data, uint32_t data_size)
+{
+    LV_ASSERT_NULL(dsc);
+    LV_ASSERT_NULL(data);
+
+    if(data_size < TIMG_INDEX_OFFSET) return LV_RESULT_INVALID;
+
+    const lv_image_header_t * header = data;
+    const lv_timg_header_t * timg = (const lv_timg_header_t *)((const uint8_t *)data + sizeof(lv_image_header_t));
+    if(header_check(header, timg) != LV_RESULT_OK) return LV_RESULT_INVALID;
+    if(timg->tile_cnt > (data_size - TIMG_INDEX_OFFSET) / sizeof(lv_timg_tile_t)) return LV_RESULT_INVALID;
+
+    lv_memzero(dsc, sizeof(lv_image_dsc_t));
+    dsc->header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc->header.cf = LV_COLOR_FORMAT_RAW;
+    dsc->header.w = header->w;
+    dsc->header.h = header->h;
+    dsc->data = data;
+    dsc->data_size = data_size;
+
+    return LV_RESULT_OK;
+}
+
+void lv_timg_get_stats(lv_timg_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+    *stats = timg_stats;
+}
+
+void lv_timg_reset_stats(void)
+{
+    lv_memzero(&timg_stats, sizeof(lv_timg_stats_t));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get info about a tiled image
+ * @param src can be file name or pointer to an image descriptor created by `lv_timg_dsc_init()`
+ * @param header store the info here
+ * @return LV_RESULT_OK: no error; LV_RESULT_INVALID: can't get the info
+ */
+static lv_result_t decoder_info(lv_image_decoder_t * decoder, const void * src, lv_image_header_t * header)
+{
+    LV_UNUSED(decoder);
+
+    lv_image_header_t img_header;
+    lv_timg_header_t timg;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(src_type == LV_IMAGE_SRC_FILE) {
+        if(lv_strcmp(lv_fs_get_ext(src), "timg") != 0) return LV_RESULT_INVALID;
+
+        lv_fs_file_t f;
+        lv_fs_res_t res = lv_fs_open(&f, src, LV_FS_MODE_RD);
+        if(res != LV_FS_RES_OK) return LV_RESULT_INVALID;
+
+        uint32_t rn1 = 0;
+        uint32_t rn2 = 0;
+        res = lv_fs_read(&f, &img_header, sizeof(img_header), &rn1);
+        if(res == LV_FS_RES_OK) res = lv_fs_read(&f, &timg, sizeof(timg), &rn2);
+        lv_fs_close(&f);
+        if(res != LV_FS_RES_OK || rn1 != sizeof(img_header) || rn2 != sizeof(timg)) return LV_RESULT_INVALID;
+    }
+    else if(src_type == LV_IMAGE_SRC_VARIABLE) {
+        const lv_image_dsc_t * img_dsc = src;
+        if(img_dsc->header.cf != LV_COLOR_FORMAT_RAW) return LV_RESULT_INVALID;
+        if(img_dsc->data == NULL || img_dsc->data_size < TIMG_INDEX_OFFSET) return LV_RESULT_INVALID;
+
+        lv_memcpy(&img_header, img_dsc->data, sizeof(img_header));
+        lv_memcpy(&timg, img_dsc->data + sizeof(img_header), sizeof(timg));
+    }
+    else {
+        return LV_RESULT_INVALID;
+    }
+
+    if(header_check(&img_header, &timg) != LV_RESULT_OK) return LV_RESULT_INVALID;
+
+    *header = img_header;
+    /*Tiles are decompressed to a buffer of the decoder, not to the image's memory*/
+    header->flags &= ~(LV_IMAGE_FLAGS_COMPRESSED | LV_IMAGE_FLAGS_MODIFIABLE | LV_IMAGE_FLAGS_ALLOCATED);
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Open a tiled image. The index entries and the tiles are loaded in `decoder_get_area`.
+ * @param decoder pointer to the decoder
+ * @param dsc     pointer to the decoder descriptor
+ * @return LV_RESULT_OK: no error; LV_RESULT_INVALID: can't open the image
+ */
+static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    timg_dsc_t * timg = lv_malloc_zeroed(sizeof(timg_dsc_t));
+    LV_ASSERT_MALLOC(timg);
+    if(timg == NULL) return LV_RESULT_INVALID;
+
+    dsc->user_data = timg;
+
+    if(dsc->src_type == LV_IMAGE_SRC_FILE) {
+        if(lv_fs_open(&timg->f, dsc->src, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+            lv_free(timg);
+            dsc->user_data = NULL;
+            return LV_RESULT_INVALID;
+        }
+
+        uint32_t rn = 0;
+        lv_fs_res_t res = lv_fs_seek(&timg->f, sizeof(lv_image_header_t), LV_FS_SEEK_SET);
+        if(res == LV_FS_RES_OK) res = lv_fs_read(&timg->f, &timg->timg, sizeof(lv_timg_header_t), &rn);
+        if(res != LV_FS_RES_OK || rn != sizeof(lv_timg_header_t)) {
+            decoder_close(decoder, dsc);
+            return LV_RESULT_INVALID;
+        }
+
+        /*A draw task needs only a few tiles, so the index isn't read as a whole*/
+        timg->read_buf = lv_malloc(timg->timg.max_tile_size);
+        if(timg->read_buf == NULL) {
+            LV_LOG_WARN("Couldn't allocate the read buffer");
+            decoder_close(decoder, dsc);
+            return LV_RESULT_INVALID;
+        }
+    }
+    else {
+        const lv_image_dsc_t * img_dsc = dsc->src;
+        timg->data = img_dsc->data;
+        timg->data_size = img_dsc->data_size;
+        lv_memcpy(&timg->timg, timg->data + sizeof(lv_image_header_t), sizeof(lv_timg_header_t));
+        if(timg->timg.tile_cnt > (timg->data_size - TIMG_INDEX_OFFSET) / sizeof(lv_timg_tile_t)) {
+            decoder_close(decoder, dsc);
+            return LV_RESULT_INVALID;
+        }
+        timg->index = (const lv_timg_tile_t *)(timg->data + TIMG_INDEX_OFFSET);
+    }
+
+    timg->col_cnt = (dsc->header.w + timg->timg.tile_w - 1) / timg->timg.tile_w;
+
+    /*The image is never decoded as a whole, so it's drawn tile by tile in `decoder_get_area`*/
+    dsc->decoded = NULL;
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Return the tiles intersecting `full_area` one by one in row-major order.
+ * @param decoder       pointer to the decoder
+ * @param dsc           pointer to the decoder descriptor
+ * @param full_area     the area of the image to draw
+ * @param decoded_area  the area of the previous tile or `y1 == LV_COORD_MIN` to start
+ * @return LV_RESULT_OK: `decoded_area` and `dsc->decoded` describe the next tile; LV_RESULT_INVALID: no more tiles
+ */
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area)
+{
+    LV_UNUSED(decoder);
+
+    timg_dsc_t * timg = dsc->user_data;
+    if(timg == NULL) return LV_RESULT_INVALID;
+
+    lv_area_t img_area;
+    lv_area_set(&img_area, 0, 0, dsc->header.w - 1, dsc->header.h - 1);
+    lv_area_t area;
+    if(!_lv_area_intersect(&area, full_area, &img_area)) return LV_RESULT_INVALID;
+
+    int32_t tile_w = timg->timg.tile_w;
+    int32_t tile_h = timg->timg.tile_h;
+    int32_t col;
+    int32_t row;
+    if(decoded_area->y1 == LV_COORD_MIN) {
+        col = area.x1 / tile_w;
+        row = area.y1 / tile_h;
+    }
+    else {
+        /*Go to the next tile in the row or to the first tile of the next row*/
+        col = decoded_area->x1 / tile_w + 1;
+        row = decoded_area->y1 / tile_h;
+        if(col * tile_w > area.x2) {
+            col = area.x1 / tile_w;
+            row++;
+        }
+        if(row * tile_h > area.y2) return LV_RESULT_INVALID;
+    }
+
+    const lv_draw_buf_t * tile = tile_load(dsc, row * timg->col_cnt + col);
+    if(tile == NULL) return LV_RESULT_INVALID;
+
+    decoded_area->x1 = col * tile_w;
+    decoded_area->y1 = row * tile_h;
+    decoded_area->x2 = LV_MIN(decoded_area->x1 + tile_w, (int32_t)dsc->header.w) - 1;
+    decoded_area->y2 = LV_MIN(decoded_area->y1 + tile_h, (int32_t)dsc->header.h) - 1;
+
+    /*The edge tiles are padded: draw only the part inside the image*/
+    lv_draw_buf_t * tile_buf = (lv_draw_buf_t *)tile;
+    tile_buf->header.w = lv_area_get_width(decoded_area);
+    tile_buf->header.h = lv_area_get_height(decoded_area);
+    dsc->decoded = tile;
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Close the tiled image and free the buffers
+ * @param decoder pointer to the decoder
+ * @param dsc     pointer to the decoder descriptor
+ */
+static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
+{
+    LV_UNUSED(decoder);
+
+    timg_dsc_t * timg = dsc->user_data;
+    if(timg == NULL) return;
+
+    if(timg->data == NULL) lv_fs_close(&timg->f);
+    if(timg->tile_buf) lv_draw_buf_destroy(timg->tile_buf);
+    lv_free(timg->read_buf);
+    lv_free(timg);
+
+    dsc->user_data = NULL;
+    dsc->decoded = NULL;
+}
+
+static lv_result_t header_check(const lv_image_header_t * header, const lv_timg_header_t * timg)
+{
+    if(header->magic != LV_IMAGE_HEADER_MAGIC || timg->magic != LV_TIMG_MAGIC) return LV_RESULT_INVALID;
+    if(header->w == 0 || header->h == 0 || timg->tile_w == 0 || timg->tile_h == 0) return LV_RESULT_INVALID;
+
+    /*Tiles are copied and drawn as plain pixel arrays*/
+    switch(header->cf) {
+        case LV_COLOR_FORMAT_L8:
+        case LV_COLOR_FORMAT_A8:
+        case LV_COLOR_FORMAT_RGB565:
+        case LV_COLOR_FORMAT_ARGB8565:
+        case LV_COLOR_FORMAT_RGB888:
+        case LV_COLOR_FORMAT_ARGB8888:
+        case LV_COLOR_FORMAT_XRGB8888:
+            break;
+        default:
+            LV_LOG_WARN("CF: %d is not supported", header->cf);
+            return LV_RESULT_INVALID;
+    }
+
+    uint32_t col_cnt = (header->w + timg->tile_w - 1) / timg->tile_w;
+    uint32_t row_cnt = (header->h + timg->tile_h - 1) / timg->tile_h;
+    if(timg->tile_cnt != col_cnt * row_cnt) {
+        LV_LOG_WARN("Invalid tile count: %" LV_PRIu32, timg->tile_cnt);
+        return LV_RESULT_INVALID;
+    }
+
+    return LV_RESULT_OK;
+}
+
+static lv_result_t tile_get_index(timg_dsc_t * timg, uint32_t tile_id, lv_timg_tile_t * tile)
+{
+    if(timg->data) {
+        *tile = timg->index[tile_id];
+
+        /*The index was checked to be in the container, the tiles weren't*/
+        uint32_t size = tile->size_method & LV_TIMG_TILE_SIZE_MASK;
+        if(tile->offset > timg->data_size || size > timg->data_size - tile->offset) {
+            LV_LOG_WARN("Tile %" LV_PRIu32 " is out of the container", tile_id);
+            return LV_RESULT_INVALID;
+        }
+
+        return LV_RESULT_OK;
+    }
+
+    uint32_t rn = 0;
+    lv_fs_res_t res = lv_fs_seek(&timg->f, TIMG_INDEX_OFFSET + tile_id * sizeof(lv_timg_tile_t), LV_FS_SEEK_SET);
+    if(res == LV_FS_RES_OK) res = lv_fs_read(&timg->f, tile, sizeof(lv_timg_tile_t), &rn);
+    if(res != LV_FS_RES_OK || rn != sizeof(lv_timg_tile_t)) {
+        LV_LOG_WARN("Couldn't read the index of tile %" LV_PRIu32, tile_id);
+        return LV_RESULT_INVALID;
+    }
+
+    timg_stats.read_bytes += sizeof(lv_timg_tile_t);
+    return LV_RESULT_OK;
+}
+
+static const lv_draw_buf_t * tile_load(lv_image_decoder_dsc_t * dsc, uint32_t tile_id)
+{
+    timg_dsc_t * timg = dsc->user_data;
+    if(tile_id >= timg->timg.tile_cnt) return NULL;
+
+    lv_color_format_t cf = dsc->header.cf;
+    uint32_t px_size = lv_color_format_get_size(cf);
+    uint32_t stride = timg->timg.tile_w * px_size;
+    uint32_t tile_size = stride * timg->timg.tile_h;
+
+    lv_timg_tile_t index;
+    if(tile_get_index(timg, tile_id, &index) != LV_RESULT_OK) return NULL;
+
+    const lv_timg_tile_t * tile = &index;
+    uint32_t size = tile->size_method & LV_TIMG_TILE_SIZE_MASK;
+    lv_image_compress_t method = tile->size_method >> LV_TIMG_TILE_METHOD_SHIFT;
+
+    uint32_t stride_expect = dsc->args.stride_align ? lv_draw_buf_width_to_stride(timg->timg.tile_w, cf) : stride;
+    bool premultiply = dsc->args.premultiply
+                       && lv_color_format_has_alpha(cf)
+                       && !LV_COLOR_FORMAT_IS_ALPHA_ONLY(cf)
+                       && !(dsc->header.flags & LV_IMAGE_FLAGS_PREMULTIPLIED);
+
+    timg_stats.tile_cnt++;
+
+    /*Draw the uncompressed tiles of a memory mapped container directly*/
+    if(timg->data && method == LV_IMAGE_COMPRESS_NONE && stride_expect == stride && !premultiply) {
+        uint8_t * tile_data = (uint8_t *)timg->data + tile->offset;
+        if(size >= tile_size && lv_draw_buf_align(tile_data, cf) == tile_data) {
+            lv_draw_buf_t * direct = &timg->tile_direct;
+            lv_memzero(direct, sizeof(lv_draw_buf_t));
+            direct->header = dsc->header;
+            direct->header.stride = stride;
+            direct->header.flags = dsc->header.flags & LV_IMAGE_FLAGS_PREMULTIPLIED;
+            direct->data = tile_data;
+            direct->unaligned_data = tile_data;
+            direct->data_size = size;
+
+            timg_stats.tile_direct_cnt++;
+            return direct;
+        }
+    }
+
+    if(timg->tile_buf == NULL) {
+        timg->tile_buf = lv_draw_buf_create(timg->timg.tile_w, timg->timg.tile_h, cf, stride_expect);
+        if(timg->tile_buf == NULL) {
+            LV_LOG_WARN("Couldn't allocate the tile buffer");
+            return NULL;
+        }
+    }
+
+    lv_draw_buf_t * tile_buf = timg->tile_buf;
+    tile_buf->header.w = timg->timg.tile_w;
+    tile_buf->header.h = timg->timg.tile_h;
+    tile_buf->header.stride = stride;
+    tile_buf->header.flags = dsc->header.flags & LV_IMAGE_FLAGS_PREMULTIPLIED;
+    lv_draw_buf_set_flag(tile_buf, LV_IMAGE_FLAGS_ALLOCATED | LV_IMAGE_FLAGS_MODIFIABLE);
+
+    const uint8_t * input;
+    if(timg->data) {
+        input = timg->data + tile->offset;
+    }
+    else {
+        /*Uncompressed tiles are read directly to the tile buffer*/
+        uint8_t * read_buf = method == LV_IMAGE_COMPRESS_NONE ? tile_buf->data : timg->read_buf;
+        uint32_t read_max = method == LV_IMAGE_COMPRESS_NONE ? tile_size : timg->timg.max_tile_size;
+        if(size > read_max) {
+            LV_LOG_WARN("Tile %" LV_PRIu32 " is too large: %" LV_PRIu32, tile_id, size);
+            return NULL;
+        }
+
+        uint32_t rn = 0;
+        lv_fs_res_t res = lv_fs_seek(&timg->f, tile->offset, LV_FS_SEEK_SET);
+        if(res == LV_FS_RES_OK) res = lv_fs_read(&timg->f, read_buf, size, &rn);
+        if(res != LV_FS_RES_OK || rn != size) {
+            LV_LOG_WARN("Couldn't read tile %" LV_PRIu32, tile_id);
+            return NULL;
+        }
+
+        timg_stats.read_bytes += size;
+        input = read_buf;
+    }
+
+    if(input != tile_buf->data) {
+        if(tile_decompress(method, input, size, tile_buf->data, tile_size, px_size) != LV_RESULT_OK) {
+            LV_LOG_WARN("Couldn't decompress tile %" LV_PRIu32, tile_id);
+            return NULL;
+        }
+    }
+    else if(size != tile_size) {
+        return NULL;
+    }
+
+    timg_stats.decompressed_bytes += tile_size;
+
+    if(stride_expect != stride) lv_draw_buf_adjust_stride(tile_buf, stride_expect);
+    if(premultiply) lv_draw_buf_premultiply(tile_buf);
+
+    return tile_buf;
+}
+
+static lv_result_t tile_decompress(lv_image_compress_t method, const uint8_t * input, uint32_t input_len,
+                                   uint8_t * output, uint32_t output_len, uint32_t px_size)
+{
+    LV_UNUSED(px_size);
+
+    if(method == LV_IMAGE_COMPRESS_NONE) {
+        if(input_len != output_len) return LV_RESULT_INVALID;
+        lv_memcpy(output, input, output_len);
+        return LV_RESULT_OK;
+    }
+    else if(method == LV_IMAGE_COMPRESS_RLE) {
+#if LV_USE_RLE
+        uint32_t len = lv_rle_decompress(input, input_len, output, output_len, px_size);
+        return len == output_len ? LV_RESULT_OK : LV_RESULT_INVALID;
+#else
+        LV_LOG_WARN("RLE decompress is not enabled");
+        return LV_RESULT_INVALID;
+#endif
+    }
+    else if(method == LV_IMAGE_COMPRESS_LZ4) {
+#if LV_USE_LZ4
+        int len = LZ4_decompress_safe((const char *)input, (char *)output, input_len, output_len);
+        return len >= 0 && (uint32_t)len == output_len ? LV_RESULT_OK : LV_RESULT_INVALID;
+#else
+        LV_LOG_WARN("LZ4 decompress is not enabled");
+        return LV_RESULT_INVALID;
+#endif
+    }
+
+    LV_LOG_WARN("Unknown compress method: %d", method);
+    return LV_RESULT_INVALID;
+}
+
+#endif /*LV_USE_TIMG*/
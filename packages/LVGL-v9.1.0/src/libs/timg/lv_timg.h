@@ -0,0 +1,118 @@
+/**
+ * @file lv_timg.h
+ *
+ */
+
+#ifndef LV_TIMG_H
+#define LV_TIMG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+#if LV_USE_TIMG
+
+#include "../../misc/lv_types.h"
+#include "../../draw/lv_image_dsc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*"LVTI" in little endian*/
+#define LV_TIMG_MAGIC               0x4954564C
+
+#define LV_TIMG_TILE_SIZE_MASK      0x0FFFFFFF
+#define LV_TIMG_TILE_METHOD_SHIFT   28
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Tiled image container (*.timg), created by `scripts/timg_pack.py`.
+ * All fields are little endian. The layout is:
+ * - `lv_image_header_t` of the whole image
+ * - `lv_timg_header_t`
+ * - `lv_timg_tile_t` index of `tile_cnt` tiles in row-major order
+ * - the data of the tiles
+ *
+ * Each tile is `tile_w` x `tile_h` pixels with packed stride (edge tiles are padded)
+ * and compressed on its own, so only the tiles of the drawn area are decompressed.
+ */
+typedef struct {
+    uint32_t magic;             /**< LV_TIMG_MAGIC*/
+    uint16_t tile_w;
+    uint16_t tile_h;
+    uint32_t tile_cnt;          /**< Number of tiles: columns * rows*/
+    uint32_t max_tile_size;     /**< Size of the largest tile's data. Size of the read buffer for files.*/
+} lv_timg_header_t;
+
+typedef struct {
+    uint32_t offset;            /**< Offset of the tile's data from the beginning of the container*/
+    uint32_t size_method;       /**< Bit 0..27: size of the tile's data, bit 28..31: `lv_image_compress_t`*/
+} lv_timg_tile_t;
+
+/**
+ * Statistics of the tiled image decoder
+ */
+typedef struct {
+    uint32_t tile_cnt;          /**< Number of tiles drawn*/
+    uint32_t tile_direct_cnt;   /**< Number of uncompressed tiles drawn directly from memory (e.g. XIP flash)*/
+    uint32_t read_bytes;        /**< Bytes read via `lv_fs`*/
+    uint32_t decompressed_bytes;/**< Bytes decompressed or copied to the tile buffer*/
+} lv_timg_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Register the tiled image decoder.
+ * It opens "*.timg" files and image descriptors created by `lv_timg_dsc_init()`
+ * or by the C array output of `scripts/timg_pack.py`.
+ */
+void lv_timg_init(void);
+
+/**
+ * Remove the tiled image decoder.
+ */
+void lv_timg_deinit(void);
+
+/**
+ * Initialize an image descriptor to draw a tiled image container from memory,
+ * e.g. from a memory-mapped (XIP) external flash. The data is not copied,
+ * uncompressed tiles are drawn directly from it.
+ * @param dsc       the image descriptor to initialize
+ * @param data      pointer to the container
+ * @param data_size size of the container in bytes
+ * @return          LV_RESULT_OK: `dsc` can be used as an image source; LV_RESULT_INVALID: not a valid container
+ */
+lv_result_t lv_timg_dsc_init(lv_image_dsc_t * dsc, const void * data, uint32_t data_size);
+
+/**
+ * Get the statistics of the tiled image decoder.
+ * @param stats     pointer to a variable to store the result
+ */
+void lv_timg_get_stats(lv_timg_stats_t * stats);
+
+/**
+ * Reset the statistics of the tiled image decoder.
+ */
+void lv_timg_reset_stats(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_TIMG*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TIMG_H*/
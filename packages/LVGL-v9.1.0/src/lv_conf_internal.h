@@ -826,6 +826,45 @@
     #endif
 #endif
 
+/*1: Decode the images in a background thread the first time they are drawn.
+ *A placeholder is drawn until the decoded image is added to the cache.
+ *Requires `LV_USE_OS` and `LV_CACHE_DEF_SIZE > 0`*/
+#ifndef LV_USE_IMAGE_DECODER_ASYNC
+    #ifdef CONFIG_LV_USE_IMAGE_DECODER_ASYNC
+        #define LV_USE_IMAGE_DECODER_ASYNC CONFIG_LV_USE_IMAGE_DECODER_ASYNC
+    #else
+        #define LV_USE_IMAGE_DECODER_ASYNC 0
+    #endif
+#endif
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*Number of images which can be queued or tracked by the decoder thread*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_JOB_CNT
+        #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_JOB_CNT
+            #define LV_IMAGE_DECODER_ASYNC_JOB_CNT CONFIG_LV_IMAGE_DECODER_ASYNC_JOB_CNT
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_JOB_CNT 8
+        #endif
+    #endif
+
+    /*Stack size of the decoder thread [bytes]*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_STACK_SIZE
+        #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_STACK_SIZE
+            #define LV_IMAGE_DECODER_ASYNC_STACK_SIZE CONFIG_LV_IMAGE_DECODER_ASYNC_STACK_SIZE
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_STACK_SIZE (8 * 1024)
+        #endif
+    #endif
+
+    /*Opacity of the placeholder drawn while the image is decoded*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA
+        #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA
+            #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA CONFIG_LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_OPA LV_OPA_20
+        #endif
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -1313,6 +1352,17 @@
     #endif
 #endif
 
+/*Number of decoded glyph bitmaps to keep in an LRU cache. 0 to disable caching.
+ *Only fonts without their own cache (e.g. the built-in fonts) use it.
+ *Saves decoding (and decompressing) the glyphs on every redraw, but every cached glyph takes box_w * box_h bytes.*/
+#ifndef LV_FONT_GLYPH_CACHE_DEF_CNT
+    #ifdef CONFIG_LV_FONT_GLYPH_CACHE_DEF_CNT
+        #define LV_FONT_GLYPH_CACHE_DEF_CNT CONFIG_LV_FONT_GLYPH_CACHE_DEF_CNT
+    #else
+        #define LV_FONT_GLYPH_CACHE_DEF_CNT 0
+    #endif
+#endif
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -1668,6 +1718,13 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LINE_CACHE
+        #ifdef CONFIG_LV_LABEL_LINE_CACHE
+            #define LV_LABEL_LINE_CACHE CONFIG_LV_LABEL_LINE_CACHE
+        #else
+            #define LV_LABEL_LINE_CACHE 0     /*Store the line breaks and line widths of labels to avoid measuring the text on every redraw*/
+        #endif
+    #endif
     #ifndef LV_LABEL_WAIT_CHAR_COUNT
         #ifdef CONFIG_LV_LABEL_WAIT_CHAR_COUNT
             #define LV_LABEL_WAIT_CHAR_COUNT CONFIG_LV_LABEL_WAIT_CHAR_COUNT
@@ -2254,6 +2311,16 @@
     #endif
 #endif
 
+/*Tiled image container decoder (*.timg, see scripts/timg_pack.py).
+ *Only the tiles of the drawn area are read and decompressed (RLE needs LV_USE_RLE, LZ4 needs LV_USE_LZ4_*)*/
+#ifndef LV_USE_TIMG
+    #ifdef CONFIG_LV_USE_TIMG
+        #define LV_USE_TIMG CONFIG_LV_USE_TIMG
+    #else
+        #define LV_USE_TIMG 0
+    #endif
+#endif
+
 /*QR code library*/
 #ifndef LV_USE_QRCODE
     #ifdef CONFIG_LV_USE_QRCODE
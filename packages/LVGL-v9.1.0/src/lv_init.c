@@ -13,6 +13,7 @@
 #include "layouts/lv_layout.h"
 #include "libs/bin_decoder/lv_bin_decoder.h"
 #include "libs/bmp/lv_bmp.h"
+#include "libs/timg/lv_timg.h"
 #include "libs/ffmpeg/lv_ffmpeg.h"
 #include "libs/freetype/lv_freetype.h"
 #include "libs/fsdrv/lv_fsdrv.h"
@@ -22,6 +23,7 @@
 #include "libs/lodepng/lv_lodepng.h"
 #include "libs/libpng/lv_libpng.h"
 #include "draw/lv_draw.h"
+#include "draw/lv_image_decoder_async.h"
 #include "misc/lv_async.h"
 #include "misc/lv_fs.h"
 #if LV_USE_DRAW_VGLITE
@@ -203,6 +205,12 @@ void lv_init(void)
     _lv_image_decoder_init();
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
+    _lv_font_glyph_cache_init();
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    _lv_image_decoder_async_init();
+#endif
+
 #if LV_USE_DRAW_VG_LITE
     lv_draw_vg_lite_init();
 #endif
@@ -288,6 +296,10 @@ void lv_init(void)
     lv_bmp_init();
 #endif
 
+#if LV_USE_TIMG
+    lv_timg_init();
+#endif
+
     /*Make FFMPEG last because the last converter will be checked first and
      *it's superior to any other */
 #if LV_USE_FFMPEG
@@ -356,6 +368,12 @@ void lv_deinit(void)
     lv_theme_mono_deinit();
 #endif
 
+    _lv_font_glyph_cache_deinit();
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    _lv_image_decoder_async_deinit();
+#endif
+
     _lv_image_decoder_deinit();
 
     _lv_refr_deinit();
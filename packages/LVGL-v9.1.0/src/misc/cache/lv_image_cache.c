@@ -9,11 +9,14 @@
 #include "../lv_assert.h"
 #include "lv_image_cache.h"
 #include "../../core/lv_global.h"
+#include "../../draw/lv_image_decoder_async.h"
+#include "../../stdlib/lv_string.h"
 /*********************
  *      DEFINES
  *********************/
 #define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
 #define img_header_cache_p (LV_GLOBAL_DEFAULT()->img_header_cache)
+#define img_cache_stats (LV_GLOBAL_DEFAULT()->img_cache_stats)
 /**********************
  *      TYPEDEFS
  **********************/
@@ -104,6 +107,50 @@ void lv_image_header_cache_resize(uint32_t new_size, bool evict_now)
 #endif
 }
 
+lv_result_t lv_image_cache_prefetch(const void * src)
+{
+    if(src == NULL) return LV_RESULT_INVALID;
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    lv_image_header_t header;
+    if(lv_image_decoder_get_info(src, &header) != LV_RESULT_OK) return LV_RESULT_INVALID;
+
+    lv_image_decoder_async_state_t state = _lv_image_decoder_async_request(src, &header, NULL, NULL);
+    if(state == LV_IMAGE_DECODER_ASYNC_PENDING) return LV_RESULT_OK;
+    if(state == LV_IMAGE_DECODER_ASYNC_FULL) return LV_RESULT_INVALID;
+    /*Already cached or not suitable for the background thread. Decode it now.*/
+#endif
+
+    lv_image_decoder_dsc_t dsc;
+    lv_result_t res = lv_image_decoder_open(&dsc, src, NULL);
+    if(res == LV_RESULT_OK) lv_image_decoder_close(&dsc);
+
+    return res;
+}
+
+void lv_image_cache_get_stats(lv_image_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+
+    _LV_IMAGE_CACHE_STATS_LOCK();
+    *stats = img_cache_stats;
+    _LV_IMAGE_CACHE_STATS_UNLOCK();
+#if LV_CACHE_DEF_SIZE > 0
+    stats->size = lv_cache_get_size(img_cache_p, NULL);
+    stats->max_size = lv_cache_get_max_size(img_cache_p, NULL);
+#else
+    stats->size = 0;
+    stats->max_size = 0;
+#endif
+}
+
+void lv_image_cache_reset_stats(void)
+{
+    _LV_IMAGE_CACHE_STATS_LOCK();
+    lv_memzero(&img_cache_stats, sizeof(lv_image_cache_stats_t));
+    _LV_IMAGE_CACHE_STATS_UNLOCK();
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
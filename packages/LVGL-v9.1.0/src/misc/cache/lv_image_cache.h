@@ -23,6 +23,22 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/**
+ * Statistics of image decoding and the image cache
+ */
+typedef struct {
+    uint32_t hit_cnt;           /**< Number of images opened from the cache*/
+    uint32_t miss_cnt;          /**< Number of images opened by a decoder as they were not in the cache*/
+    uint32_t fail_cnt;          /**< Number of images which couldn't be decoded (e.g. the cache was full)*/
+    uint32_t free_cnt;          /**< Number of decoded images freed from the cache (evicted or dropped)*/
+    uint32_t decode_time_sum;   /**< Sum of the decoding times [ms]*/
+    uint32_t decode_time_max;   /**< The longest decoding time [ms]*/
+    uint32_t async_cnt;         /**< Number of images decoded by the background thread*/
+    uint32_t placeholder_cnt;   /**< Number of placeholders drawn while the image was decoded*/
+    uint32_t size;              /**< Current size of the image cache [bytes]*/
+    uint32_t max_size;          /**< Maximum size of the image cache [bytes]*/
+} lv_image_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -54,6 +70,29 @@ void lv_image_header_cache_drop(const void * src);
  */
 void lv_image_header_cache_resize(uint32_t new_size, bool evict_now);
 
+/**
+ * Decode an image in advance, e.g. the images of the next screen, so that
+ * it can be drawn from the cache without decoding it in the rendering.
+ * With `LV_USE_IMAGE_DECODER_ASYNC` the image is decoded by the background thread,
+ * else it's decoded right away.
+ * @param src       pointer to an image source
+ * @return          LV_RESULT_OK: the image is cached or queued for decoding;
+ *                  LV_RESULT_INVALID: the image can't be decoded or the queue is full
+ */
+lv_result_t lv_image_cache_prefetch(const void * src);
+
+/**
+ * Get the statistics of the image decoding and the image cache.
+ * The counters are not protected and might miss a few events if images are decoded in parallel.
+ * @param stats     pointer to a variable to store the result
+ */
+void lv_image_cache_get_stats(lv_image_cache_stats_t * stats);
+
+/**
+ * Reset the statistics of the image decoding and the image cache.
+ */
+void lv_image_cache_reset_stats(void);
+
 /*************************
  *    GLOBAL VARIABLES
  *************************/
@@ -367,6 +367,84 @@ int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * f
     return width;
 }
 
+void lv_text_line_cache_init(lv_text_line_cache_t * cache)
+{
+    lv_memzero(cache, sizeof(lv_text_line_cache_t));
+}
+
+void lv_text_line_cache_invalidate(lv_text_line_cache_t * cache)
+{
+    cache->valid = 0;
+}
+
+void lv_text_line_cache_free(lv_text_line_cache_t * cache)
+{
+    lv_free(cache->line_start);
+    lv_free(cache->line_width);
+    lv_text_line_cache_init(cache);
+}
+
+bool lv_text_line_cache_update(lv_text_line_cache_t * cache, const char * txt, const lv_font_t * font,
+                               int32_t letter_space, int32_t max_width, lv_text_flag_t flag)
+{
+    if(txt == NULL || font == NULL) return false;
+
+    if(cache->valid && cache->font == font && cache->letter_space == letter_space &&
+       cache->max_width == max_width && cache->flag == flag) {
+        return true;
+    }
+
+    cache->valid = 0;
+    cache->line_cnt = 0;
+
+    uint32_t line_start = 0;
+    while(1) {
+        /*Keep one more slot for the end of the text*/
+        if(cache->line_cnt + 1 >= cache->line_cap) {
+            uint32_t new_cap = cache->line_cap ? cache->line_cap * 2 : 8;
+            uint32_t * new_start = lv_realloc(cache->line_start, new_cap * sizeof(uint32_t));
+            if(new_start == NULL) return false;
+            cache->line_start = new_start;
+
+            int32_t * new_width = lv_realloc(cache->line_width, new_cap * sizeof(int32_t));
+            if(new_width == NULL) return false;
+            cache->line_width = new_width;
+
+            cache->line_cap = new_cap;
+        }
+
+        cache->line_start[cache->line_cnt] = line_start;
+        if(txt[line_start] == '\0') break;
+
+        uint32_t line_len = _lv_text_get_next_line(&txt[line_start], font, letter_space, max_width, NULL, flag);
+        cache->line_width[cache->line_cnt] = lv_text_get_width(&txt[line_start], line_len, font, letter_space);
+        cache->line_cnt++;
+        line_start += line_len;
+    }
+
+    cache->font = font;
+    cache->letter_space = letter_space;
+    cache->max_width = max_width;
+    cache->flag = flag;
+    cache->valid = 1;
+
+    return true;
+}
+
+uint32_t lv_text_line_cache_find(const lv_text_line_cache_t * cache, uint32_t byte_id)
+{
+    /*Binary search the last line starting before or at `byte_id`*/
+    uint32_t lo = 0;
+    uint32_t hi = cache->line_cnt;
+    while(lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        if(cache->line_start[mid] <= byte_id) lo = mid;
+        else hi = mid - 1;
+    }
+
+    return lo;
+}
+
 void _lv_text_ins(char * txt_buf, uint32_t pos, const char * ins_txt)
 {
     if(txt_buf == NULL || ins_txt == NULL) return;
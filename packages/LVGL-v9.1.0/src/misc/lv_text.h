@@ -63,6 +63,22 @@ typedef _lv_text_align_t lv_text_align_t;
 typedef uint8_t lv_text_align_t;
 #endif /*DOXYGEN*/
 
+/**
+ * Stores the line breaks and line widths of a text to avoid measuring them on every redraw.
+ * It's valid only for the text and parameters it was built with.
+ */
+typedef struct {
+    uint32_t * line_start;      /**< Byte index of the first character of each line. `line_start[line_cnt]` is the end of the text*/
+    int32_t * line_width;       /**< Width of each line in pixels*/
+    uint32_t line_cnt;          /**< Number of lines*/
+    uint32_t line_cap;          /**< Number of lines the arrays have space for*/
+    const lv_font_t * font;     /**< Font the lines were measured with*/
+    int32_t letter_space;       /**< Letter space the lines were measured with*/
+    int32_t max_width;          /**< Max. width the lines were broken to*/
+    lv_text_flag_t flag;        /**< Flags the lines were measured with*/
+    uint8_t valid : 1;          /**< 1: the cache can be used if the parameters match*/
+} lv_text_line_cache_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -109,6 +125,47 @@ uint32_t _lv_text_get_next_line(const char * txt, const lv_font_t * font, int32_
  */
 int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space);
 
+/**
+ * Initialize a line cache.
+ * @param cache pointer to a line cache
+ */
+void lv_text_line_cache_init(lv_text_line_cache_t * cache);
+
+/**
+ * Mark a line cache invalid. Needs to be called when the text changes. The memory is kept for reuse.
+ * @param cache pointer to a line cache
+ */
+void lv_text_line_cache_invalidate(lv_text_line_cache_t * cache);
+
+/**
+ * Free the memory of a line cache.
+ * @param cache pointer to a line cache
+ */
+void lv_text_line_cache_free(lv_text_line_cache_t * cache);
+
+/**
+ * Make sure the line cache describes the given text and parameters. The lines are measured again only
+ * if the cache is invalid or any of the parameters changed.
+ * @param cache pointer to a line cache
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_width max width of the text (break the lines to fit this size). Set COORD_MAX to avoid
+ * line breaks
+ * @param flag settings for the text from ::lv_text_flag_t
+ * @return true: the cache can be used; false: out of memory, measure the lines without the cache
+ */
+bool lv_text_line_cache_update(lv_text_line_cache_t * cache, const char * txt, const lv_font_t * font,
+                               int32_t letter_space, int32_t max_width, lv_text_flag_t flag);
+
+/**
+ * Find the line which contains a byte index.
+ * @param cache pointer to a valid line cache
+ * @param byte_id byte index in the text
+ * @return the index of the line, or `line_cnt` if `byte_id` is at the end of the text
+ */
+uint32_t lv_text_line_cache_find(const lv_text_line_cache_t * cache, uint32_t byte_id);
+
 /**
  * Insert a string into an other
  * @param txt_buf the original text (must be big enough for the result text and NULL terminated)
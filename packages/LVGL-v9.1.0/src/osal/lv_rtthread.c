@@ -41,12 +41,26 @@
 lv_result_t lv_thread_init(lv_thread_t * thread, lv_thread_prio_t prio, void (*callback)(void *), size_t stack_size,
                            void * user_data)
 {
+    /*Lower number is higher priority in RT-Thread*/
+    static const rt_uint8_t prio_map[] = {
+        [LV_THREAD_PRIO_LOWEST] = RT_THREAD_PRIORITY_MAX - 2,
+        [LV_THREAD_PRIO_LOW] = RT_THREAD_PRIORITY_MAX * 3 / 4,
+        [LV_THREAD_PRIO_MID] = RT_THREAD_PRIORITY_MAX / 2,
+        [LV_THREAD_PRIO_HIGH] = RT_THREAD_PRIORITY_MAX / 4,
+        [LV_THREAD_PRIO_HIGHEST] = 1,
+    };
+
     thread->thread = rt_thread_create("thread",
                                       callback,
                                       user_data,
                                       stack_size,
-                                      prio,
+                                      prio_map[prio],
                                       THREAD_TIMESLICE);
+    if(thread->thread == RT_NULL) {
+        LV_LOG_WARN("create thread failed");
+        return LV_RESULT_INVALID;
+    }
+
     rt_err_t ret = rt_thread_startup(thread->thread);
     if(ret) {
         LV_LOG_WARN("Error: %d", ret);
@@ -636,6 +636,10 @@ static void lv_label_constructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     label->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_line_cache_init(&label->line_cache);
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     label->sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     label->sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
@@ -658,6 +662,10 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LINE_CACHE
+    lv_text_line_cache_free(&label->line_cache);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -735,6 +743,10 @@ static void draw_main(lv_event_t * e)
     }
 #endif
 
+#if LV_LABEL_LINE_CACHE
+    label_draw_dsc.line_cache = &label->line_cache;
+#endif
+
     label_draw_dsc.flag = flag;
     lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
     lv_bidi_calculate_align(&label_draw_dsc.align, &label_draw_dsc.bidi_dir, label->text);
@@ -843,6 +855,9 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->text == NULL) return;
 #if LV_LABEL_LONG_TXT_HINT
     label->hint.line_start = -1; /*The hint is invalid if the text changes*/
+#endif
+#if LV_LABEL_LINE_CACHE
+    lv_text_line_cache_invalidate(&label->line_cache);
 #endif
     label->invalid_size_cache = true;
 
@@ -72,6 +72,10 @@ typedef struct {
     lv_draw_label_hint_t hint;
 #endif
 
+#if LV_LABEL_LINE_CACHE
+    lv_text_line_cache_t line_cache;
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     uint32_t sel_start;
     uint32_t sel_end;
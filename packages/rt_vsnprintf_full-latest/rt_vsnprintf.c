@@ -331,6 +331,22 @@ static inline void putchar_via_gadget(output_gadget_t* gadget, char c)
   }
 }
 
+// Write a run of characters, at once when the output is a buffer
+static inline void puts_via_gadget(output_gadget_t* gadget, const char* s, printf_size_t len)
+{
+  if (gadget->function != NULL) {
+    while (len--) {
+      putchar_via_gadget(gadget, *s++);
+    }
+    return;
+  }
+  if (gadget->pos < gadget->max_chars) {
+    const printf_size_t room = gadget->max_chars - gadget->pos;
+    rt_memcpy(gadget->buffer + gadget->pos, s, len < room ? len : room);
+  }
+  gadget->pos += len;
+}
+
 // Possibly-write the string-terminating '\0' character
 static inline void append_termination_with_gadget(output_gadget_t* gadget)
 {
@@ -492,6 +508,47 @@ static void print_integer_finalization(output_gadget_t* output, char* buf, print
   out_rev_(output, buf, len, width, flags);
 }
 
+#if PKG_VSNPRINTF_INTEGER_BUFFER_SIZE < 20
+#error "PKG_VSNPRINTF_INTEGER_BUFFER_SIZE must hold the 20 decimal digits of a 64-bit integer"
+#endif
+
+// The digit pairs "00" to "99", for converting two decimal digits per division
+static const char decimal_digit_pairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+// Write the decimal digits of a non-zero value in reverse. Once the value fits in 32 bits,
+// the conversion goes on in 32-bit arithmetic, avoiding the slow 64-bit division.
+static printf_size_t decimal_digits_rev_(char* buf, printf_unsigned_value_t value)
+{
+  printf_size_t len = 0U;
+  uint32_t value32;
+  unsigned int pair;
+
+  while (value > UINT32_MAX) {
+    pair = (unsigned int)(value % 100U) * 2U;
+    value /= 100U;
+    buf[len++] = decimal_digit_pairs[pair + 1];
+    buf[len++] = decimal_digit_pairs[pair];
+  }
+  value32 = (uint32_t)value;
+  while (value32 >= 100U) {
+    pair = (unsigned int)(value32 % 100U) * 2U;
+    value32 /= 100U;
+    buf[len++] = decimal_digit_pairs[pair + 1];
+    buf[len++] = decimal_digit_pairs[pair];
+  }
+  if (value32 >= 10U) {
+    buf[len++] = decimal_digit_pairs[value32 * 2U + 1];
+    buf[len++] = decimal_digit_pairs[value32 * 2U];
+  }
+  else {
+    buf[len++] = (char)('0' + value32);
+  }
+  return len;
+}
+
 // An internal itoa-like function
 static void print_integer(output_gadget_t* output, printf_unsigned_value_t value, bool negative, numeric_base_t base, printf_size_t precision, printf_size_t width, printf_flags_t flags)
 {
@@ -512,11 +569,16 @@ static void print_integer(output_gadget_t* output, printf_unsigned_value_t value
       // don't differ on 0 values
     }
   }
+  else if (base == BASE_DECIMAL) {
+    len = decimal_digits_rev_(buf, value);
+  }
   else {
+    // the other bases are powers of 2, the digits are masked and shifted out
+    const char* digits = (flags & FLAGS_UPPERCASE) ? "0123456789ABCDEF" : "0123456789abcdef";
+    const unsigned int shift = (base == BASE_HEX) ? 4U : (base == BASE_OCTAL) ? 3U : 1U;
     do {
-      const char digit = (char)(value % base);
-      buf[len++] = (char)(digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10);
-      value /= base;
+      buf[len++] = digits[(unsigned int)value & (base - 1U)];
+      value >>= shift;
     } while (value && (len < PKG_VSNPRINTF_INTEGER_BUFFER_SIZE));
   }
 
@@ -1019,9 +1081,12 @@ static inline void format_string_loop(output_gadget_t* output, const char* forma
   while (*format)
   {
     if (*format != '%') {
-      // A regular content character
-      putchar_via_gadget(output, *format);
-      format++;
+      // A run of regular content characters
+      const char* run = format;
+      while (*format && *format != '%') {
+        format++;
+      }
+      puts_via_gadget(output, run, (printf_size_t)(format - run));
       continue;
     }
     // We're parsing a format specifier: %[flags][width][.precision][length]
@@ -1257,16 +1322,14 @@ static inline void format_string_loop(output_gadget_t* output, const char* forma
           if (flags & FLAGS_PRECISION) {
             l = (l < precision ? l : precision);
           }
+          const printf_size_t string_len = l;
           if (!(flags & FLAGS_LEFT)) {
             while (l++ < width) {
               putchar_via_gadget(output, ' ');
             }
           }
           // string output
-          while ((*p != 0) && (!(flags & FLAGS_PRECISION) || precision)) {
-            putchar_via_gadget(output, *(p++));
-            --precision;
-          }
+          puts_via_gadget(output, p, string_len);
           // post padding
           if (flags & FLAGS_LEFT) {
             while (l++ < width) {
@@ -34,6 +34,22 @@ int dfs_romfs_unmount(struct dfs_filesystem *fs)
 
 int dfs_romfs_ioctl(struct dfs_fd *file, int cmd, void *args)
 {
+    struct romfs_dirent *dirent;
+
+    dirent = (struct romfs_dirent *)file->data;
+    RT_ASSERT(dirent != NULL);
+
+    switch (cmd)
+    {
+    case RT_FIOGETADDR:
+        /* the file content is in the memory, it could be used directly */
+        if (dirent->type != ROMFS_DIRENT_FILE || args == NULL)
+            return -EINVAL;
+
+        *(const void **)args = dirent->data;
+        return RT_EOK;
+    }
+
     return -EIO;
 }
 
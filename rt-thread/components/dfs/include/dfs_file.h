@@ -70,6 +70,8 @@ int dfs_file_ftruncate(struct dfs_fd *fd, off_t length);
 
 /* 0x5254 is just a magic number to make these relatively unique ("RT") */
 #define RT_FIOFTRUNCATE 0x52540000U
+/* get the address of the file content, only for the file in the addressable memory (e.g. romfs) */
+#define RT_FIOGETADDR   0x52540001U
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rtthread.h>
+
+#if defined(RT_HWCRYPTO_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <stdlib.h>
+#include <rtdevice.h>
+#include <hw_symmetric.h>
+#include <hw_hash.h>
+#ifdef RT_HWCRYPTO_USING_JOB
+#include <hw_job.h>
+#endif
+
+#define HWCRYPTO_BENCH_DEF_KB       64
+#define HWCRYPTO_BENCH_MAX_SIZE     4096
+#define HWCRYPTO_BENCH_JOBS         8
+
+static const rt_size_t hwcrypto_bench_size[] = {16, 64, 256, 1024, 4096};
+
+/* KB/s of the bytes processed in the ticks */
+static rt_uint32_t hwcrypto_bench_rate(rt_uint32_t bytes, rt_tick_t tick)
+{
+    if (tick == 0)
+    {
+        tick = 1;
+    }
+
+    return (rt_uint32_t)((rt_uint64_t)bytes * RT_TICK_PER_SECOND / 1024 / tick);
+}
+
+static rt_int32_t hwcrypto_bench_aes(struct rt_hwcrypto_device *dev, rt_uint8_t *buf, rt_size_t size, rt_uint32_t total)
+{
+    static const rt_uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                       0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+    struct rt_hwcrypto_ctx *ctx;
+    rt_uint32_t done;
+    rt_tick_t tick;
+
+    ctx = rt_hwcrypto_symmetric_create(dev, HWCRYPTO_TYPE_AES_CBC);
+    if (ctx == RT_NULL)
+    {
+        return -1;
+    }
+    rt_hwcrypto_symmetric_setkey(ctx, key, 128);
+    rt_hwcrypto_symmetric_setiv(ctx, key, 16);
+
+    tick = rt_tick_get();
+    for (done = 0; done < total; done += size)
+    {
+        if (rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, size, buf, buf) != RT_EOK)
+        {
+            break;
+        }
+    }
+    tick = rt_tick_get() - tick;
+    rt_hwcrypto_symmetric_destroy(ctx);
+
+    return done < total ? -1 : (rt_int32_t)hwcrypto_bench_rate(done, tick);
+}
+
+static rt_int32_t hwcrypto_bench_sha(struct rt_hwcrypto_device *dev, rt_uint8_t *buf, rt_size_t size, rt_uint32_t total)
+{
+    struct rt_hwcrypto_ctx *ctx;
+    rt_uint8_t digest[32];
+    rt_uint32_t done;
+    rt_tick_t tick;
+
+    ctx = rt_hwcrypto_hash_create(dev, HWCRYPTO_TYPE_SHA256);
+    if (ctx == RT_NULL)
+    {
+        return -1;
+    }
+
+    tick = rt_tick_get();
+    for (done = 0; done < total; done += size)
+    {
+        if (rt_hwcrypto_hash_update(ctx, buf, size) != RT_EOK)
+        {
+            break;
+        }
+    }
+    rt_hwcrypto_hash_finish(ctx, digest, sizeof(digest));
+    tick = rt_tick_get() - tick;
+    rt_hwcrypto_hash_destroy(ctx);
+
+    return done < total ? -1 : (rt_int32_t)hwcrypto_bench_rate(done, tick);
+}
+
+#ifdef RT_HWCRYPTO_USING_JOB
+static void hwcrypto_bench_job_done(struct rt_hwcrypto_job *job, rt_err_t result)
+{
+    rt_sem_release((rt_sem_t)job->user_data);
+}
+
+/* AES-CBC through the job queue, HWCRYPTO_BENCH_JOBS jobs in flight */
+static rt_int32_t hwcrypto_bench_job(struct rt_hwcrypto_device *dev, rt_uint8_t *buf, rt_size_t size, rt_uint32_t total)
+{
+    static const rt_uint8_t key[16] = {0};
+    struct rt_hwcrypto_job job[HWCRYPTO_BENCH_JOBS];
+    struct rt_hwcrypto_sg sg;
+    struct rt_hwcrypto_ctx *ctx;
+    struct rt_semaphore sem;
+    rt_uint32_t done, failed = 0;
+    rt_tick_t tick;
+    int i;
+
+    ctx = rt_hwcrypto_symmetric_create(dev, HWCRYPTO_TYPE_AES_CBC);
+    if (ctx == RT_NULL)
+    {
+        return -1;
+    }
+    rt_hwcrypto_symmetric_setkey(ctx, key, 128);
+    rt_sem_init(&sem, "hwcbench", 0, RT_IPC_FLAG_FIFO);
+    sg.buf = buf;
+    sg.len = size;
+
+    tick = rt_tick_get();
+    for (done = 0; done < total; done += size * HWCRYPTO_BENCH_JOBS)
+    {
+        for (i = 0; i < HWCRYPTO_BENCH_JOBS; i++)
+        {
+            rt_hwcrypto_job_init_crypt(&job[i], ctx, HWCRYPTO_MODE_ENCRYPT, &sg, 1, buf, hwcrypto_bench_job_done, &sem);
+            rt_hwcrypto_job_submit(&job[i]);
+        }
+        for (i = 0; i < HWCRYPTO_BENCH_JOBS; i++)
+        {
+            rt_sem_take(&sem, RT_WAITING_FOREVER);
+            failed += (job[i].result != RT_EOK);
+        }
+    }
+    tick = rt_tick_get() - tick;
+    rt_sem_detach(&sem);
+    rt_hwcrypto_symmetric_destroy(ctx);
+
+    return failed ? -1 : (rt_int32_t)hwcrypto_bench_rate(done, tick);
+}
+#endif /* RT_HWCRYPTO_USING_JOB */
+
+static void hwcrypto_bench_print(rt_int32_t rate)
+{
+    if (rate < 0)
+    {
+        rt_kprintf(" %10s", "-");
+    }
+    else
+    {
+        rt_kprintf(" %10d", rate);
+    }
+}
+
+static void hwcrypto_bench_device(struct rt_hwcrypto_device *dev, rt_uint8_t *buf, rt_uint32_t total)
+{
+    rt_size_t i;
+
+    rt_kprintf("%s: %d KB per test, KB/s\n", dev->parent.parent.name, (int)(total / 1024));
+#ifdef RT_HWCRYPTO_USING_JOB
+    rt_kprintf("%6s %10s %10s %10s\n", "size", "aes-cbc", "sha256", "aes-job");
+#else
+    rt_kprintf("%6s %10s %10s\n", "size", "aes-cbc", "sha256");
+#endif
+    for (i = 0; i < sizeof(hwcrypto_bench_size) / sizeof(hwcrypto_bench_size[0]); i++)
+    {
+        rt_size_t size = hwcrypto_bench_size[i];
+
+        rt_kprintf("%6d", (int)size);
+        hwcrypto_bench_print(hwcrypto_bench_aes(dev, buf, size, total));
+        hwcrypto_bench_print(hwcrypto_bench_sha(dev, buf, size, total));
+#ifdef RT_HWCRYPTO_USING_JOB
+        hwcrypto_bench_print(hwcrypto_bench_job(dev, buf, size, total));
+#endif
+        rt_kprintf("\n");
+    }
+}
+
+/*
+ * AES-128-CBC and SHA-256 throughput across the block sizes, on the given
+ * device or on the default and the software devices to compare them.
+ */
+static void hwcrypto_bench(int argc, char **argv)
+{
+    struct rt_hwcrypto_device *dev = RT_NULL;
+#ifdef RT_HWCRYPTO_USING_SOFT
+    struct rt_hwcrypto_device *soft;
+#endif
+    rt_uint32_t total = HWCRYPTO_BENCH_DEF_KB * 1024;
+    rt_uint8_t *buf;
+
+    if (argc > 1)
+    {
+        dev = (struct rt_hwcrypto_device *)rt_device_find(argv[1]);
+        if (dev == RT_NULL || dev->parent.type != RT_Device_Class_Security)
+        {
+            rt_kprintf("Usage: hwcrypto_bench [device] [KB]\n");
+            return;
+        }
+    }
+    if (argc > 2)
+    {
+        total = atoi(argv[2]) * 1024;
+    }
+    if (total < HWCRYPTO_BENCH_MAX_SIZE * HWCRYPTO_BENCH_JOBS)
+    {
+        total = HWCRYPTO_BENCH_MAX_SIZE * HWCRYPTO_BENCH_JOBS;
+    }
+
+    buf = rt_malloc(HWCRYPTO_BENCH_MAX_SIZE);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("No memory for the benchmark.\n");
+        return;
+    }
+    rt_memset(buf, 0x5A, HWCRYPTO_BENCH_MAX_SIZE);
+
+    if (dev != RT_NULL)
+    {
+        hwcrypto_bench_device(dev, buf, total);
+    }
+    else
+    {
+        dev = rt_hwcrypto_dev_default();
+        if (dev != RT_NULL)
+        {
+            hwcrypto_bench_device(dev, buf, total);
+        }
+#ifdef RT_HWCRYPTO_USING_SOFT
+        soft = (struct rt_hwcrypto_device *)rt_device_find(RT_HWCRYPTO_SOFT_NAME);
+        if (soft != RT_NULL && soft != dev)
+        {
+            hwcrypto_bench_device(soft, buf, total);
+        }
+#endif
+    }
+
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(hwcrypto_bench, crypto throughput benchmark: hwcrypto_bench [device] [KB]);
+
+#endif /* defined(RT_HWCRYPTO_USING_BENCH) && defined(RT_USING_FINSH) */
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+#include <rtdevice.h>
+#include <hw_job.h>
+
+#define DBG_TAG    "hwcrypto.job"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+#if defined(RT_HWCRYPTO_USING_AES) || defined(RT_HWCRYPTO_USING_DES) || \
+    defined(RT_HWCRYPTO_USING_3DES) || defined(RT_HWCRYPTO_USING_RC4) || defined(RT_HWCRYPTO_USING_SOFT)
+#include <hw_symmetric.h>
+#define HWCRYPTO_JOB_SYMMETRIC
+#endif
+
+#if defined(RT_HWCRYPTO_USING_MD5) || defined(RT_HWCRYPTO_USING_SHA1) || \
+    defined(RT_HWCRYPTO_USING_SHA2) || defined(RT_HWCRYPTO_USING_SOFT)
+#include <hw_hash.h>
+#define HWCRYPTO_JOB_HASH
+#endif
+
+/* pending jobs, appended at the tail */
+static rt_slist_t job_head;
+static rt_slist_t *job_tail = &job_head;
+static struct rt_semaphore job_sem;
+static struct rt_hwcrypto_job_stat job_stat;
+
+static struct rt_thread job_thread;
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t job_thread_stack[RT_HWCRYPTO_JOB_THREAD_STACK_SIZE];
+
+/* the job thread coalesces the small hash segments here */
+ALIGN(RT_ALIGN_SIZE)
+static rt_uint8_t job_gather[RT_HWCRYPTO_JOB_GATHER_SIZE];
+
+#ifdef HWCRYPTO_JOB_SYMMETRIC
+static rt_err_t hwcrypto_job_crypt(struct rt_hwcrypto_job *job)
+{
+    rt_size_t i, len = 0;
+
+    if (job->sg_num == 1)
+    {
+        return rt_hwcrypto_symmetric_crypt(job->ctx, job->mode, job->sg[0].len, job->sg[0].buf, job->out);
+    }
+
+    /* gather the segments in the output buffer, the device runs once in place */
+    for (i = 0; i < job->sg_num; i++)
+    {
+        if (job->sg[i].buf != job->out + len)
+        {
+            rt_memcpy(job->out + len, job->sg[i].buf, job->sg[i].len);
+        }
+        len += job->sg[i].len;
+    }
+    job_stat.gathered += job->sg_num;
+
+    return rt_hwcrypto_symmetric_crypt(job->ctx, job->mode, len, job->out, job->out);
+}
+#endif /* HWCRYPTO_JOB_SYMMETRIC */
+
+#ifdef HWCRYPTO_JOB_HASH
+static rt_err_t hwcrypto_job_hash(struct rt_hwcrypto_job *job, rt_uint8_t *gather, rt_size_t gather_size)
+{
+    rt_size_t i, len = 0;
+    rt_err_t err = RT_EOK;
+
+    for (i = 0; i < job->sg_num && err == RT_EOK; i++)
+    {
+        const struct rt_hwcrypto_sg *sg = &job->sg[i];
+
+        if (sg->len < gather_size)
+        {
+            /* small segment, coalesce it with the neighbours */
+            if (len + sg->len > gather_size)
+            {
+                err = rt_hwcrypto_hash_update(job->ctx, gather, len);
+                len = 0;
+            }
+            rt_memcpy(gather + len, sg->buf, sg->len);
+            len += sg->len;
+            job_stat.gathered++;
+            continue;
+        }
+
+        if (len > 0)
+        {
+            err = rt_hwcrypto_hash_update(job->ctx, gather, len);
+            len = 0;
+        }
+        if (err == RT_EOK)
+        {
+            err = rt_hwcrypto_hash_update(job->ctx, sg->buf, sg->len);
+        }
+    }
+
+    if (err == RT_EOK && len > 0)
+    {
+        err = rt_hwcrypto_hash_update(job->ctx, gather, len);
+    }
+    if (err == RT_EOK && job->out != RT_NULL)
+    {
+        err = rt_hwcrypto_hash_finish(job->ctx, job->out, job->out_len);
+    }
+
+    return err;
+}
+#endif /* HWCRYPTO_JOB_HASH */
+
+static rt_err_t hwcrypto_job_exec(struct rt_hwcrypto_job *job, rt_uint8_t *gather, rt_size_t gather_size)
+{
+    if (job->ctx == RT_NULL || (job->sg == RT_NULL && job->sg_num > 0))
+    {
+        return -RT_EINVAL;
+    }
+
+    switch (job->ctx->type & HWCRYPTO_MAIN_TYPE_MASK)
+    {
+#ifdef HWCRYPTO_JOB_SYMMETRIC
+    case HWCRYPTO_TYPE_AES:
+    case HWCRYPTO_TYPE_DES:
+    case HWCRYPTO_TYPE_3DES:
+    case HWCRYPTO_TYPE_RC4:
+        if (job->out == RT_NULL || job->sg_num == 0)
+        {
+            return -RT_EINVAL;
+        }
+        return hwcrypto_job_crypt(job);
+#endif /* HWCRYPTO_JOB_SYMMETRIC */
+
+#ifdef HWCRYPTO_JOB_HASH
+    case HWCRYPTO_TYPE_MD5:
+    case HWCRYPTO_TYPE_SHA1:
+    case HWCRYPTO_TYPE_SHA2:
+        return hwcrypto_job_hash(job, gather, gather_size);
+#endif /* HWCRYPTO_JOB_HASH */
+
+    default:
+        return -RT_ENOSYS;
+    }
+}
+
+/**
+ * @brief           Init a symmetric crypto job
+ *
+ * @param job       The job to initialize
+ * @param ctx       Symmetric crypto context
+ * @param mode      Operation mode. HWCRYPTO_MODE_ENCRYPT or HWCRYPTO_MODE_DECRYPT
+ * @param sg        Input segments, the total length must be a multiple of the block size
+ * @param sg_num    Number of input segments
+ * @param out       The buffer holding the output data (may be the same as a single input segment)
+ * @param done      Completion callback
+ * @param user_data User data of the callback
+ */
+void rt_hwcrypto_job_init_crypt(struct rt_hwcrypto_job *job, struct rt_hwcrypto_ctx *ctx, hwcrypto_mode mode,
+                                const struct rt_hwcrypto_sg *sg, rt_size_t sg_num, rt_uint8_t *out,
+                                rt_hwcrypto_job_done_t done, void *user_data)
+{
+    RT_ASSERT(job != RT_NULL);
+
+    rt_memset(job, 0, sizeof(struct rt_hwcrypto_job));
+    job->ctx = ctx;
+    job->mode = mode;
+    job->sg = sg;
+    job->sg_num = sg_num;
+    job->out = out;
+    job->done = done;
+    job->user_data = user_data;
+}
+
+/**
+ * @brief           Init a hash job
+ *
+ * @param job       The job to initialize
+ * @param ctx       Hash context
+ * @param sg        Input segments
+ * @param sg_num    Number of input segments
+ * @param out       The buffer holding the hash value, RT_NULL to continue hashing by next jobs
+ * @param out_len   Length of the hash value buffer
+ * @param done      Completion callback
+ * @param user_data User data of the callback
+ */
+void rt_hwcrypto_job_init_hash(struct rt_hwcrypto_job *job, struct rt_hwcrypto_ctx *ctx,
+                               const struct rt_hwcrypto_sg *sg, rt_size_t sg_num,
+                               rt_uint8_t *out, rt_size_t out_len,
+                               rt_hwcrypto_job_done_t done, void *user_data)
+{
+    RT_ASSERT(job != RT_NULL);
+
+    rt_memset(job, 0, sizeof(struct rt_hwcrypto_job));
+    job->ctx = ctx;
+    job->mode = HWCRYPTO_MODE_UNKNOWN;
+    job->sg = sg;
+    job->sg_num = sg_num;
+    job->out = out;
+    job->out_len = out_len;
+    job->done = done;
+    job->user_data = user_data;
+}
+
+/**
+ * @brief           Queue a job to the job thread, the jobs of a context are run in order
+ *
+ * @param job       Crypto job
+ *
+ * @return          RT_EOK on success.
+ */
+rt_err_t rt_hwcrypto_job_submit(struct rt_hwcrypto_job *job)
+{
+    rt_base_t level;
+    rt_bool_t idle;
+
+    if (job == RT_NULL || job->ctx == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+
+    job->list.next = RT_NULL;
+    job->result = -RT_EBUSY;
+
+    level = rt_hw_interrupt_disable();
+    idle = rt_slist_isempty(&job_head);
+    job_tail->next = &job->list;
+    job_tail = &job->list;
+    job_stat.submitted++;
+    rt_hw_interrupt_enable(level);
+
+    /* the job thread drains the queue, it's only woken up for the first job */
+    if (idle)
+    {
+        rt_sem_release(&job_sem);
+    }
+
+    return RT_EOK;
+}
+
+/**
+ * @brief           Run a job in the calling thread, the callback is not called
+ *
+ * @param job       Crypto job
+ *
+ * @return          Result of the job
+ */
+rt_err_t rt_hwcrypto_job_run(struct rt_hwcrypto_job *job)
+{
+    RT_ASSERT(job != RT_NULL);
+
+    /* no gather buffer, it's owned by the job thread */
+    job->result = hwcrypto_job_exec(job, RT_NULL, 0);
+
+    return job->result;
+}
+
+/**
+ * @brief           Get the statistics of the job queue
+ *
+ * @param stat      The buffer holding the statistics
+ */
+void rt_hwcrypto_job_stat(struct rt_hwcrypto_job_stat *stat)
+{
+    rt_base_t level;
+
+    RT_ASSERT(stat != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    *stat = job_stat;
+    rt_hw_interrupt_enable(level);
+}
+
+static struct rt_hwcrypto_job *hwcrypto_job_pop(void)
+{
+    struct rt_hwcrypto_job *job = RT_NULL;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    if (!rt_slist_isempty(&job_head))
+    {
+        job = rt_slist_entry(job_head.next, struct rt_hwcrypto_job, list);
+        job_head.next = job->list.next;
+        if (job_head.next == RT_NULL)
+        {
+            job_tail = &job_head;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    return job;
+}
+
+static void hwcrypto_job_thread_entry(void *parameter)
+{
+    struct rt_hwcrypto_job *job;
+    rt_uint32_t batch;
+
+    while (1)
+    {
+        rt_sem_take(&job_sem, RT_WAITING_FOREVER);
+
+        batch = 0;
+        while ((job = hwcrypto_job_pop()) != RT_NULL)
+        {
+            job->result = hwcrypto_job_exec(job, job_gather, sizeof(job_gather));
+            if (job->result != RT_EOK)
+            {
+                job_stat.failed++;
+            }
+            job_stat.completed++;
+
+            /* the job may be reused or freed by the callback */
+            if (job->done)
+            {
+                job->done(job, job->result);
+            }
+
+            if (++batch > job_stat.max_batch)
+            {
+                job_stat.max_batch = batch;
+            }
+            /* give the threads of the same priority a chance between the batches */
+            if (batch % RT_HWCRYPTO_JOB_BATCH == 0)
+            {
+                rt_thread_yield();
+            }
+        }
+
+        if (batch > 0)
+        {
+            job_stat.batches++;
+        }
+    }
+}
+
+static int rt_hwcrypto_job_init(void)
+{
+    rt_err_t err;
+
+    rt_sem_init(&job_sem, "hwcjob", 0, RT_IPC_FLAG_FIFO);
+
+    err = rt_thread_init(&job_thread, "hwcjob", hwcrypto_job_thread_entry, RT_NULL,
+                         job_thread_stack, sizeof(job_thread_stack),
+                         RT_HWCRYPTO_JOB_THREAD_PRIORITY, 10);
+    if (err != RT_EOK)
+    {
+        LOG_E("init job thread failed(%d)", err);
+        return err;
+    }
+    rt_thread_startup(&job_thread);
+
+    return RT_EOK;
+}
+INIT_COMPONENT_EXPORT(rt_hwcrypto_job_init);
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __HW_JOB_H__
+#define __HW_JOB_H__
+
+#include <hwcrypto.h>
+
+#ifndef RT_HWCRYPTO_JOB_THREAD_PRIORITY
+#define RT_HWCRYPTO_JOB_THREAD_PRIORITY     (RT_THREAD_PRIORITY_MAX / 3)
+#endif
+#ifndef RT_HWCRYPTO_JOB_THREAD_STACK_SIZE
+#define RT_HWCRYPTO_JOB_THREAD_STACK_SIZE   (1024)
+#endif
+#ifndef RT_HWCRYPTO_JOB_BATCH
+#define RT_HWCRYPTO_JOB_BATCH               (8)
+#endif
+#ifndef RT_HWCRYPTO_JOB_GATHER_SIZE
+#define RT_HWCRYPTO_JOB_GATHER_SIZE         (256)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief           A segment of the scattered job input
+ */
+struct rt_hwcrypto_sg
+{
+    const rt_uint8_t *buf;          /**< Segment data */
+    rt_size_t len;                  /**< Segment length in Bytes */
+};
+
+struct rt_hwcrypto_job;
+
+typedef void (*rt_hwcrypto_job_done_t)(struct rt_hwcrypto_job *job, rt_err_t result);
+
+/**
+ * @brief           Crypto job, owned by the caller until it's completed
+ *
+ * The job runs on the context it was initialized with:
+ * symmetric context - the segments are encrypted/decrypted into 'out'
+ *                     (the total length, a multiple of the block size)
+ * hash context      - the segments are hashed and, if 'out' is given,
+ *                     the hash is finished into it ('out_len' Bytes)
+ */
+struct rt_hwcrypto_job
+{
+    rt_slist_t list;                    /**< Queue node */
+    struct rt_hwcrypto_ctx *ctx;        /**< Crypto context */
+    hwcrypto_mode mode;                 /**< Symmetric: HWCRYPTO_MODE_ENCRYPT or HWCRYPTO_MODE_DECRYPT */
+    const struct rt_hwcrypto_sg *sg;    /**< Input segments */
+    rt_size_t sg_num;                   /**< Number of input segments */
+    rt_uint8_t *out;                    /**< Output data or hash value, RT_NULL to update the hash only */
+    rt_size_t out_len;                  /**< Length of the hash value buffer */
+    rt_hwcrypto_job_done_t done;        /**< Completion callback, called in the job thread */
+    void *user_data;                    /**< User data of the callback */
+    rt_err_t result;                    /**< Result of the job */
+};
+
+/**
+ * @brief           Statistics of the job queue
+ */
+struct rt_hwcrypto_job_stat
+{
+    rt_uint32_t submitted;              /**< Jobs submitted */
+    rt_uint32_t completed;              /**< Jobs completed */
+    rt_uint32_t failed;                 /**< Jobs completed with an error */
+    rt_uint32_t batches;                /**< Wakeups of the job thread */
+    rt_uint32_t max_batch;              /**< Most jobs run in one wakeup */
+    rt_uint32_t gathered;               /**< Segments coalesced before reaching the device */
+};
+
+/**
+ * @brief           Init a symmetric crypto job
+ *
+ * @param job       The job to initialize
+ * @param ctx       Symmetric crypto context
+ * @param mode      Operation mode. HWCRYPTO_MODE_ENCRYPT or HWCRYPTO_MODE_DECRYPT
+ * @param sg        Input segments, the total length must be a multiple of the block size
+ * @param sg_num    Number of input segments
+ * @param out       The buffer holding the output data (may be the same as a single input segment)
+ * @param done      Completion callback
+ * @param user_data User data of the callback
+ */
+void rt_hwcrypto_job_init_crypt(struct rt_hwcrypto_job *job, struct rt_hwcrypto_ctx *ctx, hwcrypto_mode mode,
+                                const struct rt_hwcrypto_sg *sg, rt_size_t sg_num, rt_uint8_t *out,
+                                rt_hwcrypto_job_done_t done, void *user_data);
+
+/**
+ * @brief           Init a hash job
+ *
+ * @param job       The job to initialize
+ * @param ctx       Hash context
+ * @param sg        Input segments
+ * @param sg_num    Number of input segments
+ * @param out       The buffer holding the hash value, RT_NULL to continue hashing by next jobs
+ * @param out_len   Length of the hash value buffer
+ * @param done      Completion callback
+ * @param user_data User data of the callback
+ */
+void rt_hwcrypto_job_init_hash(struct rt_hwcrypto_job *job, struct rt_hwcrypto_ctx *ctx,
+                               const struct rt_hwcrypto_sg *sg, rt_size_t sg_num,
+                               rt_uint8_t *out, rt_size_t out_len,
+                               rt_hwcrypto_job_done_t done, void *user_data);
+
+/**
+ * @brief           Queue a job to the job thread, the jobs of a context are run in order
+ *
+ * @param job       Crypto job
+ *
+ * @return          RT_EOK on success.
+ */
+rt_err_t rt_hwcrypto_job_submit(struct rt_hwcrypto_job *job);
+
+/**
+ * @brief           Run a job in the calling thread, the callback is not called
+ *
+ * @param job       Crypto job
+ *
+ * @return          Result of the job
+ */
+rt_err_t rt_hwcrypto_job_run(struct rt_hwcrypto_job *job);
+
+/**
+ * @brief           Get the statistics of the job queue
+ *
+ * @param stat      The buffer holding the statistics
+ */
+void rt_hwcrypto_job_stat(struct rt_hwcrypto_job_stat *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
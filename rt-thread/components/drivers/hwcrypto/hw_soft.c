@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Software crypto device: portable reference implementation of AES
+ * (ECB/CBC/CTR) and SHA-224/SHA-256 behind the hwcrypto interface.
+ * It's the default device if no hardware one is registered, and the
+ * baseline for comparing the hardware throughput (hwcrypto_bench).
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <hw_symmetric.h>
+#include <hw_hash.h>
+
+#define SOFT_AES_BLOCK_SIZE     16
+#define SOFT_SHA256_BLOCK_SIZE  64
+
+struct soft_aes_ctx
+{
+    rt_uint32_t nr;                                 /* number of rounds, 0 if the key is not expanded */
+    rt_uint8_t rk[240];                             /* round keys */
+    rt_uint8_t stream[SOFT_AES_BLOCK_SIZE];         /* CTR key stream block */
+};
+
+struct soft_sha256_ctx
+{
+    rt_uint32_t state[8];
+    rt_uint64_t total;                              /* bytes processed */
+    rt_uint8_t buf[SOFT_SHA256_BLOCK_SIZE];
+};
+
+/* AES ------------------------------------------------------------------------------*/
+
+static const rt_uint8_t aes_sbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static const rt_uint8_t aes_inv_sbox[256] =
+{
+    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d,
+};
+
+#define AES_XTIME(x)    ((rt_uint8_t)(((x) << 1) ^ (((x) & 0x80) ? 0x1b : 0x00)))
+
+static rt_uint8_t aes_mul(rt_uint8_t a, rt_uint8_t b)
+{
+    rt_uint8_t r = 0;
+
+    while (b)
+    {
+        if (b & 1)
+        {
+            r ^= a;
+        }
+        a = AES_XTIME(a);
+        b >>= 1;
+    }
+
+    return r;
+}
+
+static rt_err_t soft_aes_setkey(struct soft_aes_ctx *aes, const rt_uint8_t *key, rt_uint32_t bitlen)
+{
+    rt_uint32_t nk = bitlen / 32, i;
+    rt_uint8_t rcon = 0x01, t[4], tmp;
+
+    if (bitlen != 128 && bitlen != 192 && bitlen != 256)
+    {
+        return -RT_EINVAL;
+    }
+
+    aes->nr = nk + 6;
+    rt_memcpy(aes->rk, key, nk * 4);
+    for (i = nk; i < 4 * (aes->nr + 1); i++)
+    {
+        rt_memcpy(t, &aes->rk[(i - 1) * 4], 4);
+        if (i % nk == 0)
+        {
+            tmp = t[0];
+            t[0] = aes_sbox[t[1]] ^ rcon;
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[tmp];
+            rcon = AES_XTIME(rcon);
+        }
+        else if (nk > 6 && i % nk == 4)
+        {
+            t[0] = aes_sbox[t[0]];
+            t[1] = aes_sbox[t[1]];
+            t[2] = aes_sbox[t[2]];
+            t[3] = aes_sbox[t[3]];
+        }
+        aes->rk[i * 4 + 0] = aes->rk[(i - nk) * 4 + 0] ^ t[0];
+        aes->rk[i * 4 + 1] = aes->rk[(i - nk) * 4 + 1] ^ t[1];
+        aes->rk[i * 4 + 2] = aes->rk[(i - nk) * 4 + 2] ^ t[2];
+        aes->rk[i * 4 + 3] = aes->rk[(i - nk) * 4 + 3] ^ t[3];
+    }
+
+    return RT_EOK;
+}
+
+static void aes_add_round_key(rt_uint8_t *s, const rt_uint8_t *rk)
+{
+    int i;
+
+    for (i = 0; i < SOFT_AES_BLOCK_SIZE; i++)
+    {
+        s[i] ^= rk[i];
+    }
+}
+
+static void soft_aes_encrypt_block(const struct soft_aes_ctx *aes, const rt_uint8_t *in, rt_uint8_t *out)
+{
+    rt_uint8_t s[SOFT_AES_BLOCK_SIZE], t[SOFT_AES_BLOCK_SIZE];
+    rt_uint32_t round;
+    int c, i;
+
+    rt_memcpy(s, in, SOFT_AES_BLOCK_SIZE);
+    aes_add_round_key(s, aes->rk);
+    for (round = 1; round <= aes->nr; round++)
+    {
+        /* SubBytes and ShiftRows, the state is column-major */
+        for (i = 0; i < SOFT_AES_BLOCK_SIZE; i++)
+        {
+            t[i] = aes_sbox[s[(i + 4 * (i % 4)) % SOFT_AES_BLOCK_SIZE]];
+        }
+        if (round != aes->nr)
+        {
+            /* MixColumns */
+            for (c = 0; c < 4; c++)
+            {
+                rt_uint8_t *col = &t[c * 4];
+                rt_uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3], x = a0 ^ a1 ^ a2 ^ a3;
+
+                col[0] ^= x ^ AES_XTIME(a0 ^ a1);
+                col[1] ^= x ^ AES_XTIME(a1 ^ a2);
+                col[2] ^= x ^ AES_XTIME(a2 ^ a3);
+                col[3] ^= x ^ AES_XTIME(a3 ^ a0);
+            }
+        }
+        aes_add_round_key(t, &aes->rk[round * SOFT_AES_BLOCK_SIZE]);
+        rt_memcpy(s, t, SOFT_AES_BLOCK_SIZE);
+    }
+    rt_memcpy(out, s, SOFT_AES_BLOCK_SIZE);
+}
+
+static void soft_aes_decrypt_block(const struct soft_aes_ctx *aes, const rt_uint8_t *in, rt_uint8_t *out)
+{
+    rt_uint8_t s[SOFT_AES_BLOCK_SIZE], t[SOFT_AES_BLOCK_SIZE];
+    rt_uint32_t round;
+    int c, i;
+
+    rt_memcpy(s, in, SOFT_AES_BLOCK_SIZE);
+    aes_add_round_key(s, &aes->rk[aes->nr * SOFT_AES_BLOCK_SIZE]);
+    for (round = aes->nr; round > 0; round--)
+    {
+        /* InvShiftRows and InvSubBytes */
+        for (i = 0; i < SOFT_AES_BLOCK_SIZE; i++)
+        {
+            t[(i + 4 * (i % 4)) % SOFT_AES_BLOCK_SIZE] = aes_inv_sbox[s[i]];
+        }
+        aes_add_round_key(t, &aes->rk[(round - 1) * SOFT_AES_BLOCK_SIZE]);
+        if (round != 1)
+        {
+            /* InvMixColumns */
+            for (c = 0; c < 4; c++)
+            {
+                rt_uint8_t *col = &t[c * 4];
+                rt_uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+
+                col[0] = aes_mul(a0, 14) ^ aes_mul(a1, 11) ^ aes_mul(a2, 13) ^ aes_mul(a3, 9);
+                col[1] = aes_mul(a0, 9) ^ aes_mul(a1, 14) ^ aes_mul(a2, 11) ^ aes_mul(a3, 13);
+                col[2] = aes_mul(a0, 13) ^ aes_mul(a1, 9) ^ aes_mul(a2, 14) ^ aes_mul(a3, 11);
+                col[3] = aes_mul(a0, 11) ^ aes_mul(a1, 13) ^ aes_mul(a2, 9) ^ aes_mul(a3, 14);
+            }
+        }
+        rt_memcpy(s, t, SOFT_AES_BLOCK_SIZE);
+    }
+    rt_memcpy(out, s, SOFT_AES_BLOCK_SIZE);
+}
+
+static rt_err_t soft_aes_crypt(struct hwcrypto_symmetric *symmetric_ctx, struct hwcrypto_symmetric_info *symmetric_info)
+{
+    struct soft_aes_ctx *aes = (struct soft_aes_ctx *)symmetric_ctx->parent.contex;
+    const rt_uint8_t *in = symmetric_info->in;
+    rt_uint8_t *out = symmetric_info->out;
+    rt_size_t length = symmetric_info->length;
+    rt_uint8_t block[SOFT_AES_BLOCK_SIZE];
+    rt_err_t err;
+    int i;
+
+    if ((symmetric_ctx->flags & SYMMTRIC_MODIFY_KEY) || aes->nr == 0)
+    {
+        err = soft_aes_setkey(aes, symmetric_ctx->key, symmetric_ctx->key_bitlen);
+        if (err != RT_EOK)
+        {
+            return err;
+        }
+    }
+
+    switch (symmetric_ctx->parent.type & (HWCRYPTO_MAIN_TYPE_MASK | HWCRYPTO_SUB_TYPE_MASK))
+    {
+    case HWCRYPTO_TYPE_AES_ECB:
+        if (length % SOFT_AES_BLOCK_SIZE)
+        {
+            return -RT_EINVAL;
+        }
+        for (; length > 0; length -= SOFT_AES_BLOCK_SIZE, in += SOFT_AES_BLOCK_SIZE, out += SOFT_AES_BLOCK_SIZE)
+        {
+            if (symmetric_info->mode == HWCRYPTO_MODE_ENCRYPT)
+            {
+                soft_aes_encrypt_block(aes, in, out);
+            }
+            else
+            {
+                soft_aes_decrypt_block(aes, in, out);
+            }
+        }
+        break;
+
+    case HWCRYPTO_TYPE_AES_CBC:
+        if (length % SOFT_AES_BLOCK_SIZE)
+        {
+            return -RT_EINVAL;
+        }
+        /* the IV is chained to the next call */
+        for (; length > 0; length -= SOFT_AES_BLOCK_SIZE, in += SOFT_AES_BLOCK_SIZE, out += SOFT_AES_BLOCK_SIZE)
+        {
+            if (symmetric_info->mode == HWCRYPTO_MODE_ENCRYPT)
+            {
+                for (i = 0; i < SOFT_AES_BLOCK_SIZE; i++)
+                {
+                    block[i] = in[i] ^ symmetric_ctx->iv[i];
+                }
+                soft_aes_encrypt_block(aes, block, out);
+                rt_memcpy(symmetric_ctx->iv, out, SOFT_AES_BLOCK_SIZE);
+            }
+            else
+            {
+                rt_memcpy(block, in, SOFT_AES_BLOCK_SIZE);
+                soft_aes_decrypt_block(aes, in, out);
+                for (i = 0; i < SOFT_AES_BLOCK_SIZE; i++)
+                {
+                    out[i] ^= symmetric_ctx->iv[i];
+                }
+                rt_memcpy(symmetric_ctx->iv, block, SOFT_AES_BLOCK_SIZE);
+            }
+        }
+        break;
+
+    case HWCRYPTO_TYPE_AES_CTR:
+        /* the counter and the offset in the key stream are chained to the next call */
+        while (length--)
+        {
+            if (symmetric_ctx->iv_off == 0)
+            {
+                soft_aes_encrypt_block(aes, symmetric_ctx->iv, aes->stream);
+                for (i = SOFT_AES_BLOCK_SIZE - 1; i >= 0; i--)
+                {
+                    if (++symmetric_ctx->iv[i] != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+            *out++ = *in++ ^ aes->stream[symmetric_ctx->iv_off];
+            symmetric_ctx->iv_off = (symmetric_ctx->iv_off + 1) % SOFT_AES_BLOCK_SIZE;
+        }
+        break;
+
+    default:
+        return -RT_ENOSYS;
+    }
+
+    return RT_EOK;
+}
+
+static const struct hwcrypto_symmetric_ops soft_aes_ops =
+{
+    .crypt = soft_aes_crypt,
+};
+
+/* SHA-224/SHA-256 ------------------------------------------------------------------*/
+
+static const rt_uint32_t sha256_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define SHA256_ROR(x, n)    (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void soft_sha256_block(struct soft_sha256_ctx *sha, const rt_uint8_t *data)
+{
+    rt_uint32_t w[64], a, b, c, d, e, f, g, h, t1, t2;
+    int i;
+
+    for (i = 0; i < 16; i++)
+    {
+        w[i] = ((rt_uint32_t)data[i * 4] << 24) | ((rt_uint32_t)data[i * 4 + 1] << 16) |
+               ((rt_uint32_t)data[i * 4 + 2] << 8) | (rt_uint32_t)data[i * 4 + 3];
+    }
+    for (i = 16; i < 64; i++)
+    {
+        w[i] = (SHA256_ROR(w[i - 2], 17) ^ SHA256_ROR(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7] +
+               (SHA256_ROR(w[i - 15], 7) ^ SHA256_ROR(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+    }
+
+    a = sha->state[0]; b = sha->state[1]; c = sha->state[2]; d = sha->state[3];
+    e = sha->state[4]; f = sha->state[5]; g = sha->state[6]; h = sha->state[7];
+    for (i = 0; i < 64; i++)
+    {
+        t1 = h + (SHA256_ROR(e, 6) ^ SHA256_ROR(e, 11) ^ SHA256_ROR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        t2 = (SHA256_ROR(a, 2) ^ SHA256_ROR(a, 13) ^ SHA256_ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    sha->state[0] += a; sha->state[1] += b; sha->state[2] += c; sha->state[3] += d;
+    sha->state[4] += e; sha->state[5] += f; sha->state[6] += g; sha->state[7] += h;
+}
+
+static void soft_sha256_start(struct soft_sha256_ctx *sha, hwcrypto_type type)
+{
+    static const rt_uint32_t sha224_iv[8] =
+    {
+        0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+    };
+    static const rt_uint32_t sha256_iv[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    rt_memcpy(sha->state, type == HWCRYPTO_TYPE_SHA224 ? sha224_iv : sha256_iv, sizeof(sha->state));
+    sha->total = 0;
+}
+
+static rt_err_t soft_sha256_update(struct hwcrypto_hash *hash_ctx, const rt_uint8_t *in, rt_size_t length)
+{
+    struct soft_sha256_ctx *sha = (struct soft_sha256_ctx *)hash_ctx->parent.contex;
+    rt_size_t fill = (rt_size_t)(sha->total % SOFT_SHA256_BLOCK_SIZE), n;
+
+    sha->total += length;
+    if (fill > 0)
+    {
+        n = SOFT_SHA256_BLOCK_SIZE - fill;
+        if (length < n)
+        {
+            rt_memcpy(sha->buf + fill, in, length);
+            return RT_EOK;
+        }
+        rt_memcpy(sha->buf + fill, in, n);
+        soft_sha256_block(sha, sha->buf);
+        in += n;
+        length -= n;
+    }
+    for (; length >= SOFT_SHA256_BLOCK_SIZE; length -= SOFT_SHA256_BLOCK_SIZE, in += SOFT_SHA256_BLOCK_SIZE)
+    {
+        soft_sha256_block(sha, in);
+    }
+    if (length > 0)
+    {
+        rt_memcpy(sha->buf, in, length);
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t soft_sha256_finish(struct hwcrypto_hash *hash_ctx, rt_uint8_t *out, rt_size_t length)
+{
+    struct soft_sha256_ctx *sha = (struct soft_sha256_ctx *)hash_ctx->parent.contex;
+    rt_size_t fill = (rt_size_t)(sha->total % SOFT_SHA256_BLOCK_SIZE);
+    rt_size_t digest = (hash_ctx->parent.type == HWCRYPTO_TYPE_SHA224) ? 28 : 32;
+    rt_uint64_t bits = sha->total * 8;
+    int i;
+
+    if (length < digest)
+    {
+        return -RT_EINVAL;
+    }
+
+    sha->buf[fill++] = 0x80;
+    if (fill > SOFT_SHA256_BLOCK_SIZE - 8)
+    {
+        rt_memset(sha->buf + fill, 0, SOFT_SHA256_BLOCK_SIZE - fill);
+        soft_sha256_block(sha, sha->buf);
+        fill = 0;
+    }
+    rt_memset(sha->buf + fill, 0, SOFT_SHA256_BLOCK_SIZE - 8 - fill);
+    for (i = 0; i < 8; i++)
+    {
+        sha->buf[SOFT_SHA256_BLOCK_SIZE - 1 - i] = (rt_uint8_t)(bits >> (i * 8));
+    }
+    soft_sha256_block(sha, sha->buf);
+
+    for (i = 0; i < (int)digest; i++)
+    {
+        out[i] = (rt_uint8_t)(sha->state[i / 4] >> (24 - (i % 4) * 8));
+    }
+
+    /* ready for the next message */
+    soft_sha256_start(sha, hash_ctx->parent.type);
+
+    return RT_EOK;
+}
+
+static const struct hwcrypto_hash_ops soft_sha256_ops =
+{
+    .update = soft_sha256_update,
+    .finish = soft_sha256_finish,
+};
+
+/* Device ---------------------------------------------------------------------------*/
+
+static rt_size_t soft_hwcrypto_ctx_size(hwcrypto_type type)
+{
+    switch (type & HWCRYPTO_MAIN_TYPE_MASK)
+    {
+    case HWCRYPTO_TYPE_AES:
+        return sizeof(struct soft_aes_ctx);
+    case HWCRYPTO_TYPE_SHA2:
+        return sizeof(struct soft_sha256_ctx);
+    default:
+        return 0;
+    }
+}
+
+static void soft_hwcrypto_reset(struct rt_hwcrypto_ctx *ctx)
+{
+    switch (ctx->type & HWCRYPTO_MAIN_TYPE_MASK)
+    {
+    case HWCRYPTO_TYPE_AES:
+        ((struct soft_aes_ctx *)ctx->contex)->nr = 0;
+        break;
+    case HWCRYPTO_TYPE_SHA2:
+        soft_sha256_start((struct soft_sha256_ctx *)ctx->contex, ctx->type);
+        break;
+    default:
+        break;
+    }
+}
+
+static rt_err_t soft_hwcrypto_create(struct rt_hwcrypto_ctx *ctx)
+{
+    rt_size_t size;
+
+    switch (ctx->type & (HWCRYPTO_MAIN_TYPE_MASK | HWCRYPTO_SUB_TYPE_MASK))
+    {
+    case HWCRYPTO_TYPE_AES_ECB:
+    case HWCRYPTO_TYPE_AES_CBC:
+    case HWCRYPTO_TYPE_AES_CTR:
+        ((struct hwcrypto_symmetric *)ctx)->ops = &soft_aes_ops;
+        break;
+    case HWCRYPTO_TYPE_SHA224:
+    case HWCRYPTO_TYPE_SHA256:
+        ((struct hwcrypto_hash *)ctx)->ops = &soft_sha256_ops;
+        break;
+    default:
+        return -RT_ENOSYS;
+    }
+
+    size = soft_hwcrypto_ctx_size(ctx->type);
+    ctx->contex = rt_malloc(size);
+    if (ctx->contex == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    rt_memset(ctx->contex, 0, size);
+    soft_hwcrypto_reset(ctx);
+
+    return RT_EOK;
+}
+
+static void soft_hwcrypto_destroy(struct rt_hwcrypto_ctx *ctx)
+{
+    if (ctx->contex)
+    {
+        rt_free(ctx->contex);
+        ctx->contex = RT_NULL;
+    }
+}
+
+static rt_err_t soft_hwcrypto_copy(struct rt_hwcrypto_ctx *des, const struct rt_hwcrypto_ctx *src)
+{
+    if (des->contex == RT_NULL || src->contex == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+    rt_memcpy(des->contex, src->contex, soft_hwcrypto_ctx_size(src->type));
+
+    return RT_EOK;
+}
+
+static const struct rt_hwcrypto_ops soft_hwcrypto_ops =
+{
+    .create = soft_hwcrypto_create,
+    .destroy = soft_hwcrypto_destroy,
+    .copy = soft_hwcrypto_copy,
+    .reset = soft_hwcrypto_reset,
+};
+
+static int rt_hwcrypto_soft_init(void)
+{
+    static struct rt_hwcrypto_device soft_hwcrypto_dev;
+
+    soft_hwcrypto_dev.ops = &soft_hwcrypto_ops;
+    soft_hwcrypto_dev.id = 0;
+    soft_hwcrypto_dev.user_data = &soft_hwcrypto_dev;
+
+    return rt_hwcrypto_register(&soft_hwcrypto_dev, RT_HWCRYPTO_SOFT_NAME);
+}
+INIT_DEVICE_EXPORT(rt_hwcrypto_soft_init);
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Known answer tests of the software crypto device: AES from FIPS-197
+ * appendix C and SP 800-38A F.2.1/F.5.1, SHA-224/SHA-256 from FIPS 180
+ * (one-shot and split updates), and the order of the queued jobs.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <hw_symmetric.h>
+#include <hw_hash.h>
+#ifdef RT_HWCRYPTO_USING_JOB
+#include <hw_job.h>
+#endif
+#include "utest.h"
+
+#define TC_SHA_CHUNK    199
+#define TC_JOB_NUM      4
+#define TC_JOB_TIMEOUT  rt_tick_from_millisecond(1000)
+
+static struct rt_hwcrypto_device *tc_dev;
+
+/* FIPS-197 C.1-C.3: the key is 00 01 02 ... */
+static const rt_uint8_t tc_fips197_pt[16] =
+{
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff,
+};
+
+static const rt_uint8_t tc_fips197_ct[3][16] =
+{
+    {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a},
+    {0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91},
+    {0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89},
+};
+
+/* SP 800-38A F.2.1 and F.5.1 */
+static const rt_uint8_t tc_sp800_key[16] =
+{
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+};
+
+static const rt_uint8_t tc_sp800_pt[64] =
+{
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+
+static const rt_uint8_t tc_sp800_cbc_iv[16] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+static const rt_uint8_t tc_sp800_cbc_ct[64] =
+{
+    0x76, 0x49, 0xab, 0xac, 0x81, 0x19, 0xb2, 0x46, 0xce, 0xe9, 0x8e, 0x9b, 0x12, 0xe9, 0x19, 0x7d,
+    0x50, 0x86, 0xcb, 0x9b, 0x50, 0x72, 0x19, 0xee, 0x95, 0xdb, 0x11, 0x3a, 0x91, 0x76, 0x78, 0xb2,
+    0x73, 0xbe, 0xd6, 0xb8, 0xe3, 0xc1, 0x74, 0x3b, 0x71, 0x16, 0xe6, 0x9e, 0x22, 0x22, 0x95, 0x16,
+    0x3f, 0xf1, 0xca, 0xa1, 0x68, 0x1f, 0xac, 0x09, 0x12, 0x0e, 0xca, 0x30, 0x75, 0x86, 0xe1, 0xa7,
+};
+
+static const rt_uint8_t tc_sp800_ctr_iv[16] =
+{
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+static const rt_uint8_t tc_sp800_ctr_ct[64] =
+{
+    0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+    0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+    0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+    0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee,
+};
+
+/* FIPS 180 examples: "abc" and the two block message */
+static const char tc_sha_msg[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static const rt_uint8_t tc_sha256_abc[32] =
+{
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+};
+
+static const rt_uint8_t tc_sha256_msg[32] =
+{
+    0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+    0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+};
+
+/* one million "a" */
+static const rt_uint8_t tc_sha256_million[32] =
+{
+    0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+    0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0,
+};
+
+static const rt_uint8_t tc_sha224_abc[28] =
+{
+    0x23, 0x09, 0x7d, 0x22, 0x34, 0x05, 0xd8, 0x22, 0x86, 0x42, 0xa4, 0x77, 0xbd, 0xa2, 0x55, 0xb3,
+    0x2a, 0xad, 0xbc, 0xe4, 0xbd, 0xa0, 0xb3, 0xf7, 0xe3, 0x6c, 0x9d, 0xa7,
+};
+
+static void test_aes_ecb(void)
+{
+    static const int bits[3] = {128, 192, 256};
+    struct rt_hwcrypto_ctx *ctx;
+    rt_uint8_t key[32], buf[16];
+    int i;
+
+    for (i = 0; i < 32; i++)
+    {
+        key[i] = (rt_uint8_t)i;
+    }
+
+    ctx = rt_hwcrypto_symmetric_create(tc_dev, HWCRYPTO_TYPE_AES_ECB);
+    uassert_not_null(ctx);
+    if (ctx == RT_NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        uassert_int_equal(rt_hwcrypto_symmetric_setkey(ctx, key, bits[i]), RT_EOK);
+        uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 16, tc_fips197_pt, buf), RT_EOK);
+        uassert_buf_equal(buf, tc_fips197_ct[i], 16);
+        /* the decryption key schedule is derived from the same key */
+        uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_DECRYPT, 16, buf, buf), RT_EOK);
+        uassert_buf_equal(buf, tc_fips197_pt, 16);
+    }
+
+    rt_hwcrypto_symmetric_destroy(ctx);
+}
+
+static void test_aes_cbc(void)
+{
+    struct rt_hwcrypto_ctx *ctx;
+    rt_uint8_t buf[64];
+
+    ctx = rt_hwcrypto_symmetric_create(tc_dev, HWCRYPTO_TYPE_AES_CBC);
+    uassert_not_null(ctx);
+    if (ctx == RT_NULL)
+    {
+        return;
+    }
+
+    /* the IV is chained across the calls */
+    rt_hwcrypto_symmetric_setkey(ctx, tc_sp800_key, 128);
+    rt_hwcrypto_symmetric_setiv(ctx, tc_sp800_cbc_iv, 16);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 16, tc_sp800_pt, buf), RT_EOK);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 48, tc_sp800_pt + 16, buf + 16), RT_EOK);
+    uassert_buf_equal(buf, tc_sp800_cbc_ct, 64);
+
+    /* in place */
+    rt_hwcrypto_symmetric_setiv(ctx, tc_sp800_cbc_iv, 16);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_DECRYPT, 32, buf, buf), RT_EOK);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_DECRYPT, 32, buf + 32, buf + 32), RT_EOK);
+    uassert_buf_equal(buf, tc_sp800_pt, 64);
+
+    /* not a multiple of the block size */
+    uassert_int_not_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 15, tc_sp800_pt, buf), RT_EOK);
+
+    rt_hwcrypto_symmetric_destroy(ctx);
+}
+
+static void test_aes_ctr(void)
+{
+    struct rt_hwcrypto_ctx *ctx;
+    rt_uint8_t buf[64];
+
+    ctx = rt_hwcrypto_symmetric_create(tc_dev, HWCRYPTO_TYPE_AES_CTR);
+    uassert_not_null(ctx);
+    if (ctx == RT_NULL)
+    {
+        return;
+    }
+
+    /* the keystream continues inside a block */
+    rt_hwcrypto_symmetric_setkey(ctx, tc_sp800_key, 128);
+    rt_hwcrypto_symmetric_setiv(ctx, tc_sp800_ctr_iv, 16);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 7, tc_sp800_pt, buf), RT_EOK);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 41, tc_sp800_pt + 7, buf + 7), RT_EOK);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_ENCRYPT, 16, tc_sp800_pt + 48, buf + 48), RT_EOK);
+    uassert_buf_equal(buf, tc_sp800_ctr_ct, 64);
+
+    rt_hwcrypto_symmetric_setiv(ctx, tc_sp800_ctr_iv, 16);
+    uassert_int_equal(rt_hwcrypto_symmetric_crypt(ctx, HWCRYPTO_MODE_DECRYPT, 64, buf, buf), RT_EOK);
+    uassert_buf_equal(buf, tc_sp800_pt, 64);
+
+    rt_hwcrypto_symmetric_destroy(ctx);
+}
+
+static void test_sha256(void)
+{
+    struct rt_hwcrypto_ctx *ctx, *ctx224;
+    rt_size_t len = sizeof(tc_sha_msg) - 1;
+    rt_uint8_t digest[32], buf[TC_SHA_CHUNK];
+    rt_size_t i, n;
+
+    ctx = rt_hwcrypto_hash_create(tc_dev, HWCRYPTO_TYPE_SHA256);
+    ctx224 = rt_hwcrypto_hash_create(tc_dev, HWCRYPTO_TYPE_SHA224);
+    uassert_not_null(ctx);
+    uassert_not_null(ctx224);
+    if (ctx == RT_NULL || ctx224 == RT_NULL)
+    {
+        rt_hwcrypto_hash_destroy(ctx);
+        rt_hwcrypto_hash_destroy(ctx224);
+        return;
+    }
+
+    /* one-shot, finish starts the next hash */
+    uassert_int_equal(rt_hwcrypto_hash_update(ctx, (const rt_uint8_t *)"abc", 3), RT_EOK);
+    uassert_int_equal(rt_hwcrypto_hash_finish(ctx, digest, 32), RT_EOK);
+    uassert_buf_equal(digest, tc_sha256_abc, 32);
+
+    rt_hwcrypto_hash_update(ctx, (const rt_uint8_t *)tc_sha_msg, len);
+    rt_hwcrypto_hash_finish(ctx, digest, 32);
+    uassert_buf_equal(digest, tc_sha256_msg, 32);
+
+    /* split at every offset, across the block buffer */
+    for (i = 0; i <= len; i++)
+    {
+        rt_hwcrypto_hash_update(ctx, (const rt_uint8_t *)tc_sha_msg, i);
+        rt_hwcrypto_hash_update(ctx, (const rt_uint8_t *)tc_sha_msg + i, len - i);
+        rt_hwcrypto_hash_finish(ctx, digest, 32);
+        uassert_buf_equal(digest, tc_sha256_msg, 32);
+    }
+
+    /* byte by byte */
+    for (i = 0; i < len; i++)
+    {
+        rt_hwcrypto_hash_update(ctx, (const rt_uint8_t *)tc_sha_msg + i, 1);
+    }
+    rt_hwcrypto_hash_finish(ctx, digest, 32);
+    uassert_buf_equal(digest, tc_sha256_msg, 32);
+
+    /* whole blocks straight from the input, in chunks not aligned to them */
+    rt_memset(buf, 'a', sizeof(buf));
+    for (i = 0; i < 1000000; i += n)
+    {
+        n = (1000000 - i < sizeof(buf)) ? 1000000 - i : sizeof(buf);
+        rt_hwcrypto_hash_update(ctx, buf, n);
+    }
+    rt_hwcrypto_hash_finish(ctx, digest, 32);
+    uassert_buf_equal(digest, tc_sha256_million, 32);
+
+    rt_hwcrypto_hash_update(ctx224, (const rt_uint8_t *)"abc", 3);
+    uassert_int_equal(rt_hwcrypto_hash_finish(ctx224, digest, 28), RT_EOK);
+    uassert_buf_equal(digest, tc_sha224_abc, 28);
+
+    rt_hwcrypto_hash_destroy(ctx);
+    rt_hwcrypto_hash_destroy(ctx224);
+}
+
+#ifdef RT_HWCRYPTO_USING_JOB
+static struct rt_semaphore tc_job_sem;
+static int tc_job_order[TC_JOB_NUM * 2];
+static int tc_job_done;
+
+static void tc_job_complete(struct rt_hwcrypto_job *job, rt_err_t result)
+{
+    tc_job_order[tc_job_done++] = (int)(rt_ubase_t)job->user_data;
+    if (result != RT_EOK || tc_job_done == TC_JOB_NUM * 2)
+    {
+        rt_sem_release(&tc_job_sem);
+    }
+}
+
+static void test_job_order(void)
+{
+    struct rt_hwcrypto_job job[TC_JOB_NUM * 2];
+    struct rt_hwcrypto_sg sg[TC_JOB_NUM * 2];
+    struct rt_hwcrypto_ctx *cbc, *sha;
+    rt_size_t len = sizeof(tc_sha_msg) - 1;
+    rt_uint8_t buf[64], digest[32];
+    int i;
+
+    cbc = rt_hwcrypto_symmetric_create(tc_dev, HWCRYPTO_TYPE_AES_CBC);
+    sha = rt_hwcrypto_hash_create(tc_dev, HWCRYPTO_TYPE_SHA256);
+    uassert_not_null(cbc);
+    uassert_not_null(sha);
+    if (cbc == RT_NULL || sha == RT_NULL)
+    {
+        rt_hwcrypto_symmetric_destroy(cbc);
+        rt_hwcrypto_hash_destroy(sha);
+        return;
+    }
+    rt_hwcrypto_symmetric_setkey(cbc, tc_sp800_key, 128);
+    rt_hwcrypto_symmetric_setiv(cbc, tc_sp800_cbc_iv, 16);
+
+    /* a block per CBC job and a part of the message per hash job, interleaved:
+       the chained IV and the running hash only match the vectors in order */
+    for (i = 0; i < TC_JOB_NUM; i++)
+    {
+        sg[i * 2].buf = tc_sp800_pt + i * 16;
+        sg[i * 2].len = 16;
+        rt_hwcrypto_job_init_crypt(&job[i * 2], cbc, HWCRYPTO_MODE_ENCRYPT, &sg[i * 2], 1, buf + i * 16,
+                                   tc_job_complete, (void *)(rt_ubase_t)(i * 2));
+
+        sg[i * 2 + 1].buf = (const rt_uint8_t *)tc_sha_msg + i * (len / TC_JOB_NUM);
+        sg[i * 2 + 1].len = (i == TC_JOB_NUM - 1) ? len - i * (len / TC_JOB_NUM) : len / TC_JOB_NUM;
+        rt_hwcrypto_job_init_hash(&job[i * 2 + 1], sha, &sg[i * 2 + 1], 1,
+                                  (i == TC_JOB_NUM - 1) ? digest : RT_NULL, 32,
+                                  tc_job_complete, (void *)(rt_ubase_t)(i * 2 + 1));
+    }
+
+    rt_sem_init(&tc_job_sem, "tcjob", 0, RT_IPC_FLAG_FIFO);
+    tc_job_done = 0;
+    for (i = 0; i < TC_JOB_NUM * 2; i++)
+    {
+        uassert_int_equal(rt_hwcrypto_job_submit(&job[i]), RT_EOK);
+    }
+    uassert_int_equal(rt_sem_take(&tc_job_sem, TC_JOB_TIMEOUT), RT_EOK);
+    rt_sem_detach(&tc_job_sem);
+
+    uassert_int_equal(tc_job_done, TC_JOB_NUM * 2);
+    for (i = 0; i < TC_JOB_NUM * 2; i++)
+    {
+        uassert_int_equal(tc_job_order[i], i);
+        uassert_int_equal(job[i].result, RT_EOK);
+    }
+    uassert_buf_equal(buf, tc_sp800_cbc_ct, 64);
+    uassert_buf_equal(digest, tc_sha256_msg, 32);
+
+    /* the scattered input of a job is the same as the contiguous one */
+    sg[0].buf = (const rt_uint8_t *)tc_sha_msg;
+    sg[0].len = 5;
+    sg[1].buf = (const rt_uint8_t *)tc_sha_msg + 5;
+    sg[1].len = 30;
+    sg[2].buf = (const rt_uint8_t *)tc_sha_msg + 35;
+    sg[2].len = len - 35;
+    rt_hwcrypto_job_init_hash(&job[0], sha, sg, 3, digest, 32, RT_NULL, RT_NULL);
+    uassert_int_equal(rt_hwcrypto_job_run(&job[0]), RT_EOK);
+    uassert_buf_equal(digest, tc_sha256_msg, 32);
+
+    rt_hwcrypto_symmetric_destroy(cbc);
+    rt_hwcrypto_hash_destroy(sha);
+}
+#endif /* RT_HWCRYPTO_USING_JOB */
+
+static rt_err_t utest_tc_init(void)
+{
+    tc_dev = (struct rt_hwcrypto_device *)rt_device_find(RT_HWCRYPTO_SOFT_NAME);
+
+    return tc_dev ? RT_EOK : -RT_ERROR;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_aes_ecb);
+    UTEST_UNIT_RUN(test_aes_cbc);
+    UTEST_UNIT_RUN(test_aes_ctr);
+    UTEST_UNIT_RUN(test_sha256);
+#ifdef RT_HWCRYPTO_USING_JOB
+    UTEST_UNIT_RUN(test_job_order);
+#endif
+}
+UTEST_TC_EXPORT(testcase, "components.drivers.hwcrypto.soft", utest_tc_init, utest_tc_cleanup, 10);
@@ -182,6 +182,13 @@ struct rt_hwcrypto_device *rt_hwcrypto_dev_default(void)
     }
     /* Find by default device name */
     hwcrypto_dev = (struct rt_hwcrypto_device *)rt_device_find(RT_HWCRYPTO_DEFAULT_NAME);
+#ifdef RT_HWCRYPTO_USING_SOFT
+    /* No hardware, fall back to the software implementation */
+    if (hwcrypto_dev == RT_NULL)
+    {
+        hwcrypto_dev = (struct rt_hwcrypto_device *)rt_device_find(RT_HWCRYPTO_SOFT_NAME);
+    }
+#endif
     return hwcrypto_dev;
 }
 
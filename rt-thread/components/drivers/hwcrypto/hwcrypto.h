@@ -17,6 +17,10 @@
 #define RT_HWCRYPTO_DEFAULT_NAME    ("hwcryto")
 #endif
 
+#ifndef RT_HWCRYPTO_SOFT_NAME
+#define RT_HWCRYPTO_SOFT_NAME       ("swcrypto")
+#endif
+
 #define HWCRYPTO_MAIN_TYPE_MASK     (0xffffUL << 16)
 #define HWCRYPTO_SUB_TYPE_MASK      (0xffUL << 8)
 
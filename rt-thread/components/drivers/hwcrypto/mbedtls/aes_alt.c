@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * MBEDTLS_AES_ALT on the default crypto device.
+ *
+ * ECB and CBC run on the device as they are, CTR/CFB/OFB are built on ECB:
+ * the CTR keystream of up to RT_HWCRYPTO_MBEDTLS_BATCH_SIZE bytes is
+ * encrypted in one device call.
+ */
+
+#include <rtthread.h>
+#include <hw_symmetric.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include <mbedtls/config.h>
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_AES_ALT)
+
+#include <string.h>
+#include <mbedtls/aes.h>
+#include <mbedtls/platform_util.h>
+
+#ifndef RT_HWCRYPTO_MBEDTLS_BATCH_SIZE
+#define RT_HWCRYPTO_MBEDTLS_BATCH_SIZE  256
+#endif
+
+#define AES_ALT_BATCH_BLOCKS    (RT_HWCRYPTO_MBEDTLS_BATCH_SIZE / 16)
+
+static int aes_alt_crypt(mbedtls_aes_context *ctx, hwcrypto_type type, int mode,
+                         size_t length, const unsigned char *input, unsigned char *output)
+{
+    if (ctx->hw == RT_NULL)
+    {
+        return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+    }
+
+    if (ctx->hw->type != type && rt_hwcrypto_symmetric_set_type(ctx->hw, type) != RT_EOK)
+    {
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
+
+    if (rt_hwcrypto_symmetric_crypt(ctx->hw, mode == MBEDTLS_AES_ENCRYPT ? HWCRYPTO_MODE_ENCRYPT : HWCRYPTO_MODE_DECRYPT,
+                                    length, input, output) != RT_EOK)
+    {
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
+
+    return 0;
+}
+
+void mbedtls_aes_init(mbedtls_aes_context *ctx)
+{
+    memset(ctx, 0, sizeof(mbedtls_aes_context));
+}
+
+void mbedtls_aes_free(mbedtls_aes_context *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    if (ctx->hw != RT_NULL)
+    {
+        rt_hwcrypto_symmetric_destroy(ctx->hw);
+    }
+    mbedtls_platform_zeroize(ctx, sizeof(mbedtls_aes_context));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+    struct rt_hwcrypto_device *dev;
+
+    if (keybits != 128 && keybits != 192 && keybits != 256)
+    {
+        return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    }
+
+    if (ctx->hw == RT_NULL)
+    {
+        dev = rt_hwcrypto_dev_default();
+        if (dev == RT_NULL)
+        {
+            return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+        }
+        ctx->hw = rt_hwcrypto_symmetric_create(dev, HWCRYPTO_TYPE_AES_ECB);
+        if (ctx->hw == RT_NULL)
+        {
+            return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+        }
+    }
+
+    if (rt_hwcrypto_symmetric_setkey(ctx->hw, key, keybits) != RT_EOK)
+    {
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
+    ctx->keybits = keybits;
+
+    return 0;
+}
+
+int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+    return mbedtls_aes_setkey_enc(ctx, key, keybits);
+}
+
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
+{
+    return aes_alt_crypt(ctx, HWCRYPTO_TYPE_AES_ECB, MBEDTLS_AES_ENCRYPT, 16, input, output);
+}
+
+int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
+{
+    return aes_alt_crypt(ctx, HWCRYPTO_TYPE_AES_ECB, MBEDTLS_AES_DECRYPT, 16, input, output);
+}
+
+#if !defined(MBEDTLS_DEPRECATED_REMOVED)
+void mbedtls_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
+{
+    mbedtls_internal_aes_encrypt(ctx, input, output);
+}
+
+void mbedtls_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
+{
+    mbedtls_internal_aes_decrypt(ctx, input, output);
+}
+#endif /* !MBEDTLS_DEPRECATED_REMOVED */
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode, const unsigned char input[16], unsigned char output[16])
+{
+    return aes_alt_crypt(ctx, HWCRYPTO_TYPE_AES_ECB, mode, 16, input, output);
+}
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length, unsigned char iv[16],
+                          const unsigned char *input, unsigned char *output)
+{
+    int ret;
+
+    if (length % 16)
+    {
+        return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
+    }
+    if (length == 0)
+    {
+        return 0;
+    }
+    if (ctx->hw == RT_NULL)
+    {
+        return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+    }
+
+    /* the device chains the IV, it's read back for the next call */
+    if (rt_hwcrypto_symmetric_setiv(ctx->hw, iv, 16) != RT_EOK)
+    {
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
+    ret = aes_alt_crypt(ctx, HWCRYPTO_TYPE_AES_CBC, mode, length, input, output);
+    if (ret == 0)
+    {
+        rt_hwcrypto_symmetric_getiv(ctx->hw, iv, 16);
+    }
+
+    return ret;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+
+#if defined(MBEDTLS_CIPHER_MODE_CFB)
+int mbedtls_aes_crypt_cfb128(mbedtls_aes_context *ctx, int mode, size_t length, size_t *iv_off,
+                             unsigned char iv[16], const unsigned char *input, unsigned char *output)
+{
+    size_t n = *iv_off;
+    unsigned char c;
+    int ret;
+
+    if (n > 15)
+    {
+        return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+    }
+
+    while (length--)
+    {
+        if (n == 0)
+        {
+            ret = mbedtls_internal_aes_encrypt(ctx, iv, iv);
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+
+        c = *input++;
+        *output++ = c ^ iv[n];
+        iv[n] = (mode == MBEDTLS_AES_ENCRYPT) ? output[-1] : c;
+        n = (n + 1) & 0x0F;
+    }
+    *iv_off = n;
+
+    return 0;
+}
+
+int mbedtls_aes_crypt_cfb8(mbedtls_aes_context *ctx, int mode, size_t length, unsigned char iv[16],
+                           const unsigned char *input, unsigned char *output)
+{
+    unsigned char ov[17];
+    int ret;
+
+    while (length--)
+    {
+        memcpy(ov, iv, 16);
+        ret = mbedtls_internal_aes_encrypt(ctx, iv, iv);
+        if (ret != 0)
+        {
+            return ret;
+        }
+
+        if (mode == MBEDTLS_AES_DECRYPT)
+        {
+            ov[16] = *input;
+        }
+        *output = iv[0] ^ *input;
+        if (mode == MBEDTLS_AES_ENCRYPT)
+        {
+            ov[16] = *output;
+        }
+        memcpy(iv, ov + 1, 16);
+
+        input++;
+        output++;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_OFB)
+int mbedtls_aes_crypt_ofb(mbedtls_aes_context *ctx, size_t length, size_t *iv_off,
+                          unsigned char iv[16], const unsigned char *input, unsigned char *output)
+{
+    size_t n = *iv_off;
+    int ret;
+
+    if (n > 15)
+    {
+        return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+    }
+
+    while (length--)
+    {
+        if (n == 0)
+        {
+            ret = mbedtls_internal_aes_encrypt(ctx, iv, iv);
+            if (ret != 0)
+            {
+                return ret;
+            }
+        }
+        *output++ = *input++ ^ iv[n];
+        n = (n + 1) & 0x0F;
+    }
+    *iv_off = n;
+
+    return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_OFB */
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+static void aes_alt_ctr_inc(unsigned char nonce_counter[16])
+{
+    int i;
+
+    for (i = 16; i > 0; i--)
+    {
+        if (++nonce_counter[i - 1] != 0)
+        {
+            break;
+        }
+    }
+}
+
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length, size_t *nc_off,
+                          unsigned char nonce_counter[16], unsigned char stream_block[16],
+                          const unsigned char *input, unsigned char *output)
+{
+    rt_uint32_t stream[AES_ALT_BATCH_BLOCKS * 4];
+    unsigned char *ks = (unsigned char *)stream;
+    size_t n = *nc_off;
+    size_t blocks, i, len;
+    int ret;
+
+    if (n > 15)
+    {
+        return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+    }
+
+    /* the rest of the last keystream block */
+    while (n != 0 && length > 0)
+    {
+        *output++ = *input++ ^ stream_block[n];
+        n = (n + 1) & 0x0F;
+        length--;
+    }
+
+    while (length > 0)
+    {
+        /* the counter blocks of the batch are encrypted in one call */
+        blocks = (length + 15) / 16;
+        if (blocks > AES_ALT_BATCH_BLOCKS)
+        {
+            blocks = AES_ALT_BATCH_BLOCKS;
+        }
+        for (i = 0; i < blocks; i++)
+        {
+            memcpy(ks + i * 16, nonce_counter, 16);
+            aes_alt_ctr_inc(nonce_counter);
+        }
+
+        ret = aes_alt_crypt(ctx, HWCRYPTO_TYPE_AES_ECB, MBEDTLS_AES_ENCRYPT, blocks * 16, ks, ks);
+        if (ret != 0)
+        {
+            mbedtls_platform_zeroize(stream, sizeof(stream));
+            return ret;
+        }
+
+        len = length < blocks * 16 ? length : blocks * 16;
+        for (i = 0; i < len; i++)
+        {
+            output[i] = input[i] ^ ks[i];
+        }
+        input += len;
+        output += len;
+        length -= len;
+
+        /* a partial last block is kept for the next call */
+        n = len & 0x0F;
+        if (n != 0)
+        {
+            memcpy(stream_block, ks + (blocks - 1) * 16, 16);
+        }
+    }
+    *nc_off = n;
+    mbedtls_platform_zeroize(stream, sizeof(stream));
+
+    return 0;
+}
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
+
+#endif /* defined(MBEDTLS_AES_C) && defined(MBEDTLS_AES_ALT) */
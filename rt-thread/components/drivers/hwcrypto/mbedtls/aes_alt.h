@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __AES_ALT_H__
+#define __AES_ALT_H__
+
+#include <hwcrypto.h>
+
+#if defined(MBEDTLS_CIPHER_MODE_XTS)
+#error "MBEDTLS_AES_ALT of hwcrypto doesn't support MBEDTLS_CIPHER_MODE_XTS"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief           AES context on the default crypto device.
+ *
+ * The device context is created by the first setkey, the same key is used
+ * in both directions so setkey_enc and setkey_dec only differ in name.
+ */
+typedef struct mbedtls_aes_context
+{
+    struct rt_hwcrypto_ctx *hw;     /**< Symmetric context of the crypto device */
+    unsigned int keybits;           /**< Key length in bits, 0 if no key is set */
+}
+mbedtls_aes_context;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * MBEDTLS_GCM_ALT with the AES on the default crypto device.
+ *
+ * The counter blocks of up to RT_HWCRYPTO_MBEDTLS_BATCH_SIZE bytes are
+ * encrypted in one ECB call of the device, GHASH uses the 4-bit tables.
+ */
+
+#include <rtthread.h>
+#include <hw_symmetric.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include <mbedtls/config.h>
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_GCM_ALT)
+
+#if !defined(MBEDTLS_AES_ALT)
+#error "MBEDTLS_GCM_ALT of hwcrypto requires MBEDTLS_AES_ALT"
+#endif
+
+#include <string.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/platform_util.h>
+
+#ifndef RT_HWCRYPTO_MBEDTLS_BATCH_SIZE
+#define RT_HWCRYPTO_MBEDTLS_BATCH_SIZE  256
+#endif
+
+#define GCM_ALT_BATCH_BLOCKS    (RT_HWCRYPTO_MBEDTLS_BATCH_SIZE / 16)
+
+/* reduction of the 4 bits shifted out of GHASH, x^128 + x^7 + x^2 + x + 1 */
+static const uint16_t gcm_alt_last4[16] =
+{
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static uint64_t gcm_alt_get_be64(const unsigned char *b)
+{
+    return ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) | ((uint64_t)b[3] << 32) |
+           ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) | ((uint64_t)b[6] << 8) | (uint64_t)b[7];
+}
+
+static void gcm_alt_put_be64(uint64_t v, unsigned char *b)
+{
+    int i;
+
+    for (i = 7; i >= 0; i--)
+    {
+        b[i] = (unsigned char)v;
+        v >>= 8;
+    }
+}
+
+/* ECB encrypts the blocks on the device in place */
+static int gcm_alt_ecb(mbedtls_gcm_context *ctx, unsigned char *buf, size_t length)
+{
+    struct rt_hwcrypto_ctx *hw = ctx->aes.hw;
+
+    if (hw == RT_NULL)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+
+    if (hw->type != HWCRYPTO_TYPE_AES_ECB && rt_hwcrypto_symmetric_set_type(hw, HWCRYPTO_TYPE_AES_ECB) != RT_EOK)
+    {
+        return MBEDTLS_ERR_GCM_HW_ACCEL_FAILED;
+    }
+
+    if (rt_hwcrypto_symmetric_crypt(hw, HWCRYPTO_MODE_ENCRYPT, length, buf, buf) != RT_EOK)
+    {
+        return MBEDTLS_ERR_GCM_HW_ACCEL_FAILED;
+    }
+
+    return 0;
+}
+
+/* the multiples of H by the 4-bit values, for the table driven multiplication */
+static void gcm_alt_gen_table(mbedtls_gcm_context *ctx, const unsigned char h[16])
+{
+    uint64_t vh, vl;
+    uint32_t t;
+    int i, j;
+
+    vh = gcm_alt_get_be64(h);
+    vl = gcm_alt_get_be64(h + 8);
+
+    ctx->HL[8] = vl;
+    ctx->HH[8] = vh;
+    ctx->HL[0] = 0;
+    ctx->HH[0] = 0;
+
+    for (i = 4; i > 0; i >>= 1)
+    {
+        t = (vl & 1) * 0xe1000000U;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ ((uint64_t)t << 32);
+
+        ctx->HL[i] = vl;
+        ctx->HH[i] = vh;
+    }
+
+    for (i = 2; i <= 8; i *= 2)
+    {
+        vh = ctx->HH[i];
+        vl = ctx->HL[i];
+        for (j = 1; j < i; j++)
+        {
+            ctx->HH[i + j] = vh ^ ctx->HH[j];
+            ctx->HL[i + j] = vl ^ ctx->HL[j];
+        }
+    }
+}
+
+/* output = x * H in GF(2^128) */
+static void gcm_alt_mult(const mbedtls_gcm_context *ctx, const unsigned char x[16], unsigned char output[16])
+{
+    uint64_t zh, zl;
+    unsigned char lo, hi, rem;
+    int i;
+
+    lo = x[15] & 0x0F;
+    zh = ctx->HH[lo];
+    zl = ctx->HL[lo];
+
+    for (i = 15; i >= 0; i--)
+    {
+        lo = x[i] & 0x0F;
+        hi = (x[i] >> 4) & 0x0F;
+
+        if (i != 15)
+        {
+            rem = (unsigned char)(zl & 0x0F);
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ ((uint64_t)gcm_alt_last4[rem] << 48);
+            zh ^= ctx->HH[lo];
+            zl ^= ctx->HL[lo];
+        }
+
+        rem = (unsigned char)(zl & 0x0F);
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ ((uint64_t)gcm_alt_last4[rem] << 48);
+        zh ^= ctx->HH[hi];
+        zl ^= ctx->HL[hi];
+    }
+
+    gcm_alt_put_be64(zh, output);
+    gcm_alt_put_be64(zl, output + 8);
+}
+
+/* absorbs the data into the GHASH state, a partial last block is zero padded */
+static void gcm_alt_ghash(mbedtls_gcm_context *ctx, const unsigned char *data, size_t length)
+{
+    size_t i, use_len;
+
+    while (length > 0)
+    {
+        use_len = length < 16 ? length : 16;
+        for (i = 0; i < use_len; i++)
+        {
+            ctx->buf[i] ^= data[i];
+        }
+        gcm_alt_mult(ctx, ctx->buf, ctx->buf);
+
+        data += use_len;
+        length -= use_len;
+    }
+}
+
+static void gcm_alt_inc32(unsigned char y[16])
+{
+    int i;
+
+    for (i = 16; i > 12; i--)
+    {
+        if (++y[i - 1] != 0)
+        {
+            break;
+        }
+    }
+}
+
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx)
+{
+    memset(ctx, 0, sizeof(mbedtls_gcm_context));
+    mbedtls_aes_init(&ctx->aes);
+}
+
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher,
+                       const unsigned char *key, unsigned int keybits)
+{
+    rt_uint32_t h[4] = {0};
+    int ret;
+
+    if (cipher != MBEDTLS_CIPHER_ID_AES)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+
+    ret = mbedtls_aes_setkey_enc(&ctx->aes, key, keybits);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    /* H = E(K, 0^128) */
+    ret = gcm_alt_ecb(ctx, (unsigned char *)h, 16);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    gcm_alt_gen_table(ctx, (unsigned char *)h);
+    mbedtls_platform_zeroize(h, sizeof(h));
+
+    return 0;
+}
+
+int mbedtls_gcm_starts(mbedtls_gcm_context *ctx, int mode, const unsigned char *iv, size_t iv_len,
+                       const unsigned char *add, size_t add_len)
+{
+    rt_uint32_t ectr[4];
+    unsigned char work_buf[16];
+    int ret;
+
+    /* IV and AD are limited to 2^64 bits, so 2^61 bytes */
+    if (iv_len == 0 || ((uint64_t)iv_len) >> 61 != 0 || ((uint64_t)add_len) >> 61 != 0)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+
+    memset(ctx->y, 0x00, sizeof(ctx->y));
+    memset(ctx->buf, 0x00, sizeof(ctx->buf));
+    ctx->mode = mode;
+    ctx->len = 0;
+    ctx->add_len = 0;
+
+    if (iv_len == 12)
+    {
+        memcpy(ctx->y, iv, iv_len);
+        ctx->y[15] = 1;
+    }
+    else
+    {
+        gcm_alt_ghash(ctx, iv, iv_len);
+        memset(work_buf, 0x00, 8);
+        gcm_alt_put_be64((uint64_t)iv_len * 8, work_buf + 8);
+        gcm_alt_ghash(ctx, work_buf, 16);
+        memcpy(ctx->y, ctx->buf, 16);
+        memset(ctx->buf, 0x00, sizeof(ctx->buf));
+    }
+
+    memcpy(ectr, ctx->y, 16);
+    ret = gcm_alt_ecb(ctx, (unsigned char *)ectr, 16);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    memcpy(ctx->base_ectr, ectr, 16);
+
+    ctx->add_len = add_len;
+    gcm_alt_ghash(ctx, add, add_len);
+
+    return 0;
+}
+
+int mbedtls_gcm_update(mbedtls_gcm_context *ctx, size_t length, const unsigned char *input, unsigned char *output)
+{
+    rt_uint32_t stream[GCM_ALT_BATCH_BLOCKS * 4];
+    unsigned char *ks = (unsigned char *)stream;
+    size_t blocks, len, i;
+    int ret;
+
+    if (output > input && (size_t)(output - input) < length)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+
+    /* total length is restricted to 2^39 - 256 bits, ie 2^36 - 2^5 bytes */
+    if (ctx->len + length < ctx->len || (uint64_t)ctx->len + length > 0xFFFFFFFE0ull)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+    ctx->len += length;
+
+    while (length > 0)
+    {
+        /* the counter blocks of the batch are encrypted in one call */
+        blocks = (length + 15) / 16;
+        if (blocks > GCM_ALT_BATCH_BLOCKS)
+        {
+            blocks = GCM_ALT_BATCH_BLOCKS;
+        }
+        for (i = 0; i < blocks; i++)
+        {
+            gcm_alt_inc32(ctx->y);
+            memcpy(ks + i * 16, ctx->y, 16);
+        }
+
+        ret = gcm_alt_ecb(ctx, ks, blocks * 16);
+        if (ret != 0)
+        {
+            mbedtls_platform_zeroize(stream, sizeof(stream));
+            return ret;
+        }
+
+        len = length < blocks * 16 ? length : blocks * 16;
+        if (ctx->mode == MBEDTLS_GCM_DECRYPT)
+        {
+            gcm_alt_ghash(ctx, input, len);
+        }
+        for (i = 0; i < len; i++)
+        {
+            output[i] = input[i] ^ ks[i];
+        }
+        if (ctx->mode == MBEDTLS_GCM_ENCRYPT)
+        {
+            gcm_alt_ghash(ctx, output, len);
+        }
+
+        input += len;
+        output += len;
+        length -= len;
+    }
+    mbedtls_platform_zeroize(stream, sizeof(stream));
+
+    return 0;
+}
+
+int mbedtls_gcm_finish(mbedtls_gcm_context *ctx, unsigned char *tag, size_t tag_len)
+{
+    unsigned char work_buf[16];
+    size_t i;
+
+    if (tag_len > 16 || tag_len < 4)
+    {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+
+    memcpy(tag, ctx->base_ectr, tag_len);
+
+    if (ctx->len != 0 || ctx->add_len != 0)
+    {
+        gcm_alt_put_be64(ctx->add_len * 8, work_buf);
+        gcm_alt_put_be64(ctx->len * 8, work_buf + 8);
+        gcm_alt_ghash(ctx, work_buf, 16);
+
+        for (i = 0; i < tag_len; i++)
+        {
+            tag[i] ^= ctx->buf[i];
+        }
+    }
+
+    return 0;
+}
+
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length,
+                              const unsigned char *iv, size_t iv_len,
+                              const unsigned char *add, size_t add_len,
+                              const unsigned char *input, unsigned char *output,
+                              size_t tag_len, unsigned char *tag)
+{
+    int ret;
+
+    ret = mbedtls_gcm_starts(ctx, mode, iv, iv_len, add, add_len);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    ret = mbedtls_gcm_update(ctx, length, input, output);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    return mbedtls_gcm_finish(ctx, tag, tag_len);
+}
+
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length,
+                             const unsigned char *iv, size_t iv_len,
+                             const unsigned char *add, size_t add_len,
+                             const unsigned char *tag, size_t tag_len,
+                             const unsigned char *input, unsigned char *output)
+{
+    unsigned char check_tag[16];
+    unsigned char diff = 0;
+    size_t i;
+    int ret;
+
+    ret = mbedtls_gcm_crypt_and_tag(ctx, MBEDTLS_GCM_DECRYPT, length, iv, iv_len, add, add_len,
+                                    input, output, tag_len, check_tag);
+    if (ret != 0)
+    {
+        return ret;
+    }
+
+    /* check the tag in constant time */
+    for (i = 0; i < tag_len; i++)
+    {
+        diff |= tag[i] ^ check_tag[i];
+    }
+
+    if (diff != 0)
+    {
+        mbedtls_platform_zeroize(output, length);
+        return MBEDTLS_ERR_GCM_AUTH_FAILED;
+    }
+
+    return 0;
+}
+
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    mbedtls_aes_free(&ctx->aes);
+    mbedtls_platform_zeroize(ctx, sizeof(mbedtls_gcm_context));
+}
+
+#endif /* defined(MBEDTLS_GCM_C) && defined(MBEDTLS_GCM_ALT) */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __GCM_ALT_H__
+#define __GCM_ALT_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/aes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief           AES-GCM context. The keystream is run on the crypto
+ *                  device through the AES context, GHASH is table driven.
+ */
+typedef struct mbedtls_gcm_context
+{
+    mbedtls_aes_context aes;        /**< Block cipher of the key */
+    uint64_t HL[16];                /**< GHASH table, low halves of the multiples of H */
+    uint64_t HH[16];                /**< GHASH table, high halves of the multiples of H */
+    uint64_t len;                   /**< Length of the encrypted data */
+    uint64_t add_len;               /**< Length of the additional data */
+    unsigned char base_ectr[16];    /**< E(K, Y0), masks the tag */
+    unsigned char y[16];            /**< Counter block */
+    unsigned char buf[16];          /**< GHASH state */
+    int mode;                       /**< MBEDTLS_GCM_ENCRYPT or MBEDTLS_GCM_DECRYPT */
+}
+mbedtls_gcm_context;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
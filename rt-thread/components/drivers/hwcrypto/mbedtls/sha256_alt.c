@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * MBEDTLS_SHA256_ALT on the software crypto device. Its hash context holds the
+ * whole state, the engines keeping the digest in their registers don't survive
+ * the interleaved contexts of a TLS handshake.
+ */
+
+#include <rtthread.h>
+#include <hw_hash.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include <mbedtls/config.h>
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_SHA256_C) && defined(MBEDTLS_SHA256_ALT)
+
+#include <string.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/platform_util.h>
+
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
+{
+    memset(ctx, 0, sizeof(mbedtls_sha256_context));
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    if (ctx->hw != RT_NULL)
+    {
+        rt_hwcrypto_hash_destroy(ctx->hw);
+    }
+    mbedtls_platform_zeroize(ctx, sizeof(mbedtls_sha256_context));
+}
+
+void mbedtls_sha256_clone(mbedtls_sha256_context *dst, const mbedtls_sha256_context *src)
+{
+    if (src->hw == RT_NULL)
+    {
+        return;
+    }
+
+    if (dst->hw == RT_NULL)
+    {
+        dst->hw = rt_hwcrypto_hash_create(src->hw->device, src->hw->type);
+        if (dst->hw == RT_NULL)
+        {
+            return;
+        }
+    }
+
+    /* the TLS handshake clones the running checksum to compute the Finished */
+    rt_hwcrypto_hash_cpy(dst->hw, src->hw);
+    dst->is224 = src->is224;
+}
+
+int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224)
+{
+    struct rt_hwcrypto_device *dev;
+    hwcrypto_type type = is224 ? HWCRYPTO_TYPE_SHA224 : HWCRYPTO_TYPE_SHA256;
+
+    if (ctx->hw == RT_NULL)
+    {
+        dev = (struct rt_hwcrypto_device *)rt_device_find(RT_HWCRYPTO_SOFT_NAME);
+        if (dev == RT_NULL)
+        {
+            return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
+        }
+        ctx->hw = rt_hwcrypto_hash_create(dev, type);
+        if (ctx->hw == RT_NULL)
+        {
+            return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
+        }
+    }
+    else
+    {
+        /* the reset loads the initial hash value of the type, SHA-224 and SHA-256 differ */
+        if (rt_hwcrypto_hash_set_type(ctx->hw, type) != RT_EOK)
+        {
+            return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
+        }
+        rt_hwcrypto_hash_reset(ctx->hw);
+    }
+    ctx->is224 = is224;
+
+    return 0;
+}
+
+int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
+{
+    if (ctx->hw == RT_NULL)
+    {
+        return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+    }
+    if (ilen == 0)
+    {
+        return 0;
+    }
+
+    if (rt_hwcrypto_hash_update(ctx->hw, input, ilen) != RT_EOK)
+    {
+        return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
+    }
+
+    return 0;
+}
+
+int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[32])
+{
+    if (ctx->hw == RT_NULL)
+    {
+        return MBEDTLS_ERR_SHA256_BAD_INPUT_DATA;
+    }
+
+    if (rt_hwcrypto_hash_finish(ctx->hw, output, ctx->is224 ? 28 : 32) != RT_EOK)
+    {
+        return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
+    }
+
+    return 0;
+}
+
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64])
+{
+    return mbedtls_sha256_update_ret(ctx, data, 64);
+}
+
+#if !defined(MBEDTLS_DEPRECATED_REMOVED)
+void mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224)
+{
+    mbedtls_sha256_starts_ret(ctx, is224);
+}
+
+void mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
+{
+    mbedtls_sha256_update_ret(ctx, input, ilen);
+}
+
+void mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char output[32])
+{
+    mbedtls_sha256_finish_ret(ctx, output);
+}
+
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64])
+{
+    mbedtls_internal_sha256_process(ctx, data);
+}
+#endif /* !MBEDTLS_DEPRECATED_REMOVED */
+
+#endif /* defined(MBEDTLS_SHA256_C) && defined(MBEDTLS_SHA256_ALT) */
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __SHA256_ALT_H__
+#define __SHA256_ALT_H__
+
+#include <hwcrypto.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief           SHA-224/SHA-256 context on the default crypto device.
+ */
+typedef struct mbedtls_sha256_context
+{
+    struct rt_hwcrypto_ctx *hw;     /**< Hash context of the crypto device */
+    int is224;                      /**< 0 for SHA-256, 1 for SHA-224 */
+}
+mbedtls_sha256_context;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Tests of the mbedTLS AES, GCM and SHA-256 ALT on the swcrypto device: the
+ * known answers of the mbedTLS self tests, then ALT_TEST_ROUNDS random keys
+ * and messages, each processed in one call and in random pieces. The pieces
+ * must give the same output and leave the same IV, offset and counter for
+ * the next call, a cloned SHA-256 context must continue on its own.
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+
+#include <mbedtls/aes.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/sha256.h>
+
+#ifndef ALT_TEST_ROUNDS
+#define ALT_TEST_ROUNDS     200
+#endif
+#define ALT_TEST_MAX_LEN    2048
+
+static rt_uint32_t lcg = 12345;
+static int failed;
+
+static rt_uint32_t test_rand(void)
+{
+    lcg = lcg * 1103515245u + 12345u;
+    return lcg >> 8;
+}
+
+static void test_fill(unsigned char *buf, size_t len)
+{
+    while (len--)
+    {
+        *buf++ = (unsigned char)test_rand();
+    }
+}
+
+/* the length of the next piece of len Bytes at pos, a multiple of align but the last one */
+static size_t test_piece(size_t pos, size_t len, size_t align)
+{
+    size_t n = (test_rand() % 300 + 1) * align;
+
+    return n < len - pos ? n : len - pos;
+}
+
+#define TEST_CHECK(x)                                                       \
+    do                                                                      \
+    {                                                                       \
+        if (!(x))                                                           \
+        {                                                                   \
+            printf("round %d: check failed: %s, line %d\n", round, #x, __LINE__); \
+            failed++;                                                       \
+        }                                                                   \
+    } while (0)
+
+/* the modes with an IV and an offset carried from call to call */
+static void test_aes_stream(int round, const unsigned char *key, unsigned int keybits, size_t len)
+{
+    static unsigned char in[ALT_TEST_MAX_LEN], one[ALT_TEST_MAX_LEN], split[ALT_TEST_MAX_LEN], back[ALT_TEST_MAX_LEN];
+    unsigned char iv[16], iv1[16], iv2[16], block1[16], block2[16];
+    mbedtls_aes_context one_ctx, split_ctx;
+    size_t off1, off2, pos, n;
+    int mode;
+
+    test_fill(in, len);
+    test_fill(iv, sizeof(iv));
+    /* the counter wraps in the low 32 bits within the message */
+    iv[12] = iv[13] = iv[14] = 0xFF;
+
+    mbedtls_aes_init(&one_ctx);
+    mbedtls_aes_init(&split_ctx);
+    TEST_CHECK(mbedtls_aes_setkey_enc(&one_ctx, key, keybits) == 0);
+    TEST_CHECK(mbedtls_aes_setkey_enc(&split_ctx, key, keybits) == 0);
+
+    /* CTR */
+    memcpy(iv1, iv, 16);
+    memcpy(iv2, iv, 16);
+    off1 = off2 = 0;
+    TEST_CHECK(mbedtls_aes_crypt_ctr(&one_ctx, len, &off1, iv1, block1, in, one) == 0);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 1);
+        TEST_CHECK(mbedtls_aes_crypt_ctr(&split_ctx, n, &off2, iv2, block2, in + pos, split + pos) == 0);
+    }
+    TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(iv1, iv2, 16) == 0 && off1 == off2);
+    memcpy(iv1, iv, 16);
+    off1 = 0;
+    TEST_CHECK(mbedtls_aes_crypt_ctr(&one_ctx, len, &off1, iv1, block1, one, back) == 0);
+    TEST_CHECK(memcmp(back, in, len) == 0);
+
+    /* CFB128 and CFB8 decrypt with the encryption key */
+    for (mode = MBEDTLS_AES_DECRYPT; mode <= MBEDTLS_AES_ENCRYPT; mode++)
+    {
+        memcpy(iv1, iv, 16);
+        memcpy(iv2, iv, 16);
+        off1 = off2 = 0;
+        TEST_CHECK(mbedtls_aes_crypt_cfb128(&one_ctx, mode, len, &off1, iv1, in, one) == 0);
+        for (pos = 0; pos < len; pos += n)
+        {
+            n = test_piece(pos, len, 1);
+            TEST_CHECK(mbedtls_aes_crypt_cfb128(&split_ctx, mode, n, &off2, iv2, in + pos, split + pos) == 0);
+        }
+        TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(iv1, iv2, 16) == 0 && off1 == off2);
+
+        memcpy(iv1, iv, 16);
+        memcpy(iv2, iv, 16);
+        TEST_CHECK(mbedtls_aes_crypt_cfb8(&one_ctx, mode, len, iv1, in, one) == 0);
+        for (pos = 0; pos < len; pos += n)
+        {
+            n = test_piece(pos, len, 1);
+            TEST_CHECK(mbedtls_aes_crypt_cfb8(&split_ctx, mode, n, iv2, in + pos, split + pos) == 0);
+        }
+        TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(iv1, iv2, 16) == 0);
+    }
+    memcpy(iv1, iv, 16);
+    off1 = 0;
+    TEST_CHECK(mbedtls_aes_crypt_cfb128(&one_ctx, MBEDTLS_AES_ENCRYPT, len, &off1, iv1, in, one) == 0);
+    memcpy(iv1, iv, 16);
+    off1 = 0;
+    TEST_CHECK(mbedtls_aes_crypt_cfb128(&one_ctx, MBEDTLS_AES_DECRYPT, len, &off1, iv1, one, back) == 0);
+    TEST_CHECK(memcmp(back, in, len) == 0);
+
+    /* OFB */
+    memcpy(iv1, iv, 16);
+    memcpy(iv2, iv, 16);
+    off1 = off2 = 0;
+    TEST_CHECK(mbedtls_aes_crypt_ofb(&one_ctx, len, &off1, iv1, in, one) == 0);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 1);
+        TEST_CHECK(mbedtls_aes_crypt_ofb(&split_ctx, n, &off2, iv2, in + pos, split + pos) == 0);
+    }
+    TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(iv1, iv2, 16) == 0 && off1 == off2);
+
+    /* CBC in whole blocks, decrypted with the decryption key */
+    len &= ~(size_t)15;
+    memcpy(iv1, iv, 16);
+    memcpy(iv2, iv, 16);
+    TEST_CHECK(mbedtls_aes_crypt_cbc(&one_ctx, MBEDTLS_AES_ENCRYPT, len, iv1, in, one) == 0);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 16);
+        TEST_CHECK(mbedtls_aes_crypt_cbc(&split_ctx, MBEDTLS_AES_ENCRYPT, n, iv2, in + pos, split + pos) == 0);
+    }
+    TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(iv1, iv2, 16) == 0);
+    TEST_CHECK(mbedtls_aes_setkey_dec(&split_ctx, key, keybits) == 0);
+    memcpy(iv2, iv, 16);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 16);
+        TEST_CHECK(mbedtls_aes_crypt_cbc(&split_ctx, MBEDTLS_AES_DECRYPT, n, iv2, one + pos, back + pos) == 0);
+    }
+    TEST_CHECK(memcmp(back, in, len) == 0 && memcmp(iv1, iv2, 16) == 0);
+    TEST_CHECK(mbedtls_aes_crypt_cbc(&split_ctx, MBEDTLS_AES_DECRYPT, 15, iv2, one, back) == MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
+
+    mbedtls_aes_free(&one_ctx);
+    mbedtls_aes_free(&split_ctx);
+}
+
+static void test_gcm(int round, const unsigned char *key, unsigned int keybits, size_t len)
+{
+    static unsigned char in[ALT_TEST_MAX_LEN], one[ALT_TEST_MAX_LEN], split[ALT_TEST_MAX_LEN], back[ALT_TEST_MAX_LEN];
+    unsigned char iv[64], add[64], tag1[16], tag2[16];
+    size_t iv_len, add_len, tag_len, pos, n;
+    mbedtls_gcm_context ctx;
+
+    test_fill(in, len);
+    /* the 12 Bytes IV of TLS mostly, the others are hashed to the counter */
+    iv_len = (round % 4) ? 12 : test_rand() % sizeof(iv) + 1;
+    add_len = test_rand() % (sizeof(add) + 1);
+    tag_len = test_rand() % 13 + 4;
+    test_fill(iv, iv_len);
+    test_fill(add, add_len);
+
+    mbedtls_gcm_init(&ctx);
+    TEST_CHECK(mbedtls_gcm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key, keybits) == 0);
+    TEST_CHECK(mbedtls_gcm_crypt_and_tag(&ctx, MBEDTLS_GCM_ENCRYPT, len, iv, iv_len, add, add_len,
+                                         in, one, tag_len, tag1) == 0);
+
+    /* the updates but the last one are whole blocks */
+    TEST_CHECK(mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_ENCRYPT, iv, iv_len, add, add_len) == 0);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 16);
+        TEST_CHECK(mbedtls_gcm_update(&ctx, n, in + pos, split + pos) == 0);
+    }
+    TEST_CHECK(mbedtls_gcm_finish(&ctx, tag2, tag_len) == 0);
+    TEST_CHECK(memcmp(one, split, len) == 0 && memcmp(tag1, tag2, tag_len) == 0);
+
+    TEST_CHECK(mbedtls_gcm_auth_decrypt(&ctx, len, iv, iv_len, add, add_len, tag1, tag_len, one, back) == 0);
+    TEST_CHECK(memcmp(back, in, len) == 0);
+    tag1[test_rand() % tag_len] ^= 0x01;
+    TEST_CHECK(mbedtls_gcm_auth_decrypt(&ctx, len, iv, iv_len, add, add_len, tag1, tag_len, one, back) ==
+               MBEDTLS_ERR_GCM_AUTH_FAILED);
+
+    mbedtls_gcm_free(&ctx);
+}
+
+static void test_sha256(int round, size_t len)
+{
+    static unsigned char in[ALT_TEST_MAX_LEN];
+    unsigned char one[32], split[32], cloned[32];
+    mbedtls_sha256_context ctx, clone;
+    size_t pos, n, cut;
+    int is224 = round & 1;
+
+    test_fill(in, len);
+    cut = len ? test_rand() % len : 0;
+    TEST_CHECK(mbedtls_sha256_ret(in, len, one, is224) == 0);
+
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_init(&clone);
+    TEST_CHECK(mbedtls_sha256_starts_ret(&ctx, is224) == 0);
+    for (pos = 0; pos < cut; pos += n)
+    {
+        n = test_piece(pos, cut, 1);
+        TEST_CHECK(mbedtls_sha256_update_ret(&ctx, in + pos, n) == 0);
+    }
+    /* the clone finishes the message, the original is fed garbage first */
+    mbedtls_sha256_clone(&clone, &ctx);
+    TEST_CHECK(mbedtls_sha256_update_ret(&clone, in + cut, len - cut) == 0);
+    TEST_CHECK(mbedtls_sha256_update_ret(&ctx, (const unsigned char *)"x", 1) == 0);
+    TEST_CHECK(mbedtls_sha256_finish_ret(&clone, cloned) == 0);
+    TEST_CHECK(mbedtls_sha256_finish_ret(&ctx, split) == 0);
+    TEST_CHECK(memcmp(one, cloned, is224 ? 28 : 32) == 0);
+    TEST_CHECK(memcmp(one, split, is224 ? 28 : 32) != 0);
+
+    /* the context restarts after finish */
+    TEST_CHECK(mbedtls_sha256_starts_ret(&ctx, is224) == 0);
+    for (pos = 0; pos < len; pos += n)
+    {
+        n = test_piece(pos, len, 1);
+        TEST_CHECK(mbedtls_sha256_update_ret(&ctx, in + pos, n) == 0);
+    }
+    TEST_CHECK(mbedtls_sha256_finish_ret(&ctx, split) == 0);
+    TEST_CHECK(memcmp(one, split, is224 ? 28 : 32) == 0);
+
+    mbedtls_sha256_free(&ctx);
+    mbedtls_sha256_free(&clone);
+}
+
+int main(void)
+{
+    static const unsigned int keybits[] = {128, 192, 256};
+    unsigned char key[32];
+    size_t len;
+    int round = 0;
+
+    if (host_crypto_init() != RT_EOK)
+    {
+        printf("swcrypto registration failed\n");
+        return 1;
+    }
+
+    TEST_CHECK(mbedtls_aes_self_test(1) == 0);
+    TEST_CHECK(mbedtls_gcm_self_test(1) == 0);
+    TEST_CHECK(mbedtls_sha256_self_test(1) == 0);
+
+    for (round = 0; round < ALT_TEST_ROUNDS; round++)
+    {
+        test_fill(key, sizeof(key));
+        len = test_rand() % (ALT_TEST_MAX_LEN + 1);
+        test_aes_stream(round, key, keybits[round % 3], len);
+        test_gcm(round, key, keybits[round % 3], len);
+        test_sha256(round, len);
+    }
+
+    printf("%d rounds, %s\n", ALT_TEST_ROUNDS, failed ? "FAILED" : "OK");
+    return failed != 0;
+}
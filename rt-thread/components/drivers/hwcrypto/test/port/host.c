@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The kernel services the crypto device framework needs on the build host:
+ * the heap is the C library one, the device table a list of names and there
+ * are no interrupts to mask.
+ */
+
+#include <rtthread.h>
+#include <rthw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "host.h"
+
+/* the software device registers itself from INIT_DEVICE_EXPORT on the target */
+#include "hw_soft.c"
+
+static rt_device_t host_devices;
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    return calloc(count, size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+rt_base_t rt_hw_interrupt_disable(void)
+{
+    return 0;
+}
+
+void rt_hw_interrupt_enable(rt_base_t level)
+{
+    (void)level;
+}
+
+void rt_assert_handler(const char *ex, const char *func, rt_size_t line)
+{
+    printf("(%s) assertion failed at function:%s, line number:%d\n", ex, func, (int)line);
+    abort();
+}
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (rt_device_find(name) != RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+
+    rt_strncpy(dev->parent.name, name, RT_NAME_MAX - 1);
+    dev->flag = flags;
+    /* the list is linked through the object list node, unused on the host */
+    dev->parent.list.next = (rt_list_t *)host_devices;
+    host_devices = dev;
+
+    return RT_EOK;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+    rt_device_t dev;
+
+    for (dev = host_devices; dev != RT_NULL; dev = (rt_device_t)dev->parent.list.next)
+    {
+        if (rt_strncmp(dev->parent.name, name, RT_NAME_MAX) == 0)
+        {
+            return dev;
+        }
+    }
+
+    return RT_NULL;
+}
+
+int host_crypto_init(void)
+{
+    return rt_hwcrypto_soft_init();
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+/* registers the swcrypto device, the host build runs no INIT_DEVICE_EXPORT */
+int host_crypto_init(void);
+
+#endif
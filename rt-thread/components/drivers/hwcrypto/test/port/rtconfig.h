@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/* The configuration of the host build, the crypto device is swcrypto */
+
+#ifndef RT_CONFIG_H__
+#define RT_CONFIG_H__
+
+#define RT_NAME_MAX 16
+#define RT_ALIGN_SIZE 8
+#define RT_THREAD_PRIORITY_32
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_TICK_PER_SECOND 1000
+#define RT_USING_SEMAPHORE
+#define RT_USING_MUTEX
+#define RT_USING_EVENT
+#define RT_USING_MAILBOX
+#define RT_USING_MESSAGEQUEUE
+#define RT_USING_HEAP
+#define RT_USING_DEVICE
+#define RT_KSERVICE_USING_STDLIB
+#define RT_KSERVICE_USING_STDLIB_MEMORY
+
+#define RT_USING_HWCRYPTO
+#define RT_HWCRYPTO_DEFAULT_NAME "hwcryto"
+#define RT_HWCRYPTO_USING_SOFT
+#define RT_HWCRYPTO_USING_MBEDTLS_ALT
+#define RT_HWCRYPTO_MBEDTLS_AES_ALT
+#define RT_HWCRYPTO_MBEDTLS_GCM_ALT
+#define RT_HWCRYPTO_MBEDTLS_SHA256_ALT
+#ifndef RT_HWCRYPTO_MBEDTLS_BATCH_SIZE
+#define RT_HWCRYPTO_MBEDTLS_BATCH_SIZE 256
+#endif
+
+#endif
@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The host counterpart of sal_tls_bench: a TLS 1.2 client and server in one
+ * process, connected by memory pipes, with AES, GCM and SHA-256 on the
+ * swcrypto device. For each cipher suite it times TLS_BENCH_HANDSHAKES full
+ * handshakes, as many resumed from the server session cache, and the bulk
+ * transfer of TLS_BENCH_KB from the client to the server. The times are the
+ * work of both ends. It fails if a resumption isn't served from the cache or
+ * the received data differ from the sent.
+ */
+
+#include <rtthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include <mbedtls/config.h>
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include <mbedtls/certs.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/x509_crt.h>
+
+#ifndef TLS_BENCH_HANDSHAKES
+#define TLS_BENCH_HANDSHAKES    10
+#endif
+#ifndef TLS_BENCH_KB
+#define TLS_BENCH_KB            4096
+#endif
+/* the record size of sal_tls_bench */
+#define TLS_BENCH_CHUNK         1024
+#define TLS_BENCH_PIPE_SIZE     (32 * 1024)
+#define TLS_BENCH_HOST          "localhost"
+
+/* one direction of the connection */
+struct tls_bench_pipe
+{
+    unsigned char buf[TLS_BENCH_PIPE_SIZE];
+    size_t head;
+    size_t len;
+};
+
+/* an end of the connection, it sends to tx and receives from rx */
+struct tls_bench_end
+{
+    mbedtls_ssl_context ssl;
+    struct tls_bench_pipe *tx;
+    struct tls_bench_pipe *rx;
+};
+
+static struct tls_bench_pipe to_server, to_client;
+static mbedtls_ctr_drbg_context drbg;
+static mbedtls_x509_crt ca_crt, srv_crt;
+static mbedtls_pk_context srv_key;
+static mbedtls_ssl_cache_context cache;
+static rt_uint32_t cache_hits;
+static rt_uint32_t lcg = 12345;
+
+static const char *tls_bench_suites[] =
+{
+    "TLS-ECDHE-ECDSA-WITH-AES-128-GCM-SHA256",
+    "TLS-ECDHE-ECDSA-WITH-AES-128-CBC-SHA256",
+};
+
+/* a reproducible run, the bench doesn't need real entropy */
+static int tls_bench_entropy(void *data, unsigned char *output, size_t len)
+{
+    (void)data;
+    while (len--)
+    {
+        lcg = lcg * 1103515245u + 12345u;
+        *output++ = (unsigned char)(lcg >> 16);
+    }
+    return 0;
+}
+
+static double tls_bench_ms(const struct timespec *t0)
+{
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (t1.tv_sec - t0->tv_sec) * 1e3 + (t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+static int tls_bench_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    struct tls_bench_pipe *pipe = ((struct tls_bench_end *)ctx)->tx;
+    size_t n, i;
+
+    n = TLS_BENCH_PIPE_SIZE - pipe->len;
+    if (n == 0)
+    {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+    if (n > len)
+    {
+        n = len;
+    }
+    for (i = 0; i < n; i++)
+    {
+        pipe->buf[(pipe->head + pipe->len + i) % TLS_BENCH_PIPE_SIZE] = buf[i];
+    }
+    pipe->len += n;
+
+    return (int)n;
+}
+
+static int tls_bench_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    struct tls_bench_pipe *pipe = ((struct tls_bench_end *)ctx)->rx;
+    size_t n, i;
+
+    if (pipe->len == 0)
+    {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    n = pipe->len < len ? pipe->len : len;
+    for (i = 0; i < n; i++)
+    {
+        buf[i] = pipe->buf[(pipe->head + i) % TLS_BENCH_PIPE_SIZE];
+    }
+    pipe->head = (pipe->head + n) % TLS_BENCH_PIPE_SIZE;
+    pipe->len -= n;
+
+    return (int)n;
+}
+
+/* the test certificates of the older mbedTLS releases are expired, the time isn't what's measured */
+static int tls_bench_verify(void *data, mbedtls_x509_crt *crt, int depth, uint32_t *flags)
+{
+    (void)data;
+    (void)crt;
+    (void)depth;
+    *flags &= ~(MBEDTLS_X509_BADCERT_EXPIRED | MBEDTLS_X509_BADCERT_FUTURE);
+    return 0;
+}
+
+/* counts the sessions the server resumes */
+static int tls_bench_cache_get(void *data, mbedtls_ssl_session *session)
+{
+    int ret = mbedtls_ssl_cache_get(data, session);
+
+    if (ret == 0)
+    {
+        cache_hits++;
+    }
+    return ret;
+}
+
+static int tls_bench_setup(const char *suite, mbedtls_ssl_config *cli_conf, mbedtls_ssl_config *srv_conf, int *suites)
+{
+    suites[0] = mbedtls_ssl_get_ciphersuite_id(suite);
+    suites[1] = 0;
+    if (suites[0] == 0)
+    {
+        return -1;
+    }
+
+    mbedtls_ssl_config_init(cli_conf);
+    mbedtls_ssl_config_init(srv_conf);
+    if (mbedtls_ssl_config_defaults(cli_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0 ||
+        mbedtls_ssl_config_defaults(srv_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0)
+    {
+        return -1;
+    }
+
+    mbedtls_ssl_conf_rng(cli_conf, mbedtls_ctr_drbg_random, &drbg);
+    mbedtls_ssl_conf_authmode(cli_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(cli_conf, &ca_crt, RT_NULL);
+    mbedtls_ssl_conf_verify(cli_conf, tls_bench_verify, RT_NULL);
+    mbedtls_ssl_conf_ciphersuites(cli_conf, suites);
+
+    mbedtls_ssl_conf_rng(srv_conf, mbedtls_ctr_drbg_random, &drbg);
+    mbedtls_ssl_conf_session_cache(srv_conf, &cache, tls_bench_cache_get, mbedtls_ssl_cache_set);
+    mbedtls_ssl_conf_ciphersuites(srv_conf, suites);
+
+    return mbedtls_ssl_conf_own_cert(srv_conf, &srv_crt, &srv_key);
+}
+
+/* runs both ends until the handshake completes */
+static int tls_bench_handshake(struct tls_bench_end *cli, struct tls_bench_end *srv)
+{
+    int cli_ret = -1, srv_ret = -1;
+
+    while (cli_ret != 0 || srv_ret != 0)
+    {
+        if (cli_ret != 0)
+        {
+            cli_ret = mbedtls_ssl_handshake(&cli->ssl);
+        }
+        if (srv_ret != 0)
+        {
+            srv_ret = mbedtls_ssl_handshake(&srv->ssl);
+        }
+        if ((cli_ret != 0 && cli_ret != MBEDTLS_ERR_SSL_WANT_READ && cli_ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+            (srv_ret != 0 && srv_ret != MBEDTLS_ERR_SSL_WANT_READ && srv_ret != MBEDTLS_ERR_SSL_WANT_WRITE))
+        {
+            printf("handshake failed: client -0x%04x, server -0x%04x\n", -cli_ret, -srv_ret);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* connects, with the saved session if resume, and returns the handshake time */
+static double tls_bench_connect(struct tls_bench_end *cli, struct tls_bench_end *srv,
+                                mbedtls_ssl_config *cli_conf, mbedtls_ssl_config *srv_conf,
+                                mbedtls_ssl_session *saved, int resume)
+{
+    struct timespec t0;
+    double ms;
+
+    memset(&to_server, 0, sizeof(to_server));
+    memset(&to_client, 0, sizeof(to_client));
+    mbedtls_ssl_init(&cli->ssl);
+    mbedtls_ssl_init(&srv->ssl);
+    if (mbedtls_ssl_setup(&cli->ssl, cli_conf) != 0 || mbedtls_ssl_setup(&srv->ssl, srv_conf) != 0 ||
+        mbedtls_ssl_set_hostname(&cli->ssl, TLS_BENCH_HOST) != 0)
+    {
+        return -1;
+    }
+    mbedtls_ssl_set_bio(&cli->ssl, cli, tls_bench_send, tls_bench_recv, RT_NULL);
+    mbedtls_ssl_set_bio(&srv->ssl, srv, tls_bench_send, tls_bench_recv, RT_NULL);
+    if (resume && mbedtls_ssl_set_session(&cli->ssl, saved) != 0)
+    {
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    if (tls_bench_handshake(cli, srv) != 0)
+    {
+        return -1;
+    }
+    ms = tls_bench_ms(&t0);
+
+    if (!resume)
+    {
+        mbedtls_ssl_session_free(saved);
+        mbedtls_ssl_session_init(saved);
+        if (mbedtls_ssl_get_session(&cli->ssl, saved) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return ms;
+}
+
+static void tls_bench_close(struct tls_bench_end *cli, struct tls_bench_end *srv)
+{
+    mbedtls_ssl_free(&cli->ssl);
+    mbedtls_ssl_free(&srv->ssl);
+}
+
+/* sends TLS_BENCH_KB from the client to the server, returns the time */
+static double tls_bench_bulk(struct tls_bench_end *cli, struct tls_bench_end *srv)
+{
+    static unsigned char tx[TLS_BENCH_CHUNK], rx[TLS_BENCH_CHUNK];
+    size_t sent = 0, received = 0, total = (size_t)TLS_BENCH_KB * 1024;
+    struct timespec t0;
+    int ret, i;
+
+    for (i = 0; i < TLS_BENCH_CHUNK; i++)
+    {
+        tx[i] = (unsigned char)i;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    while (received < total)
+    {
+        /* fill the pipe, then drain it */
+        while (sent < total)
+        {
+            ret = mbedtls_ssl_write(&cli->ssl, tx + sent % TLS_BENCH_CHUNK, TLS_BENCH_CHUNK - sent % TLS_BENCH_CHUNK);
+            if (ret == MBEDTLS_ERR_SSL_WANT_WRITE)
+            {
+                break;
+            }
+            if (ret < 0)
+            {
+                printf("write failed: -0x%04x\n", -ret);
+                return -1;
+            }
+            sent += ret;
+        }
+        while ((ret = mbedtls_ssl_read(&srv->ssl, rx, sizeof(rx))) > 0)
+        {
+            for (i = 0; i < ret; i++)
+            {
+                if (rx[i] != (unsigned char)(received + i))
+                {
+                    printf("data differ at %u\n", (unsigned)(received + i));
+                    return -1;
+                }
+            }
+            received += ret;
+        }
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ)
+        {
+            printf("read failed: -0x%04x\n", -ret);
+            return -1;
+        }
+    }
+
+    return tls_bench_ms(&t0);
+}
+
+static int tls_bench_suite(const char *suite)
+{
+    struct tls_bench_end cli = {.tx = &to_server, .rx = &to_client};
+    struct tls_bench_end srv = {.tx = &to_client, .rx = &to_server};
+    mbedtls_ssl_config cli_conf, srv_conf;
+    mbedtls_ssl_session saved;
+    double full = 0, resumed = 0, bulk = 0, ms;
+    rt_uint32_t hits;
+    int suites[2], i, ret = -1;
+
+    mbedtls_ssl_session_init(&saved);
+    if (tls_bench_setup(suite, &cli_conf, &srv_conf, suites) != 0)
+    {
+        printf("%s: setup failed\n", suite);
+        goto __exit;
+    }
+
+    for (i = 0; i < 2 * TLS_BENCH_HANDSHAKES; i++)
+    {
+        hits = cache_hits;
+        ms = tls_bench_connect(&cli, &srv, &cli_conf, &srv_conf, &saved, i >= TLS_BENCH_HANDSHAKES);
+        if (ms < 0 || strcmp(mbedtls_ssl_get_ciphersuite(&cli.ssl), suite) != 0)
+        {
+            printf("%s: handshake %d failed\n", suite, i);
+            tls_bench_close(&cli, &srv);
+            goto __exit;
+        }
+        if (cache_hits - hits != (i >= TLS_BENCH_HANDSHAKES))
+        {
+            printf("%s: handshake %d %s resumed\n", suite, i, cache_hits == hits ? "not" : "unexpectedly");
+            tls_bench_close(&cli, &srv);
+            goto __exit;
+        }
+        if (i < TLS_BENCH_HANDSHAKES)
+        {
+            full += ms;
+        }
+        else
+        {
+            resumed += ms;
+        }
+
+        if (i == 2 * TLS_BENCH_HANDSHAKES - 1)
+        {
+            bulk = tls_bench_bulk(&cli, &srv);
+            if (bulk < 0)
+            {
+                tls_bench_close(&cli, &srv);
+                goto __exit;
+            }
+        }
+        tls_bench_close(&cli, &srv);
+    }
+
+    printf("%-40s %8.2f %8.2f %10.0f\n", suite, full / TLS_BENCH_HANDSHAKES,
+           resumed / TLS_BENCH_HANDSHAKES, TLS_BENCH_KB * 1e3 / bulk);
+    ret = 0;
+
+__exit:
+    mbedtls_ssl_session_free(&saved);
+    mbedtls_ssl_config_free(&cli_conf);
+    mbedtls_ssl_config_free(&srv_conf);
+    return ret;
+}
+
+int main(void)
+{
+    int i, failed = 0;
+
+    if (host_crypto_init() != RT_EOK)
+    {
+        printf("swcrypto registration failed\n");
+        return 1;
+    }
+
+    mbedtls_ctr_drbg_init(&drbg);
+    mbedtls_x509_crt_init(&ca_crt);
+    mbedtls_x509_crt_init(&srv_crt);
+    mbedtls_pk_init(&srv_key);
+    mbedtls_ssl_cache_init(&cache);
+    if (mbedtls_ctr_drbg_seed(&drbg, tls_bench_entropy, RT_NULL, (const unsigned char *)"tls_bench", 9) != 0 ||
+        mbedtls_x509_crt_parse(&ca_crt, (const unsigned char *)mbedtls_test_ca_crt_ec, mbedtls_test_ca_crt_ec_len) != 0 ||
+        mbedtls_x509_crt_parse(&srv_crt, (const unsigned char *)mbedtls_test_srv_crt_ec, mbedtls_test_srv_crt_ec_len) != 0 ||
+        mbedtls_pk_parse_key(&srv_key, (const unsigned char *)mbedtls_test_srv_key_ec, mbedtls_test_srv_key_ec_len,
+                             RT_NULL, 0) != 0)
+    {
+        printf("setup failed\n");
+        return 1;
+    }
+
+    printf("%d handshakes, %d KB in %d Bytes records\n", TLS_BENCH_HANDSHAKES, TLS_BENCH_KB, TLS_BENCH_CHUNK);
+    printf("%-40s %8s %8s %10s\n", "suite", "full ms", "res. ms", "bulk KB/s");
+    for (i = 0; i < (int)(sizeof(tls_bench_suites) / sizeof(tls_bench_suites[0])); i++)
+    {
+        if (tls_bench_suite(tls_bench_suites[i]) != 0)
+        {
+            failed++;
+        }
+    }
+
+    mbedtls_ssl_cache_free(&cache);
+    mbedtls_pk_free(&srv_key);
+    mbedtls_x509_crt_free(&srv_crt);
+    mbedtls_x509_crt_free(&ca_crt);
+    mbedtls_ctr_drbg_free(&drbg);
+
+    return failed != 0;
+}
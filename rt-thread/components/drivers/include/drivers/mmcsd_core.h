@@ -237,6 +237,49 @@ int rt_mmcsd_core_init(void);
 rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card);
 void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card);
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+/*
+ * asynchronous block request, the done callback runs in the
+ * context of the queue thread and must not block
+ */
+struct rt_mmcsd_blk_req {
+    rt_uint32_t  sector;    /* first sector, relative to the block device */
+    rt_uint32_t  blks;
+    void        *buf;
+    rt_uint8_t   dir;       /* 0: read, 1: write */
+    rt_err_t     err;       /* result of the request */
+
+    void (*done)(struct rt_mmcsd_blk_req *req);
+    void        *user_data;
+
+    /* private, set by rt_mmcsd_blk_submit */
+    rt_list_t    list;
+    rt_device_t  dev;
+    rt_uint32_t  lba;       /* first sector on the card */
+    rt_uint32_t  batch;
+    rt_tick_t    stamp;
+    rt_uint8_t   prio;      /* priority of the submitting thread */
+};
+
+struct rt_mmcsd_blk_stat {
+    rt_uint32_t  read_reqs;
+    rt_uint32_t  read_blks;
+    rt_uint32_t  write_reqs;
+    rt_uint32_t  write_blks;
+    rt_uint32_t  merged;    /* requests merged into a previous one */
+    rt_uint32_t  transfers; /* data commands issued on the bus */
+    rt_uint32_t  sbc;       /* transfers pre-defined by CMD23 */
+    rt_uint32_t  pre_erase; /* writes hinted by ACMD23 */
+    rt_uint32_t  errors;
+    rt_uint32_t  lat_total; /* ticks from submission to completion */
+    rt_uint32_t  lat_max;
+    rt_uint32_t  busy;      /* ticks spent in transfers */
+};
+
+rt_err_t rt_mmcsd_blk_submit(rt_device_t dev, struct rt_mmcsd_blk_req *req);
+rt_err_t rt_mmcsd_blk_get_stat(rt_device_t dev, struct rt_mmcsd_blk_stat *stat);
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+#ifndef FASTLOCK_H_
+#define FASTLOCK_H_
+
+#include <rtthread.h>
+
+/**
+ * Fast mutex
+ *
+ * The uncontended take and release are one atomic operation on the state word,
+ * the waiters sleep on the semaphore only under contention. The fast mutex is
+ * recursive but has no priority inheritance.
+ */
+struct rt_fast_mutex
+{
+    volatile rt_int32_t state;          /* 0: unlocked, 1: locked, 2: locked with waiters */
+    struct rt_thread *owner;
+    rt_uint16_t hold;
+
+    struct rt_semaphore wait;
+};
+
+rt_err_t rt_fast_mutex_init(struct rt_fast_mutex *mutex, const char *name);
+rt_err_t rt_fast_mutex_detach(struct rt_fast_mutex *mutex);
+rt_err_t rt_fast_mutex_take(struct rt_fast_mutex *mutex, rt_int32_t timeout);
+rt_err_t rt_fast_mutex_trytake(struct rt_fast_mutex *mutex);
+rt_err_t rt_fast_mutex_release(struct rt_fast_mutex *mutex);
+
+/**
+ * Fast semaphore
+ *
+ * The count is decreased atomically, the taker sleeps on the semaphore only
+ * if no token is left, and the release signals it only if there is a sleeper.
+ */
+struct rt_fast_sem
+{
+    volatile rt_int32_t count;          /* > 0: tokens left, < 0: the number of waiters */
+
+    struct rt_semaphore wait;
+};
+
+rt_err_t rt_fast_sem_init(struct rt_fast_sem *sem, const char *name, rt_uint32_t value);
+rt_err_t rt_fast_sem_detach(struct rt_fast_sem *sem);
+rt_err_t rt_fast_sem_take(struct rt_fast_sem *sem, rt_int32_t timeout);
+rt_err_t rt_fast_sem_trytake(struct rt_fast_sem *sem);
+rt_err_t rt_fast_sem_release(struct rt_fast_sem *sem);
+
+#endif
@@ -16,6 +16,7 @@
 
 #include "ipc/ringbuffer.h"
 #include "ipc/completion.h"
+#include "ipc/fastlock.h"
 #include "ipc/dataqueue.h"
 #include "ipc/workqueue.h"
 #include "ipc/waitqueue.h"
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+/*
+ * The atomic operations are the LDREX/STREX loops the compiler generates for the
+ * builtins, the cores without them disable the interrupt around the update.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+rt_inline rt_bool_t _fast_cas(volatile rt_int32_t *ptr, rt_int32_t expected, rt_int32_t desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+rt_inline rt_int32_t _fast_xchg(volatile rt_int32_t *ptr, rt_int32_t value)
+{
+    return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+rt_inline rt_int32_t _fast_add(volatile rt_int32_t *ptr, rt_int32_t value)
+{
+    return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+}
+#else
+rt_inline rt_bool_t _fast_cas(volatile rt_int32_t *ptr, rt_int32_t expected, rt_int32_t desired)
+{
+    rt_base_t level;
+    rt_bool_t result = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (*ptr == expected)
+    {
+        *ptr = desired;
+        result = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+rt_inline rt_int32_t _fast_xchg(volatile rt_int32_t *ptr, rt_int32_t value)
+{
+    rt_base_t level;
+    rt_int32_t old;
+
+    level = rt_hw_interrupt_disable();
+    old = *ptr;
+    *ptr = value;
+    rt_hw_interrupt_enable(level);
+
+    return old;
+}
+
+rt_inline rt_int32_t _fast_add(volatile rt_int32_t *ptr, rt_int32_t value)
+{
+    rt_base_t level;
+    rt_int32_t old;
+
+    level = rt_hw_interrupt_disable();
+    old = *ptr;
+    *ptr = old + value;
+    rt_hw_interrupt_enable(level);
+
+    return old;
+}
+#endif
+
+/**
+ * @brief This function will initialize a fast mutex.
+ *
+ * @param mutex is a pointer to the fast mutex.
+ *
+ * @param name is the name of the semaphore the waiters sleep on.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the initialization is successful.
+ */
+rt_err_t rt_fast_mutex_init(struct rt_fast_mutex *mutex, const char *name)
+{
+    RT_ASSERT(mutex != RT_NULL);
+
+    mutex->state = 0;
+    mutex->owner = RT_NULL;
+    mutex->hold = 0;
+
+    return rt_sem_init(&(mutex->wait), name, 0, RT_IPC_FLAG_PRIO);
+}
+RTM_EXPORT(rt_fast_mutex_init);
+
+/**
+ * @brief This function will detach a fast mutex, the waiting threads are woken up with an error.
+ *
+ * @param mutex is a pointer to the fast mutex.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the operation is successful.
+ */
+rt_err_t rt_fast_mutex_detach(struct rt_fast_mutex *mutex)
+{
+    RT_ASSERT(mutex != RT_NULL);
+
+    return rt_sem_detach(&(mutex->wait));
+}
+RTM_EXPORT(rt_fast_mutex_detach);
+
+/**
+ * @brief This function will take a fast mutex. If the mutex is held by another thread,
+ *        the current thread waits for it up to the specified time.
+ *
+ * @note  The mutex is recursive, the owner may take it again and shall release it as many times.
+ *
+ * @param mutex is a pointer to the fast mutex.
+ *
+ * @param timeout is the waiting time in OS ticks, 0 to return at once, RT_WAITING_FOREVER to wait forever.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the mutex is taken.
+ *         -RT_ETIMEOUT is returned if it isn't taken in time.
+ *
+ * @warning The mutex can ONLY be taken in the thread context, except for the trial with a zero timeout.
+ */
+rt_err_t rt_fast_mutex_take(struct rt_fast_mutex *mutex, rt_int32_t timeout)
+{
+    struct rt_thread *thread = rt_thread_self();
+    rt_tick_t tick;
+    rt_err_t result;
+
+    RT_ASSERT(mutex != RT_NULL);
+
+    /* only the owner sees itself here, so the owner needs no atomic access */
+    if (thread != RT_NULL && mutex->owner == thread)
+    {
+        mutex->hold++;
+        return RT_EOK;
+    }
+
+    if (!_fast_cas(&(mutex->state), 0, 1))
+    {
+        if (timeout == 0)
+            return -RT_ETIMEOUT;
+
+        /* current context checking */
+        RT_DEBUG_IN_THREAD_CONTEXT;
+
+        /* mark the mutex contended, the owner signals the semaphore when it releases */
+        tick = rt_tick_get();
+        while (_fast_xchg(&(mutex->state), 2) != 0)
+        {
+            if (timeout > 0)
+            {
+                rt_int32_t left = timeout - (rt_int32_t)(rt_tick_get() - tick);
+
+                if (left <= 0)
+                    return -RT_ETIMEOUT;
+                result = rt_sem_take(&(mutex->wait), left);
+            }
+            else
+            {
+                result = rt_sem_take(&(mutex->wait), RT_WAITING_FOREVER);
+            }
+
+            if (result != RT_EOK && result != -RT_ETIMEOUT)
+                return result;
+        }
+    }
+
+    mutex->owner = thread;
+    mutex->hold = 1;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_fast_mutex_take);
+
+/**
+ * @brief This function will try to take a fast mutex without waiting.
+ *
+ * @param mutex is a pointer to the fast mutex.
+ *
+ * @return Return RT_EOK if the mutex is taken, -RT_ETIMEOUT otherwise.
+ */
+rt_err_t rt_fast_mutex_trytake(struct rt_fast_mutex *mutex)
+{
+    return rt_fast_mutex_take(mutex, RT_WAITING_NO);
+}
+RTM_EXPORT(rt_fast_mutex_trytake);
+
+/**
+ * @brief This function will release a fast mutex, a waiting thread is woken up if there is one.
+ *
+ * @param mutex is a pointer to the fast mutex.
+ *
+ * @return Return the operation status. -RT_ERROR is returned if the current thread isn't the owner.
+ */
+rt_err_t rt_fast_mutex_release(struct rt_fast_mutex *mutex)
+{
+    RT_ASSERT(mutex != RT_NULL);
+
+    if (mutex->owner != rt_thread_self() || mutex->hold == 0)
+        return -RT_ERROR;
+
+    if (--mutex->hold > 0)
+        return RT_EOK;
+
+    mutex->owner = RT_NULL;
+    if (_fast_xchg(&(mutex->state), 0) == 2)
+    {
+        /* contended, wake up a waiter to retry */
+        rt_sem_release(&(mutex->wait));
+    }
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_fast_mutex_release);
+
+/**
+ * @brief This function will initialize a fast semaphore.
+ *
+ * @param sem is a pointer to the fast semaphore.
+ *
+ * @param name is the name of the semaphore the waiters sleep on.
+ *
+ * @param value is the initial value of the fast semaphore.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the initialization is successful.
+ */
+rt_err_t rt_fast_sem_init(struct rt_fast_sem *sem, const char *name, rt_uint32_t value)
+{
+    RT_ASSERT(sem != RT_NULL);
+    RT_ASSERT(value < 0x7fffffffUL);
+
+    sem->count = (rt_int32_t)value;
+
+    return rt_sem_init(&(sem->wait), name, 0, RT_IPC_FLAG_PRIO);
+}
+RTM_EXPORT(rt_fast_sem_init);
+
+/**
+ * @brief This function will detach a fast semaphore, the waiting threads are woken up with an error.
+ *
+ * @param sem is a pointer to the fast semaphore.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the operation is successful.
+ */
+rt_err_t rt_fast_sem_detach(struct rt_fast_sem *sem)
+{
+    RT_ASSERT(sem != RT_NULL);
+
+    return rt_sem_detach(&(sem->wait));
+}
+RTM_EXPORT(rt_fast_sem_detach);
+
+/**
+ * @brief This function will take a fast semaphore. If no token is left, the current thread
+ *        waits for a release up to the specified time.
+ *
+ * @param sem is a pointer to the fast semaphore.
+ *
+ * @param timeout is the waiting time in OS ticks, 0 to return at once, RT_WAITING_FOREVER to wait forever.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the semaphore is taken.
+ *         -RT_ETIMEOUT is returned if it isn't taken in time.
+ *
+ * @warning The semaphore can ONLY be taken in the thread context, except for the trial with a zero timeout.
+ */
+rt_err_t rt_fast_sem_take(struct rt_fast_sem *sem, rt_int32_t timeout)
+{
+    rt_int32_t count;
+    rt_err_t result;
+
+    RT_ASSERT(sem != RT_NULL);
+
+    if (timeout == 0)
+    {
+        for (count = sem->count; count > 0; count = sem->count)
+        {
+            if (_fast_cas(&(sem->count), count, count - 1))
+                return RT_EOK;
+        }
+
+        return -RT_ETIMEOUT;
+    }
+
+    if (_fast_add(&(sem->count), -1) > 0)
+        return RT_EOK;
+
+    /* current context checking */
+    RT_DEBUG_IN_THREAD_CONTEXT;
+
+    result = rt_sem_take(&(sem->wait), timeout);
+    if (result == RT_EOK)
+        return RT_EOK;
+
+    /*
+     * Give up the wait. While the count is negative there are more waiters than
+     * signals on the way, otherwise a release has already been counted for this
+     * thread and its signal must be consumed.
+     */
+    for (count = sem->count; count < 0; count = sem->count)
+    {
+        if (_fast_cas(&(sem->count), count, count + 1))
+            return result;
+    }
+    rt_sem_take(&(sem->wait), RT_WAITING_FOREVER);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_fast_sem_take);
+
+/**
+ * @brief This function will try to take a fast semaphore without waiting.
+ *
+ * @param sem is a pointer to the fast semaphore.
+ *
+ * @return Return RT_EOK if the semaphore is taken, -RT_ETIMEOUT otherwise.
+ */
+rt_err_t rt_fast_sem_trytake(struct rt_fast_sem *sem)
+{
+    return rt_fast_sem_take(sem, RT_WAITING_NO);
+}
+RTM_EXPORT(rt_fast_sem_trytake);
+
+/**
+ * @brief This function will release a fast semaphore, a waiting thread is woken up if there is one.
+ *
+ * @note  It can be called in the interrupt context.
+ *
+ * @param sem is a pointer to the fast semaphore.
+ *
+ * @return Return the operation status. When the return value is RT_EOK, the operation is successful.
+ */
+rt_err_t rt_fast_sem_release(struct rt_fast_sem *sem)
+{
+    RT_ASSERT(sem != RT_NULL);
+
+    if (_fast_add(&(sem->count), 1) < 0)
+    {
+        /* a thread is waiting or about to wait */
+        return rt_sem_release(&(sem->wait));
+    }
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_fast_sem_release);
@@ -12,6 +12,7 @@
 #include <dfs_fs.h>
 
 #include <drivers/mmcsd_core.h>
+#include <rtdevice.h>
 
 #define DBG_TAG               "SDIO"
 #ifdef RT_SDIO_DEBUG
@@ -24,6 +25,24 @@
 
 #define BLK_MIN(a, b) ((a) < (b) ? (a) : (b))
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+struct mmcsd_blk_queue
+{
+    struct rt_mmcsd_card *card;
+    rt_list_t pending;          /* sorted by batch, then by sector */
+    struct rt_mutex lock;
+    struct rt_semaphore sem;
+    struct rt_completion exited;
+    rt_thread_t thread;
+    rt_bool_t exit;
+    rt_uint32_t batch;          /* the batch new requests join */
+    rt_uint32_t head;           /* the sector after the last transfer */
+    rt_uint32_t max_blks;       /* blocks of one transfer */
+    rt_uint32_t bounce_blks;
+    rt_uint8_t *bounce;         /* gathers the merged requests */
+};
+#endif
+
 struct mmcsd_blk_device
 {
     struct rt_mmcsd_card *card;
@@ -32,12 +51,24 @@ struct mmcsd_blk_device
     struct dfs_partition part;
     struct rt_device_blk_geometry geometry;
     rt_size_t max_req_size;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    struct mmcsd_blk_queue *queue;  /* shared by the devices of the card */
+    struct rt_mmcsd_blk_stat stat;
+#endif
 };
 
 #ifndef RT_MMCSD_MAX_PARTITION
 #define RT_MMCSD_MAX_PARTITION 16
 #endif
 
+#ifndef RT_MMCSD_PRE_ERASE_BLOCKS
+#define RT_MMCSD_PRE_ERASE_BLOCKS 0
+#endif
+
+/* the commands a transfer was prepared with */
+#define MMCSD_BLK_SBC       (1 << 0)
+#define MMCSD_BLK_PRE_ERASE (1 << 1)
+
 rt_int32_t mmcsd_num_wr_blocks(struct rt_mmcsd_card *card)
 {
     rt_int32_t err;
@@ -99,17 +130,74 @@ rt_int32_t mmcsd_num_wr_blocks(struct rt_mmcsd_card *card)
     return blocks;
 }
 
+static rt_bool_t mmcsd_blk_use_sbc(struct rt_mmcsd_card *card)
+{
+#ifdef RT_MMCSD_USING_SET_BLOCK_COUNT
+    if (controller_is_spi(card->host))
+        return RT_FALSE;
+    /* optional for SD cards, advertised in the SCR */
+    if (card->card_type == CARD_TYPE_MMC)
+        return RT_TRUE;
+    if (card->scr.sd_cmds & SD_SCR_CMD23_SUPPORT)
+        return RT_TRUE;
+#endif
+    return RT_FALSE;
+}
+
+static rt_int32_t mmcsd_set_block_count(struct rt_mmcsd_card *card, rt_uint32_t blks)
+{
+    struct rt_mmcsd_cmd cmd;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = SET_BLOCK_COUNT;
+    cmd.arg = blks;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    return mmcsd_send_cmd(card->host, &cmd, 0);
+}
+
+#if RT_MMCSD_PRE_ERASE_BLOCKS > 0
+static rt_int32_t mmcsd_set_wr_blk_erase_count(struct rt_mmcsd_card *card, rt_uint32_t blks)
+{
+    rt_int32_t err;
+    struct rt_mmcsd_cmd cmd;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = APP_CMD;
+    cmd.arg = card->rca << 16;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    err = mmcsd_send_cmd(card->host, &cmd, 0);
+    if (err)
+        return err;
+    if (!(cmd.resp[0] & R1_APP_CMD))
+        return -RT_ERROR;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = SD_APP_SET_WR_BLK_ERASE_COUNT;
+    cmd.arg = blks & 0x7FFFFF;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    return mmcsd_send_cmd(card->host, &cmd, 0);
+}
+#endif
+
 static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
                                  rt_uint32_t           sector,
                                  void                 *buf,
                                  rt_size_t             blks,
-                                 rt_uint8_t            dir)
+                                 rt_uint8_t            dir,
+                                 rt_uint32_t          *used)
 {
     struct rt_mmcsd_cmd  cmd, stop;
     struct rt_mmcsd_data  data;
     struct rt_mmcsd_req  req;
     struct rt_mmcsd_host *host = card->host;
     rt_uint32_t r_cmd, w_cmd;
+    rt_uint32_t cmds = 0;
 
     mmcsd_host_lock(host);
     rt_memset(&req, 0, sizeof(struct rt_mmcsd_req));
@@ -131,13 +219,28 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
 
     if (blks > 1)
     {
-        if (!controller_is_spi(card->host) || !dir)
+        if (blks <= 0xFFFF && mmcsd_blk_use_sbc(card) &&
+            mmcsd_set_block_count(card, blks) == RT_EOK)
+        {
+            /* the card ends the transfer by itself, no CMD12 */
+            cmds |= MMCSD_BLK_SBC;
+        }
+        else if (!controller_is_spi(card->host) || !dir)
         {
             req.stop = &stop;
             stop.cmd_code = STOP_TRANSMISSION;
             stop.arg = 0;
             stop.flags = RESP_SPI_R1B | RESP_R1B | CMD_AC;
         }
+#if RT_MMCSD_PRE_ERASE_BLOCKS > 0
+        /* a pre-defined transfer already tells the card how much is coming */
+        if (dir && blks >= RT_MMCSD_PRE_ERASE_BLOCKS && !(cmds & MMCSD_BLK_SBC) &&
+            card->card_type == CARD_TYPE_SD && !controller_is_spi(card->host))
+        {
+            if (mmcsd_set_wr_blk_erase_count(card, blks) == RT_EOK)
+                cmds |= MMCSD_BLK_PRE_ERASE;
+        }
+#endif
         r_cmd = READ_MULTIPLE_BLOCK;
         w_cmd = WRITE_MULTIPLE_BLOCK;
     }
@@ -189,6 +292,9 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
 
     mmcsd_host_unlock(host);
 
+    if (used)
+        *used = cmds;
+
     if (cmd.err || data.err || stop.err)
     {
         LOG_E("mmcsd request blocks error");
@@ -201,6 +307,391 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
     return RT_EOK;
 }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+#define MMCSD_BLK_REQ(node) rt_list_entry(node, struct rt_mmcsd_blk_req, list)
+
+/*
+ * The requests are served in batches: a batch is closed once its first
+ * request is dispatched, and each batch is swept once in sector order
+ * (C-LOOK), merging the adjacent requests. The requests that arrive in
+ * the meantime wait for the next batch, so none of them starves.
+ */
+static rt_bool_t mmcsd_blk_overlap(struct rt_mmcsd_blk_req *a, struct rt_mmcsd_blk_req *b)
+{
+    return a->lba < b->lba + b->blks && b->lba < a->lba + a->blks;
+}
+
+/*
+ * The queue thread runs at the priority of the most urgent pending request,
+ * RT_MMCSD_BLK_THREAD_PRIORITY at the lowest, so a thread waiting for its
+ * request isn't held up by the threads between its priority and the queue's.
+ * A submission raises it, it's lowered after each transfer. Called with the
+ * queue lock held.
+ */
+static void mmcsd_blk_update_priority(struct mmcsd_blk_queue *q)
+{
+    rt_uint8_t prio = RT_MMCSD_BLK_THREAD_PRIORITY;
+    rt_list_t *node;
+
+    rt_list_for_each(node, &q->pending)
+    {
+        if (MMCSD_BLK_REQ(node)->prio < prio)
+            prio = MMCSD_BLK_REQ(node)->prio;
+    }
+    if (prio != q->thread->current_priority)
+        rt_thread_control(q->thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &prio);
+}
+
+rt_err_t rt_mmcsd_blk_submit(rt_device_t dev, struct rt_mmcsd_blk_req *req)
+{
+    struct mmcsd_blk_device *blk_dev;
+    struct mmcsd_blk_queue *q;
+    rt_thread_t thread;
+    rt_list_t *node;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(req != RT_NULL);
+
+    blk_dev = (struct mmcsd_blk_device *)dev->user_data;
+    q = blk_dev->queue;
+    if (req->blks == 0 || req->sector >= blk_dev->geometry.sector_count ||
+        req->blks > blk_dev->geometry.sector_count - req->sector)
+    {
+        return -RT_EINVAL;
+    }
+
+    req->dev = dev;
+    req->lba = blk_dev->part.offset + req->sector;
+    req->err = RT_EOK;
+    req->stamp = rt_tick_get();
+    thread = rt_thread_self();
+    req->prio = thread ? thread->current_priority : RT_MMCSD_BLK_THREAD_PRIORITY;
+
+    rt_mutex_take(&q->lock, RT_WAITING_FOREVER);
+    if (q->exit)
+    {
+        rt_mutex_release(&q->lock);
+        return -RT_EIO;
+    }
+
+    /* a write must stay ordered with the requests it overlaps */
+    rt_list_for_each(node, &q->pending)
+    {
+        struct rt_mmcsd_blk_req *r = MMCSD_BLK_REQ(node);
+
+        if (r->batch == q->batch && (r->dir || req->dir) && mmcsd_blk_overlap(r, req))
+        {
+            q->batch++;
+            break;
+        }
+    }
+    req->batch = q->batch;
+
+    /* the open batch is at the tail, keep it sorted by sector */
+    node = q->pending.prev;
+    while (node != &q->pending && MMCSD_BLK_REQ(node)->batch == req->batch &&
+           MMCSD_BLK_REQ(node)->lba > req->lba)
+    {
+        node = node->prev;
+    }
+    rt_list_insert_after(node, &req->list);
+    if (req->prio < q->thread->current_priority)
+        rt_thread_control(q->thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &req->prio);
+    rt_mutex_release(&q->lock);
+
+    rt_sem_release(&q->sem);
+
+    return RT_EOK;
+}
+
+static void mmcsd_blk_complete(struct rt_mmcsd_blk_req *req, rt_err_t err)
+{
+    struct mmcsd_blk_device *blk_dev = (struct mmcsd_blk_device *)req->dev->user_data;
+    struct rt_mmcsd_blk_stat *stat = &blk_dev->stat;
+    rt_uint32_t lat = rt_tick_get() - req->stamp;
+
+    if (req->dir)
+    {
+        stat->write_reqs++;
+        stat->write_blks += req->blks;
+    }
+    else
+    {
+        stat->read_reqs++;
+        stat->read_blks += req->blks;
+    }
+    if (err)
+        stat->errors++;
+    stat->lat_total += lat;
+    if (lat > stat->lat_max)
+        stat->lat_max = lat;
+
+    req->err = err;
+    if (req->done)
+        req->done(req);
+}
+
+/* takes the next run of adjacent requests out of the queue */
+static rt_uint32_t mmcsd_blk_fetch(struct mmcsd_blk_queue *q, rt_list_t *run, rt_bool_t *copy)
+{
+    struct rt_mmcsd_blk_req *first, *last, *r;
+    rt_list_t *node;
+    rt_uint32_t blks;
+
+    first = MMCSD_BLK_REQ(q->pending.next);
+    if (first->batch == q->batch)
+        q->batch++;
+
+    /* the first request at or beyond the head, else restart the sweep */
+    rt_list_for_each(node, &q->pending)
+    {
+        r = MMCSD_BLK_REQ(node);
+        if (r->batch != first->batch)
+            break;
+        if (r->lba >= q->head)
+        {
+            first = r;
+            break;
+        }
+    }
+
+    node = first->list.next;
+    rt_list_remove(&first->list);
+    rt_list_insert_before(run, &first->list);
+    blks = first->blks;
+    last = first;
+    *copy = RT_FALSE;
+
+    while (node != &q->pending)
+    {
+        r = MMCSD_BLK_REQ(node);
+        if (r->batch != first->batch || r->dev != first->dev || r->dir != first->dir ||
+            r->lba != first->lba + blks || blks + r->blks > q->max_blks)
+        {
+            break;
+        }
+        /* contiguous buffers go out as they are, others through the bounce buffer */
+        if (*copy || (rt_uint8_t *)last->buf + (last->blks << 9) != (rt_uint8_t *)r->buf)
+        {
+            if (blks + r->blks > q->bounce_blks)
+                break;
+            *copy = RT_TRUE;
+        }
+
+        node = node->next;
+        rt_list_remove(&r->list);
+        rt_list_insert_before(run, &r->list);
+        blks += r->blks;
+        last = r;
+    }
+
+    return blks;
+}
+
+static void mmcsd_blk_issue(struct mmcsd_blk_queue *q, rt_list_t *run, rt_uint32_t blks, rt_bool_t copy)
+{
+    struct rt_mmcsd_blk_req *first = MMCSD_BLK_REQ(run->next);
+    struct rt_mmcsd_blk_stat *stat = &((struct mmcsd_blk_device *)first->dev->user_data)->stat;
+    rt_uint8_t *buf = copy ? q->bounce : (rt_uint8_t *)first->buf;
+    rt_uint32_t offset, n, used;
+    rt_list_t *node, *next;
+    rt_tick_t tick;
+    rt_err_t err = RT_EOK;
+
+    if (copy && first->dir)
+    {
+        offset = 0;
+        rt_list_for_each(node, run)
+        {
+            rt_memcpy(buf + offset, MMCSD_BLK_REQ(node)->buf, MMCSD_BLK_REQ(node)->blks << 9);
+            offset += MMCSD_BLK_REQ(node)->blks << 9;
+        }
+    }
+
+    tick = rt_tick_get();
+    for (offset = 0; offset < blks && err == RT_EOK; offset += n)
+    {
+        n = BLK_MIN(blks - offset, q->max_blks);
+        err = rt_mmcsd_req_blk(q->card, first->lba + offset, buf + (offset << 9), n, first->dir, &used);
+        stat->transfers++;
+        if (used & MMCSD_BLK_SBC)
+            stat->sbc++;
+        if (used & MMCSD_BLK_PRE_ERASE)
+            stat->pre_erase++;
+    }
+    stat->busy += rt_tick_get() - tick;
+    q->head = first->lba + blks;
+
+    if (copy && !first->dir && err == RT_EOK)
+    {
+        offset = 0;
+        rt_list_for_each(node, run)
+        {
+            rt_memcpy(MMCSD_BLK_REQ(node)->buf, buf + offset, MMCSD_BLK_REQ(node)->blks << 9);
+            offset += MMCSD_BLK_REQ(node)->blks << 9;
+        }
+    }
+
+    /* the callbacks may reuse the requests */
+    for (node = run->next; node != run; node = next)
+    {
+        next = node->next;
+        if (node != &first->list)
+            stat->merged++;
+        rt_list_remove(node);
+        mmcsd_blk_complete(MMCSD_BLK_REQ(node), err ? -RT_EIO : RT_EOK);
+    }
+}
+
+static void mmcsd_blk_thread_entry(void *parameter)
+{
+    struct mmcsd_blk_queue *q = (struct mmcsd_blk_queue *)parameter;
+    rt_list_t run;
+    rt_uint32_t blks;
+    rt_bool_t copy;
+
+    while (1)
+    {
+        rt_sem_take(&q->sem, RT_WAITING_FOREVER);
+
+        rt_list_init(&run);
+        rt_mutex_take(&q->lock, RT_WAITING_FOREVER);
+        if (q->exit)
+        {
+            /* the card is gone, fail what is left */
+            if (!rt_list_isempty(&q->pending))
+            {
+                rt_list_insert_before(&q->pending, &run);
+                rt_list_remove(&q->pending);
+            }
+            rt_mutex_release(&q->lock);
+
+            while (!rt_list_isempty(&run))
+            {
+                rt_list_t *node = run.next;
+
+                rt_list_remove(node);
+                mmcsd_blk_complete(MMCSD_BLK_REQ(node), -RT_EIO);
+            }
+            rt_completion_done(&q->exited);
+            return;
+        }
+        /* the merged requests leave extra counts on the semaphore */
+        if (rt_list_isempty(&q->pending))
+        {
+            rt_mutex_release(&q->lock);
+            continue;
+        }
+        blks = mmcsd_blk_fetch(q, &run, &copy);
+        rt_mutex_release(&q->lock);
+
+        mmcsd_blk_issue(q, &run, blks, copy);
+
+        rt_mutex_take(&q->lock, RT_WAITING_FOREVER);
+        mmcsd_blk_update_priority(q);
+        rt_mutex_release(&q->lock);
+    }
+}
+
+static struct mmcsd_blk_queue *mmcsd_blk_queue_create(struct rt_mmcsd_card *card, rt_uint32_t max_blks)
+{
+    struct mmcsd_blk_queue *q;
+    char name[RT_NAME_MAX];
+
+    q = rt_calloc(1, sizeof(struct mmcsd_blk_queue));
+    if (!q)
+        return RT_NULL;
+
+    q->card = card;
+    q->max_blks = max_blks ? max_blks : 1;
+    q->bounce_blks = BLK_MIN(q->max_blks, RT_MMCSD_BLK_MERGE_BLOCKS);
+    if (q->bounce_blks > 1)
+    {
+        q->bounce = rt_malloc(q->bounce_blks << 9);
+        if (!q->bounce)
+            q->bounce_blks = 0;
+    }
+    else
+    {
+        q->bounce_blks = 0;
+    }
+    rt_snprintf(name, sizeof(name), "sdq%d", card->host->id);
+    rt_list_init(&q->pending);
+    rt_mutex_init(&q->lock, name, RT_IPC_FLAG_PRIO);
+    rt_sem_init(&q->sem, name, 0, RT_IPC_FLAG_FIFO);
+    rt_completion_init(&q->exited);
+
+    q->thread = rt_thread_create(name, mmcsd_blk_thread_entry, q,
+                                 RT_MMCSD_BLK_THREAD_STACK_SIZE, RT_MMCSD_BLK_THREAD_PRIORITY, 20);
+    if (!q->thread)
+    {
+        rt_mutex_detach(&q->lock);
+        rt_sem_detach(&q->sem);
+        rt_free(q->bounce);
+        rt_free(q);
+        return RT_NULL;
+    }
+    rt_thread_startup(q->thread);
+
+    return q;
+}
+
+static void mmcsd_blk_queue_stop(struct mmcsd_blk_queue *q)
+{
+    rt_mutex_take(&q->lock, RT_WAITING_FOREVER);
+    q->exit = RT_TRUE;
+    rt_mutex_release(&q->lock);
+    rt_sem_release(&q->sem);
+
+    rt_completion_wait(&q->exited, RT_WAITING_FOREVER);
+}
+
+static void mmcsd_blk_queue_delete(struct mmcsd_blk_queue *q)
+{
+    rt_mutex_detach(&q->lock);
+    rt_sem_detach(&q->sem);
+    rt_free(q->bounce);
+    rt_free(q);
+}
+
+static void mmcsd_blk_sync_done(struct rt_mmcsd_blk_req *req)
+{
+    rt_completion_done((struct rt_completion *)req->user_data);
+}
+
+static rt_size_t mmcsd_blk_sync(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size, rt_uint8_t dir)
+{
+    struct rt_mmcsd_blk_req req;
+    struct rt_completion done;
+
+    if (size == 0)
+        return 0;
+
+    rt_memset(&req, 0, sizeof(struct rt_mmcsd_blk_req));
+    req.sector = pos;
+    req.blks = size;
+    req.buf = buffer;
+    req.dir = dir;
+    req.done = mmcsd_blk_sync_done;
+    req.user_data = &done;
+    rt_completion_init(&done);
+
+    if (rt_mmcsd_blk_submit(dev, &req) != RT_EOK)
+    {
+        rt_set_errno(-EIO);
+        return 0;
+    }
+    rt_completion_wait(&done, RT_WAITING_FOREVER);
+
+    if (req.err)
+    {
+        rt_set_errno(-EIO);
+        return 0;
+    }
+    return size;
+}
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 static rt_err_t rt_mmcsd_init(rt_device_t dev)
 {
     return RT_EOK;
@@ -230,6 +721,35 @@ static rt_err_t rt_mmcsd_control(rt_device_t dev, int cmd, void *args)
     return RT_EOK;
 }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+static rt_size_t rt_mmcsd_read(rt_device_t dev,
+                               rt_off_t    pos,
+                               void       *buffer,
+                               rt_size_t   size)
+{
+    if (dev == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return 0;
+    }
+
+    return mmcsd_blk_sync(dev, pos, buffer, size, 0);
+}
+
+static rt_size_t rt_mmcsd_write(rt_device_t dev,
+                                rt_off_t    pos,
+                                const void *buffer,
+                                rt_size_t   size)
+{
+    if (dev == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return 0;
+    }
+
+    return mmcsd_blk_sync(dev, pos, (void *)buffer, size, 1);
+}
+#else
 static rt_size_t rt_mmcsd_read(rt_device_t dev,
                                rt_off_t    pos,
                                void       *buffer,
@@ -253,7 +773,7 @@ static rt_size_t rt_mmcsd_read(rt_device_t dev,
     while (remain_size)
     {
         req_size = (remain_size > blk_dev->max_req_size) ? blk_dev->max_req_size : remain_size;
-        err = rt_mmcsd_req_blk(blk_dev->card, part->offset + pos + offset, rd_ptr, req_size, 0);
+        err = rt_mmcsd_req_blk(blk_dev->card, part->offset + pos + offset, rd_ptr, req_size, 0, RT_NULL);
         if (err)
             break;
         offset += req_size;
@@ -294,7 +814,7 @@ static rt_size_t rt_mmcsd_write(rt_device_t dev,
     while (remain_size)
     {
         req_size = (remain_size > blk_dev->max_req_size) ? blk_dev->max_req_size : remain_size;
-        err = rt_mmcsd_req_blk(blk_dev->card, part->offset + pos + offset, wr_ptr, req_size, 1);
+        err = rt_mmcsd_req_blk(blk_dev->card, part->offset + pos + offset, wr_ptr, req_size, 1, RT_NULL);
         if (err)
             break;
         offset += req_size;
@@ -312,6 +832,7 @@ static rt_size_t rt_mmcsd_write(rt_device_t dev,
     }
     return size - remain_size;
 }
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
 
 static rt_int32_t mmcsd_set_blksize(struct rt_mmcsd_card *card)
 {
@@ -351,6 +872,68 @@ const static struct rt_device_ops mmcsd_blk_ops =
 };
 #endif
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+static rt_bool_t mmcsd_is_blkdev(rt_device_t dev)
+{
+#ifdef RT_USING_DEVICE_OPS
+    return dev->ops == &mmcsd_blk_ops;
+#else
+    return dev->read == rt_mmcsd_read;
+#endif
+}
+
+rt_err_t rt_mmcsd_blk_get_stat(rt_device_t dev, struct rt_mmcsd_blk_stat *stat)
+{
+    if (dev == RT_NULL || stat == RT_NULL || !mmcsd_is_blkdev(dev))
+        return -RT_EINVAL;
+
+    rt_memcpy(stat, &((struct mmcsd_blk_device *)dev->user_data)->stat, sizeof(struct rt_mmcsd_blk_stat));
+
+    return RT_EOK;
+}
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+
+static void mmcsd_stat(int argc, char **argv)
+{
+    struct rt_mmcsd_blk_stat stat;
+    rt_device_t dev;
+    rt_uint32_t reqs, blks, ms;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: mmcsd_stat <device> [reset]\n");
+        return;
+    }
+    dev = rt_device_find(argv[1]);
+    if (rt_mmcsd_blk_get_stat(dev, &stat) != RT_EOK)
+    {
+        rt_kprintf("%s is not a mmcsd block device.\n", argv[1]);
+        return;
+    }
+    if (argc > 2 && !rt_strcmp(argv[2], "reset"))
+    {
+        rt_memset(&((struct mmcsd_blk_device *)dev->user_data)->stat, 0, sizeof(struct rt_mmcsd_blk_stat));
+        return;
+    }
+
+    reqs = stat.read_reqs + stat.write_reqs;
+    blks = stat.read_blks + stat.write_blks;
+    ms = stat.busy * 1000 / RT_TICK_PER_SECOND;
+    rt_kprintf("read     %8u requests %10u blocks\n", stat.read_reqs, stat.read_blks);
+    rt_kprintf("write    %8u requests %10u blocks\n", stat.write_reqs, stat.write_blks);
+    rt_kprintf("bus      %8u transfers, %u merged, %u CMD23, %u ACMD23, %u errors\n",
+               stat.transfers, stat.merged, stat.sbc, stat.pre_erase, stat.errors);
+    rt_kprintf("latency  %8u ms avg, %u ms max\n",
+               reqs ? stat.lat_total * 1000 / RT_TICK_PER_SECOND / reqs : 0,
+               stat.lat_max * 1000 / RT_TICK_PER_SECOND);
+    rt_kprintf("busy     %8u ms, %u KB/s\n", ms, ms ? (rt_uint32_t)((rt_uint64_t)blks * 500 / ms) : 0);
+}
+MSH_CMD_EXPORT(mmcsd_stat, show the request statistics of a mmcsd block device);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 
 static struct mmcsd_blk_device * rt_mmcsd_create_blkdev(struct rt_mmcsd_card *card, const char* dname, struct dfs_partition* psPart)
 {
@@ -387,6 +970,24 @@ static struct mmcsd_blk_device * rt_mmcsd_create_blkdev(struct rt_mmcsd_card *ca
                                     (card->host->max_blk_count *
                                      card->host->max_blk_size) >> 9);
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    if (rt_list_isempty(&card->blk_devices))
+    {
+        blk_dev->queue = mmcsd_blk_queue_create(card, blk_dev->max_req_size);
+    }
+    else
+    {
+        blk_dev->queue = rt_list_entry(card->blk_devices.next, struct mmcsd_blk_device, list)->queue;
+    }
+    if (!blk_dev->queue)
+    {
+        LOG_E("mmcsd:create request queue failed!");
+        rt_sem_delete(blk_dev->part.lock);
+        rt_free(blk_dev);
+        return RT_NULL;
+    }
+#endif
+
     /* register mmcsd device */
     blk_dev->dev.type = RT_Device_Class_Block;
 #ifdef RT_USING_DEVICE_OPS
@@ -444,7 +1045,7 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
         return -RT_ENOMEM;
     }
 
-    status = rt_mmcsd_req_blk(card, 0, sector, 1, 0);
+    status = rt_mmcsd_req_blk(card, 0, sector, 1, 0, RT_NULL);
     if (status == RT_EOK)
     {
         rt_uint8_t i;
@@ -504,6 +1105,9 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
 {
     rt_list_t *l, *n;
     struct mmcsd_blk_device *blk_dev;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    struct mmcsd_blk_queue *queue;
+#endif
 
     if(card == RT_NULL)
     {
@@ -517,6 +1121,12 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
         return;
     }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    /* no transfer may refer to the devices once they are freed */
+    queue = rt_list_entry(card->blk_devices.next, struct mmcsd_blk_device, list)->queue;
+    mmcsd_blk_queue_stop(queue);
+#endif
+
     for (l = (&card->blk_devices)->next, n = l->next; l != &card->blk_devices; l = n, n=n->next)
     {
         blk_dev = (struct mmcsd_blk_device *)rt_list_entry(l, struct mmcsd_blk_device, list);
@@ -535,4 +1145,7 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
             rt_free(blk_dev);
         }
     }
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    mmcsd_blk_queue_delete(queue);
+#endif
 }
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Simulated SD host with a card in RAM: the core detects and initializes it
+ * like a real SDHC card and the block device runs its requests on it, so the
+ * request merging can be measured on boards whose host driver moves one block
+ * per request. The card reports 512 KB, the least capacity of a version 2.0
+ * CSD, the blocks wrap at RT_MMCSD_SIM_CARD_BLOCKS.
+ *
+ * Every command is counted and the bus time of the card is modelled: 40 us
+ * per command, 300 us of read or 900 us of write access per data command and
+ * 25 us per block. The CMD23/CMD12 and ACMD23 sequences of the data commands
+ * are checked, the violations are counted.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <string.h>
+#include <drivers/mmcsd_core.h>
+
+#ifdef RT_MMCSD_USING_SIM_HOST
+
+#ifndef RT_MMCSD_SIM_CARD_BLOCKS
+#define RT_MMCSD_SIM_CARD_BLOCKS        128
+#endif
+#ifndef RT_MMCSD_SIM_MAX_BLK_COUNT
+#define RT_MMCSD_SIM_MAX_BLK_COUNT      64
+#endif
+
+#define SIM_BLOCK_SIZE                  512
+#define SIM_RCA                         1
+#define SIM_CMD_US                      40
+#define SIM_READ_ACCESS_US              300
+#define SIM_WRITE_ACCESS_US             900
+#define SIM_BLOCK_US                    25
+
+struct mmcsd_sim_stat
+{
+    rt_uint32_t cmds;
+    rt_uint32_t transfers;              /* data commands of the blocks */
+    rt_uint32_t blocks;
+    rt_uint32_t sbc;
+    rt_uint32_t stops;
+    rt_uint32_t pre_erase;
+    rt_uint32_t bad;                    /* violations of the command sequences */
+    rt_uint32_t us;                     /* modelled bus time */
+};
+
+static struct
+{
+    rt_uint8_t mem[RT_MMCSD_SIM_CARD_BLOCKS * SIM_BLOCK_SIZE];
+    rt_uint8_t app;                     /* the previous command was APP_CMD */
+    rt_int32_t sbc;                     /* the blocks pre-defined by CMD23, -1 for none */
+    rt_uint32_t pre_erase;
+    struct rt_mmcsd_host *host;
+
+    struct mmcsd_sim_stat stat;
+} mmcsd_sim;
+
+static void mmcsd_sim_csd(rt_uint32_t *resp)
+{
+    /* version 2.0, TAAC 1 ms, 25 MHz, 512 bytes blocks, C_SIZE 0 */
+    resp[0] = (1 << 30) | (0x0E << 16) | 0x32;
+    resp[1] = (0x5B5 << 20) | (9 << 16);
+    resp[2] = 0;
+    resp[3] = 9 << 22;
+}
+
+static void mmcsd_sim_data(struct rt_mmcsd_req *req)
+{
+    struct rt_mmcsd_cmd *cmd = req->cmd;
+    struct rt_mmcsd_data *data = req->data;
+    rt_uint8_t *buf = (rt_uint8_t *)data->buf;
+    rt_uint32_t i, blk;
+    rt_bool_t multi;
+
+    multi = (cmd->cmd_code == READ_MULTIPLE_BLOCK || cmd->cmd_code == WRITE_MULTIPLE_BLOCK);
+    if (data->blksize != SIM_BLOCK_SIZE || data->blks == 0 || data->blks > mmcsd_sim.host->max_blk_count)
+    {
+        mmcsd_sim.stat.bad++;
+    }
+    else if (multi)
+    {
+        /* a pre-defined transfer ends by itself, the others need CMD12 */
+        if (mmcsd_sim.sbc >= 0 ? (req->stop || mmcsd_sim.sbc != (rt_int32_t)data->blks) : !req->stop)
+            mmcsd_sim.stat.bad++;
+    }
+    else if (data->blks != 1 || req->stop)
+    {
+        mmcsd_sim.stat.bad++;
+    }
+    if (mmcsd_sim.pre_erase && cmd->cmd_code != WRITE_MULTIPLE_BLOCK)
+    {
+        mmcsd_sim.stat.bad++;
+    }
+    mmcsd_sim.sbc = -1;
+    mmcsd_sim.pre_erase = 0;
+
+    for (i = 0; i < data->blks; i++)
+    {
+        blk = (cmd->arg + i) % RT_MMCSD_SIM_CARD_BLOCKS;
+        if (data->flags & DATA_DIR_READ)
+            memcpy(buf + i * SIM_BLOCK_SIZE, mmcsd_sim.mem + blk * SIM_BLOCK_SIZE, SIM_BLOCK_SIZE);
+        else
+            memcpy(mmcsd_sim.mem + blk * SIM_BLOCK_SIZE, buf + i * SIM_BLOCK_SIZE, SIM_BLOCK_SIZE);
+    }
+
+    mmcsd_sim.stat.transfers++;
+    mmcsd_sim.stat.blocks += data->blks;
+    mmcsd_sim.stat.us += ((data->flags & DATA_DIR_READ) ? SIM_READ_ACCESS_US : SIM_WRITE_ACCESS_US) +
+                         data->blks * SIM_BLOCK_US;
+    if (req->stop)
+    {
+        mmcsd_sim.stat.stops++;
+        mmcsd_sim.stat.cmds++;
+        mmcsd_sim.stat.us += SIM_CMD_US;
+    }
+}
+
+static void mmcsd_sim_request(struct rt_mmcsd_host *host, struct rt_mmcsd_req *req)
+{
+    struct rt_mmcsd_cmd *cmd = req->cmd;
+    struct rt_mmcsd_data *data = req->data;
+    rt_uint8_t app = mmcsd_sim.app;
+
+    mmcsd_sim.app = 0;
+    mmcsd_sim.stat.cmds++;
+    mmcsd_sim.stat.us += SIM_CMD_US;
+    /* card status: ready for data in the transfer state */
+    cmd->resp[0] = R1_READY_FOR_DATA | (4 << 9);
+
+    switch (cmd->cmd_code)
+    {
+    case GO_IDLE_STATE:
+    case SELECT_CARD:
+    case SET_BLOCKLEN:
+    case SEND_STATUS:
+        break;
+
+    case SD_SEND_IF_COND:
+        cmd->resp[0] = cmd->arg & 0xFFF;
+        break;
+
+    case APP_CMD:
+        mmcsd_sim.app = 1;
+        cmd->resp[0] |= R1_APP_CMD;
+        break;
+
+    case ALL_SEND_CID:
+        cmd->resp[0] = 0x00525453;
+        cmd->resp[1] = 0x53494D30;
+        cmd->resp[2] = 0x10000000;
+        cmd->resp[3] = 0x01001000;
+        break;
+
+    case SD_SEND_RELATIVE_ADDR:
+        cmd->resp[0] = SIM_RCA << 16;
+        break;
+
+    case SEND_CSD:
+        mmcsd_sim_csd(cmd->resp);
+        break;
+
+    case SD_SWITCH:
+        if (app)
+        {
+            /* ACMD6, the bus width */
+            break;
+        }
+        if (data == RT_NULL || data->blksize * data->blks < 64)
+        {
+            cmd->err = -RT_ERROR;
+            break;
+        }
+        /* high speed supported, the function group 1 switched to it */
+        memset(data->buf, 0, 64);
+        ((rt_uint8_t *)data->buf)[13] = 0x02;
+        ((rt_uint8_t *)data->buf)[16] = cmd->arg & 0xF;
+        break;
+
+    case SET_BLOCK_COUNT:
+        if (app)
+        {
+            mmcsd_sim.pre_erase = cmd->arg;
+            mmcsd_sim.stat.pre_erase++;
+        }
+        else
+        {
+            mmcsd_sim.sbc = cmd->arg;
+            mmcsd_sim.stat.sbc++;
+        }
+        break;
+
+    case READ_SINGLE_BLOCK:
+    case READ_MULTIPLE_BLOCK:
+    case WRITE_BLOCK:
+    case WRITE_MULTIPLE_BLOCK:
+        if (data == RT_NULL)
+        {
+            cmd->err = -RT_ERROR;
+            mmcsd_sim.stat.bad++;
+            break;
+        }
+        mmcsd_sim_data(req);
+        break;
+
+    default:
+        if (app && cmd->cmd_code == SD_APP_OP_COND)
+        {
+            cmd->resp[0] = CARD_BUSY | (1 << 30) | VDD_32_33 | VDD_33_34;
+        }
+        else if (app && cmd->cmd_code == SD_APP_SEND_SCR && data && data->blksize * data->blks >= 8)
+        {
+            /* SD 2.0, 1 and 4 bits bus, CMD23 supported, in the byte order of the card */
+            static const rt_uint8_t scr[8] = {0x02, 0x05, 0x80, 0x02, 0, 0, 0, 0};
+
+            memcpy(data->buf, scr, sizeof(scr));
+        }
+        else if (app && cmd->cmd_code == SD_APP_SEND_NUM_WR_BLKS && data && data->blksize * data->blks >= 4)
+        {
+            memset(data->buf, 0, 4);
+        }
+        else
+        {
+            /* SDIO and MMC commands, no response */
+            cmd->err = -RT_ETIMEOUT;
+        }
+        break;
+    }
+
+    mmcsd_req_complete(host);
+}
+
+static void mmcsd_sim_set_iocfg(struct rt_mmcsd_host *host, struct rt_mmcsd_io_cfg *io_cfg)
+{
+}
+
+static rt_int32_t mmcsd_sim_get_card_status(struct rt_mmcsd_host *host)
+{
+    return 0;
+}
+
+static void mmcsd_sim_enable_sdio_irq(struct rt_mmcsd_host *host, rt_int32_t en)
+{
+}
+
+static const struct rt_mmcsd_host_ops mmcsd_sim_ops =
+{
+    mmcsd_sim_request,
+    mmcsd_sim_set_iocfg,
+    mmcsd_sim_get_card_status,
+    mmcsd_sim_enable_sdio_irq,
+};
+
+static int rt_mmcsd_sim_init(void)
+{
+    struct rt_mmcsd_host *host;
+
+    host = mmcsd_alloc_host();
+    if (host == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    host->ops = &mmcsd_sim_ops;
+    host->freq_min = 400 * 1000;
+    host->freq_max = 50 * 1000 * 1000;
+    host->valid_ocr = VDD_32_33 | VDD_33_34;
+    host->flags = MMCSD_BUSWIDTH_4 | MMCSD_MUTBLKWRITE | MMCSD_SUP_HIGHSPEED;
+    host->max_seg_size = RT_MMCSD_SIM_MAX_BLK_COUNT * SIM_BLOCK_SIZE;
+    host->max_dma_segs = 1;
+    host->max_blk_size = SIM_BLOCK_SIZE;
+    host->max_blk_count = RT_MMCSD_SIM_MAX_BLK_COUNT;
+
+    mmcsd_sim.sbc = -1;
+    mmcsd_sim.host = host;
+    mmcsd_change(host);
+
+    return RT_EOK;
+}
+INIT_DEVICE_EXPORT(rt_mmcsd_sim_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <stdlib.h>
+#include <finsh.h>
+
+#define SIM_BENCH_DEPTH                 16
+
+static void mmcsd_sim_report(const char *name, rt_uint32_t reqs, const struct mmcsd_sim_stat *begin)
+{
+    rt_kprintf("%-6s %6u requests %6u commands %6u transfers %6u CMD23 %6u CMD12 %8u us %u bad\n", name, reqs,
+               mmcsd_sim.stat.cmds - begin->cmds, mmcsd_sim.stat.transfers - begin->transfers,
+               mmcsd_sim.stat.sbc - begin->sbc, mmcsd_sim.stat.stops - begin->stops,
+               mmcsd_sim.stat.us - begin->us, mmcsd_sim.stat.bad - begin->bad);
+}
+
+static rt_uint32_t mmcsd_sim_verify(rt_device_t dev, rt_uint32_t count, rt_uint8_t seed, rt_uint8_t *buf)
+{
+    rt_uint32_t i, bad = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (rt_device_read(dev, i, buf, 1) != 1 || buf[0] != (rt_uint8_t)(seed + i) ||
+            buf[SIM_BLOCK_SIZE - 1] != buf[0])
+        {
+            bad++;
+        }
+    }
+
+    return bad;
+}
+
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+static struct rt_semaphore bench_sem;
+static volatile rt_uint8_t bench_busy[SIM_BENCH_DEPTH];
+
+static void mmcsd_sim_bench_done(struct rt_mmcsd_blk_req *req)
+{
+    bench_busy[(rt_ubase_t)req->user_data] = 0;
+    rt_sem_release(&bench_sem);
+}
+
+/* one block writes of adjacent sectors with up to SIM_BENCH_DEPTH in flight */
+static void mmcsd_sim_bench_async(rt_device_t dev, rt_uint32_t count, rt_uint8_t seed)
+{
+    struct rt_mmcsd_blk_req *reqs;
+    rt_uint8_t *bufs;
+    rt_uint32_t i, k;
+
+    reqs = rt_calloc(SIM_BENCH_DEPTH, sizeof(struct rt_mmcsd_blk_req) + SIM_BLOCK_SIZE);
+    if (reqs == RT_NULL)
+    {
+        rt_kprintf("Low memory!\n");
+        return;
+    }
+    bufs = (rt_uint8_t *)(reqs + SIM_BENCH_DEPTH);
+    rt_sem_init(&bench_sem, "sdsim", SIM_BENCH_DEPTH, RT_IPC_FLAG_FIFO);
+
+    for (i = 0; i < count; i++)
+    {
+        rt_sem_take(&bench_sem, RT_WAITING_FOREVER);
+        for (k = 0; k < SIM_BENCH_DEPTH - 1 && bench_busy[k]; k++)
+            ;
+
+        memset(&reqs[k], 0, sizeof(struct rt_mmcsd_blk_req));
+        memset(bufs + k * SIM_BLOCK_SIZE, (rt_uint8_t)(seed + i), SIM_BLOCK_SIZE);
+        reqs[k].sector = i;
+        reqs[k].blks = 1;
+        reqs[k].buf = bufs + k * SIM_BLOCK_SIZE;
+        reqs[k].dir = 1;
+        reqs[k].done = mmcsd_sim_bench_done;
+        reqs[k].user_data = (void *)(rt_ubase_t)k;
+        bench_busy[k] = 1;
+        if (rt_mmcsd_blk_submit(dev, &reqs[k]) != RT_EOK)
+        {
+            bench_busy[k] = 0;
+            rt_sem_release(&bench_sem);
+        }
+    }
+
+    /* wait for the requests in flight */
+    for (i = 0; i < SIM_BENCH_DEPTH; i++)
+    {
+        rt_sem_take(&bench_sem, RT_WAITING_FOREVER);
+    }
+    rt_sem_detach(&bench_sem);
+    rt_free(reqs);
+}
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
+/* one block writes of the first sectors, one by one and queued */
+static void mmcsd_sim_bench(int argc, char **argv)
+{
+    struct mmcsd_sim_stat begin;
+    rt_device_t dev;
+    rt_uint8_t *buf;
+    rt_uint32_t count = RT_MMCSD_SIM_CARD_BLOCKS, i;
+    char name[RT_NAME_MAX];
+
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+    if (count == 0 || count > RT_MMCSD_SIM_CARD_BLOCKS)
+    {
+        rt_kprintf("Usage: mmcsd_sim_bench [blocks], up to %d\n", RT_MMCSD_SIM_CARD_BLOCKS);
+        return;
+    }
+
+    rt_snprintf(name, sizeof(name), "sd%d", mmcsd_sim.host->id);
+    dev = rt_device_find(name);
+    if (dev == RT_NULL)
+    {
+        rt_kprintf("The simulated card %s is not ready.\n", name);
+        return;
+    }
+
+    buf = rt_malloc(SIM_BLOCK_SIZE);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("Low memory!\n");
+        return;
+    }
+
+    begin = mmcsd_sim.stat;
+    for (i = 0; i < count; i++)
+    {
+        memset(buf, (rt_uint8_t)i, SIM_BLOCK_SIZE);
+        rt_device_write(dev, i, buf, 1);
+    }
+    mmcsd_sim_report("sync", count, &begin);
+    rt_kprintf("verify %6u bad blocks\n", mmcsd_sim_verify(dev, count, 0, buf));
+
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    begin = mmcsd_sim.stat;
+    mmcsd_sim_bench_async(dev, count, 0x80);
+    mmcsd_sim_report("queued", count, &begin);
+    rt_kprintf("verify %6u bad blocks\n", mmcsd_sim_verify(dev, count, 0x80, buf));
+#endif
+
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(mmcsd_sim_bench, write the simulated SD card one block per request: mmcsd_sim_bench [blocks]);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+
+#endif /* RT_MMCSD_USING_SIM_HOST */
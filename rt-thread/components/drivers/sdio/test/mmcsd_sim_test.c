@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Tests of the mmcsd block device on the build host. The simulated host of
+ * mmcsd_sim.c is detected by the core, the threads of the test read and
+ * write the card against copies of its blocks. The simulated card checks the
+ * CMD23/CMD12 and ACMD23 sequences of the data commands. With the request
+ * queue the test also checks that a request sees the writes submitted before
+ * it and none after it, that the requests waiting for the bus are merged and
+ * that the queue thread runs at the priority of the most urgent submitter.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mmcsd_sim.c"
+#include "host.h"
+
+#define TEST_WORKERS        4
+#define TEST_WORKER_BLOCKS  48
+#define TEST_WORKER_BASE    HOST_PART_OFFSET(HOST_PART_NUM)
+#define TEST_WORKER_ROUNDS  2000
+#define TEST_MAX_BLKS       8
+
+static rt_uint8_t test_worker_ref[TEST_WORKERS][TEST_WORKER_BLOCKS * SIM_BLOCK_SIZE];
+static rt_uint8_t test_worker_buf[TEST_WORKERS][TEST_MAX_BLKS * SIM_BLOCK_SIZE];
+static int test_worker_failed[TEST_WORKERS];
+static struct rt_semaphore test_sem;
+static int failed;
+
+static rt_uint32_t test_rand(rt_uint32_t *lcg)
+{
+    *lcg = *lcg * 1103515245u + 12345u;
+    return *lcg >> 8;
+}
+
+#define TEST_CHECK(x)                                                       \
+    do                                                                      \
+    {                                                                       \
+        if (!(x))                                                           \
+        {                                                                   \
+            printf("check failed: %s, line %d\n", #x, __LINE__);            \
+            failed++;                                                       \
+        }                                                                   \
+    } while (0)
+
+/* every worker reads and writes its own blocks of the whole card */
+static void test_worker_entry(void *parameter)
+{
+    rt_uint32_t id = (rt_uint32_t)(rt_ubase_t)parameter;
+    rt_uint32_t lcg = id + 1, round, sector, blks, i;
+    rt_uint8_t *ref = test_worker_ref[id], *buf = test_worker_buf[id];
+    rt_device_t dev = rt_device_find("sd0");
+
+    if (rt_device_read(dev, TEST_WORKER_BASE + id * TEST_WORKER_BLOCKS, ref, TEST_WORKER_BLOCKS) !=
+        TEST_WORKER_BLOCKS)
+    {
+        test_worker_failed[id]++;
+    }
+
+    for (round = 0; round < TEST_WORKER_ROUNDS; round++)
+    {
+        blks = 1 + test_rand(&lcg) % TEST_MAX_BLKS;
+        sector = test_rand(&lcg) % (TEST_WORKER_BLOCKS - blks + 1);
+        if (test_rand(&lcg) & 1)
+        {
+            for (i = 0; i < blks * SIM_BLOCK_SIZE; i++)
+            {
+                buf[i] = (rt_uint8_t)test_rand(&lcg);
+            }
+            memcpy(ref + sector * SIM_BLOCK_SIZE, buf, blks * SIM_BLOCK_SIZE);
+            if (rt_device_write(dev, TEST_WORKER_BASE + id * TEST_WORKER_BLOCKS + sector, buf, blks) != blks)
+            {
+                test_worker_failed[id]++;
+            }
+        }
+        else if (rt_device_read(dev, TEST_WORKER_BASE + id * TEST_WORKER_BLOCKS + sector, buf, blks) != blks ||
+                 memcmp(buf, ref + sector * SIM_BLOCK_SIZE, blks * SIM_BLOCK_SIZE) != 0)
+        {
+            test_worker_failed[id]++;
+        }
+    }
+
+    rt_sem_release(&test_sem);
+}
+
+static void test_sync(void)
+{
+    rt_thread_t thread;
+    char name[RT_NAME_MAX];
+    rt_uint32_t i;
+
+    rt_sem_init(&test_sem, "test", 0, RT_IPC_FLAG_FIFO);
+    for (i = 0; i < TEST_WORKERS; i++)
+    {
+        rt_snprintf(name, sizeof(name), "worker%d", i);
+        thread = rt_thread_create(name, test_worker_entry, (void *)(rt_ubase_t)i, 1024, 15, 20);
+        TEST_CHECK(thread != RT_NULL && rt_thread_startup(thread) == RT_EOK);
+    }
+    for (i = 0; i < TEST_WORKERS; i++)
+    {
+        rt_sem_take(&test_sem, RT_WAITING_FOREVER);
+    }
+    rt_sem_detach(&test_sem);
+
+    for (i = 0; i < TEST_WORKERS; i++)
+    {
+        TEST_CHECK(test_worker_failed[i] == 0);
+        TEST_CHECK(memcmp(mmcsd_sim.mem + (TEST_WORKER_BASE + i * TEST_WORKER_BLOCKS) * SIM_BLOCK_SIZE,
+                          test_worker_ref[i], TEST_WORKER_BLOCKS * SIM_BLOCK_SIZE) == 0);
+    }
+}
+
+/* the commands that framed the multiple block transfers */
+static void test_sequences(void)
+{
+    printf("%u commands %u transfers %u blocks %u CMD23 %u CMD12 %u ACMD23 %u bad\n", mmcsd_sim.stat.cmds,
+           mmcsd_sim.stat.transfers, mmcsd_sim.stat.blocks, mmcsd_sim.stat.sbc, mmcsd_sim.stat.stops,
+           mmcsd_sim.stat.pre_erase, mmcsd_sim.stat.bad);
+    TEST_CHECK(mmcsd_sim.stat.bad == 0);
+#ifdef RT_MMCSD_USING_SET_BLOCK_COUNT
+    /* the card advertises CMD23, a pre-defined write needs no ACMD23 */
+    TEST_CHECK(mmcsd_sim.stat.sbc > 0 && mmcsd_sim.stat.stops == 0 && mmcsd_sim.stat.pre_erase == 0);
+#else
+    TEST_CHECK(mmcsd_sim.stat.sbc == 0 && mmcsd_sim.stat.stops > 0 && mmcsd_sim.stat.pre_erase > 0);
+#endif
+}
+
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+#define TEST_DEPTH          32
+#define TEST_ORDER_ROUNDS   20000
+#define TEST_MERGE_REQS     16
+
+static struct rt_mmcsd_blk_req test_reqs[TEST_DEPTH];
+static rt_uint8_t test_bufs[TEST_DEPTH][TEST_MAX_BLKS * SIM_BLOCK_SIZE];
+static rt_uint8_t test_expect[TEST_DEPTH][TEST_MAX_BLKS * SIM_BLOCK_SIZE];
+static rt_uint8_t test_busy[TEST_DEPTH];
+static struct rt_mutex test_lock;
+static rt_uint8_t test_ref[HOST_PART_SIZE * SIM_BLOCK_SIZE];
+static int test_order_failed;
+
+/* a read must see the writes submitted before it and none after it */
+static void test_done(struct rt_mmcsd_blk_req *req)
+{
+    rt_uint32_t k = req - test_reqs;
+
+    if (req->err != RT_EOK ||
+        (!req->dir && memcmp(req->buf, test_expect[k], req->blks * SIM_BLOCK_SIZE) != 0))
+    {
+        test_order_failed++;
+    }
+    rt_mutex_take(&test_lock, RT_WAITING_FOREVER);
+    test_busy[k] = 0;
+    rt_mutex_release(&test_lock);
+    rt_sem_release(&test_sem);
+}
+
+static struct rt_mmcsd_blk_req *test_req_alloc(void)
+{
+    rt_uint32_t k;
+
+    rt_sem_take(&test_sem, RT_WAITING_FOREVER);
+    rt_mutex_take(&test_lock, RT_WAITING_FOREVER);
+    for (k = 0; k < TEST_DEPTH - 1 && test_busy[k]; k++)
+        ;
+    test_busy[k] = 1;
+    rt_mutex_release(&test_lock);
+    memset(&test_reqs[k], 0, sizeof(struct rt_mmcsd_blk_req));
+    test_reqs[k].buf = test_bufs[k];
+    test_reqs[k].done = test_done;
+
+    return &test_reqs[k];
+}
+
+static void test_submit(rt_device_t dev, struct rt_mmcsd_blk_req *req)
+{
+    rt_uint32_t k = req - test_reqs;
+
+    if (req->dir)
+        memcpy(test_ref + req->sector * SIM_BLOCK_SIZE, req->buf, req->blks * SIM_BLOCK_SIZE);
+    else
+        memcpy(test_expect[k], test_ref + req->sector * SIM_BLOCK_SIZE, req->blks * SIM_BLOCK_SIZE);
+
+    if (rt_mmcsd_blk_submit(dev, req) != RT_EOK)
+    {
+        test_order_failed++;
+        rt_mutex_take(&test_lock, RT_WAITING_FOREVER);
+        test_busy[k] = 0;
+        rt_mutex_release(&test_lock);
+        rt_sem_release(&test_sem);
+    }
+}
+
+static void test_wait_all(void)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < TEST_DEPTH; i++)
+    {
+        rt_sem_take(&test_sem, RT_WAITING_FOREVER);
+    }
+    for (i = 0; i < TEST_DEPTH; i++)
+    {
+        rt_sem_release(&test_sem);
+    }
+}
+
+static void test_order(void)
+{
+    rt_device_t dev = rt_device_find("sd0p1");
+    struct rt_mmcsd_blk_req *req;
+    rt_uint32_t lcg = 7, round, i;
+
+    TEST_CHECK(rt_device_read(dev, 0, test_ref, HOST_PART_SIZE) == HOST_PART_SIZE);
+    for (round = 0; round < TEST_ORDER_ROUNDS; round++)
+    {
+        req = test_req_alloc();
+        req->blks = 1 + test_rand(&lcg) % TEST_MAX_BLKS;
+        req->sector = test_rand(&lcg) % (HOST_PART_SIZE - req->blks + 1);
+        req->dir = test_rand(&lcg) & 1;
+        if (req->dir)
+        {
+            for (i = 0; i < req->blks * SIM_BLOCK_SIZE; i++)
+            {
+                ((rt_uint8_t *)req->buf)[i] = (rt_uint8_t)test_rand(&lcg);
+            }
+        }
+        test_submit(dev, req);
+    }
+    test_wait_all();
+
+    TEST_CHECK(test_order_failed == 0);
+    TEST_CHECK(memcmp(mmcsd_sim.mem + HOST_PART_OFFSET(1) * SIM_BLOCK_SIZE, test_ref, sizeof(test_ref)) == 0);
+}
+
+/* the requests queued while the bus is taken go out merged */
+static void test_merge(void)
+{
+    rt_device_t dev = rt_device_find("sd0p0");
+    struct rt_mmcsd_blk_stat before, after;
+    struct rt_mmcsd_blk_req *req;
+    rt_uint32_t transfers, i;
+
+    TEST_CHECK(rt_device_read(dev, 0, test_ref, HOST_PART_SIZE) == HOST_PART_SIZE);
+    rt_mmcsd_blk_get_stat(dev, &before);
+    transfers = mmcsd_sim.stat.transfers;
+
+    mmcsd_host_lock(mmcsd_sim.host);
+    for (i = 0; i < TEST_MERGE_REQS; i++)
+    {
+        req = test_req_alloc();
+        req->sector = 100 + i;
+        req->blks = 1;
+        req->dir = 1;
+        memset(req->buf, (rt_uint8_t)i, SIM_BLOCK_SIZE);
+        test_submit(dev, req);
+    }
+    mmcsd_host_unlock(mmcsd_sim.host);
+    test_wait_all();
+
+    rt_mmcsd_blk_get_stat(dev, &after);
+    printf("%u one block writes in %u transfers, %u merged\n", TEST_MERGE_REQS,
+           mmcsd_sim.stat.transfers - transfers, after.merged - before.merged);
+    /* the first may go out alone, the rest fills the bounce buffer */
+    TEST_CHECK(mmcsd_sim.stat.transfers - transfers <=
+               1 + (TEST_MERGE_REQS - 1 + RT_MMCSD_BLK_MERGE_BLOCKS - 1) / RT_MMCSD_BLK_MERGE_BLOCKS);
+    TEST_CHECK(test_order_failed == 0);
+    TEST_CHECK(memcmp(mmcsd_sim.mem + HOST_PART_OFFSET(0) * SIM_BLOCK_SIZE, test_ref, sizeof(test_ref)) == 0);
+}
+
+static struct rt_completion test_urgent_done;
+
+static void test_urgent_entry(void *parameter)
+{
+    struct rt_mmcsd_blk_req *req = test_req_alloc();
+
+    req->sector = 200;
+    req->blks = 1;
+    test_submit(rt_device_find("sd0p0"), req);
+    rt_completion_done(&test_urgent_done);
+}
+
+/* a request of a thread of higher priority raises the queue thread until it's served */
+static void test_priority(void)
+{
+    rt_device_t dev = rt_device_find("sd0p0");
+    rt_thread_t queue, urgent;
+    struct rt_mmcsd_blk_req *req;
+    char name[RT_NAME_MAX];
+
+    rt_snprintf(name, sizeof(name), "sdq%d", mmcsd_sim.host->id);
+    queue = rt_thread_find(name);
+    TEST_CHECK(queue != RT_NULL);
+    if (queue == RT_NULL)
+        return;
+    TEST_CHECK(queue->current_priority == RT_MMCSD_BLK_THREAD_PRIORITY);
+
+    mmcsd_host_lock(mmcsd_sim.host);
+    req = test_req_alloc();
+    req->sector = 100;
+    req->blks = 1;
+    req->dir = 1;
+    test_submit(dev, req);
+    TEST_CHECK(rt_thread_self()->current_priority > RT_MMCSD_BLK_THREAD_PRIORITY);
+    TEST_CHECK(queue->current_priority == RT_MMCSD_BLK_THREAD_PRIORITY);
+
+    rt_completion_init(&test_urgent_done);
+    urgent = rt_thread_create("urgent", test_urgent_entry, RT_NULL, 1024, RT_MMCSD_BLK_THREAD_PRIORITY - 5, 20);
+    TEST_CHECK(urgent != RT_NULL && rt_thread_startup(urgent) == RT_EOK);
+    rt_completion_wait(&test_urgent_done, RT_WAITING_FOREVER);
+    TEST_CHECK(queue->current_priority == RT_MMCSD_BLK_THREAD_PRIORITY - 5);
+    mmcsd_host_unlock(mmcsd_sim.host);
+    test_wait_all();
+
+    /* served after the urgent one, the queue is back at its own priority */
+    TEST_CHECK(rt_device_read(dev, 0, test_bufs[0], 1) == 1);
+    TEST_CHECK(queue->current_priority == RT_MMCSD_BLK_THREAD_PRIORITY);
+    TEST_CHECK(test_order_failed == 0);
+}
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
+int main(void)
+{
+    rt_uint32_t i;
+
+    rt_mmcsd_core_init();
+    rt_mmcsd_sim_init();
+    for (i = 0; i < 200 && rt_device_find("sd0") == RT_NULL; i++)
+    {
+        rt_thread_mdelay(10);
+    }
+    if (rt_device_find("sd0") == RT_NULL || rt_device_find("sd0p1") == RT_NULL)
+    {
+        printf("the simulated card is not detected\nFAILED\n");
+        return 1;
+    }
+
+    test_sync();
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    rt_sem_init(&test_sem, "test", TEST_DEPTH, RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&test_lock, "test", RT_IPC_FLAG_PRIO);
+    test_order();
+    test_merge();
+    test_priority();
+    rt_mutex_detach(&test_lock);
+    rt_sem_detach(&test_sem);
+#endif
+    test_sequences();
+
+    rt_mmcsd_blk_remove(mmcsd_sim.host->card);
+    TEST_CHECK(rt_device_find("sd0") == RT_NULL);
+
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed != 0;
+}
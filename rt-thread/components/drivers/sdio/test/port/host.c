@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The kernel services the mmcsd core and the block device need on the build
+ * host. The threads are POSIX threads and the IPC objects wait on one
+ * condition, the priorities are kept but not scheduled by. The heap is the C
+ * library one, the device table a list of names and the card has the
+ * partitions of host.h instead of a partition table.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <dfs_fs.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "host.h"
+
+#define HOST_THREAD_MAX     16
+
+static pthread_mutex_t host_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t host_cond = PTHREAD_COND_INITIALIZER;
+static struct rt_thread host_main_thread =
+{
+    .name = "main",
+    .type = RT_Object_Class_Thread | RT_Object_Class_Static,
+    .current_priority = RT_MAIN_THREAD_PRIORITY,
+    .init_priority = RT_MAIN_THREAD_PRIORITY,
+};
+static rt_thread_t host_threads[HOST_THREAD_MAX] = {&host_main_thread};
+static __thread rt_thread_t host_self;
+static __thread rt_err_t host_errno;
+static rt_device_t host_devices;
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void *rt_calloc(rt_size_t count, rt_size_t size)
+{
+    return calloc(count, size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+int rt_snprintf(char *buf, rt_size_t size, const char *fmt, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, fmt);
+    length = vsnprintf(buf, size, fmt, args);
+    va_end(args);
+
+    return length;
+}
+
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, fmt);
+    length = vprintf(fmt, args);
+    va_end(args);
+
+    return length;
+}
+
+void rt_assert_handler(const char *ex, const char *func, rt_size_t line)
+{
+    printf("(%s) assertion failed at function:%s, line number:%d\n", ex, func, (int)line);
+    abort();
+}
+
+rt_err_t rt_get_errno(void)
+{
+    return host_errno;
+}
+
+void rt_set_errno(rt_err_t no)
+{
+    host_errno = no;
+}
+
+int __rt_ffs(int value)
+{
+    return __builtin_ffs(value);
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (rt_tick_t)(ts.tv_sec * RT_TICK_PER_SECOND + ts.tv_nsec / (1000000000 / RT_TICK_PER_SECOND));
+}
+
+/* waits on the host condition with the lock held, RT_WAITING_NO only polls */
+static rt_err_t host_wait(rt_int32_t timeout)
+{
+    if (timeout == RT_WAITING_NO)
+    {
+        return -RT_ETIMEOUT;
+    }
+    pthread_cond_wait(&host_cond, &host_lock);
+    return RT_EOK;
+}
+
+rt_thread_t rt_thread_self(void)
+{
+    return host_self ? host_self : &host_main_thread;
+}
+
+static void *host_thread_entry(void *parameter)
+{
+    rt_thread_t thread = (rt_thread_t)parameter;
+    int i;
+
+    host_self = thread;
+    ((void (*)(void *))thread->entry)(thread->parameter);
+
+    pthread_mutex_lock(&host_lock);
+    for (i = 0; i < HOST_THREAD_MAX; i++)
+    {
+        if (host_threads[i] == thread)
+        {
+            host_threads[i] = RT_NULL;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+    if (!(thread->type & RT_Object_Class_Static))
+    {
+        rt_free(thread);
+    }
+
+    return NULL;
+}
+
+rt_err_t rt_thread_init(struct rt_thread *thread, const char *name, void (*entry)(void *parameter),
+                        void *parameter, void *stack_start, rt_uint32_t stack_size, rt_uint8_t priority,
+                        rt_uint32_t tick)
+{
+    rt_memset(thread, 0, sizeof(struct rt_thread));
+    rt_strncpy(thread->name, name, RT_NAME_MAX - 1);
+    thread->type = RT_Object_Class_Thread | RT_Object_Class_Static;
+    thread->entry = (void *)entry;
+    thread->parameter = parameter;
+    thread->init_priority = priority;
+    thread->current_priority = priority;
+
+    return RT_EOK;
+}
+
+rt_thread_t rt_thread_create(const char *name, void (*entry)(void *parameter), void *parameter,
+                             rt_uint32_t stack_size, rt_uint8_t priority, rt_uint32_t tick)
+{
+    rt_thread_t thread = rt_malloc(sizeof(struct rt_thread));
+
+    if (thread == RT_NULL)
+    {
+        return RT_NULL;
+    }
+    rt_thread_init(thread, name, entry, parameter, RT_NULL, stack_size, priority, tick);
+    thread->type = RT_Object_Class_Thread;
+
+    return thread;
+}
+
+rt_err_t rt_thread_startup(rt_thread_t thread)
+{
+    pthread_t id;
+    int i;
+
+    pthread_mutex_lock(&host_lock);
+    for (i = 0; i < HOST_THREAD_MAX && host_threads[i] != RT_NULL; i++)
+        ;
+    if (i < HOST_THREAD_MAX)
+    {
+        host_threads[i] = thread;
+    }
+    pthread_mutex_unlock(&host_lock);
+    if (i == HOST_THREAD_MAX || pthread_create(&id, NULL, host_thread_entry, thread) != 0)
+    {
+        return -RT_ERROR;
+    }
+    pthread_detach(id);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_delete(rt_thread_t thread)
+{
+    /* the threads of the host end by returning from their entries */
+    return -RT_ERROR;
+}
+
+rt_thread_t rt_thread_find(char *name)
+{
+    rt_thread_t thread = RT_NULL;
+    int i;
+
+    pthread_mutex_lock(&host_lock);
+    for (i = 0; i < HOST_THREAD_MAX; i++)
+    {
+        if (host_threads[i] && rt_strncmp(host_threads[i]->name, name, RT_NAME_MAX) == 0)
+        {
+            thread = host_threads[i];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+
+    return thread;
+}
+
+rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg)
+{
+    if (cmd != RT_THREAD_CTRL_CHANGE_PRIORITY)
+    {
+        return -RT_ERROR;
+    }
+    thread->current_priority = *(rt_uint8_t *)arg;
+
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_mdelay(rt_int32_t ms)
+{
+    usleep(ms * 1000);
+    return RT_EOK;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    return rt_thread_mdelay(tick * 1000 / RT_TICK_PER_SECOND);
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    mutex->owner = RT_NULL;
+    mutex->hold = 0;
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_detach(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    rt_thread_t thread = rt_thread_self();
+
+    pthread_mutex_lock(&host_lock);
+    while (mutex->owner != RT_NULL && mutex->owner != thread)
+    {
+        if (host_wait(time) != RT_EOK)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return -RT_ETIMEOUT;
+        }
+    }
+    mutex->owner = thread;
+    mutex->hold++;
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    pthread_mutex_lock(&host_lock);
+    RT_ASSERT(mutex->owner == rt_thread_self());
+    if (--mutex->hold == 0)
+    {
+        mutex->owner = RT_NULL;
+        pthread_cond_broadcast(&host_cond);
+    }
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_init(rt_sem_t sem, const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    sem->value = value;
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_detach(rt_sem_t sem)
+{
+    return RT_EOK;
+}
+
+rt_sem_t rt_sem_create(const char *name, rt_uint32_t value, rt_uint8_t flag)
+{
+    rt_sem_t sem = rt_calloc(1, sizeof(struct rt_semaphore));
+
+    if (sem)
+    {
+        sem->value = value;
+    }
+    return sem;
+}
+
+rt_err_t rt_sem_delete(rt_sem_t sem)
+{
+    rt_free(sem);
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
+{
+    pthread_mutex_lock(&host_lock);
+    while (sem->value == 0)
+    {
+        if (host_wait(time) != RT_EOK)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return -RT_ETIMEOUT;
+        }
+    }
+    sem->value--;
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_sem_release(rt_sem_t sem)
+{
+    pthread_mutex_lock(&host_lock);
+    sem->value++;
+    pthread_cond_broadcast(&host_cond);
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+void rt_completion_init(struct rt_completion *completion)
+{
+    completion->flag = 0;
+}
+
+rt_err_t rt_completion_wait(struct rt_completion *completion, rt_int32_t timeout)
+{
+    pthread_mutex_lock(&host_lock);
+    while (completion->flag == 0)
+    {
+        if (host_wait(timeout) != RT_EOK)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return -RT_ETIMEOUT;
+        }
+    }
+    completion->flag = 0;
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+void rt_completion_done(struct rt_completion *completion)
+{
+    pthread_mutex_lock(&host_lock);
+    completion->flag = 1;
+    pthread_cond_broadcast(&host_cond);
+    pthread_mutex_unlock(&host_lock);
+}
+
+rt_err_t rt_mb_init(rt_mailbox_t mb, const char *name, void *msgpool, rt_size_t size, rt_uint8_t flag)
+{
+    mb->msg_pool = (rt_ubase_t *)msgpool;
+    mb->size = size;
+    mb->entry = 0;
+    mb->in_offset = 0;
+    mb->out_offset = 0;
+
+    return RT_EOK;
+}
+
+rt_err_t rt_mb_send(rt_mailbox_t mb, rt_ubase_t value)
+{
+    pthread_mutex_lock(&host_lock);
+    if (mb->entry == mb->size)
+    {
+        pthread_mutex_unlock(&host_lock);
+        return -RT_EFULL;
+    }
+    mb->msg_pool[mb->in_offset] = value;
+    mb->in_offset = (mb->in_offset + 1) % mb->size;
+    mb->entry++;
+    pthread_cond_broadcast(&host_cond);
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_ubase_t *value, rt_int32_t timeout)
+{
+    pthread_mutex_lock(&host_lock);
+    while (mb->entry == 0)
+    {
+        if (host_wait(timeout) != RT_EOK)
+        {
+            pthread_mutex_unlock(&host_lock);
+            return -RT_ETIMEOUT;
+        }
+    }
+    *value = mb->msg_pool[mb->out_offset];
+    mb->out_offset = (mb->out_offset + 1) % mb->size;
+    mb->entry--;
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (rt_device_find(name) != RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+
+    pthread_mutex_lock(&host_lock);
+    rt_strncpy(dev->parent.name, name, RT_NAME_MAX - 1);
+    dev->flag = flags;
+    /* the list is linked through the object list node, unused on the host */
+    dev->parent.list.next = (rt_list_t *)host_devices;
+    host_devices = dev;
+    pthread_mutex_unlock(&host_lock);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_device_unregister(rt_device_t dev)
+{
+    rt_device_t *node;
+    rt_err_t result = -RT_ERROR;
+
+    pthread_mutex_lock(&host_lock);
+    for (node = &host_devices; *node != RT_NULL; node = (rt_device_t *)&(*node)->parent.list.next)
+    {
+        if (*node == dev)
+        {
+            *node = (rt_device_t)dev->parent.list.next;
+            result = RT_EOK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+
+    return result;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+    rt_device_t dev;
+
+    pthread_mutex_lock(&host_lock);
+    for (dev = host_devices; dev != RT_NULL; dev = (rt_device_t)dev->parent.list.next)
+    {
+        if (rt_strncmp(dev->parent.name, name, RT_NAME_MAX) == 0)
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&host_lock);
+
+    return dev;
+}
+
+rt_size_t rt_device_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    return dev->read(dev, pos, buffer, size);
+}
+
+rt_size_t rt_device_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    return dev->write(dev, pos, buffer, size);
+}
+
+int dfs_filesystem_get_partition(struct dfs_partition *part, uint8_t *buf, uint32_t pindex)
+{
+    if (pindex >= HOST_PART_NUM)
+    {
+        return -RT_ERROR;
+    }
+
+    part->type = 0x0C;
+    part->offset = HOST_PART_OFFSET(pindex);
+    part->size = HOST_PART_SIZE;
+
+    return RT_EOK;
+}
+
+const char *dfs_filesystem_get_mounted_path(struct rt_device *device)
+{
+    return RT_NULL;
+}
+
+int dfs_unmount(const char *specialfile)
+{
+    return 0;
+}
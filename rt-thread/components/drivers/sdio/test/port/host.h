@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __SDIO_TEST_HOST_H__
+#define __SDIO_TEST_HOST_H__
+
+#include <rtthread.h>
+
+/* the partitions the card reports, the rest of it is outside of them */
+#define HOST_PART_NUM       2
+#define HOST_PART_OFFSET(i) (1 + (i) * 400)
+#define HOST_PART_SIZE      400
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/* The configuration of the host build */
+
+#ifndef RT_CONFIG_H__
+#define RT_CONFIG_H__
+
+#define RT_NAME_MAX 16
+#define RT_ALIGN_SIZE 8
+#define RT_THREAD_PRIORITY_32
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_TICK_PER_SECOND 1000
+#define RT_MAIN_THREAD_PRIORITY 20
+#define RT_USING_SEMAPHORE
+#define RT_USING_MUTEX
+#define RT_USING_MAILBOX
+#define RT_USING_HEAP
+#define RT_USING_DEVICE
+#define RT_USING_DEVICE_IPC
+#define RT_USING_CONSOLE
+#define RT_DEBUG
+#define RT_DEBUG_CONTEXT_CHECK 0
+#define RT_KSERVICE_USING_STDLIB
+#define RT_KSERVICE_USING_STDLIB_MEMORY
+
+#define RT_USING_SDIO
+#define RT_SDIO_STACK_SIZE 512
+#define RT_SDIO_THREAD_PRIORITY 15
+#define RT_MMCSD_STACK_SIZE 1024
+#define RT_MMCSD_THREAD_PREORITY 22
+#define RT_MMCSD_MAX_PARTITION 16
+/* the direct build uses CMD12 and ACMD23, the queued one CMD23 */
+#ifndef MMCSD_TEST_DIRECT
+#define RT_MMCSD_USING_SET_BLOCK_COUNT
+#define RT_MMCSD_USING_BLK_QUEUE
+#define RT_MMCSD_BLK_MERGE_BLOCKS 8
+#define RT_MMCSD_BLK_THREAD_STACK_SIZE 1024
+#define RT_MMCSD_BLK_THREAD_PRIORITY 10
+#endif
+#define RT_MMCSD_PRE_ERASE_BLOCKS 4
+#define RT_MMCSD_USING_SIM_HOST
+#define RT_MMCSD_SIM_CARD_BLOCKS 1024
+#define RT_MMCSD_SIM_MAX_BLK_COUNT 64
+
+#endif
@@ -21,6 +21,12 @@ struct spi_flash_device
     struct rt_spi_device *          rt_spi_device;
     struct rt_mutex                 lock;
     void *                          user_data;
+#ifdef RT_SFUD_USING_READ_CACHE
+    struct rt_sfud_read_cache *     read_cache;
+#endif
+#ifdef RT_SFUD_USING_BUSY_SPIN
+    rt_uint8_t                      busy_spin;  /* a page program was sent, spin on the next status read */
+#endif
 };
 
 typedef struct spi_flash_device *rt_spi_flash_device_t;
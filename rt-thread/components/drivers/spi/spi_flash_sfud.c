@@ -31,6 +31,29 @@
 }
 #endif /* RT_SFUD_DEFAULT_SPI_CFG */
 
+#ifdef RT_SFUD_USING_READ_CACHE
+#ifndef RT_SFUD_READ_CACHE_LINES
+#define RT_SFUD_READ_CACHE_LINES 4
+#endif
+#ifndef RT_SFUD_READ_CACHE_LINE_SIZE
+#define RT_SFUD_READ_CACHE_LINE_SIZE 256
+#endif
+#if (RT_SFUD_READ_CACHE_LINE_SIZE & (RT_SFUD_READ_CACHE_LINE_SIZE - 1)) != 0
+#error "RT_SFUD_READ_CACHE_LINE_SIZE must be a power of 2"
+#endif
+#endif /* RT_SFUD_USING_READ_CACHE */
+
+#ifdef RT_SFUD_USING_BUSY_SPIN
+#include <rthw.h>
+
+#ifndef RT_SFUD_BUSY_SPIN_US
+#define RT_SFUD_BUSY_SPIN_US 2000
+#endif
+#ifndef RT_SFUD_BUSY_POLL_US
+#define RT_SFUD_BUSY_POLL_US 10
+#endif
+#endif /* RT_SFUD_USING_BUSY_SPIN */
+
 #ifdef SFUD_USING_QSPI
 #define RT_SFUD_DEFAULT_QSPI_CFG                 \
 {                                                \
@@ -125,7 +148,7 @@ static rt_size_t rt_sfud_write(rt_device_t dev, rt_off_t pos, const void* buffer
 /**
  * SPI write data then read data
  */
-static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
+static sfud_err spi_transfer(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
         size_t read_size) {
     sfud_err result = SFUD_SUCCESS;
     sfud_flash *sfud_dev = (sfud_flash *) (spi->user_data);
@@ -181,7 +204,7 @@ static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, si
 /**
  * QSPI fast read data
  */
-static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format, uint8_t *read_buf, size_t read_size) {
+static sfud_err qspi_transfer_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format, uint8_t *read_buf, size_t read_size) {
     struct rt_qspi_message message;
     sfud_err result = SFUD_SUCCESS;
 
@@ -223,6 +246,232 @@ static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi
 }
 #endif
 
+#ifdef RT_SFUD_USING_READ_CACHE
+/**
+ * read data by the read command which SFUD selected for the flash
+ */
+static sfud_err flash_read(sfud_flash *sfud_dev, uint32_t addr, uint8_t *read_buf, size_t read_size) {
+    uint8_t cmd_data[5], cmd_size, i;
+
+#ifdef SFUD_USING_QSPI
+    if (sfud_dev->read_cmd_format.instruction != SFUD_CMD_READ_DATA) {
+        return qspi_transfer_read(&sfud_dev->spi, addr, &sfud_dev->read_cmd_format, read_buf, read_size);
+    }
+#endif
+    cmd_size = sfud_dev->addr_in_4_byte ? 5 : 4;
+    cmd_data[0] = SFUD_CMD_READ_DATA;
+    for (i = 1; i < cmd_size; i++) {
+        cmd_data[i] = (addr >> ((cmd_size - i - 1) * 8)) & 0xFF;
+    }
+
+    return spi_transfer(&sfud_dev->spi, cmd_data, cmd_size, read_buf, read_size);
+}
+
+#define READ_CACHE_LINE_EMPTY 0xFFFFFFFF
+
+/**
+ * Read cache of the small reads. The reads of a line or larger are one continuous read of the flash, the DMA of the SPI
+ * bus transfers them. The page programs invalidate the lines they write, the other commands which modify the flash
+ * invalidate all lines.
+ */
+struct rt_sfud_read_cache {
+    struct {
+        uint32_t addr;
+        uint32_t used;
+        uint8_t buf[RT_SFUD_READ_CACHE_LINE_SIZE];
+    } line[RT_SFUD_READ_CACHE_LINES];
+    uint32_t used;
+    struct rt_sfud_read_cache_stat stat;
+};
+
+static void read_cache_invalidate(struct rt_sfud_read_cache *cache, uint32_t addr, size_t size) {
+    size_t i;
+
+    for (i = 0; i < RT_SFUD_READ_CACHE_LINES; i++) {
+        if (cache->line[i].addr != READ_CACHE_LINE_EMPTY && cache->line[i].addr < addr + size
+                && addr < cache->line[i].addr + RT_SFUD_READ_CACHE_LINE_SIZE) {
+            cache->line[i].addr = READ_CACHE_LINE_EMPTY;
+            cache->stat.invalidate++;
+        }
+    }
+}
+
+static sfud_err read_cache_read(sfud_flash *sfud_dev, struct rt_sfud_read_cache *cache, uint32_t addr,
+        uint8_t *read_buf, size_t read_size) {
+    sfud_err result = SFUD_SUCCESS;
+    uint32_t line_addr;
+    size_t i, lru, off, size;
+
+    if (read_size >= RT_SFUD_READ_CACHE_LINE_SIZE) {
+        cache->stat.bypass++;
+        return flash_read(sfud_dev, addr, read_buf, read_size);
+    }
+
+    for (; read_size; addr += size, read_buf += size, read_size -= size) {
+        line_addr = addr & ~(RT_SFUD_READ_CACHE_LINE_SIZE - 1);
+        off = addr - line_addr;
+        size = RT_SFUD_READ_CACHE_LINE_SIZE - off < read_size ? RT_SFUD_READ_CACHE_LINE_SIZE - off : read_size;
+
+        for (i = 0, lru = 0; i < RT_SFUD_READ_CACHE_LINES; i++) {
+            if (cache->line[i].addr == line_addr) {
+                break;
+            }
+            if (cache->line[i].used < cache->line[lru].used) {
+                lru = i;
+            }
+        }
+        if (i < RT_SFUD_READ_CACHE_LINES) {
+            cache->stat.hit++;
+        } else if (line_addr + RT_SFUD_READ_CACHE_LINE_SIZE > sfud_dev->chip.capacity) {
+            cache->stat.bypass++;
+            result = flash_read(sfud_dev, addr, read_buf, size);
+            if (result != SFUD_SUCCESS) {
+                break;
+            }
+            continue;
+        } else {
+            i = lru;
+            cache->stat.miss++;
+            cache->line[i].addr = READ_CACHE_LINE_EMPTY;
+            result = flash_read(sfud_dev, line_addr, cache->line[i].buf, RT_SFUD_READ_CACHE_LINE_SIZE);
+            if (result != SFUD_SUCCESS) {
+                break;
+            }
+            cache->line[i].addr = line_addr;
+        }
+        cache->line[i].used = ++cache->used;
+        rt_memcpy(read_buf, cache->line[i].buf + off, size);
+    }
+
+    return result;
+}
+
+/**
+ * the command modifies the flash, invalidate the lines of it
+ */
+static void read_cache_command(sfud_flash *sfud_dev, struct rt_sfud_read_cache *cache, const uint8_t *write_buf,
+        size_t write_size) {
+    uint8_t cmd_size = sfud_dev->addr_in_4_byte ? 5 : 4, i;
+    uint32_t addr = 0;
+
+    switch (write_buf[0]) {
+    case SFUD_CMD_READ_STATUS_REGISTER:
+    case SFUD_CMD_WRITE_ENABLE:
+    case SFUD_CMD_WRITE_DISABLE:
+    case SFUD_CMD_JEDEC_ID:
+    case SFUD_CMD_READ_SFDP_REGISTER:
+    case SFUD_CMD_READ_UNIQUE_ID:
+    case SFUD_CMD_MANUFACTURER_DEVICE_ID:
+        break;
+    case SFUD_CMD_PAGE_PROGRAM:
+        if (write_size >= cmd_size) {
+            for (i = 1; i < cmd_size; i++) {
+                addr = (addr << 8) | write_buf[i];
+            }
+            read_cache_invalidate(cache, addr, write_size - cmd_size);
+            break;
+        }
+        /* fall through */
+    default:
+        /* the erases, the status and the address mode commands */
+        read_cache_invalidate(cache, 0, sfud_dev->chip.capacity);
+        break;
+    }
+}
+
+/**
+ * get the read cache statistics of the SPI flash device
+ *
+ * @param spi_flash_dev SPI flash device
+ * @param stat the buffer holding the statistics
+ *
+ * @return the operation status, RT_EOK on successful
+ */
+rt_err_t rt_sfud_read_cache_get_stat(rt_spi_flash_device_t spi_flash_dev, struct rt_sfud_read_cache_stat *stat) {
+    RT_ASSERT(spi_flash_dev);
+    RT_ASSERT(stat);
+
+    if (spi_flash_dev->read_cache == RT_NULL) {
+        return -RT_ERROR;
+    }
+    rt_mutex_take(&(spi_flash_dev->lock), RT_WAITING_FOREVER);
+    *stat = spi_flash_dev->read_cache->stat;
+    rt_mutex_release(&(spi_flash_dev->lock));
+
+    return RT_EOK;
+}
+#endif /* RT_SFUD_USING_READ_CACHE */
+
+/**
+ * SPI write data then read data, the port of SFUD
+ */
+static sfud_err spi_write_read(const sfud_spi *spi, const uint8_t *write_buf, size_t write_size, uint8_t *read_buf,
+        size_t read_size) {
+    sfud_err result = SFUD_SUCCESS;
+    sfud_flash *sfud_dev = (sfud_flash *) (spi->user_data);
+    struct spi_flash_device *rtt_dev = (struct spi_flash_device *) (sfud_dev->user_data);
+#ifdef RT_SFUD_USING_BUSY_SPIN
+    uint32_t spin;
+#endif
+
+    RT_ASSERT(spi);
+    RT_ASSERT(sfud_dev);
+    RT_ASSERT(rtt_dev);
+
+#ifdef RT_SFUD_USING_READ_CACHE
+    if (rtt_dev->read_cache && write_size) {
+        uint8_t cmd_size = sfud_dev->addr_in_4_byte ? 5 : 4, i;
+        uint32_t addr = 0;
+
+        if (write_buf[0] == SFUD_CMD_READ_DATA && write_size == cmd_size && read_size) {
+            for (i = 1; i < cmd_size; i++) {
+                addr = (addr << 8) | write_buf[i];
+            }
+            return read_cache_read(sfud_dev, rtt_dev->read_cache, addr, read_buf, read_size);
+        }
+        read_cache_command(sfud_dev, rtt_dev->read_cache, write_buf, write_size);
+    }
+#endif /* RT_SFUD_USING_READ_CACHE */
+
+    result = spi_transfer(spi, write_buf, write_size, read_buf, read_size);
+
+#ifdef RT_SFUD_USING_BUSY_SPIN
+    /* The page program completes in hundreds of microseconds, the retry delay of SFUD sleeps a tick. Poll the status
+     * after it here, the next page is sent once the flash is ready. The erases take milliseconds and are left to the
+     * tick sleeps of SFUD. */
+    if (write_size && write_buf[0] == SFUD_CMD_PAGE_PROGRAM) {
+        rtt_dev->busy_spin = 1;
+    } else if (write_size == 1 && write_buf[0] == SFUD_CMD_READ_STATUS_REGISTER && read_size == 1 && rtt_dev->busy_spin) {
+        rtt_dev->busy_spin = 0;
+        for (spin = 0; result == SFUD_SUCCESS && (read_buf[0] & SFUD_STATUS_REGISTER_BUSY) && spin < RT_SFUD_BUSY_SPIN_US;
+                spin += RT_SFUD_BUSY_POLL_US) {
+            rt_hw_us_delay(RT_SFUD_BUSY_POLL_US);
+            result = spi_transfer(spi, write_buf, write_size, read_buf, read_size);
+        }
+    }
+#endif /* RT_SFUD_USING_BUSY_SPIN */
+
+    return result;
+}
+
+#ifdef SFUD_USING_QSPI
+/**
+ * QSPI fast read data, the port of SFUD
+ */
+static sfud_err qspi_read(const struct __sfud_spi *spi, uint32_t addr, sfud_qspi_read_cmd_format *qspi_read_cmd_format, uint8_t *read_buf, size_t read_size) {
+#ifdef RT_SFUD_USING_READ_CACHE
+    sfud_flash *sfud_dev = (sfud_flash *) (spi->user_data);
+    struct spi_flash_device *rtt_dev = (struct spi_flash_device *) (sfud_dev->user_data);
+
+    if (rtt_dev->read_cache) {
+        return read_cache_read(sfud_dev, rtt_dev->read_cache, addr, read_buf, read_size);
+    }
+#endif
+
+    return qspi_transfer_read(spi, addr, qspi_read_cmd_format, read_buf, read_size);
+}
+#endif
+
 static void spi_lock(const sfud_spi *spi) {
     sfud_flash *sfud_dev = (sfud_flash *) (spi->user_data);
     struct spi_flash_device *rtt_dev = (struct spi_flash_device *) (sfud_dev->user_data);
@@ -303,6 +552,9 @@ rt_spi_flash_device_t rt_sfud_flash_probe_ex(const char *spi_flash_dev_name, con
     sfud_flash *sfud_dev = RT_NULL;
     char *spi_flash_dev_name_bak = RT_NULL, *spi_dev_name_bak = RT_NULL;
     extern sfud_err sfud_device_init(sfud_flash *flash);
+#ifdef RT_SFUD_USING_READ_CACHE
+    size_t i;
+#endif
 #ifdef SFUD_USING_QSPI
     struct rt_qspi_device *qspi_dev = RT_NULL;
 #endif
@@ -319,6 +571,17 @@ rt_spi_flash_device_t rt_sfud_flash_probe_ex(const char *spi_flash_dev_name, con
         rt_memset(rtt_dev, 0, sizeof(struct spi_flash_device));
         /* initialize lock */
         rt_mutex_init(&(rtt_dev->lock), spi_flash_dev_name, RT_IPC_FLAG_PRIO);
+#ifdef RT_SFUD_USING_READ_CACHE
+        rtt_dev->read_cache = (struct rt_sfud_read_cache *) rt_malloc(sizeof(struct rt_sfud_read_cache));
+        if (rtt_dev->read_cache) {
+            rt_memset(rtt_dev->read_cache, 0, sizeof(struct rt_sfud_read_cache));
+            for (i = 0; i < RT_SFUD_READ_CACHE_LINES; i++) {
+                rtt_dev->read_cache->line[i].addr = READ_CACHE_LINE_EMPTY;
+            }
+        } else {
+            LOG_W("Warning: Low memory, the read cache of %s is disabled.", spi_flash_dev_name);
+        }
+#endif
     }
 
     if (rtt_dev && sfud_dev && spi_flash_dev_name_bak && spi_dev_name_bak) {
@@ -406,6 +669,9 @@ error:
 
     if (rtt_dev) {
         rt_mutex_detach(&(rtt_dev->lock));
+#ifdef RT_SFUD_USING_READ_CACHE
+        rt_free(rtt_dev->read_cache);
+#endif
     }
     /* may be one of objects memory was malloc success, so need free all */
     rt_free(rtt_dev);
@@ -453,6 +719,9 @@ rt_err_t rt_sfud_flash_delete(rt_spi_flash_device_t spi_flash_dev) {
 
     rt_mutex_detach(&(spi_flash_dev->lock));
 
+#ifdef RT_SFUD_USING_READ_CACHE
+    rt_free(spi_flash_dev->read_cache);
+#endif
     rt_free(sfud_flash_dev->spi.name);
     rt_free(sfud_flash_dev->name);
     rt_free(sfud_flash_dev);
@@ -523,6 +792,7 @@ static void sf(uint8_t argc, char **argv) {
 #define CMD_ERASE_INDEX               3
 #define CMD_RW_STATUS_INDEX           4
 #define CMD_BENCH_INDEX               5
+#define CMD_CACHE_INDEX               6
 
     sfud_err result = SFUD_SUCCESS;
     static const sfud_flash *sfud_dev = NULL;
@@ -536,6 +806,9 @@ static void sf(uint8_t argc, char **argv) {
             [CMD_ERASE_INDEX]     = "sf erase addr size              - erase 'size' bytes starting at 'addr'",
             [CMD_RW_STATUS_INDEX] = "sf status [<volatile> <status>] - read or write '1:volatile|0:non-volatile' 'status'",
             [CMD_BENCH_INDEX]     = "sf bench                        - full chip benchmark. DANGER: It will erase full chip!",
+#ifdef RT_SFUD_USING_READ_CACHE
+            [CMD_CACHE_INDEX]     = "sf cache                        - show the read cache statistics",
+#endif
     };
 
     if (argc < 2) {
@@ -759,7 +1032,20 @@ static void sf(uint8_t argc, char **argv) {
                 }
                 rt_free(write_data);
                 rt_free(read_data);
-            } else {
+            }
+#ifdef RT_SFUD_USING_READ_CACHE
+            else if (!rt_strcmp(operator, "cache")) {
+                struct rt_sfud_read_cache_stat stat;
+
+                if (rt_sfud_read_cache_get_stat(rtt_dev, &stat) != RT_EOK) {
+                    rt_kprintf("The read cache of %s is disabled.\n", sfud_dev->name);
+                    return;
+                }
+                rt_kprintf("The %s read cache: hit %u, miss %u, bypass %u, invalidated %u lines.\n", sfud_dev->name,
+                        stat.hit, stat.miss, stat.bypass, stat.invalidate);
+            }
+#endif /* RT_SFUD_USING_READ_CACHE */
+            else {
                 rt_kprintf("Usage:\n");
                 for (i = 0; i < sizeof(sf_help_info) / sizeof(char*); i++) {
                     rt_kprintf("%s\n", sf_help_info[i]);
@@ -66,4 +66,24 @@ sfud_flash_t rt_sfud_flash_find(const char *spi_dev_name);
  */
 sfud_flash_t rt_sfud_flash_find_by_dev_name(const char *flash_dev_name);
 
+#ifdef RT_SFUD_USING_READ_CACHE
+struct rt_sfud_read_cache_stat
+{
+    rt_uint32_t hit;                /* the small reads served by the cache lines */
+    rt_uint32_t miss;               /* the lines filled from the flash */
+    rt_uint32_t bypass;             /* the large reads sent to the flash directly */
+    rt_uint32_t invalidate;         /* the lines invalidated by the programs and the erases */
+};
+
+/**
+ * Get the read cache statistics of the SPI flash device
+ *
+ * @param spi_flash_dev SPI flash device
+ * @param stat the buffer holding the statistics
+ *
+ * @return the operation status, RT_EOK on successful, -RT_ERROR when the cache is disabled
+ */
+rt_err_t rt_sfud_read_cache_get_stat(rt_spi_flash_device_t spi_flash_dev, struct rt_sfud_read_cache_stat *stat);
+#endif /* RT_SFUD_USING_READ_CACHE */
+
 #endif /* _SPI_FLASH_SFUD_H_ */
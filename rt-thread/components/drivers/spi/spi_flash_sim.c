@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Simulated SPI NOR flash: the SPI bus "sfsim" with the device "sfsim0"
+ * answers the commands of SFUD from RAM, so the real driver and library run
+ * on it. The chip reports the JEDEC ID of a W25Q40BV, the addresses wrap at
+ * RT_SFUD_SIM_FLASH_SIZE.
+ *
+ * The page program is busy for RT_SFUD_SIM_PROGRAM_POLLS status reads or
+ * until the tick changes, whichever comes first, the erases are busy for
+ * milliseconds of ticks. The status reads and the commands sent while busy
+ * are counted, the sf_sim_bench command reports them.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <string.h>
+#include "spi_flash.h"
+#include "spi_flash_sfud.h"
+
+#ifdef RT_SFUD_USING_SIM_FLASH
+
+#ifndef RT_SFUD_SIM_FLASH_SIZE
+#define RT_SFUD_SIM_FLASH_SIZE          (64 * 1024)
+#endif
+#ifndef RT_SFUD_SIM_PROGRAM_POLLS
+#define RT_SFUD_SIM_PROGRAM_POLLS       40
+#endif
+#ifndef RT_SFUD_SIM_SECTOR_ERASE_MS
+#define RT_SFUD_SIM_SECTOR_ERASE_MS     45
+#endif
+
+#define SFSIM_BUS_NAME                  "sfsim"
+#define SFSIM_DEV_NAME                  "sfsim0"
+#define SFSIM_PAGE_SIZE                 256
+#define SFSIM_BLOCK_ERASE_MS            150
+#define SFSIM_CHIP_ERASE_MS             1000
+
+#define SFSIM_STATUS_BUSY               0x01
+#define SFSIM_STATUS_WEL                0x02
+
+struct sfsim_stat
+{
+    rt_uint32_t programs;               /* page programs */
+    rt_uint32_t polled;                 /* page programs seen ready by the status polls */
+    rt_uint32_t erases;
+    rt_uint32_t status_reads;
+    rt_uint32_t busy_cmds;              /* commands other than the status read sent while busy */
+};
+
+static struct
+{
+    rt_uint8_t mem[RT_SFUD_SIM_FLASH_SIZE];
+    rt_uint8_t cmd[4 + SFSIM_PAGE_SIZE];
+    rt_size_t cmd_len;
+    rt_size_t read_pos;                 /* bytes answered since the command */
+    rt_bool_t reading;
+
+    rt_uint8_t wel;
+    rt_uint8_t busy;
+    rt_uint8_t busy_program;            /* the busy is a page program */
+    rt_uint32_t busy_polls;
+    rt_tick_t busy_start;
+    rt_tick_t busy_ticks;
+
+    struct sfsim_stat stat;
+} sfsim;
+
+static struct rt_spi_bus sfsim_bus;
+static struct rt_spi_device sfsim_dev;
+
+static rt_uint32_t sfsim_addr(void)
+{
+    return ((rt_uint32_t)sfsim.cmd[1] << 16 | (rt_uint32_t)sfsim.cmd[2] << 8 | sfsim.cmd[3]) % RT_SFUD_SIM_FLASH_SIZE;
+}
+
+static void sfsim_busy_update(void)
+{
+    if (!sfsim.busy)
+    {
+        return;
+    }
+
+    if (sfsim.busy_program)
+    {
+        if (sfsim.busy_polls >= RT_SFUD_SIM_PROGRAM_POLLS)
+        {
+            sfsim.stat.polled++;
+            sfsim.busy = 0;
+        }
+        else if (rt_tick_get() != sfsim.busy_start)
+        {
+            sfsim.busy = 0;
+        }
+    }
+    else if (rt_tick_get() - sfsim.busy_start >= sfsim.busy_ticks)
+    {
+        sfsim.busy = 0;
+    }
+}
+
+static void sfsim_busy_set(rt_uint8_t program, rt_uint32_t ms)
+{
+    sfsim.wel = 0;
+    sfsim.busy = 1;
+    sfsim.busy_program = program;
+    sfsim.busy_polls = 0;
+    sfsim.busy_start = rt_tick_get();
+    sfsim.busy_ticks = rt_tick_from_millisecond(ms);
+}
+
+static void sfsim_erase(rt_uint32_t addr, rt_uint32_t size, rt_uint32_t ms)
+{
+    if (!sfsim.wel)
+    {
+        return;
+    }
+
+    if (size >= RT_SFUD_SIM_FLASH_SIZE)
+    {
+        memset(sfsim.mem, 0xFF, RT_SFUD_SIM_FLASH_SIZE);
+    }
+    else
+    {
+        memset(sfsim.mem + (addr & ~(size - 1)), 0xFF, size);
+    }
+    sfsim.stat.erases++;
+    sfsim_busy_set(0, ms);
+}
+
+/* the write commands run when the chip select is released */
+static void sfsim_exec(void)
+{
+    rt_uint32_t addr, page, i;
+
+    if (sfsim.cmd_len == 0)
+    {
+        return;
+    }
+
+    sfsim_busy_update();
+    if (sfsim.busy)
+    {
+        sfsim.stat.busy_cmds++;
+        return;
+    }
+
+    switch (sfsim.cmd[0])
+    {
+    case 0x06:
+        sfsim.wel = 1;
+        break;
+
+    case 0x04:
+    case 0x01:
+        sfsim.wel = 0;
+        break;
+
+    case 0x02:
+        if (!sfsim.wel || sfsim.cmd_len < 4)
+        {
+            break;
+        }
+        /* the address wraps in the page, the program only clears bits */
+        addr = sfsim_addr();
+        page = addr & ~(SFSIM_PAGE_SIZE - 1);
+        for (i = 0; i < sfsim.cmd_len - 4; i++)
+        {
+            sfsim.mem[page + ((addr + i) & (SFSIM_PAGE_SIZE - 1))] &= sfsim.cmd[4 + i];
+        }
+        sfsim.stat.programs++;
+        sfsim_busy_set(1, 0);
+        break;
+
+    case 0x20:
+        sfsim_erase(sfsim_addr(), 4096, RT_SFUD_SIM_SECTOR_ERASE_MS);
+        break;
+
+    case 0xD8:
+        sfsim_erase(sfsim_addr(), 65536, SFSIM_BLOCK_ERASE_MS);
+        break;
+
+    case 0x60:
+    case 0xC7:
+        sfsim_erase(0, RT_SFUD_SIM_FLASH_SIZE, SFSIM_CHIP_ERASE_MS);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void sfsim_answer(rt_uint8_t *buf, rt_size_t size)
+{
+    static const rt_uint8_t jedec_id[] = {0xEF, 0x40, 0x13};
+    rt_size_t i;
+
+    if (sfsim.cmd_len == 0)
+    {
+        memset(buf, 0xFF, size);
+        return;
+    }
+
+    sfsim_busy_update();
+    switch (sfsim.cmd[0])
+    {
+    case 0x05:
+        sfsim.stat.status_reads++;
+        if (sfsim.busy)
+        {
+            sfsim.busy_polls++;
+        }
+        memset(buf, (sfsim.busy ? SFSIM_STATUS_BUSY : 0) | (sfsim.wel ? SFSIM_STATUS_WEL : 0), size);
+        break;
+
+    case 0x9F:
+        for (i = 0; i < size; i++)
+        {
+            buf[i] = sfsim.read_pos + i < sizeof(jedec_id) ? jedec_id[sfsim.read_pos + i] : 0xFF;
+        }
+        break;
+
+    case 0x03:
+        if (sfsim.busy)
+        {
+            sfsim.stat.busy_cmds++;
+            memset(buf, 0xFF, size);
+            break;
+        }
+        for (i = 0; i < size; i++)
+        {
+            buf[i] = sfsim.mem[(sfsim_addr() + sfsim.read_pos + i) % RT_SFUD_SIM_FLASH_SIZE];
+        }
+        break;
+
+    default:
+        /* no SFDP, SFUD falls back to the flash information table */
+        memset(buf, 0xFF, size);
+        break;
+    }
+    sfsim.read_pos += size;
+}
+
+static rt_err_t sfsim_configure(struct rt_spi_device *device, struct rt_spi_configuration *configuration)
+{
+    return RT_EOK;
+}
+
+static rt_uint32_t sfsim_xfer(struct rt_spi_device *device, struct rt_spi_message *message)
+{
+    rt_size_t size;
+
+    if (message->cs_take)
+    {
+        sfsim.cmd_len = 0;
+        sfsim.read_pos = 0;
+        sfsim.reading = RT_FALSE;
+    }
+
+    if (message->send_buf && !sfsim.reading)
+    {
+        size = message->length;
+        if (size > sizeof(sfsim.cmd) - sfsim.cmd_len)
+        {
+            size = sizeof(sfsim.cmd) - sfsim.cmd_len;
+        }
+        memcpy(sfsim.cmd + sfsim.cmd_len, message->send_buf, size);
+        sfsim.cmd_len += size;
+    }
+    if (message->recv_buf)
+    {
+        sfsim.reading = RT_TRUE;
+        sfsim_answer(message->recv_buf, message->length);
+    }
+
+    if (message->cs_release && !sfsim.reading)
+    {
+        sfsim_exec();
+    }
+
+    return message->length;
+}
+
+static const struct rt_spi_ops sfsim_ops =
+{
+    sfsim_configure,
+    sfsim_xfer,
+};
+
+static int rt_sfud_sim_init(void)
+{
+    rt_err_t result;
+
+    memset(sfsim.mem, 0xFF, sizeof(sfsim.mem));
+
+    result = rt_spi_bus_register(&sfsim_bus, SFSIM_BUS_NAME, &sfsim_ops);
+    if (result == RT_EOK)
+    {
+        result = rt_spi_bus_attach_device(&sfsim_dev, SFSIM_DEV_NAME, SFSIM_BUS_NAME, RT_NULL);
+    }
+
+    return result;
+}
+INIT_DEVICE_EXPORT(rt_sfud_sim_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <stdlib.h>
+#include <finsh.h>
+
+static void sfsim_report(const char *name, rt_tick_t tick, const struct sfsim_stat *begin)
+{
+    rt_kprintf("%-8s %6d ms %6u erases %6u programs %6u polled %8u status reads %u busy commands\n", name,
+            (int)(tick * 1000 / RT_TICK_PER_SECOND), sfsim.stat.erases - begin->erases,
+            sfsim.stat.programs - begin->programs, sfsim.stat.polled - begin->polled,
+            sfsim.stat.status_reads - begin->status_reads, sfsim.stat.busy_cmds - begin->busy_cmds);
+}
+
+/* erase, program and read back the first size bytes of the simulated flash */
+static void sf_sim_bench(int argc, char **argv)
+{
+    sfud_flash_t flash;
+    struct sfsim_stat begin;
+    rt_uint8_t *buf;
+    rt_uint32_t size = RT_SFUD_SIM_FLASH_SIZE, i, bad = 0;
+    rt_tick_t tick;
+
+    if (argc > 1)
+    {
+        size = atoi(argv[1]) * 1024;
+    }
+    if (size == 0 || size > RT_SFUD_SIM_FLASH_SIZE || size % 4096)
+    {
+        rt_kprintf("Usage: sf_sim_bench [KB], a multiple of 4 KB up to %d KB\n", RT_SFUD_SIM_FLASH_SIZE / 1024);
+        return;
+    }
+
+    flash = rt_sfud_flash_find(SFSIM_DEV_NAME);
+    if (flash == RT_NULL && rt_sfud_flash_probe("sfsim_flash", SFSIM_DEV_NAME) != RT_NULL)
+    {
+        flash = rt_sfud_flash_find(SFSIM_DEV_NAME);
+    }
+    if (flash == RT_NULL)
+    {
+        rt_kprintf("Probe the simulated flash failed.\n");
+        return;
+    }
+
+    buf = rt_malloc(SFSIM_PAGE_SIZE);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("Low memory!\n");
+        return;
+    }
+
+    begin = sfsim.stat;
+    tick = rt_tick_get();
+    sfud_erase(flash, 0, size);
+    sfsim_report("erase", rt_tick_get() - tick, &begin);
+
+    begin = sfsim.stat;
+    tick = rt_tick_get();
+    for (i = 0; i < size; i += SFSIM_PAGE_SIZE)
+    {
+        memset(buf, (rt_uint8_t)(i / SFSIM_PAGE_SIZE), SFSIM_PAGE_SIZE);
+        sfud_write(flash, i, SFSIM_PAGE_SIZE, buf);
+    }
+    sfsim_report("program", rt_tick_get() - tick, &begin);
+
+    for (i = 0; i < size; i += SFSIM_PAGE_SIZE)
+    {
+        sfud_read(flash, i, SFSIM_PAGE_SIZE, buf);
+        if (buf[0] != (rt_uint8_t)(i / SFSIM_PAGE_SIZE) || buf[SFSIM_PAGE_SIZE - 1] != buf[0])
+        {
+            bad++;
+        }
+    }
+    rt_kprintf("verify   %u bad pages\n", bad);
+
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(sf_sim_bench, erase and program the simulated SPI flash: sf_sim_bench [KB]);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+
+#endif /* RT_SFUD_USING_SIM_FLASH */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The kernel services the SPI core and the SFUD port need on the build host:
+ * the heap is the C library one, the device table a list of names and the
+ * mutexes are free, there is one thread. The clock is simulated, a sleep
+ * advances it by its ticks and a microsecond delay by its microseconds, so
+ * the busy times of the simulated flash pass without waiting.
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "host.h"
+
+rt_uint64_t host_now_us;
+rt_uint32_t host_sleeps;
+rt_uint32_t host_us_delays;
+
+static rt_device_t host_devices;
+
+void *rt_malloc(rt_size_t size)
+{
+    return malloc(size);
+}
+
+void rt_free(void *ptr)
+{
+    free(ptr);
+}
+
+int rt_kprintf(const char *fmt, ...)
+{
+    va_list args;
+    int length;
+
+    va_start(args, fmt);
+    length = vprintf(fmt, args);
+    va_end(args);
+
+    return length;
+}
+
+void rt_assert_handler(const char *ex, const char *func, rt_size_t line)
+{
+    printf("(%s) assertion failed at function:%s, line number:%d\n", ex, func, (int)line);
+    abort();
+}
+
+void rt_set_errno(rt_err_t no)
+{
+    (void)no;
+}
+
+rt_tick_t rt_tick_get(void)
+{
+    return (rt_tick_t)(host_now_us * RT_TICK_PER_SECOND / 1000000);
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return (rt_tick_t)ms * RT_TICK_PER_SECOND / 1000;
+}
+
+rt_err_t rt_thread_delay(rt_tick_t tick)
+{
+    host_now_us += (rt_uint64_t)tick * 1000000 / RT_TICK_PER_SECOND;
+    host_sleeps++;
+    return RT_EOK;
+}
+
+void rt_hw_us_delay(rt_uint32_t us)
+{
+    host_now_us += us;
+    host_us_delays++;
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_detach(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_device_register(rt_device_t dev, const char *name, rt_uint16_t flags)
+{
+    if (rt_device_find(name) != RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+
+    rt_strncpy(dev->parent.name, name, RT_NAME_MAX - 1);
+    dev->flag = flags;
+    /* the list is linked through the object list node, unused on the host */
+    dev->parent.list.next = (rt_list_t *)host_devices;
+    host_devices = dev;
+
+    return RT_EOK;
+}
+
+rt_err_t rt_device_unregister(rt_device_t dev)
+{
+    rt_device_t *node;
+
+    for (node = &host_devices; *node != RT_NULL; node = (rt_device_t *)&(*node)->parent.list.next)
+    {
+        if (*node == dev)
+        {
+            *node = (rt_device_t)dev->parent.list.next;
+            return RT_EOK;
+        }
+    }
+
+    return -RT_ERROR;
+}
+
+rt_device_t rt_device_find(const char *name)
+{
+    rt_device_t dev;
+
+    for (dev = host_devices; dev != RT_NULL; dev = (rt_device_t)dev->parent.list.next)
+    {
+        if (rt_strncmp(dev->parent.name, name, RT_NAME_MAX) == 0)
+        {
+            return dev;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* the device ops of spi_dev.c aren't needed, the flash is driven through the SPI core */
+rt_err_t rt_spi_bus_device_init(struct rt_spi_bus *bus, const char *name)
+{
+    bus->parent.type = RT_Device_Class_SPIBUS;
+    return rt_device_register(&bus->parent, name, RT_DEVICE_FLAG_RDWR);
+}
+
+rt_err_t rt_spidev_device_init(struct rt_spi_device *dev, const char *name)
+{
+    dev->parent.type = RT_Device_Class_SPIDevice;
+    return rt_device_register(&dev->parent, name, RT_DEVICE_FLAG_RDWR);
+}
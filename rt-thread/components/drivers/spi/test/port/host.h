@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <rtthread.h>
+
+/* the simulated clock, the sleeps advance it by ticks, the delays by microseconds */
+extern rt_uint64_t host_now_us;
+extern rt_uint32_t host_sleeps;
+extern rt_uint32_t host_us_delays;
+
+#endif
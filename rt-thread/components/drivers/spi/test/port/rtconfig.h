@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/* The configuration of the host build */
+
+#ifndef RT_CONFIG_H__
+#define RT_CONFIG_H__
+
+#define RT_NAME_MAX 16
+#define RT_ALIGN_SIZE 8
+#define RT_THREAD_PRIORITY_32
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_TICK_PER_SECOND 1000
+#define RT_USING_SEMAPHORE
+#define RT_USING_MUTEX
+#define RT_USING_HEAP
+#define RT_USING_DEVICE
+#define RT_USING_CONSOLE
+#define RT_DEBUG
+#define RT_DEBUG_CONTEXT_CHECK 0
+#define RT_KSERVICE_USING_STDLIB
+#define RT_KSERVICE_USING_STDLIB_MEMORY
+
+#define RT_USING_SPI
+#define RT_USING_SFUD
+#define RT_SFUD_USING_FLASH_INFO_TABLE
+#define RT_SFUD_SPI_MAX_HZ 50000000
+#ifndef SF_SIM_TEST_PLAIN
+#define RT_SFUD_USING_BUSY_SPIN
+#define RT_SFUD_BUSY_SPIN_US 2000
+#define RT_SFUD_BUSY_POLL_US 10
+#define RT_SFUD_USING_READ_CACHE
+#define RT_SFUD_READ_CACHE_LINES 4
+#define RT_SFUD_READ_CACHE_LINE_SIZE 256
+#endif
+#define RT_SFUD_USING_SIM_FLASH
+#define RT_SFUD_SIM_FLASH_SIZE 65536
+#ifndef RT_SFUD_SIM_PROGRAM_POLLS
+#define RT_SFUD_SIM_PROGRAM_POLLS 40
+#endif
+#define RT_SFUD_SIM_SECTOR_ERASE_MS 45
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Tests of the SFUD port on the build host. The simulated flash of
+ * spi_flash_sim.c is probed through spi_flash_sfud.c and the SFUD library,
+ * the page programs and the erases are timed on the simulated clock and
+ * random reads, writes and erases are checked against a copy of the flash.
+ * A write clears the bits, an erase sets the sectors it touches to 0xFF.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spi_flash_sim.c"
+#include "host.h"
+
+#define TEST_SECTOR_SIZE    4096
+#define TEST_ROUNDS         20000
+#define TEST_MAX_LEN        3000
+
+static rt_uint8_t test_ref[RT_SFUD_SIM_FLASH_SIZE];
+static rt_uint8_t test_buf[TEST_MAX_LEN];
+static rt_uint32_t lcg = 1;
+static int failed;
+
+static rt_uint32_t test_rand(void)
+{
+    lcg = lcg * 1103515245u + 12345u;
+    return lcg >> 8;
+}
+
+#define TEST_CHECK(x)                                                       \
+    do                                                                      \
+    {                                                                       \
+        if (!(x))                                                           \
+        {                                                                   \
+            printf("check failed: %s, line %d\n", #x, __LINE__);            \
+            failed++;                                                       \
+        }                                                                   \
+    } while (0)
+
+/*
+ * The page programs sleep by ticks unless the busy spin polls them. The
+ * simulated program also completes when the tick changes, so not all of
+ * them are seen ready by the polls.
+ */
+static void test_timing(sfud_flash_t flash)
+{
+    struct sfsim_stat begin = sfsim.stat;
+    rt_uint64_t start = host_now_us;
+    rt_uint32_t sleeps = host_sleeps, us_delays = host_us_delays;
+    rt_uint32_t i;
+
+    TEST_CHECK(sfud_erase(flash, 0, TEST_SECTOR_SIZE) == SFUD_SUCCESS);
+    TEST_CHECK(host_now_us - start >= RT_SFUD_SIM_SECTOR_ERASE_MS * 1000);
+    printf("erase    %6u us %4u sleeps %4u us delays\n", (unsigned)(host_now_us - start),
+           host_sleeps - sleeps, host_us_delays - us_delays);
+
+    start = host_now_us;
+    sleeps = host_sleeps;
+    us_delays = host_us_delays;
+    for (i = 0; i < TEST_SECTOR_SIZE; i += SFSIM_PAGE_SIZE)
+    {
+        memset(test_buf, (rt_uint8_t)i, SFSIM_PAGE_SIZE);
+        TEST_CHECK(sfud_write(flash, i, SFSIM_PAGE_SIZE, test_buf) == SFUD_SUCCESS);
+    }
+    printf("program  %6u us %4u sleeps %4u us delays, %u of %u programs polled\n",
+           (unsigned)(host_now_us - start), host_sleeps - sleeps, host_us_delays - us_delays,
+           sfsim.stat.polled - begin.polled, sfsim.stat.programs - begin.programs);
+    TEST_CHECK(sfsim.stat.programs - begin.programs == TEST_SECTOR_SIZE / SFSIM_PAGE_SIZE);
+#ifdef RT_SFUD_USING_BUSY_SPIN
+    TEST_CHECK(host_sleeps == sleeps);
+#endif
+    TEST_CHECK(sfsim.stat.busy_cmds == begin.busy_cmds);
+}
+
+static void test_random(sfud_flash_t flash)
+{
+    rt_uint8_t *data = rt_malloc(TEST_MAX_LEN);
+    rt_uint32_t round, addr, len, i, start, end;
+
+    TEST_CHECK(sfud_read(flash, 0, sizeof(test_ref), test_ref) == SFUD_SUCCESS);
+
+    for (round = 0; round < TEST_ROUNDS && !failed; round++)
+    {
+        addr = test_rand() % RT_SFUD_SIM_FLASH_SIZE;
+        len = 1 + test_rand() % TEST_MAX_LEN;
+        if (addr + len > RT_SFUD_SIM_FLASH_SIZE)
+        {
+            len = RT_SFUD_SIM_FLASH_SIZE - addr;
+        }
+
+        switch (test_rand() % 10)
+        {
+        case 0:
+        case 1:
+        case 2:
+            for (i = 0; i < len; i++)
+            {
+                data[i] = (rt_uint8_t)test_rand();
+                test_ref[addr + i] &= data[i];
+            }
+            TEST_CHECK(sfud_write(flash, addr, len, data) == SFUD_SUCCESS);
+            break;
+        case 3:
+            start = addr / TEST_SECTOR_SIZE * TEST_SECTOR_SIZE;
+            end = (addr + len + TEST_SECTOR_SIZE - 1) / TEST_SECTOR_SIZE * TEST_SECTOR_SIZE;
+            memset(test_ref + start, 0xFF, end - start);
+            TEST_CHECK(sfud_erase(flash, addr, len) == SFUD_SUCCESS);
+            break;
+        default:
+            memset(test_buf, 0x5A, len);
+            TEST_CHECK(sfud_read(flash, addr, len, test_buf) == SFUD_SUCCESS);
+            if (memcmp(test_buf, test_ref + addr, len) != 0)
+            {
+                printf("round %u: read of %u bytes at 0x%x differs\n", round, len, addr);
+                failed++;
+            }
+            break;
+        }
+    }
+
+    TEST_CHECK(memcmp(sfsim.mem, test_ref, sizeof(test_ref)) == 0);
+    printf("random   %u rounds, %u erases %u programs %u status reads %u busy commands\n", round,
+           sfsim.stat.erases, sfsim.stat.programs, sfsim.stat.status_reads, sfsim.stat.busy_cmds);
+    TEST_CHECK(sfsim.stat.busy_cmds == 0);
+
+    rt_free(data);
+}
+
+int main(void)
+{
+    sfud_flash_t flash;
+
+    TEST_CHECK(rt_sfud_sim_init() == RT_EOK);
+    TEST_CHECK(rt_sfud_flash_probe("sfsim_flash", SFSIM_DEV_NAME) != RT_NULL);
+    flash = rt_sfud_flash_find(SFSIM_DEV_NAME);
+    if (flash == RT_NULL)
+    {
+        printf("FAILED\n");
+        return 1;
+    }
+    TEST_CHECK(flash->chip.capacity >= RT_SFUD_SIM_FLASH_SIZE);
+
+    test_timing(flash);
+    test_random(flash);
+
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed != 0;
+}
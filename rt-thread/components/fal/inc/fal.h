@@ -120,6 +120,131 @@ int fal_partition_erase_all(const struct fal_partition *part);
  */
 void fal_show_part_table(void);
 
+#ifdef FAL_USING_CACHE
+/* =============== block cache API =============== */
+/**
+ * erase and program all dirty blocks of the cache to the flash
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_cache_flush(void);
+
+/**
+ * enable or disable the cache, the cache is flushed and emptied before it's disabled
+ *
+ * @param enable 0: disable, others: enable
+ *
+ * @return 0: success
+ *        -1: the flush is failed, the cache is kept enabled
+ */
+int fal_cache_enable(int enable);
+
+/**
+ * get the cache statistics
+ *
+ * @param stat the buffer holding the statistics
+ */
+void fal_cache_get_stat(struct fal_cache_stat *stat);
+
+/**
+ * enable or disable the block cache of a partition, it's enabled on all partitions by default,
+ * the cached blocks of the partition are flushed and emptied before it's disabled
+ *
+ * @param part partition
+ * @param enable 0: disable, others: enable
+ *
+ * @return 0: success
+ *        -1: the flush is failed, the cache is kept enabled
+ */
+int fal_partition_set_cache(const struct fal_partition *part, int enable);
+#endif /* FAL_USING_CACHE */
+
+#ifdef FAL_USING_KV
+/* =============== key-value store API =============== */
+/**
+ * open the key-value store on the partition, the index is rebuilt from the records
+ *
+ * @param part_name partition name
+ *
+ * @return != NULL: the database
+ *            NULL: error
+ */
+fal_kv_t fal_kv_open(const char *part_name);
+
+/**
+ * close the key-value store
+ *
+ * @param db the database
+ */
+void fal_kv_close(fal_kv_t db);
+
+/**
+ * get the value of the key
+ *
+ * @param db the database
+ * @param key the key string
+ * @param value the value buffer
+ * @param len the value buffer size, the value is truncated to it
+ *
+ * @return >= 0: the value length
+ *           -1: not found or the record is broken
+ */
+int fal_kv_get(fal_kv_t db, const char *key, void *value, size_t len);
+
+/**
+ * set the value of the key
+ *
+ * @param db the database
+ * @param key the key string
+ * @param value the value
+ * @param len the value length
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_kv_set(fal_kv_t db, const char *key, const void *value, size_t len);
+
+/**
+ * delete the key
+ *
+ * @param db the database
+ * @param key the key string
+ *
+ * @return 0: success, or the key isn't found
+ *        -1: error
+ */
+int fal_kv_del(fal_kv_t db, const char *key);
+
+/**
+ * collect the oldest sector, it may be called when the system is idle
+ *
+ * @param db the database
+ *
+ * @return 0: success
+ *        -1: no sector to collect or error
+ */
+int fal_kv_gc(fal_kv_t db);
+
+/**
+ * erase all keys
+ *
+ * @param db the database
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_kv_format(fal_kv_t db);
+
+/**
+ * get the statistics of the key-value store
+ *
+ * @param db the database
+ * @param stat the buffer holding the statistics
+ */
+void fal_kv_get_stat(fal_kv_t db, struct fal_kv_stat *stat);
+#endif /* FAL_USING_KV */
+
 /* =============== API provided to RT-Thread =============== */
 /**
  * create RT-Thread block device by specified partition
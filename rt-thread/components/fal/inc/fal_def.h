@@ -118,4 +118,44 @@ struct fal_partition
 };
 typedef struct fal_partition *fal_partition_t;
 
+/**
+ * FAL block cache statistics
+ */
+struct fal_cache_stat
+{
+    /* read requests of a block served from the cache */
+    uint32_t read_hit;
+    uint32_t read_miss;
+    /* write requests merged into an erased block of the cache */
+    uint32_t write_merge;
+    /* blocks erase requested by the partitions */
+    uint32_t erase_req;
+    /* blocks erased on the flash devices */
+    uint32_t erase_flash;
+    /* dirty blocks programmed to the flash devices */
+    uint32_t flush;
+};
+
+struct fal_kv_stat
+{
+    /* keys, bytes of their latest records and the bytes allowed */
+    uint32_t keys;
+    uint32_t live_bytes;
+    uint32_t capacity;
+    uint32_t free_sectors;
+    /* requests, the sets of an unchanged value are skipped */
+    uint32_t set;
+    uint32_t set_skip;
+    uint32_t get;
+    uint32_t del;
+    /* sectors collected and the live record bytes copied by the collection */
+    uint32_t gc;
+    uint32_t gc_bytes;
+    /* key and value bytes written by the users and bytes programmed to the flash */
+    uint32_t user_bytes;
+    uint32_t flash_bytes;
+    uint32_t erases;
+};
+typedef struct fal_kv_db *fal_kv_t;
+
 #endif /* _FAL_DEF_H_ */
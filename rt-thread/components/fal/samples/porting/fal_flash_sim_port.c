@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Simulated NOR flash in RAM: the erase sets the block to 0xFF, the program
+ * only clears bits. The erases of every block are counted to measure the
+ * wear of the partitions on it.
+ */
+
+#include <fal.h>
+#include <string.h>
+
+#ifdef FAL_USING_SIM_FLASH
+
+#ifndef FAL_SIM_FLASH_DEV_NAME
+#define FAL_SIM_FLASH_DEV_NAME          "sim_flash"
+#endif
+#ifndef FAL_SIM_FLASH_SIZE
+#define FAL_SIM_FLASH_SIZE              (64 * 1024)
+#endif
+#ifndef FAL_SIM_FLASH_BLK_SIZE
+#define FAL_SIM_FLASH_BLK_SIZE          4096
+#endif
+#ifndef FAL_SIM_FLASH_ERASE_DELAY
+#define FAL_SIM_FLASH_ERASE_DELAY       0
+#endif
+
+#define SIM_FLASH_BLK_NUM               (FAL_SIM_FLASH_SIZE / FAL_SIM_FLASH_BLK_SIZE)
+
+static int init(void);
+static int read(long offset, uint8_t *buf, size_t size);
+static int write(long offset, const uint8_t *buf, size_t size);
+static int erase(long offset, size_t size);
+
+static uint8_t sim_flash_mem[FAL_SIM_FLASH_SIZE];
+static uint32_t sim_flash_erase_cnt[SIM_FLASH_BLK_NUM];
+static uint32_t sim_flash_prog_bytes;
+
+const struct fal_flash_dev sim_flash =
+{
+    .name       = FAL_SIM_FLASH_DEV_NAME,
+    .addr       = 0,
+    .len        = FAL_SIM_FLASH_SIZE,
+    .blk_size   = FAL_SIM_FLASH_BLK_SIZE,
+    .ops        = {init, read, write, erase},
+    .write_gran = 1
+};
+
+static int init(void)
+{
+    memset(sim_flash_mem, 0xFF, sizeof(sim_flash_mem));
+
+    return 0;
+}
+
+static int read(long offset, uint8_t *buf, size_t size)
+{
+    if (offset < 0 || offset + size > FAL_SIM_FLASH_SIZE)
+    {
+        return -1;
+    }
+    memcpy(buf, sim_flash_mem + offset, size);
+
+    return size;
+}
+
+static int write(long offset, const uint8_t *buf, size_t size)
+{
+    size_t i;
+
+    if (offset < 0 || offset + size > FAL_SIM_FLASH_SIZE)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        sim_flash_mem[offset + i] &= buf[i];
+    }
+    sim_flash_prog_bytes += size;
+
+    return size;
+}
+
+static int erase(long offset, size_t size)
+{
+    long blk, end;
+
+    if (offset < 0 || offset + size > FAL_SIM_FLASH_SIZE)
+    {
+        return -1;
+    }
+
+    /* the blocks covered by the range are erased */
+    end = (offset + size + FAL_SIM_FLASH_BLK_SIZE - 1) / FAL_SIM_FLASH_BLK_SIZE;
+    for (blk = offset / FAL_SIM_FLASH_BLK_SIZE; blk < end; blk++)
+    {
+        memset(sim_flash_mem + blk * FAL_SIM_FLASH_BLK_SIZE, 0xFF, FAL_SIM_FLASH_BLK_SIZE);
+        sim_flash_erase_cnt[blk]++;
+#if FAL_SIM_FLASH_ERASE_DELAY > 0
+        rt_thread_mdelay(FAL_SIM_FLASH_ERASE_DELAY);
+#endif
+    }
+
+    return size;
+}
+
+static uint32_t sim_flash_erase_total(void)
+{
+    uint32_t total = 0;
+    size_t i;
+
+    for (i = 0; i < SIM_FLASH_BLK_NUM; i++)
+    {
+        total += sim_flash_erase_cnt[i];
+    }
+
+    return total;
+}
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <stdlib.h>
+#include <finsh.h>
+
+/* read-modify-erase-write updates of the records in the hot blocks of the partition */
+static int sim_flash_bench_run(const struct fal_partition *part, uint32_t updates, uint32_t hot, uint32_t *sum)
+{
+    uint8_t *buf;
+    uint32_t seed = 1, i, addr, blk;
+    size_t j;
+
+    buf = FAL_MALLOC(FAL_SIM_FLASH_BLK_SIZE);
+    if (buf == NULL)
+    {
+        return -1;
+    }
+
+    fal_partition_erase_all(part);
+    for (i = 0; i < updates; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        blk = (seed >> 16) % hot * FAL_SIM_FLASH_BLK_SIZE;
+        addr = (seed >> 8) % (FAL_SIM_FLASH_BLK_SIZE / 16) * 16;
+
+        if (fal_partition_read(part, blk, buf, FAL_SIM_FLASH_BLK_SIZE) < 0)
+        {
+            break;
+        }
+        memset(buf + addr, (uint8_t)i, 16);
+        if (fal_partition_erase(part, blk, FAL_SIM_FLASH_BLK_SIZE) < 0
+                || fal_partition_write(part, blk, buf, FAL_SIM_FLASH_BLK_SIZE) < 0)
+        {
+            break;
+        }
+    }
+#ifdef FAL_USING_CACHE
+    fal_cache_flush();
+#endif
+
+    /* the content checksum, the same for both runs */
+    *sum = 0;
+    for (blk = 0; blk < hot * FAL_SIM_FLASH_BLK_SIZE; blk += FAL_SIM_FLASH_BLK_SIZE)
+    {
+        fal_partition_read(part, blk, buf, FAL_SIM_FLASH_BLK_SIZE);
+        for (j = 0; j < FAL_SIM_FLASH_BLK_SIZE; j++)
+        {
+            *sum = *sum * 31 + buf[j];
+        }
+    }
+    FAL_FREE(buf);
+
+    return i < updates ? -1 : 0;
+}
+
+static void sim_flash_bench_report(const char *name, rt_tick_t tick, uint32_t erases, uint32_t prog, uint32_t sum)
+{
+    rt_kprintf("%-8s %6d ms %8u erases %8u KB programmed  sum %08x\n", name,
+            (int)(tick * 1000 / RT_TICK_PER_SECOND), erases, prog / 1024, sum);
+}
+
+static void fal_sim_bench(int argc, char **argv)
+{
+    const struct fal_partition *part;
+    uint32_t updates = 256, hot = 2, erases, prog, sum = 0;
+    rt_tick_t tick;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: fal_sim_bench <part_name> [updates] [hot_blocks]\n");
+        return;
+    }
+    part = fal_partition_find(argv[1]);
+    if (part == NULL || strcmp(part->flash_name, FAL_SIM_FLASH_DEV_NAME))
+    {
+        rt_kprintf("Partition %s NOT found on %s.\n", argv[1], FAL_SIM_FLASH_DEV_NAME);
+        return;
+    }
+    if (argc > 2)
+    {
+        updates = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        hot = atoi(argv[3]);
+    }
+    if (hot == 0 || hot > part->len / FAL_SIM_FLASH_BLK_SIZE)
+    {
+        hot = part->len / FAL_SIM_FLASH_BLK_SIZE;
+    }
+
+    rt_kprintf("%u updates of 16 bytes in %u blocks\n", updates, hot);
+#ifdef FAL_USING_CACHE
+    fal_cache_enable(0);
+#endif
+    erases = sim_flash_erase_total();
+    prog = sim_flash_prog_bytes;
+    tick = rt_tick_get();
+    if (sim_flash_bench_run(part, updates, hot, &sum) < 0)
+    {
+        rt_kprintf("Benchmark failed!\n");
+    }
+    sim_flash_bench_report("direct", rt_tick_get() - tick, sim_flash_erase_total() - erases,
+            sim_flash_prog_bytes - prog, sum);
+
+#ifdef FAL_USING_CACHE
+    fal_cache_enable(1);
+    erases = sim_flash_erase_total();
+    prog = sim_flash_prog_bytes;
+    tick = rt_tick_get();
+    if (sim_flash_bench_run(part, updates, hot, &sum) < 0)
+    {
+        rt_kprintf("Benchmark failed!\n");
+    }
+    sim_flash_bench_report("cached", rt_tick_get() - tick, sim_flash_erase_total() - erases,
+            sim_flash_prog_bytes - prog, sum);
+#endif
+}
+MSH_CMD_EXPORT(fal_sim_bench, FAL simulated flash benchmark: fal_sim_bench <part_name> [updates] [hot_blocks]);
+
+#ifdef FAL_USING_KV
+/* telemetry updates of the keys, every key is read back after its update */
+static void fal_kv_bench(int argc, char **argv)
+{
+    const struct fal_partition *part;
+    struct fal_kv_stat stat;
+    fal_kv_t db;
+    uint32_t ops = 2000, keys = 32, seed = 1, erases, i, value[4], check[4];
+    rt_tick_t set_tick = 0, get_tick = 0, tick;
+    char key[16];
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage: fal_kv_bench <part_name> [ops] [keys]\n");
+        return;
+    }
+    part = fal_partition_find(argv[1]);
+    if (part == NULL || strcmp(part->flash_name, FAL_SIM_FLASH_DEV_NAME))
+    {
+        rt_kprintf("Partition %s NOT found on %s.\n", argv[1], FAL_SIM_FLASH_DEV_NAME);
+        return;
+    }
+    if (argc > 2)
+    {
+        ops = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        keys = atoi(argv[3]);
+    }
+    if (keys == 0)
+    {
+        keys = 1;
+    }
+
+#ifdef FAL_USING_CACHE
+    fal_cache_enable(0);
+#endif
+    db = fal_kv_open(argv[1]);
+    if (db == NULL)
+    {
+        return;
+    }
+    fal_kv_format(db);
+    erases = sim_flash_erase_total();
+
+    for (i = 0; i < ops; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        rt_snprintf(key, sizeof(key), "sensor.%u", (seed >> 16) % keys);
+        value[0] = i;
+        value[1] = seed;
+        value[2] = ~seed;
+        value[3] = rt_tick_get();
+
+        tick = rt_tick_get();
+        if (fal_kv_set(db, key, value, sizeof(value)) < 0)
+        {
+            rt_kprintf("Set %s failed!\n", key);
+            break;
+        }
+        set_tick += rt_tick_get() - tick;
+
+        tick = rt_tick_get();
+        if (fal_kv_get(db, key, check, sizeof(check)) != sizeof(check) || memcmp(value, check, sizeof(check)))
+        {
+            rt_kprintf("Get %s failed!\n", key);
+            break;
+        }
+        get_tick += rt_tick_get() - tick;
+    }
+
+    fal_kv_get_stat(db, &stat);
+    rt_kprintf("%u sets and gets of %u keys, 16 bytes values\n", i, keys);
+    rt_kprintf("set %8u ops/s, get %8u ops/s\n",
+            set_tick ? (uint32_t)((uint64_t)i * RT_TICK_PER_SECOND / set_tick) : 0,
+            get_tick ? (uint32_t)((uint64_t)i * RT_TICK_PER_SECOND / get_tick) : 0);
+    rt_kprintf("%u sectors collected, %u erases on flash\n", stat.gc, sim_flash_erase_total() - erases);
+    rt_kprintf("write amplification %u.%02u (%u bytes programmed for %u bytes)\n",
+            stat.user_bytes ? stat.flash_bytes / stat.user_bytes : 0,
+            stat.user_bytes ? stat.flash_bytes % stat.user_bytes * 100 / stat.user_bytes : 0,
+            stat.flash_bytes, stat.user_bytes);
+    fal_kv_close(db);
+#ifdef FAL_USING_CACHE
+    fal_cache_enable(1);
+#endif
+}
+MSH_CMD_EXPORT(fal_kv_bench, FAL key-value store benchmark: fal_kv_bench <part_name> [ops] [keys]);
+#endif /* FAL_USING_KV */
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
+
+#endif /* FAL_USING_SIM_FLASH */
@@ -22,6 +22,9 @@ int fal_init(void)
 {
     extern int fal_flash_init(void);
     extern int fal_partition_init(void);
+#ifdef FAL_USING_CACHE
+    extern int fal_cache_init(void);
+#endif
 
     int result;
 
@@ -32,6 +35,10 @@ int fal_init(void)
         goto __exit;
     }
 
+#ifdef FAL_USING_CACHE
+    fal_cache_init();
+#endif
+
     /* initialize all flash partition on FAL partition table */
     result = fal_partition_init();
 
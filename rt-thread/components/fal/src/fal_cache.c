@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Write-back block cache of the flash devices under the partitions.
+ *
+ * A cached block is a copy of one erase block of a flash device. The erase of
+ * a single block is deferred: the cached copy becomes 0xFF and is marked
+ * dirty, the next writes to the block are merged into the copy, and the block
+ * is erased and programmed once when it's flushed. So the read-erase-write
+ * cycles of the small updates cost one flash erase per flush, not per update.
+ * The writes to the clean blocks go through to the flash.
+ *
+ * The dirty blocks are lost on power failure before the flush, the users of
+ * the cache call fal_cache_flush() at their commit points.
+ */
+
+#include <fal.h>
+#include <string.h>
+
+#ifdef FAL_USING_CACHE
+
+#ifndef FAL_CACHE_BLOCK_NUM
+#define FAL_CACHE_BLOCK_NUM            4
+#endif
+#ifndef FAL_CACHE_BLOCK_SIZE
+#define FAL_CACHE_BLOCK_SIZE           4096
+#endif
+#ifndef FAL_CACHE_FLUSH_DELAY
+#define FAL_CACHE_FLUSH_DELAY          1000
+#endif
+
+#if defined(RT_USING_SYSTEM_WORKQUEUE) && (FAL_CACHE_FLUSH_DELAY > 0)
+#include <rtdevice.h>
+#define FAL_CACHE_USING_FLUSH_WORK
+#endif
+
+#define CACHE_BLOCK_VALID              0x01
+/* the block is erased in the cache, the erase and the program are pending */
+#define CACHE_BLOCK_DIRTY              0x02
+
+struct fal_cache_block
+{
+    const struct fal_flash_dev *flash_dev;
+    /* erase block offset on the flash device */
+    long addr;
+    uint8_t flags;
+    /* last used, the least recently used block is replaced */
+    rt_tick_t used;
+    uint8_t *buf;
+};
+
+ALIGN(RT_ALIGN_SIZE)
+static uint8_t cache_buf[FAL_CACHE_BLOCK_NUM][FAL_CACHE_BLOCK_SIZE];
+static struct fal_cache_block cache_block[FAL_CACHE_BLOCK_NUM];
+static struct fal_cache_stat cache_stat;
+static struct rt_mutex cache_lock;
+static uint8_t cache_enabled = 1;
+static uint8_t init_ok = 0;
+
+#ifdef FAL_CACHE_USING_FLUSH_WORK
+static struct rt_work flush_work;
+static uint8_t flush_pending = 0;
+#endif
+
+static int cache_bypass(const struct fal_flash_dev *flash_dev)
+{
+    return !init_ok || !cache_enabled || flash_dev->blk_size == 0 || flash_dev->blk_size > FAL_CACHE_BLOCK_SIZE;
+}
+
+static struct fal_cache_block *cache_find(const struct fal_flash_dev *flash_dev, long addr)
+{
+    size_t i;
+
+    for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+    {
+        if ((cache_block[i].flags & CACHE_BLOCK_VALID) && cache_block[i].flash_dev == flash_dev
+                && cache_block[i].addr == addr)
+        {
+            cache_block[i].used = rt_tick_get();
+            return &cache_block[i];
+        }
+    }
+
+    return NULL;
+}
+
+static int cache_gran_erased(const uint8_t *buf, size_t gran)
+{
+    size_t i;
+
+    for (i = 0; i < gran; i++)
+    {
+        if (buf[i] != 0xFF)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* erase the block and program the granules written in the cache */
+static int cache_flush_block(struct fal_cache_block *blk)
+{
+    const struct fal_flash_dev *flash_dev = blk->flash_dev;
+    size_t gran, i, start;
+
+    if (!(blk->flags & CACHE_BLOCK_DIRTY))
+    {
+        return 0;
+    }
+    gran = flash_dev->write_gran > 8 ? flash_dev->write_gran / 8 : 1;
+
+    if (flash_dev->ops.erase(blk->addr, flash_dev->blk_size) < 0)
+    {
+        log_e("Cache flush error! Flash device(%s) erase error!", flash_dev->name);
+        return -1;
+    }
+    cache_stat.erase_flash++;
+
+    /* program the runs of the written granules, the erased ones are skipped */
+    for (i = 0; i < flash_dev->blk_size;)
+    {
+        while (i < flash_dev->blk_size && cache_gran_erased(blk->buf + i, gran))
+        {
+            i += gran;
+        }
+        start = i;
+        while (i < flash_dev->blk_size && !cache_gran_erased(blk->buf + i, gran))
+        {
+            i += gran;
+        }
+
+        if (i > start && flash_dev->ops.write(blk->addr + start, blk->buf + start, i - start) < 0)
+        {
+            log_e("Cache flush error! Flash device(%s) write error!", flash_dev->name);
+            return -1;
+        }
+    }
+
+    blk->flags &= ~CACHE_BLOCK_DIRTY;
+    cache_stat.flush++;
+
+    return 0;
+}
+
+/* get a block to cache the erase block, the least recently used one is flushed */
+static struct fal_cache_block *cache_alloc(const struct fal_flash_dev *flash_dev, long addr)
+{
+    struct fal_cache_block *blk = NULL;
+    size_t i;
+
+    for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+    {
+        if (!(cache_block[i].flags & CACHE_BLOCK_VALID))
+        {
+            blk = &cache_block[i];
+            break;
+        }
+        if (blk == NULL || rt_tick_get() - cache_block[i].used > rt_tick_get() - blk->used)
+        {
+            blk = &cache_block[i];
+        }
+    }
+
+    if (cache_flush_block(blk) < 0)
+    {
+        return NULL;
+    }
+
+    blk->flash_dev = flash_dev;
+    blk->addr = addr;
+    blk->flags = CACHE_BLOCK_VALID;
+    blk->used = rt_tick_get();
+
+    return blk;
+}
+
+static void cache_mark_dirty(struct fal_cache_block *blk)
+{
+    blk->flags |= CACHE_BLOCK_DIRTY;
+
+#ifdef FAL_CACHE_USING_FLUSH_WORK
+    if (!flush_pending)
+    {
+        flush_pending = 1;
+        rt_work_submit(&flush_work, rt_tick_from_millisecond(FAL_CACHE_FLUSH_DELAY));
+    }
+#endif
+}
+
+static int cache_flush_all(void)
+{
+    int result = 0;
+    size_t i;
+
+    for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+    {
+        if (cache_flush_block(&cache_block[i]) < 0)
+        {
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+#ifdef FAL_CACHE_USING_FLUSH_WORK
+static void cache_flush_work(struct rt_work *work, void *work_data)
+{
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    flush_pending = 0;
+    cache_flush_all();
+    rt_mutex_release(&cache_lock);
+}
+#endif
+
+/**
+ * read data from the flash device through the cache
+ *
+ * @param flash_dev flash device
+ * @param addr offset on the flash device
+ * @param buf read buffer
+ * @param size read size
+ *
+ * @return >= 0: successful read data size
+ *           -1: error
+ */
+int fal_cache_read(const struct fal_flash_dev *flash_dev, long addr, uint8_t *buf, size_t size)
+{
+    struct fal_cache_block *blk;
+    size_t len, done, off;
+
+    if (cache_bypass(flash_dev))
+    {
+        return flash_dev->ops.read(addr, buf, size);
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    for (done = 0; done < size; done += len)
+    {
+        off = (addr + done) % flash_dev->blk_size;
+        len = flash_dev->blk_size - off;
+        if (len > size - done)
+        {
+            len = size - done;
+        }
+
+        blk = cache_find(flash_dev, addr + done - off);
+        if (blk)
+        {
+            cache_stat.read_hit++;
+            memcpy(buf + done, blk->buf + off, len);
+            continue;
+        }
+        cache_stat.read_miss++;
+
+        /* the whole blocks are read around the cache */
+        if (len < flash_dev->blk_size && (blk = cache_alloc(flash_dev, addr + done - off)) != NULL)
+        {
+            if (flash_dev->ops.read(blk->addr, blk->buf, flash_dev->blk_size) < 0)
+            {
+                blk->flags = 0;
+                break;
+            }
+            memcpy(buf + done, blk->buf + off, len);
+        }
+        else if (flash_dev->ops.read(addr + done, buf + done, len) < 0)
+        {
+            break;
+        }
+    }
+    rt_mutex_release(&cache_lock);
+
+    return done < size ? -1 : (int)size;
+}
+
+/**
+ * write data to the flash device through the cache
+ *
+ * @param flash_dev flash device
+ * @param addr offset on the flash device
+ * @param buf write buffer
+ * @param size write size
+ *
+ * @return >= 0: successful write data size
+ *           -1: error
+ */
+int fal_cache_write(const struct fal_flash_dev *flash_dev, long addr, const uint8_t *buf, size_t size)
+{
+    struct fal_cache_block *blk;
+    size_t len, done, off, i;
+
+    if (cache_bypass(flash_dev))
+    {
+        return flash_dev->ops.write(addr, buf, size);
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    for (done = 0; done < size; done += len)
+    {
+        off = (addr + done) % flash_dev->blk_size;
+        len = flash_dev->blk_size - off;
+        if (len > size - done)
+        {
+            len = size - done;
+        }
+
+        blk = cache_find(flash_dev, addr + done - off);
+        if (blk && (blk->flags & CACHE_BLOCK_DIRTY))
+        {
+            /* merged into the erased block, it's programmed by the flush */
+            cache_stat.write_merge++;
+        }
+        else if (flash_dev->ops.write(addr + done, buf + done, len) < 0)
+        {
+            break;
+        }
+
+        if (blk)
+        {
+            /* programming only clears the bits */
+            for (i = 0; i < len; i++)
+            {
+                blk->buf[off + i] &= buf[done + i];
+            }
+        }
+    }
+    rt_mutex_release(&cache_lock);
+
+    return done < size ? -1 : (int)size;
+}
+
+/**
+ * erase the flash device through the cache
+ *
+ * @param flash_dev flash device
+ * @param addr offset on the flash device
+ * @param size erase size
+ *
+ * @return >= 0: successful erased data size
+ *           -1: error
+ */
+int fal_cache_erase(const struct fal_flash_dev *flash_dev, long addr, size_t size)
+{
+    struct fal_cache_block *blk;
+    long start, end;
+    size_t blocks;
+    int result = (int)size;
+
+    if (cache_bypass(flash_dev) || size == 0)
+    {
+        return flash_dev->ops.erase(addr, size);
+    }
+
+    /* the erase blocks covered by the range */
+    start = addr - addr % flash_dev->blk_size;
+    end = addr + size - 1;
+    end = end - end % flash_dev->blk_size;
+    blocks = (end - start) / flash_dev->blk_size + 1;
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    cache_stat.erase_req += blocks;
+
+    if (start == end)
+    {
+        /* a single block erase is deferred to the flush */
+        blk = cache_find(flash_dev, start);
+        if (blk == NULL)
+        {
+            blk = cache_alloc(flash_dev, start);
+        }
+        if (blk)
+        {
+            memset(blk->buf, 0xFF, flash_dev->blk_size);
+            cache_mark_dirty(blk);
+            rt_mutex_release(&cache_lock);
+            return result;
+        }
+    }
+
+    /* the cached copies of the blocks erased on the flash are dropped */
+    for (; start <= end; start += flash_dev->blk_size)
+    {
+        blk = cache_find(flash_dev, start);
+        if (blk)
+        {
+            blk->flags = 0;
+        }
+    }
+
+    result = flash_dev->ops.erase(addr, size);
+    if (result >= 0)
+    {
+        cache_stat.erase_flash += blocks;
+    }
+    rt_mutex_release(&cache_lock);
+
+    return result;
+}
+
+/**
+ * flush and drop the cached blocks of a range on the flash device
+ *
+ * @param flash_dev flash device
+ * @param addr offset on the flash device
+ * @param size range size
+ *
+ * @return 0: success
+ *        -1: the flush is failed, the blocks are kept
+ */
+int fal_cache_drop(const struct fal_flash_dev *flash_dev, long addr, size_t size)
+{
+    int result = 0;
+    size_t i;
+
+    if (!init_ok)
+    {
+        return 0;
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+    {
+        if ((cache_block[i].flags & CACHE_BLOCK_VALID) && cache_block[i].flash_dev == flash_dev
+                && cache_block[i].addr + (long)flash_dev->blk_size > addr && cache_block[i].addr < addr + (long)size)
+        {
+            if (cache_flush_block(&cache_block[i]) < 0)
+            {
+                result = -1;
+                continue;
+            }
+            cache_block[i].flags = 0;
+        }
+    }
+    rt_mutex_release(&cache_lock);
+
+    return result;
+}
+
+/**
+ * erase and program all dirty blocks of the cache to the flash
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_cache_flush(void)
+{
+    int result;
+
+    if (!init_ok)
+    {
+        return 0;
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    result = cache_flush_all();
+    rt_mutex_release(&cache_lock);
+
+    return result;
+}
+
+/**
+ * enable or disable the cache, the cache is flushed and emptied before it's disabled
+ *
+ * @param enable 0: disable, others: enable
+ *
+ * @return 0: success
+ *        -1: the flush is failed, the cache is kept enabled
+ */
+int fal_cache_enable(int enable)
+{
+    size_t i;
+
+    if (!init_ok)
+    {
+        return -1;
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    if (!enable)
+    {
+        if (cache_flush_all() < 0)
+        {
+            rt_mutex_release(&cache_lock);
+            return -1;
+        }
+        for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+        {
+            cache_block[i].flags = 0;
+        }
+    }
+    cache_enabled = enable ? 1 : 0;
+    rt_mutex_release(&cache_lock);
+
+    return 0;
+}
+
+/**
+ * get the cache statistics
+ *
+ * @param stat the buffer holding the statistics
+ */
+void fal_cache_get_stat(struct fal_cache_stat *stat)
+{
+    assert(stat);
+
+    if (!init_ok)
+    {
+        *stat = cache_stat;
+        return;
+    }
+
+    rt_mutex_take(&cache_lock, RT_WAITING_FOREVER);
+    *stat = cache_stat;
+    rt_mutex_release(&cache_lock);
+}
+
+/**
+ * initialize the cache
+ *
+ * @return 0: success
+ */
+int fal_cache_init(void)
+{
+    size_t i;
+
+    if (init_ok)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < FAL_CACHE_BLOCK_NUM; i++)
+    {
+        cache_block[i].buf = cache_buf[i];
+        cache_block[i].flags = 0;
+    }
+    rt_mutex_init(&cache_lock, "fal_cache", RT_IPC_FLAG_PRIO);
+#ifdef FAL_CACHE_USING_FLUSH_WORK
+    rt_work_init(&flush_work, cache_flush_work, NULL);
+#endif
+
+    init_ok = 1;
+
+    return 0;
+}
+
+#endif /* FAL_USING_CACHE */
@@ -0,0 +1,1059 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Log-structured key-value store on a partition.
+ *
+ * The partition is divided into sectors of whole erase blocks. A sector in
+ * use starts with a header holding its allocation sequence, the records are
+ * appended after it and never rewritten: setting or deleting a key appends a
+ * new record (a deleted record for the delete), the latest record of a key
+ * wins. The RAM index maps the hash of the key to the latest record, so the
+ * get and the set cost one hash lookup and one or two flash accesses.
+ *
+ * The garbage collection copies the live records of the oldest sector to the
+ * head of the log and erases it, one sector at a time, when a new sector is
+ * opened and less than two erased sectors are left. The deleted records of the
+ * oldest sector are dropped, the older records of their keys are in the same
+ * sector or were collected already.
+ *
+ * Power failure safety: every record is protected by a CRC-32. A torn record
+ * ends the scan of its sector at mount and the sector isn't appended anymore.
+ * An interrupted collection leaves the same records in the victim and in the
+ * head, the head wins. The victim is marked retired before it's erased, so an
+ * interrupted erase can't bring back the records collected from it. Each flash
+ * location is programmed once, it works with the flash requiring the whole
+ * write granules. The block cache defers the erases, so fal_kv_open() turns
+ * it off on the partition.
+ */
+
+#include <fal.h>
+#include <string.h>
+
+#ifdef FAL_USING_KV
+
+#ifndef FAL_KV_SECTOR_SIZE
+#define FAL_KV_SECTOR_SIZE             4096
+#endif
+#ifndef FAL_KV_KEY_MAX
+#define FAL_KV_KEY_MAX                 32
+#endif
+#ifndef FAL_KV_VALUE_MAX
+#define FAL_KV_VALUE_MAX               256
+#endif
+#ifndef FAL_KV_INDEX_SIZE
+#define FAL_KV_INDEX_SIZE              256
+#endif
+
+#if (FAL_KV_INDEX_SIZE & (FAL_KV_INDEX_SIZE - 1)) != 0
+#error "FAL_KV_INDEX_SIZE must be a power of 2"
+#endif
+#if FAL_KV_KEY_MAX > 255 || FAL_KV_VALUE_MAX > 65535
+#error "FAL_KV_KEY_MAX or FAL_KV_VALUE_MAX is too large"
+#endif
+
+#if defined(FAL_KV_USING_HWCRC) && defined(RT_USING_HWCRYPTO) && defined(RT_HWCRYPTO_USING_CRC)
+#include <rtdevice.h>
+#define KV_USING_HWCRC
+#endif
+
+#define KV_SECTOR_MAGIC                0x30564B46 /* "FKV0" */
+#define KV_RECORD_MAGIC                0x4352564B /* "KVRC" */
+#define KV_RECORD_DELETED              0x01
+
+#define KV_ADDR_EMPTY                  0xFFFFFFFF
+/* keep a quarter of the index empty to bound the probes */
+#define KV_KEYS_MAX                    (FAL_KV_INDEX_SIZE - FAL_KV_INDEX_SIZE / 4)
+
+#define KV_ALIGN(size, align)          (((size) + (align) - 1) / (align) * (align))
+
+struct kv_sector_hdr
+{
+    uint32_t magic;
+    uint32_t seq;
+    /* ~seq, a torn header isn't taken as valid */
+    uint32_t check;
+};
+
+struct kv_record_hdr
+{
+    uint32_t magic;
+    /* CRC-32 from key_len to the end of the value */
+    uint32_t crc;
+    uint8_t key_len;
+    uint8_t flags;
+    uint16_t val_len;
+};
+
+#define KV_RECORD_CRC_OFF              (sizeof(uint32_t) * 2)
+
+struct kv_index_entry
+{
+    uint32_t hash;
+    /* partition offset of the latest record of the key */
+    uint32_t addr;
+};
+
+struct fal_kv_db
+{
+    const struct fal_partition *part;
+    struct rt_mutex lock;
+    size_t sector_size;
+    size_t sector_num;
+    /* the write granule, 4 bytes at least */
+    size_t align;
+    /* the retired mark is programmed before the sector is erased */
+    size_t retire_off;
+    /* the records start after the sector header and the retired mark */
+    size_t hdr_size;
+    size_t rec_max;
+    /* the live record bytes allowed, the collection always makes progress */
+    size_t capacity;
+    /* allocation sequence of every sector, 0: erased */
+    uint32_t *seq;
+    uint32_t max_seq;
+    size_t free_num;
+    /* the sector being appended, -1: none */
+    long head;
+    size_t head_off;
+    struct kv_index_entry *index;
+    size_t keys;
+    /* bytes of the records referenced by the index */
+    size_t live;
+    /* the record being read or written */
+    uint8_t *rec_buf;
+    /* the record header and the key compared by the lookups */
+    uint8_t *cmp_buf;
+    size_t cmp_size;
+    struct fal_kv_stat stat;
+#ifdef KV_USING_HWCRC
+    struct rt_hwcrypto_ctx *crc_ctx;
+#endif
+};
+
+/* CRC-32 (ISO-HDLC) with a nibble table, small enough for the flash of the MCU */
+static const uint32_t crc32_nibble[16] =
+{
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t kv_crc(struct fal_kv_db *db, const uint8_t *buf, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    size_t i;
+
+#ifdef KV_USING_HWCRC
+    if (db->crc_ctx)
+    {
+        struct hwcrypto_crc_cfg cfg =
+        {
+            .last_val = 0xFFFFFFFF,
+            .poly = 0x04C11DB7,
+            .width = 32,
+            .xorout = 0xFFFFFFFF,
+            .flags = CRC_FLAG_REFIN | CRC_FLAG_REFOUT,
+        };
+
+        /* the record is checked in one piece, the seed of the device isn't chained */
+        rt_hwcrypto_crc_cfg(db->crc_ctx, &cfg);
+        return rt_hwcrypto_crc_update(db->crc_ctx, buf, len);
+    }
+#endif
+
+    for (i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble[crc & 0x0F];
+    }
+
+    return crc ^ 0xFFFFFFFF;
+}
+
+/* FNV-1a */
+static uint32_t kv_hash(const char *key, size_t key_len)
+{
+    uint32_t hash = 0x811C9DC5;
+    size_t i;
+
+    for (i = 0; i < key_len; i++)
+    {
+        hash = (hash ^ (uint8_t)key[i]) * 0x01000193;
+    }
+
+    return hash;
+}
+
+static int kv_blank(const uint8_t *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (buf[i] != 0xFF)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static size_t kv_record_size(struct fal_kv_db *db, size_t key_len, size_t val_len)
+{
+    return KV_ALIGN(sizeof(struct kv_record_hdr) + key_len + val_len, db->align);
+}
+
+/**
+ * read the record into rec_buf and check it
+ *
+ * @param db the database
+ * @param addr the partition offset of the record
+ * @param end the end of the sector
+ *
+ * @return >0: the record size
+ *          0: the end of the records
+ *         -1: a broken record
+ */
+static int kv_record_read(struct fal_kv_db *db, uint32_t addr, uint32_t end)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->rec_buf;
+    size_t size;
+
+    if (addr + sizeof(struct kv_record_hdr) > end)
+    {
+        return 0;
+    }
+    if (fal_partition_read(db->part, addr, db->rec_buf, sizeof(struct kv_record_hdr)) < 0)
+    {
+        return -1;
+    }
+    if (kv_blank(db->rec_buf, sizeof(struct kv_record_hdr)))
+    {
+        return 0;
+    }
+    if (hdr->magic != KV_RECORD_MAGIC || hdr->key_len == 0 || hdr->key_len > FAL_KV_KEY_MAX
+            || hdr->val_len > FAL_KV_VALUE_MAX)
+    {
+        return -1;
+    }
+
+    size = kv_record_size(db, hdr->key_len, hdr->val_len);
+    if (addr + size > end || fal_partition_read(db->part, addr + sizeof(struct kv_record_hdr),
+            db->rec_buf + sizeof(struct kv_record_hdr), size - sizeof(struct kv_record_hdr)) < 0)
+    {
+        return -1;
+    }
+    if (hdr->crc != kv_crc(db, db->rec_buf + KV_RECORD_CRC_OFF,
+            sizeof(struct kv_record_hdr) - KV_RECORD_CRC_OFF + hdr->key_len + hdr->val_len))
+    {
+        return -1;
+    }
+
+    return size;
+}
+
+/* build the record in rec_buf, the padding is left unprogrammed */
+static size_t kv_record_make(struct fal_kv_db *db, const char *key, size_t key_len, const void *value,
+        size_t val_len, uint8_t flags)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->rec_buf;
+    size_t size = kv_record_size(db, key_len, val_len);
+
+    memset(db->rec_buf, 0xFF, size);
+    hdr->magic = KV_RECORD_MAGIC;
+    hdr->key_len = key_len;
+    hdr->flags = flags;
+    hdr->val_len = val_len;
+    memcpy(db->rec_buf + sizeof(struct kv_record_hdr), key, key_len);
+    if (val_len)
+    {
+        memcpy(db->rec_buf + sizeof(struct kv_record_hdr) + key_len, value, val_len);
+    }
+    hdr->crc = kv_crc(db, db->rec_buf + KV_RECORD_CRC_OFF,
+            sizeof(struct kv_record_hdr) - KV_RECORD_CRC_OFF + key_len + val_len);
+
+    return size;
+}
+
+/**
+ * find the index slot of the key, the header and the key of its record are left in cmp_buf
+ *
+ * @return >=0: the slot
+ *          -1: not found
+ */
+static long kv_index_find(struct fal_kv_db *db, const char *key, size_t key_len, uint32_t hash)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->cmp_buf;
+    size_t i;
+
+    for (i = hash & (FAL_KV_INDEX_SIZE - 1); db->index[i].addr != KV_ADDR_EMPTY; i = (i + 1) & (FAL_KV_INDEX_SIZE - 1))
+    {
+        if (db->index[i].hash != hash)
+        {
+            continue;
+        }
+        if (fal_partition_read(db->part, db->index[i].addr, db->cmp_buf, sizeof(struct kv_record_hdr) + key_len) < 0)
+        {
+            continue;
+        }
+        if (hdr->key_len == key_len && !memcmp(db->cmp_buf + sizeof(struct kv_record_hdr), key, key_len))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static void kv_index_insert(struct fal_kv_db *db, uint32_t hash, uint32_t addr)
+{
+    size_t i;
+
+    for (i = hash & (FAL_KV_INDEX_SIZE - 1); db->index[i].addr != KV_ADDR_EMPTY; i = (i + 1) & (FAL_KV_INDEX_SIZE - 1));
+    db->index[i].hash = hash;
+    db->index[i].addr = addr;
+    db->keys++;
+}
+
+/* linear probing removal, the next entries of the probe sequence are moved back */
+static void kv_index_remove(struct fal_kv_db *db, size_t i)
+{
+    size_t j = i, home;
+
+    while (1)
+    {
+        j = (j + 1) & (FAL_KV_INDEX_SIZE - 1);
+        if (db->index[j].addr == KV_ADDR_EMPTY)
+        {
+            break;
+        }
+        home = db->index[j].hash & (FAL_KV_INDEX_SIZE - 1);
+        /* the entry stays when its home is cyclically in (i, j] */
+        if ((i <= j) ? (i < home && home <= j) : (i < home || home <= j))
+        {
+            continue;
+        }
+        db->index[i] = db->index[j];
+        i = j;
+    }
+    db->index[i].addr = KV_ADDR_EMPTY;
+    db->keys--;
+}
+
+/* take the record in rec_buf at the mount */
+static void kv_index_replay(struct fal_kv_db *db, uint32_t addr, size_t size)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->rec_buf;
+    struct kv_record_hdr *old = (struct kv_record_hdr *)db->cmp_buf;
+    const char *key = (const char *)db->rec_buf + sizeof(struct kv_record_hdr);
+    uint32_t hash = kv_hash(key, hdr->key_len);
+    long slot;
+
+    slot = kv_index_find(db, key, hdr->key_len, hash);
+    if (slot >= 0)
+    {
+        db->live -= kv_record_size(db, old->key_len, old->val_len);
+        if (hdr->flags & KV_RECORD_DELETED)
+        {
+            kv_index_remove(db, slot);
+        }
+        else
+        {
+            db->index[slot].addr = addr;
+            db->live += size;
+        }
+    }
+    else if (!(hdr->flags & KV_RECORD_DELETED))
+    {
+        if (db->keys >= KV_KEYS_MAX)
+        {
+            log_e("The index of the KV on partition(%s) is full, the key at 0x%08x is dropped.", db->part->name, addr);
+            return;
+        }
+        kv_index_insert(db, hash, addr);
+        db->live += size;
+    }
+}
+
+static int kv_sector_erase(struct fal_kv_db *db, size_t sec)
+{
+    uint32_t addr = sec * db->sector_size;
+
+    if (db->seq[sec])
+    {
+        memset(db->cmp_buf, 0x00, db->hdr_size - db->retire_off);
+        fal_partition_write(db->part, addr + db->retire_off, db->cmp_buf, db->hdr_size - db->retire_off);
+        db->seq[sec] = 0;
+    }
+    /* a sector failed to erase is left out until the next mount */
+    if (fal_partition_erase(db->part, addr, db->sector_size) < 0)
+    {
+        return -1;
+    }
+    db->free_num++;
+    db->stat.erases++;
+
+    return 0;
+}
+
+/* start a new head sector in the next erased sector */
+static int kv_sector_open(struct fal_kv_db *db)
+{
+    struct kv_sector_hdr *hdr = (struct kv_sector_hdr *)db->cmp_buf;
+    size_t i, sec = 0, size = db->retire_off;
+
+    for (i = 1; i <= db->sector_num; i++)
+    {
+        sec = (db->head + i) % db->sector_num;
+        if (db->seq[sec] == 0)
+        {
+            break;
+        }
+    }
+    if (i > db->sector_num)
+    {
+        return -1;
+    }
+
+    memset(db->cmp_buf, 0xFF, size);
+    hdr->magic = KV_SECTOR_MAGIC;
+    hdr->seq = ++db->max_seq;
+    hdr->check = ~hdr->seq;
+    if (fal_partition_write(db->part, sec * db->sector_size, db->cmp_buf, size) < 0)
+    {
+        db->seq[sec] = db->max_seq;
+        db->free_num--;
+        kv_sector_erase(db, sec);
+        return -1;
+    }
+    db->stat.flash_bytes += size;
+    db->seq[sec] = db->max_seq;
+    db->free_num--;
+    db->head = sec;
+    db->head_off = db->hdr_size;
+
+    return 0;
+}
+
+/**
+ * append the record in rec_buf to the head sector
+ *
+ * @return >=0: the partition offset of the record
+ *          -1: error
+ */
+static long kv_append(struct fal_kv_db *db, size_t size)
+{
+    uint32_t addr;
+
+    if (db->head < 0 || db->head_off + size > db->sector_size)
+    {
+        if (kv_sector_open(db) < 0)
+        {
+            return -1;
+        }
+    }
+
+    addr = db->head * db->sector_size + db->head_off;
+    if (fal_partition_write(db->part, addr, db->rec_buf, size) < 0)
+    {
+        /* the rest of the sector may be programmed partly */
+        db->head_off = db->sector_size;
+        return -1;
+    }
+    db->head_off += size;
+    db->stat.flash_bytes += size;
+
+    return addr;
+}
+
+/* copy the live records of the oldest sector to the head and erase it */
+static int kv_gc_one(struct fal_kv_db *db)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->rec_buf;
+    const char *key = (const char *)db->rec_buf + sizeof(struct kv_record_hdr);
+    uint32_t off, end;
+    long victim = -1, slot, addr;
+    size_t i;
+    int size;
+
+    for (i = 0; i < db->sector_num; i++)
+    {
+        if (db->seq[i] && (long)i != db->head && (victim < 0 || db->seq[i] < db->seq[victim]))
+        {
+            victim = i;
+        }
+    }
+    if (victim < 0)
+    {
+        return -1;
+    }
+
+    off = victim * db->sector_size + db->hdr_size;
+    end = (victim + 1) * db->sector_size;
+    for (; (size = kv_record_read(db, off, end)) > 0; off += size)
+    {
+        if (hdr->flags & KV_RECORD_DELETED)
+        {
+            continue;
+        }
+        slot = kv_index_find(db, key, hdr->key_len, kv_hash(key, hdr->key_len));
+        if (slot < 0 || db->index[slot].addr != off)
+        {
+            continue;
+        }
+        addr = kv_append(db, size);
+        if (addr < 0)
+        {
+            log_e("The KV on partition(%s) collection is failed.", db->part->name);
+            return -1;
+        }
+        db->index[slot].addr = addr;
+        db->stat.gc_bytes += size;
+    }
+
+    db->stat.gc++;
+
+    return kv_sector_erase(db, victim);
+}
+
+/* keep an erased sector for the collection before a new sector is opened */
+static int kv_make_room(struct fal_kv_db *db, size_t size)
+{
+    size_t i;
+
+    if (db->head >= 0 && db->head_off + size <= db->sector_size)
+    {
+        return 0;
+    }
+    for (i = 0; db->free_num < 2 && i < db->sector_num; i++)
+    {
+        if (kv_gc_one(db) < 0)
+        {
+            break;
+        }
+    }
+
+    return db->free_num ? 0 : -1;
+}
+
+static int kv_mount(struct fal_kv_db *db)
+{
+    struct kv_sector_hdr *hdr = (struct kv_sector_hdr *)db->cmp_buf;
+    uint32_t last = 0, off, end;
+    size_t i, j;
+    long sec;
+    int size;
+
+    db->max_seq = 0;
+    db->free_num = 0;
+    for (i = 0; i < db->sector_num; i++)
+    {
+        db->seq[i] = 0;
+        if (fal_partition_read(db->part, i * db->sector_size, db->cmp_buf, db->hdr_size) < 0)
+        {
+            return -1;
+        }
+        if (hdr->magic == KV_SECTOR_MAGIC && hdr->check == ~hdr->seq && hdr->seq != 0
+                && kv_blank(db->cmp_buf + db->retire_off, db->hdr_size - db->retire_off))
+        {
+            db->seq[i] = hdr->seq;
+            if (hdr->seq > db->max_seq)
+            {
+                db->max_seq = hdr->seq;
+            }
+            continue;
+        }
+
+        /* a retired, torn or foreign sector is erased to be reused */
+        for (j = 0; j < db->sector_size; j += db->rec_max)
+        {
+            size = db->sector_size - j < db->rec_max ? db->sector_size - j : db->rec_max;
+            if (fal_partition_read(db->part, i * db->sector_size + j, db->rec_buf, size) < 0)
+            {
+                return -1;
+            }
+            if (!kv_blank(db->rec_buf, size))
+            {
+                break;
+            }
+        }
+        if (j < db->sector_size)
+        {
+            kv_sector_erase(db, i);
+        }
+        else
+        {
+            db->free_num++;
+        }
+    }
+
+    /* replay the sectors in the allocation order, the last one is the head */
+    db->head = -1;
+    while (1)
+    {
+        for (i = 0, sec = -1; i < db->sector_num; i++)
+        {
+            if (db->seq[i] > last && (sec < 0 || db->seq[i] < db->seq[sec]))
+            {
+                sec = i;
+            }
+        }
+        if (sec < 0)
+        {
+            break;
+        }
+        last = db->seq[sec];
+
+        off = sec * db->sector_size + db->hdr_size;
+        end = (sec + 1) * db->sector_size;
+        for (; (size = kv_record_read(db, off, end)) > 0; off += size)
+        {
+            kv_index_replay(db, off, size);
+        }
+        db->head = sec;
+        db->head_off = off - sec * db->sector_size;
+        if (size < 0)
+        {
+            log_d("The KV on partition(%s) sector %d is broken at 0x%08x.", db->part->name, sec, off);
+            /* the sector isn't appended after the broken record */
+            db->head_off = db->sector_size;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * open the key-value store on the partition, the index is rebuilt from the records
+ *
+ * @param part_name partition name
+ *
+ * @return != NULL: the database
+ *            NULL: error
+ */
+fal_kv_t fal_kv_open(const char *part_name)
+{
+    const struct fal_partition *part;
+    const struct fal_flash_dev *flash_dev;
+    struct fal_kv_db *db;
+
+    assert(part_name);
+
+    part = fal_partition_find(part_name);
+    if (part == NULL)
+    {
+        log_e("Partition(%s) NOT found.", part_name);
+        return NULL;
+    }
+    flash_dev = fal_flash_device_find(part->flash_name);
+    if (flash_dev == NULL)
+    {
+        log_e("Flash device(%s) NOT found.", part->flash_name);
+        return NULL;
+    }
+#ifdef FAL_USING_CACHE
+    /* a deferred erase breaks the write order the recovery relies on, the records go to the flash */
+    if (fal_partition_set_cache(part, 0) < 0)
+    {
+        log_e("Partition(%s) cache flush error.", part_name);
+        return NULL;
+    }
+#endif
+
+    db = FAL_CALLOC(1, sizeof(struct fal_kv_db));
+    if (db == NULL)
+    {
+        log_e("Not enough memory for the KV on partition(%s).", part_name);
+        return NULL;
+    }
+    db->part = part;
+    db->sector_size = flash_dev->blk_size ? KV_ALIGN(FAL_KV_SECTOR_SIZE, flash_dev->blk_size) : FAL_KV_SECTOR_SIZE;
+    db->sector_num = part->len / db->sector_size;
+    db->align = flash_dev->write_gran > 32 ? flash_dev->write_gran / 8 : 4;
+    db->retire_off = KV_ALIGN(sizeof(struct kv_sector_hdr), db->align);
+    db->hdr_size = db->retire_off + KV_ALIGN(sizeof(uint32_t), db->align);
+    db->rec_max = kv_record_size(db, FAL_KV_KEY_MAX, FAL_KV_VALUE_MAX);
+    db->cmp_size = sizeof(struct kv_record_hdr) + FAL_KV_KEY_MAX;
+    if (db->cmp_size < db->hdr_size)
+    {
+        db->cmp_size = db->hdr_size;
+    }
+    if (db->sector_num < 3 || db->sector_size < db->hdr_size + db->rec_max)
+    {
+        log_e("Partition(%s) is too small for the KV, %d sectors of %d bytes at least.", part_name, 3,
+                db->hdr_size + db->rec_max);
+        goto __error;
+    }
+    /* one sector is kept erased and one is being collected */
+    db->capacity = (db->sector_num - 2) * (db->sector_size - db->hdr_size - db->rec_max);
+
+    db->seq = FAL_CALLOC(db->sector_num, sizeof(uint32_t));
+    db->index = FAL_MALLOC(FAL_KV_INDEX_SIZE * sizeof(struct kv_index_entry));
+    db->rec_buf = FAL_MALLOC(db->rec_max);
+    db->cmp_buf = FAL_MALLOC(db->cmp_size);
+    if (db->seq == NULL || db->index == NULL || db->rec_buf == NULL || db->cmp_buf == NULL)
+    {
+        log_e("Not enough memory for the KV on partition(%s).", part_name);
+        goto __error;
+    }
+    memset(db->index, 0xFF, FAL_KV_INDEX_SIZE * sizeof(struct kv_index_entry));
+
+#ifdef KV_USING_HWCRC
+    if (rt_hwcrypto_dev_default())
+    {
+        db->crc_ctx = rt_hwcrypto_crc_create(rt_hwcrypto_dev_default(), HWCRYPTO_CRC_CRC32);
+    }
+#endif
+
+    if (kv_mount(db) < 0)
+    {
+        log_e("The KV on partition(%s) mount failed.", part_name);
+        goto __error;
+    }
+    rt_mutex_init(&db->lock, "fal_kv", RT_IPC_FLAG_PRIO);
+
+    log_d("KV on partition(%s): %d sectors, %d keys, %d bytes live.", part_name, db->sector_num, db->keys, db->live);
+
+    return db;
+
+__error:
+#ifdef KV_USING_HWCRC
+    if (db->crc_ctx)
+    {
+        rt_hwcrypto_crc_destroy(db->crc_ctx);
+    }
+#endif
+    FAL_FREE(db->cmp_buf);
+    FAL_FREE(db->rec_buf);
+    FAL_FREE(db->index);
+    FAL_FREE(db->seq);
+    FAL_FREE(db);
+
+    return NULL;
+}
+
+/**
+ * close the key-value store
+ *
+ * @param db the database
+ */
+void fal_kv_close(fal_kv_t db)
+{
+    assert(db);
+
+    rt_mutex_detach(&db->lock);
+#ifdef KV_USING_HWCRC
+    if (db->crc_ctx)
+    {
+        rt_hwcrypto_crc_destroy(db->crc_ctx);
+    }
+#endif
+    FAL_FREE(db->cmp_buf);
+    FAL_FREE(db->rec_buf);
+    FAL_FREE(db->index);
+    FAL_FREE(db->seq);
+    FAL_FREE(db);
+}
+
+/**
+ * get the value of the key
+ *
+ * @param db the database
+ * @param key the key string
+ * @param value the value buffer
+ * @param len the value buffer size, the value is truncated to it
+ *
+ * @return >= 0: the value length
+ *           -1: not found or the record is broken
+ */
+int fal_kv_get(fal_kv_t db, const char *key, void *value, size_t len)
+{
+    struct kv_record_hdr *hdr = (struct kv_record_hdr *)db->rec_buf;
+    size_t key_len;
+    uint32_t addr;
+    long slot;
+    int result = -1;
+
+    assert(db);
+    assert(key);
+    assert(value || len == 0);
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > FAL_KV_KEY_MAX)
+    {
+        return -1;
+    }
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    db->stat.get++;
+    slot = kv_index_find(db, key, key_len, kv_hash(key, key_len));
+    if (slot >= 0)
+    {
+        addr = db->index[slot].addr;
+        if (kv_record_read(db, addr, (addr / db->sector_size + 1) * db->sector_size) > 0)
+        {
+            if (len > hdr->val_len)
+            {
+                len = hdr->val_len;
+            }
+            memcpy(value, db->rec_buf + sizeof(struct kv_record_hdr) + key_len, len);
+            result = hdr->val_len;
+        }
+        else
+        {
+            log_e("The KV on partition(%s) record at 0x%08x is broken.", db->part->name, addr);
+        }
+    }
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+/* compare the value of the record with the value to set */
+static int kv_value_equal(struct fal_kv_db *db, uint32_t addr, const uint8_t *value, size_t len)
+{
+    size_t size;
+
+    for (; len; len -= size, addr += size, value += size)
+    {
+        size = len < db->cmp_size ? len : db->cmp_size;
+        if (fal_partition_read(db->part, addr, db->cmp_buf, size) < 0 || memcmp(db->cmp_buf, value, size))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * set the value of the key
+ *
+ * @param db the database
+ * @param key the key string
+ * @param value the value
+ * @param len the value length
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_kv_set(fal_kv_t db, const char *key, const void *value, size_t len)
+{
+    struct kv_record_hdr *old = (struct kv_record_hdr *)db->cmp_buf;
+    size_t key_len, size, old_size = 0;
+    uint32_t hash;
+    long slot, addr;
+    int result = -1;
+
+    assert(db);
+    assert(key);
+    assert(value || len == 0);
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > FAL_KV_KEY_MAX || len > FAL_KV_VALUE_MAX)
+    {
+        log_e("The key or the value is too long, %d and %d bytes at most.", FAL_KV_KEY_MAX, FAL_KV_VALUE_MAX);
+        return -1;
+    }
+    size = kv_record_size(db, key_len, len);
+    hash = kv_hash(key, key_len);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    db->stat.set++;
+    slot = kv_index_find(db, key, key_len, hash);
+    if (slot >= 0)
+    {
+        old_size = kv_record_size(db, old->key_len, old->val_len);
+        /* the same value isn't written again */
+        if (old->val_len == len && kv_value_equal(db, db->index[slot].addr + sizeof(struct kv_record_hdr) + key_len,
+                value, len))
+        {
+            db->stat.set_skip++;
+            result = 0;
+            goto __exit;
+        }
+    }
+    else if (db->keys >= KV_KEYS_MAX)
+    {
+        log_e("The index of the KV on partition(%s) is full.", db->part->name);
+        goto __exit;
+    }
+    if (db->live - old_size + size > db->capacity)
+    {
+        log_e("The KV on partition(%s) is full.", db->part->name);
+        goto __exit;
+    }
+
+    /* the collection only moves the records, the slot is kept */
+    if (kv_make_room(db, size) < 0)
+    {
+        log_e("The KV on partition(%s) has no erased sector.", db->part->name);
+        goto __exit;
+    }
+    kv_record_make(db, key, key_len, value, len, 0);
+    addr = kv_append(db, size);
+    if (addr < 0)
+    {
+        goto __exit;
+    }
+    if (slot >= 0)
+    {
+        db->index[slot].addr = addr;
+    }
+    else
+    {
+        kv_index_insert(db, hash, addr);
+    }
+    db->live += size - old_size;
+    db->stat.user_bytes += key_len + len;
+    result = 0;
+
+__exit:
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+/**
+ * delete the key
+ *
+ * @param db the database
+ * @param key the key string
+ *
+ * @return 0: success, or the key isn't found
+ *        -1: error
+ */
+int fal_kv_del(fal_kv_t db, const char *key)
+{
+    struct kv_record_hdr *old = (struct kv_record_hdr *)db->cmp_buf;
+    size_t key_len, size, old_size;
+    uint32_t hash;
+    long slot;
+    int result = 0;
+
+    assert(db);
+    assert(key);
+
+    key_len = strlen(key);
+    if (key_len == 0 || key_len > FAL_KV_KEY_MAX)
+    {
+        return 0;
+    }
+    size = kv_record_size(db, key_len, 0);
+    hash = kv_hash(key, key_len);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    db->stat.del++;
+    slot = kv_index_find(db, key, key_len, hash);
+    if (slot < 0)
+    {
+        goto __exit;
+    }
+    old_size = kv_record_size(db, old->key_len, old->val_len);
+
+    result = -1;
+    /* the collection only moves the records, the slot is kept */
+    if (kv_make_room(db, size) < 0)
+    {
+        log_e("The KV on partition(%s) has no erased sector.", db->part->name);
+        goto __exit;
+    }
+    kv_record_make(db, key, key_len, NULL, 0, KV_RECORD_DELETED);
+    if (kv_append(db, size) < 0)
+    {
+        goto __exit;
+    }
+    kv_index_remove(db, slot);
+    db->live -= old_size;
+    db->stat.user_bytes += key_len;
+    result = 0;
+
+__exit:
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+/**
+ * collect the oldest sector, it may be called when the system is idle
+ *
+ * @param db the database
+ *
+ * @return 0: success
+ *        -1: no sector to collect or error
+ */
+int fal_kv_gc(fal_kv_t db)
+{
+    int result;
+
+    assert(db);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    result = kv_gc_one(db);
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+/**
+ * erase all keys
+ *
+ * @param db the database
+ *
+ * @return 0: success
+ *        -1: error
+ */
+int fal_kv_format(fal_kv_t db)
+{
+    size_t i;
+    int result = 0;
+
+    assert(db);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    for (i = 0; i < db->sector_num; i++)
+    {
+        if (db->seq[i] && kv_sector_erase(db, i) < 0)
+        {
+            result = -1;
+        }
+    }
+    memset(db->index, 0xFF, FAL_KV_INDEX_SIZE * sizeof(struct kv_index_entry));
+    db->keys = 0;
+    db->live = 0;
+    db->head = -1;
+    db->max_seq = 0;
+    rt_mutex_release(&db->lock);
+
+    return result;
+}
+
+/**
+ * get the statistics of the key-value store
+ *
+ * @param db the database
+ * @param stat the buffer holding the statistics
+ */
+void fal_kv_get_stat(fal_kv_t db, struct fal_kv_stat *stat)
+{
+    assert(db);
+    assert(stat);
+
+    rt_mutex_take(&db->lock, RT_WAITING_FOREVER);
+    *stat = db->stat;
+    stat->keys = db->keys;
+    stat->live_bytes = db->live;
+    stat->capacity = db->capacity;
+    stat->free_sectors = db->free_num;
+    rt_mutex_release(&db->lock);
+}
+
+#endif /* FAL_USING_KV */
@@ -18,9 +18,18 @@
 #define FAL_PART_MAGIC_WORD_L       0x3130L
 #define FAL_PART_MAGIC_WROD         0x45503130
 
+#ifdef FAL_USING_CACHE
+extern int fal_cache_read(const struct fal_flash_dev *flash_dev, long addr, uint8_t *buf, size_t size);
+extern int fal_cache_write(const struct fal_flash_dev *flash_dev, long addr, const uint8_t *buf, size_t size);
+extern int fal_cache_erase(const struct fal_flash_dev *flash_dev, long addr, size_t size);
+extern int fal_cache_drop(const struct fal_flash_dev *flash_dev, long addr, size_t size);
+#endif
+
 struct part_flash_info
 {
     const struct fal_flash_dev *flash_dev;
+    /* the partition bypasses the block cache */
+    uint8_t uncached;
 };
 
 /**
@@ -121,6 +130,7 @@ static int check_and_update_part_cache(const struct fal_partition *table, size_t
 
     for (i = 0; i < len; i++)
     {
+        part_flash_cache[i].uncached = 0;
         flash_dev = fal_flash_device_find(table[i].flash_name);
         if (flash_dev == NULL)
         {
@@ -411,7 +421,16 @@ int fal_partition_read(const struct fal_partition *part, uint32_t addr, uint8_t
         return -1;
     }
 
-    ret = flash_dev->ops.read(part->offset + addr, buf, size);
+#ifdef FAL_USING_CACHE
+    if (!part_flash_cache[part - partition_table].uncached)
+    {
+        ret = fal_cache_read(flash_dev, part->offset + addr, buf, size);
+    }
+    else
+#endif
+    {
+        ret = flash_dev->ops.read(part->offset + addr, buf, size);
+    }
     if (ret < 0)
     {
         log_e("Partition read error! Flash device(%s) read error!", part->flash_name);
@@ -452,7 +471,16 @@ int fal_partition_write(const struct fal_partition *part, uint32_t addr, const u
         return -1;
     }
 
-    ret = flash_dev->ops.write(part->offset + addr, buf, size);
+#ifdef FAL_USING_CACHE
+    if (!part_flash_cache[part - partition_table].uncached)
+    {
+        ret = fal_cache_write(flash_dev, part->offset + addr, buf, size);
+    }
+    else
+#endif
+    {
+        ret = flash_dev->ops.write(part->offset + addr, buf, size);
+    }
     if (ret < 0)
     {
         log_e("Partition write error! Flash device(%s) write error!", part->flash_name);
@@ -491,7 +519,16 @@ int fal_partition_erase(const struct fal_partition *part, uint32_t addr, size_t
         return -1;
     }
 
-    ret = flash_dev->ops.erase(part->offset + addr, size);
+#ifdef FAL_USING_CACHE
+    if (!part_flash_cache[part - partition_table].uncached)
+    {
+        ret = fal_cache_erase(flash_dev, part->offset + addr, size);
+    }
+    else
+#endif
+    {
+        ret = flash_dev->ops.erase(part->offset + addr, size);
+    }
     if (ret < 0)
     {
         log_e("Partition erase error! Flash device(%s) erase error!", part->flash_name);
@@ -512,3 +549,39 @@ int fal_partition_erase_all(const struct fal_partition *part)
 {
     return fal_partition_erase(part, 0, part->len);
 }
+
+#ifdef FAL_USING_CACHE
+/**
+ * enable or disable the block cache of a partition,
+ * the cached blocks of the partition are flushed and emptied before it's disabled
+ *
+ * @param part partition
+ * @param enable 0: disable, others: enable
+ *
+ * @return 0: success
+ *        -1: the flush is failed, the cache is kept enabled
+ */
+int fal_partition_set_cache(const struct fal_partition *part, int enable)
+{
+    const struct fal_flash_dev *flash_dev = NULL;
+
+    assert(part);
+
+    flash_dev = flash_device_find_by_part(part);
+    if (flash_dev == NULL)
+    {
+        log_e("Don't found flash device(%s) of the partition(%s).", part->flash_name, part->name);
+        return -1;
+    }
+
+    /* bypass the cache first, the flush makes the blocks reach the flash */
+    part_flash_cache[part - partition_table].uncached = enable ? 0 : 1;
+    if (!enable && fal_cache_drop(flash_dev, part->offset, part->len) < 0)
+    {
+        part_flash_cache[part - partition_table].uncached = 0;
+        return -1;
+    }
+
+    return 0;
+}
+#endif /* FAL_USING_CACHE */
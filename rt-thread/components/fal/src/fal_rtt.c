@@ -547,6 +547,21 @@ struct rt_device *fal_char_device_create(const char *parition_name)
 #include <finsh.h>
 extern int fal_init_check(void);
 
+#ifdef FAL_USING_CACHE
+/* the probed flash device is accessed through the cache as the partitions on it are,
+ * so the shell sees the pending writes and does not leave stale cached blocks behind */
+extern int fal_cache_read(const struct fal_flash_dev *flash_dev, long addr, uint8_t *buf, size_t size);
+extern int fal_cache_write(const struct fal_flash_dev *flash_dev, long addr, const uint8_t *buf, size_t size);
+extern int fal_cache_erase(const struct fal_flash_dev *flash_dev, long addr, size_t size);
+#define fal_flash_read(dev, addr, buf, size)    fal_cache_read(dev, addr, buf, size)
+#define fal_flash_write(dev, addr, buf, size)   fal_cache_write(dev, addr, buf, size)
+#define fal_flash_erase(dev, addr, size)        fal_cache_erase(dev, addr, size)
+#else
+#define fal_flash_read(dev, addr, buf, size)    (dev)->ops.read(addr, buf, size)
+#define fal_flash_write(dev, addr, buf, size)   (dev)->ops.write(addr, buf, size)
+#define fal_flash_erase(dev, addr, size)        (dev)->ops.erase(addr, size)
+#endif /* FAL_USING_CACHE */
+
 static void fal(uint8_t argc, char **argv) {
 
 #define __is_print(ch)                ((unsigned int)((ch) - ' ') < 127u - ' ')
@@ -556,10 +571,15 @@ static void fal(uint8_t argc, char **argv) {
 #define CMD_WRITE_INDEX               2
 #define CMD_ERASE_INDEX               3
 #define CMD_BENCH_INDEX               4
+#define CMD_CACHE_INDEX               5
+#define CMD_KV_INDEX                  6
 
     int result = 0;
     static const struct fal_flash_dev *flash_dev = NULL;
     static const struct fal_partition *part_dev = NULL;
+#ifdef FAL_USING_KV
+    static char kv_db_part[FAL_DEV_NAME_MAX + 1];
+#endif
     size_t i = 0, j = 0;
 
     const char* help_info[] =
@@ -569,6 +589,12 @@ static void fal(uint8_t argc, char **argv) {
             [CMD_WRITE_INDEX]     = "fal write addr data1 ... dataN   - write some bytes 'data' starting at 'addr'",
             [CMD_ERASE_INDEX]     = "fal erase addr size              - erase 'size' bytes starting at 'addr'",
             [CMD_BENCH_INDEX]     = "fal bench <blk_size>             - benchmark test with per block size",
+#ifdef FAL_USING_CACHE
+            [CMD_CACHE_INDEX]     = "fal cache [flush|on|off]         - show the block cache statistics, flush or switch it",
+#endif
+#ifdef FAL_USING_KV
+            [CMD_KV_INDEX]        = "fal kv [set|get|del|gc|format]   - show the key-value store statistics of the partition or operate it",
+#endif
     };
 
     if (fal_init_check() != 1)
@@ -582,7 +608,10 @@ static void fal(uint8_t argc, char **argv) {
         rt_kprintf("Usage:\n");
         for (i = 0; i < sizeof(help_info) / sizeof(char*); i++)
         {
-            rt_kprintf("%s\n", help_info[i]);
+            if (help_info[i])
+            {
+                rt_kprintf("%s\n", help_info[i]);
+            }
         }
         rt_kprintf("\n");
     }
@@ -629,6 +658,98 @@ static void fal(uint8_t argc, char **argv) {
                 fal_show_part_table();
             }
         }
+#ifdef FAL_USING_CACHE
+        else if (!strcmp(operator, "cache"))
+        {
+            struct fal_cache_stat stat;
+
+            if (argc >= 3 && !strcmp(argv[2], "flush"))
+            {
+                result = fal_cache_flush();
+            }
+            else if (argc >= 3 && (!strcmp(argv[2], "on") || !strcmp(argv[2], "off")))
+            {
+                result = fal_cache_enable(!strcmp(argv[2], "on"));
+            }
+
+            fal_cache_get_stat(&stat);
+            rt_kprintf("read  : hit %u, miss %u\n", stat.read_hit, stat.read_miss);
+            rt_kprintf("write : merged %u\n", stat.write_merge);
+            rt_kprintf("erase : requested %u blocks, erased %u blocks on flash\n", stat.erase_req, stat.erase_flash);
+            rt_kprintf("flush : %u blocks\n", stat.flush);
+            if (result < 0)
+            {
+                rt_kprintf("This operate has an error. Error code: %d.\n", result);
+            }
+        }
+#endif /* FAL_USING_CACHE */
+#ifdef FAL_USING_KV
+        else if (!strcmp(operator, "kv"))
+        {
+            static fal_kv_t kv_db = NULL;
+            struct fal_kv_stat stat;
+            char value[64];
+
+            if (!part_dev)
+            {
+                rt_kprintf("No partition was probed. Please run 'fal probe part_name'.\n");
+                return;
+            }
+            if (kv_db && strcmp(kv_db_part, part_dev->name))
+            {
+                fal_kv_close(kv_db);
+                kv_db = NULL;
+            }
+            if (!kv_db && (kv_db = fal_kv_open(part_dev->name)) == NULL)
+            {
+                return;
+            }
+            strncpy(kv_db_part, part_dev->name, FAL_DEV_NAME_MAX);
+
+            if (argc >= 5 && !strcmp(argv[2], "set"))
+            {
+                result = fal_kv_set(kv_db, argv[3], argv[4], strlen(argv[4]));
+            }
+            else if (argc >= 4 && !strcmp(argv[2], "get"))
+            {
+                result = fal_kv_get(kv_db, argv[3], value, sizeof(value) - 1);
+                if (result >= 0)
+                {
+                    value[result < (int)sizeof(value) - 1 ? result : (int)sizeof(value) - 1] = '\0';
+                    rt_kprintf("%s = %s\n", argv[3], value);
+                    return;
+                }
+            }
+            else if (argc >= 4 && !strcmp(argv[2], "del"))
+            {
+                result = fal_kv_del(kv_db, argv[3]);
+            }
+            else if (argc >= 3 && !strcmp(argv[2], "gc"))
+            {
+                result = fal_kv_gc(kv_db);
+            }
+            else if (argc >= 3 && !strcmp(argv[2], "format"))
+            {
+                result = fal_kv_format(kv_db);
+            }
+            else if (argc >= 3)
+            {
+                rt_kprintf("Usage: fal kv [set key value|get key|del key|gc|format].\n");
+                return;
+            }
+
+            fal_kv_get_stat(kv_db, &stat);
+            rt_kprintf("keys  : %u, %u of %u bytes live, %u sectors erased\n", stat.keys, stat.live_bytes,
+                    stat.capacity, stat.free_sectors);
+            rt_kprintf("ops   : set %u (%u unchanged), get %u, del %u\n", stat.set, stat.set_skip, stat.get, stat.del);
+            rt_kprintf("gc    : %u sectors, %u bytes copied, %u erases\n", stat.gc, stat.gc_bytes, stat.erases);
+            rt_kprintf("write : %u bytes by users, %u bytes programmed\n", stat.user_bytes, stat.flash_bytes);
+            if (result < 0)
+            {
+                rt_kprintf("This operate has an error. Error code: %d.\n", result);
+            }
+        }
+#endif /* FAL_USING_KV */
         else
         {
             if (!flash_dev && !part_dev)
@@ -652,7 +773,7 @@ static void fal(uint8_t argc, char **argv) {
                     {
                         if (flash_dev)
                         {
-                            result = flash_dev->ops.read(addr, data, size);
+                            result = fal_flash_read(flash_dev, addr, data, size);
                         }
                         else if (part_dev)
                         {
@@ -718,7 +839,7 @@ static void fal(uint8_t argc, char **argv) {
                         }
                         if (flash_dev)
                         {
-                            result = flash_dev->ops.write(addr, data, size);
+                            result = fal_flash_write(flash_dev, addr, data, size);
                         }
                         else if (part_dev)
                         {
@@ -755,7 +876,7 @@ static void fal(uint8_t argc, char **argv) {
                     size = strtol(argv[3], NULL, 0);
                     if (flash_dev)
                     {
-                        result = flash_dev->ops.erase(addr, size);
+                        result = fal_flash_erase(flash_dev, addr, size);
                     }
                     else if (part_dev)
                     {
@@ -802,7 +923,7 @@ static void fal(uint8_t argc, char **argv) {
                     start_time = rt_tick_get();
                     if (flash_dev)
                     {
-                        result = flash_dev->ops.erase(0, size);
+                        result = fal_flash_erase(flash_dev, 0, size);
                     }
                     else if (part_dev)
                     {
@@ -833,7 +954,7 @@ static void fal(uint8_t argc, char **argv) {
                         }
                         if (flash_dev)
                         {
-                            result = flash_dev->ops.write(i, write_data, cur_op_size);
+                            result = fal_flash_write(flash_dev, i, write_data, cur_op_size);
                         }
                         else if (part_dev)
                         {
@@ -869,7 +990,7 @@ static void fal(uint8_t argc, char **argv) {
                         }
                         if (flash_dev)
                         {
-                            result = flash_dev->ops.read(i, read_data, cur_op_size);
+                            result = fal_flash_read(flash_dev, i, read_data, cur_op_size);
                         }
                         else if (part_dev)
                         {
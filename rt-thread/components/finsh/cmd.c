@@ -218,7 +218,20 @@ long list_thread(void)
                     else if (stat == RT_THREAD_CLOSE)   rt_kprintf(" close  ");
                     else if (stat == RT_THREAD_RUNNING) rt_kprintf(" running");
 
+#if defined(RT_USING_STACK_WATERMARK)
+                    /* the watermark is kept by the scan in the idle thread */
+                    RT_UNUSED(ptr);
+                    rt_kprintf(" 0x%08x 0x%08x    %02d%%   0x%08x %s\n",
 #if defined(ARCH_CPU_STACK_GROWS_UPWARD)
+                               ((rt_ubase_t)thread->sp - (rt_ubase_t)thread->stack_addr),
+#else
+                               thread->stack_size + ((rt_ubase_t)thread->stack_addr - (rt_ubase_t)thread->sp),
+#endif
+                               thread->stack_size,
+                               rt_thread_stack_max_used(thread) * 100 / thread->stack_size,
+                               thread->remaining_tick,
+                               rt_strerror(thread->error));
+#elif defined(ARCH_CPU_STACK_GROWS_UPWARD)
                     ptr = (rt_uint8_t *)thread->stack_addr + thread->stack_size - 1;
                     while (*ptr == '#')ptr --;
 
@@ -248,6 +261,120 @@ long list_thread(void)
     return 0;
 }
 
+#ifdef RT_USING_SCHED_EDF
+long list_edf(void)
+{
+    rt_base_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t *)RT_NULL;
+    const char *item_title = "thread";
+    int maxlen;
+
+    list_find_init(&find_arg, RT_Object_Class_Thread, obj_list, sizeof(obj_list) / sizeof(obj_list[0]));
+
+    maxlen = RT_NAME_MAX;
+
+    rt_kprintf("%-*.s period   budget deadline       jobs     misses   overruns max late\n", maxlen, item_title);
+    object_split(maxlen);
+    rt_kprintf(" -------- -------- -------- ---------- ---------- ---------- --------\n");
+
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+                struct rt_thread *thread;
+                struct rt_sched_edf edf;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+                thread = (struct rt_thread *)obj;
+                /* copy info */
+                rt_memcpy(&edf, &(thread->edf), sizeof edf);
+                rt_hw_interrupt_enable(level);
+
+                if (edf.period == 0)
+                    continue;
+
+                rt_kprintf("%-*.*s %8d %8d %8d %10d %10d %10d %8d\n", maxlen, RT_NAME_MAX, thread->name,
+                           edf.period, edf.budget, edf.deadline,
+                           edf.jobs, edf.misses, edf.overruns, edf.max_lateness);
+            }
+        }
+    }
+    while (next != (rt_list_t *)RT_NULL);
+
+    return 0;
+}
+#endif /* RT_USING_SCHED_EDF */
+
+#ifdef RT_USING_STACK_WATERMARK
+long list_stack(void)
+{
+    rt_base_t level;
+    list_get_next_t find_arg;
+    rt_list_t *obj_list[LIST_FIND_OBJ_NR];
+    rt_list_t *next = (rt_list_t *)RT_NULL;
+    const char *item_title = "thread";
+    int maxlen;
+
+    list_find_init(&find_arg, RT_Object_Class_Thread, obj_list, sizeof(obj_list) / sizeof(obj_list[0]));
+
+    maxlen = RT_NAME_MAX;
+
+    rt_kprintf("%-*.s stack addr stack size   max used       free  usage\n", maxlen, item_title);
+    object_split(maxlen);
+    rt_kprintf(" ---------- ---------- ---------- ---------- ------\n");
+
+    do
+    {
+        next = list_get_next(next, &find_arg);
+        {
+            int i;
+            for (i = 0; i < find_arg.nr_out; i++)
+            {
+                struct rt_object *obj;
+                struct rt_thread *thread;
+                rt_size_t stack_size, max_used;
+                void *stack_addr;
+
+                obj = rt_list_entry(obj_list[i], struct rt_object, list);
+                level = rt_hw_interrupt_disable();
+
+                if ((obj->type & ~RT_Object_Class_Static) != find_arg.type)
+                {
+                    rt_hw_interrupt_enable(level);
+                    continue;
+                }
+                thread = (struct rt_thread *)obj;
+                /* copy info */
+                stack_addr = thread->stack_addr;
+                stack_size = thread->stack_size;
+                max_used = rt_thread_stack_max_used(thread);
+                rt_hw_interrupt_enable(level);
+
+                rt_kprintf("%-*.*s 0x%08x %10d %10d %10d   %3d%%\n", maxlen, RT_NAME_MAX, thread->name,
+                           stack_addr, stack_size, max_used, stack_size - max_used,
+                           max_used * 100 / stack_size);
+            }
+        }
+    }
+    while (next != (rt_list_t *)RT_NULL);
+
+    return 0;
+}
+#endif /* RT_USING_STACK_WATERMARK */
+
 static void show_wait_queue(struct rt_list_node *list)
 {
     struct rt_thread *thread;
@@ -658,9 +785,15 @@ long list_mempool(void)
 
     maxlen = RT_NAME_MAX;
 
+#ifdef RT_USING_MEMPOOL_STATS
+    rt_kprintf("%-*.s block total free  max   fail  waits  wait tick suspend thread\n", maxlen, item_title);
+    object_split(maxlen);
+    rt_kprintf(" ----  ----  ---- ---- ------ ------ ---------- --------------\n");
+#else
     rt_kprintf("%-*.s block total free suspend thread\n", maxlen, item_title);
     object_split(maxlen);
     rt_kprintf(" ----  ----  ---- --------------\n");
+#endif /* RT_USING_MEMPOOL_STATS */
     do
     {
         next = list_get_next(next, &find_arg);
@@ -691,27 +824,29 @@ long list_mempool(void)
                     suspend_thread_count++;
                 }
 
+                rt_kprintf("%-*.*s %04d  %04d  %04d ",
+                           maxlen, RT_NAME_MAX,
+                           mp->parent.name,
+                           mp->block_size,
+                           mp->block_total_count,
+                           mp->block_free_count);
+#ifdef RT_USING_MEMPOOL_STATS
+                rt_kprintf("%04d %6d %6d %10d ",
+                           mp->max_used,
+                           mp->fail_count,
+                           mp->wait_count,
+                           mp->wait_tick);
+#endif /* RT_USING_MEMPOOL_STATS */
+
                 if (suspend_thread_count > 0)
                 {
-                    rt_kprintf("%-*.*s %04d  %04d  %04d %d:",
-                               maxlen, RT_NAME_MAX,
-                               mp->parent.name,
-                               mp->block_size,
-                               mp->block_total_count,
-                               mp->block_free_count,
-                               suspend_thread_count);
+                    rt_kprintf("%d:", suspend_thread_count);
                     show_wait_queue(&(mp->suspend_thread));
                     rt_kprintf("\n");
                 }
                 else
                 {
-                    rt_kprintf("%-*.*s %04d  %04d  %04d %d\n",
-                               maxlen, RT_NAME_MAX,
-                               mp->parent.name,
-                               mp->block_size,
-                               mp->block_total_count,
-                               mp->block_free_count,
-                               suspend_thread_count);
+                    rt_kprintf("%d\n", suspend_thread_count);
                 }
             }
         }
@@ -891,6 +1026,18 @@ int cmd_list(int argc, char **argv)
         {
             list_timer();
         }
+#ifdef RT_USING_SCHED_EDF
+        else if(strcmp(argv[1], "edf") == 0)
+        {
+            list_edf();
+        }
+#endif /* RT_USING_SCHED_EDF */
+#ifdef RT_USING_STACK_WATERMARK
+        else if(strcmp(argv[1], "stack") == 0)
+        {
+            list_stack();
+        }
+#endif /* RT_USING_STACK_WATERMARK */
 #ifdef RT_USING_SEMAPHORE
         else if(strcmp(argv[1], "sem") == 0)
         {
@@ -959,6 +1106,12 @@ _usage:
     rt_kprintf("[options]:\n");
     rt_kprintf("    thread - list threads\n");
     rt_kprintf("    timer - list timers\n");
+#ifdef RT_USING_SCHED_EDF
+    rt_kprintf("    edf - list EDF threads\n");
+#endif /* RT_USING_SCHED_EDF */
+#ifdef RT_USING_STACK_WATERMARK
+    rt_kprintf("    stack - list thread stack watermarks\n");
+#endif /* RT_USING_STACK_WATERMARK */
 #ifdef RT_USING_SEMAPHORE
     rt_kprintf("    sem - list semaphores\n");
 #endif /* RT_USING_SEMAPHORE */
@@ -19,6 +19,9 @@ extern "C" {
 
 #include <posix_types.h>
 #include <sched.h>
+#ifdef PTHREAD_USING_FAST_MUTEX
+#include <ipc/fastlock.h>
+#endif /* PTHREAD_USING_FAST_MUTEX */
 
 #define PTHREAD_KEY_MAX             8
 
@@ -97,7 +100,11 @@ typedef struct pthread_attr pthread_attr_t;
 struct pthread_mutex
 {
     pthread_mutexattr_t attr;
+#ifdef PTHREAD_USING_FAST_MUTEX
+    struct rt_fast_mutex lock;
+#else
     struct rt_mutex lock;
+#endif /* PTHREAD_USING_FAST_MUTEX */
 };
 typedef struct pthread_mutex pthread_mutex_t;
 
@@ -121,6 +121,15 @@ int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
         mutex->attr = *attr;
 
     /* init mutex lock */
+#ifdef PTHREAD_USING_FAST_MUTEX
+    result = rt_fast_mutex_init(&(mutex->lock), name);
+    if (result != RT_EOK)
+        return EINVAL;
+
+    /* detach the object from system object container */
+    rt_object_detach(&(mutex->lock.wait.parent.parent));
+    mutex->lock.wait.parent.parent.type = RT_Object_Class_Semaphore;
+#else
     result = rt_mutex_init(&(mutex->lock), name, RT_IPC_FLAG_PRIO);
     if (result != RT_EOK)
         return EINVAL;
@@ -128,6 +137,7 @@ int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
     /* detach the object from system object container */
     rt_object_detach(&(mutex->lock.parent.parent));
     mutex->lock.parent.parent.type = RT_Object_Class_Mutex;
+#endif /* PTHREAD_USING_FAST_MUTEX */
 
     return 0;
 }
@@ -174,7 +184,11 @@ int pthread_mutex_lock(pthread_mutex_t *mutex)
     }
     rt_exit_critical();
 
+#ifdef PTHREAD_USING_FAST_MUTEX
+    result = rt_fast_mutex_take(&(mutex->lock), RT_WAITING_FOREVER);
+#else
     result = rt_mutex_take(&(mutex->lock), RT_WAITING_FOREVER);
+#endif /* PTHREAD_USING_FAST_MUTEX */
     if (result == RT_EOK)
         return 0;
 
@@ -208,7 +222,11 @@ int pthread_mutex_unlock(pthread_mutex_t *mutex)
             return 0;
     }
 
+#ifdef PTHREAD_USING_FAST_MUTEX
+    result = rt_fast_mutex_release(&(mutex->lock));
+#else
     result = rt_mutex_release(&(mutex->lock));
+#endif /* PTHREAD_USING_FAST_MUTEX */
     if (result == RT_EOK)
         return 0;
 
@@ -240,7 +258,11 @@ int pthread_mutex_trylock(pthread_mutex_t *mutex)
     }
     rt_exit_critical();
 
+#ifdef PTHREAD_USING_FAST_MUTEX
+    result = rt_fast_mutex_trytake(&(mutex->lock));
+#else
     result = rt_mutex_take(&(mutex->lock), 0);
+#endif /* PTHREAD_USING_FAST_MUTEX */
     if (result == RT_EOK) return 0;
 
     return EBUSY;
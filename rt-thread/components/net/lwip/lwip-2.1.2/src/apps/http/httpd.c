@@ -122,6 +122,9 @@
 #define HTTP11_CONNECTIONKEEPALIVE  "Connection: keep-alive"
 #define HTTP11_CONNECTIONKEEPALIVE2 "Connection: Keep-Alive"
 #endif
+#if LWIP_HTTPD_CUSTOM_FILES
+#define HTTP_HDR_ACCEPT_ENCODING    "Accept-Encoding:"
+#endif
 
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
 #define HTTP_IS_DYNAMIC_FILE(hs) ((hs)->buf != NULL)
@@ -260,6 +263,10 @@ struct http_state {
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
   u8_t keepalive;
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+  struct pbuf *pipeline; /* Requests received behind the current one, served
+                            from http_sent()/http_poll() when it is done */
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
 #if LWIP_HTTPD_SSI
   struct http_ssi_state *ssi;
 #endif /* LWIP_HTTPD_SSI */
@@ -305,9 +312,22 @@ LWIP_MEMPOOL_DECLARE(HTTPD_SSI_STATE, MEMP_NUM_PARALLEL_HTTPD_SSI_CONNS, sizeof(
 #endif /* LWIP_HTTPD_SSI */
 #endif /* HTTPD_USE_MEM_POOL */
 
+#if LWIP_HTTPD_DYNAMIC_FILE_READ
+#ifndef HTTP_ALLOC_FILE_BUF
+/** Allocate/free the buffer the file data is read into by fs_read().
+ * A port may serve it from a pool shared by all connections. */
+#define HTTP_ALLOC_FILE_BUF(size) (char *)mem_malloc((mem_size_t)(size))
+#define HTTP_FREE_FILE_BUF(x)     mem_free(x)
+#endif /* HTTP_ALLOC_FILE_BUF */
+#endif /* LWIP_HTTPD_DYNAMIC_FILE_READ */
+
 static err_t http_close_conn(struct altcp_pcb *pcb, struct http_state *hs);
 static err_t http_close_or_abort_conn(struct altcp_pcb *pcb, struct http_state *hs, u8_t abort_conn);
 static err_t http_find_file(struct http_state *hs, const char *uri, int is_09);
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+static err_t http_parse_request(struct pbuf *inp, struct http_state *hs, struct altcp_pcb *pcb);
+static u8_t http_pipeline_serve(struct altcp_pcb *pcb, struct http_state *hs);
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
 static err_t http_init_file(struct http_state *hs, struct fs_file *file, int is_09, const char *uri, u8_t tag_check, char *params);
 static err_t http_poll(void *arg, struct altcp_pcb *pcb);
 static u8_t http_check_eof(struct altcp_pcb *pcb, struct http_state *hs);
@@ -489,7 +509,7 @@ http_state_eof(struct http_state *hs)
   }
 #if LWIP_HTTPD_DYNAMIC_FILE_READ
   if (hs->buf != NULL) {
-    mem_free(hs->buf);
+    HTTP_FREE_FILE_BUF(hs->buf);
     hs->buf = NULL;
   }
 #endif /* LWIP_HTTPD_DYNAMIC_FILE_READ */
@@ -505,6 +525,12 @@ http_state_eof(struct http_state *hs)
     hs->req = NULL;
   }
 #endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+  if (hs->pipeline) {
+    pbuf_free(hs->pipeline);
+    hs->pipeline = NULL;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
 }
 
 /** Free a struct http_state.
@@ -657,6 +683,11 @@ http_eof(struct altcp_pcb *pcb, struct http_state *hs)
   /* HTTP/1.1 persistent connection? (Not supported for SSI) */
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
   if (hs->keepalive) {
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    /* the requests received meanwhile survive the state reset */
+    struct pbuf *next = hs->pipeline;
+    hs->pipeline = NULL;
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
     http_remove_connection(hs);
 
     http_state_eof(hs);
@@ -667,6 +698,11 @@ http_eof(struct altcp_pcb *pcb, struct http_state *hs)
     http_add_connection(hs);
     /* ensure nagle doesn't interfere with sending all data as fast as possible: */
     altcp_nagle_disable(pcb);
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    /* not parsed from here: this runs inside http_send(), serving the next
+       request right away would nest one more http_send() per request */
+    hs->pipeline = next;
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
   } else
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
   {
@@ -927,6 +963,13 @@ get_http_headers(struct http_state *hs, const char *uri)
     return;
   }
 #endif /* LWIP_HTTPD_OMIT_HEADER_FOR_EXTENSIONLESS_URI */
+  if ((hs->handle != NULL) && (hs->handle->flags & FS_FILE_FLAGS_CONTENT_GZIP)) {
+    /* precompressed file: the encoding is sent along with the server identification */
+    hs->hdrs[HDR_STRINGS_IDX_SERVER_NAME] = HTTP_HDR_SERVER_GZIP;
+  } else if ((hs->handle != NULL) && (hs->handle->flags & FS_FILE_FLAGS_VARY_ENCODING)) {
+    /* the client didn't accept the precompressed variant, the caches must not give it one */
+    hs->hdrs[HDR_STRINGS_IDX_SERVER_NAME] = HTTP_HDR_SERVER_VARY;
+  }
   /* Did we find a matching extension? */
   if (content_type < NUM_HTTP_HEADERS) {
     /* yes, store it */
@@ -1132,7 +1175,7 @@ http_check_eof(struct altcp_pcb *pcb, struct http_state *hs)
     }
 #endif /* HTTPD_MAX_WRITE_LEN */
     do {
-      hs->buf = (char *)mem_malloc((mem_size_t)count);
+      hs->buf = HTTP_ALLOC_FILE_BUF(count);
       if (hs->buf != NULL) {
         hs->buf_len = count;
         break;
@@ -1937,6 +1980,166 @@ http_continue(void *connection)
 }
 #endif /* LWIP_HTTPD_FS_ASYNC_READ */
 
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+/** Queue received data behind the request currently served.
+ * The pbuf is taken over. http_recv() checks LWIP_HTTPD_PIPELINE_BUFSIZE
+ * before and refuses the data that does not fit.
+ */
+static void
+http_pipeline_add(struct http_state *hs, struct pbuf *p)
+{
+  if (hs->pipeline == NULL) {
+    hs->pipeline = p;
+  } else {
+    pbuf_cat(hs->pipeline, p);
+  }
+}
+
+/** Check if received data fits into the pipeline queue.
+ * An empty queue always takes it, so that one segment is never refused forever.
+ */
+static u8_t
+http_pipeline_fits(struct http_state *hs, struct pbuf *p)
+{
+  return (u8_t)((hs->pipeline == NULL) ||
+                (hs->pipeline->tot_len + p->tot_len <= LWIP_HTTPD_PIPELINE_BUFSIZE));
+}
+
+/** Keep the data following the request just parsed (the first 'consumed'
+ * bytes of p) for being served when the current response is done.
+ */
+static void
+http_pipeline_keep(struct http_state *hs, struct pbuf *p, u16_t consumed)
+{
+  struct pbuf *q;
+  u16_t len;
+
+  if ((p == NULL) || (p->tot_len <= consumed)) {
+    return;
+  }
+  len = (u16_t)(p->tot_len - consumed);
+  q = pbuf_alloc(PBUF_RAW, len, PBUF_RAM);
+  if (q == NULL) {
+    /* the client still waits for these responses: close after the current
+       one instead of leaving it hanging */
+    LWIP_DEBUGF(HTTPD_DEBUG, ("http_pipeline_keep: out of memory, close after this response\n"));
+    hs->keepalive = 0;
+    return;
+  }
+  pbuf_copy_partial(p, q->payload, len, consumed);
+  http_pipeline_add(hs, q);
+}
+
+/** Serve the next pipelined request once the previous response is done
+ * (like http_recv() does for a newly received request).
+ * Called from the callbacks only, never from http_eof(), so the stack depth
+ * does not grow with the number of queued requests.
+ *
+ * @return != 0 if data has been written (call altcp_output)
+ */
+static u8_t
+http_pipeline_serve(struct altcp_pcb *pcb, struct http_state *hs)
+{
+  struct pbuf *p = hs->pipeline;
+  err_t parsed;
+
+  if ((p == NULL) || (hs->handle != NULL)) {
+    return 0;
+  }
+  hs->pipeline = NULL;
+  parsed = http_parse_request(p, hs, pcb);
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+  if ((parsed != ERR_INPROGRESS) && (hs->req != NULL)) {
+    pbuf_free(hs->req);
+    hs->req = NULL;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+  pbuf_free(p);
+  if (parsed == ERR_OK) {
+#if LWIP_HTTPD_SUPPORT_POST
+    if (hs->post_content_len_left == 0)
+#endif /* LWIP_HTTPD_SUPPORT_POST */
+    {
+      return http_send(pcb, hs);
+    }
+  } else if (parsed == ERR_ARG) {
+    http_close_conn(pcb, hs);
+  }
+  return 0;
+}
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
+#if LWIP_HTTPD_CUSTOM_FILES
+/** Check if the value of an "Accept-Encoding" header (from p to end) accepts
+ * gzip: listed as "gzip" or "*" and not refused with "q=0".
+ */
+static u8_t
+http_coding_accepts_gzip(const char *p, const char *end)
+{
+  u8_t any = 0;
+
+  while (p < end) {
+    const char *token;
+    size_t token_len;
+    u8_t refused = 0;
+
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == ','))) {
+      p++;
+    }
+    token = p;
+    while ((p < end) && (*p != ',') && (*p != ';') && (*p != ' ') && (*p != '\t')) {
+      p++;
+    }
+    token_len = (size_t)(p - token);
+    /* parameters: only the quality value matters */
+    while ((p < end) && (*p != ',')) {
+      if (((*p == 'q') || (*p == 'Q')) && (p + 1 < end) && (p[1] == '=')) {
+        refused = 1;
+        for (p += 2; (p < end) && ((*p == '0') || (*p == '.')); p++) {
+        }
+        if ((p < end) && (*p >= '1') && (*p <= '9')) {
+          refused = 0;
+        }
+        continue;
+      }
+      p++;
+    }
+    if ((token_len == 4) && !lwip_strnicmp(token, "gzip", 4)) {
+      return (u8_t)!refused;
+    }
+    if ((token_len == 1) && (*token == '*')) {
+      any = (u8_t)!refused;
+    }
+  }
+  return any;
+}
+
+/** Check if the request headers (from data to hdr_end, the final CRLF CRLF)
+ * accept a gzip-compressed response.
+ */
+static u8_t
+http_accepts_gzip(const char *data, const char *hdr_end)
+{
+  const size_t name_len = sizeof(HTTP_HDR_ACCEPT_ENCODING) - 1;
+  const char *line = lwip_strnstr(data, CRLF, (size_t)(hdr_end - data));
+
+  while ((line != NULL) && (line < hdr_end)) {
+    const char *eol;
+    line += 2;
+    eol = lwip_strnstr(line, CRLF, (size_t)(hdr_end + 2 - line));
+    if (eol == NULL) {
+      break;
+    }
+    if (((size_t)(eol - line) >= name_len) &&
+        !lwip_strnicmp(line, HTTP_HDR_ACCEPT_ENCODING, name_len)) {
+      return http_coding_accepts_gzip(line + name_len, eol);
+    }
+    line = eol;
+  }
+  return 0;
+}
+#endif /* LWIP_HTTPD_CUSTOM_FILES */
+
 /**
  * When data has been received in the correct state, try to parse it
  * as a HTTP request.
@@ -2057,7 +2260,8 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct altcp_pcb *pc
       uri_len = (u16_t)(sp2 - (sp1 + 1));
       if ((sp2 != 0) && (sp2 > sp1)) {
         /* wait for CRLFCRLF (indicating end of HTTP headers) before parsing anything */
-        if (lwip_strnstr(data, CRLF CRLF, data_len) != NULL) {
+        char *hdr_end = lwip_strnstr(data, CRLF CRLF, data_len);
+        if (hdr_end != NULL) {
           char *uri = sp1 + 1;
 #if LWIP_HTTPD_SUPPORT_11_KEEPALIVE
           /* This is HTTP/1.0 compatible: for strict 1.1, a connection
@@ -2069,6 +2273,10 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct altcp_pcb *pc
             hs->keepalive = 0;
           }
 #endif /* LWIP_HTTPD_SUPPORT_11_KEEPALIVE */
+#if LWIP_HTTPD_CUSTOM_FILES
+          /* tell fs_open_custom() whether a gzip-compressed file may be sent */
+          hs->file_handle.flags = http_accepts_gzip(data, hdr_end) ? FS_FILE_FLAGS_ACCEPT_GZIP : 0;
+#endif /* LWIP_HTTPD_CUSTOM_FILES */
           /* null-terminate the METHOD (pbuf is freed anyway wen returning) */
           *sp1 = 0;
           uri[uri_len] = 0;
@@ -2095,7 +2303,20 @@ http_parse_request(struct pbuf *inp, struct http_state *hs, struct altcp_pcb *pc
           } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
           {
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+            err_t ferr = http_find_file(hs, uri, is_09);
+            if ((ferr == ERR_OK) && hs->keepalive) {
+              /* keep the requests behind this one until its response is done */
+#if LWIP_HTTPD_SUPPORT_REQUESTLIST
+              http_pipeline_keep(hs, hs->req, (u16_t)(hdr_end + 4 - data));
+#else /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+              http_pipeline_keep(hs, inp, (u16_t)(hdr_end + 4 - data));
+#endif /* LWIP_HTTPD_SUPPORT_REQUESTLIST */
+            }
+            return ferr;
+#else /* LWIP_HTTPD_SUPPORT_PIPELINING */
             return http_find_file(hs, uri, is_09);
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
           }
         }
       } else {
@@ -2452,6 +2673,13 @@ http_sent(void *arg, struct altcp_pcb *pcb, u16_t len)
 
   hs->retries = 0;
 
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+  if ((hs->handle == NULL) && (hs->pipeline != NULL)) {
+    /* previous response done: serve the next pipelined request */
+    http_pipeline_serve(pcb, hs);
+    return ERR_OK;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
   http_send(pcb, hs);
 
   return ERR_OK;
@@ -2503,6 +2731,14 @@ http_poll(void *arg, struct altcp_pcb *pcb)
         altcp_output(pcb);
       }
     }
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    else if (hs->pipeline != NULL) {
+      /* no ACK came to serve the next pipelined request from http_sent() */
+      if (http_pipeline_serve(pcb, hs)) {
+        altcp_output(pcb);
+      }
+    }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
   }
 
   return ERR_OK;
@@ -2534,6 +2770,16 @@ http_recv(void *arg, struct altcp_pcb *pcb, struct pbuf *p, err_t err)
     return ERR_OK;
   }
 
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+  if (hs->keepalive && ((hs->handle != NULL) || (hs->pipeline != NULL)) &&
+      !http_pipeline_fits(hs, p)) {
+    /* pipeline full: refuse the data without updating the window, TCP
+       delivers it again later and the client is throttled meanwhile */
+    LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: pipeline full, data refused\n"));
+    return ERR_MEM;
+  }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
+
 #if LWIP_HTTPD_SUPPORT_POST && LWIP_HTTPD_POST_MANUAL_WND
   if (hs->no_auto_wnd) {
     hs->unrecved_bytes += p->tot_len;
@@ -2559,6 +2805,14 @@ http_recv(void *arg, struct altcp_pcb *pcb, struct pbuf *p, err_t err)
   } else
 #endif /* LWIP_HTTPD_SUPPORT_POST */
   {
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+    if ((hs->handle == NULL) && (hs->pipeline != NULL)) {
+      /* keep the order: this data follows the requests still queued */
+      http_pipeline_add(hs, p);
+      http_pipeline_serve(pcb, hs);
+      return ERR_OK;
+    }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
     if (hs->handle == NULL) {
       err_t parsed = http_parse_request(p, hs, pcb);
       LWIP_ASSERT("http_parse_request: unexpected return value", parsed == ERR_OK
@@ -2586,6 +2840,13 @@ http_recv(void *arg, struct altcp_pcb *pcb, struct pbuf *p, err_t err)
         http_close_conn(pcb, hs);
       }
     } else {
+#if LWIP_HTTPD_SUPPORT_PIPELINING
+      if (hs->keepalive) {
+        /* pipelined request, served when the current response is done */
+        http_pipeline_add(hs, p);
+        return ERR_OK;
+      }
+#endif /* LWIP_HTTPD_SUPPORT_PIPELINING */
       LWIP_DEBUGF(HTTPD_DEBUG, ("http_recv: already sending data\n"));
       /* already sending but still receiving data, we might want to RST here? */
       pbuf_free(p);
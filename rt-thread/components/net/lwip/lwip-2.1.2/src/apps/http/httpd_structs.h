@@ -77,6 +77,11 @@ static const char *const g_psHTTPHeaderStrings[] = {
 
 #define HTTP_HDR_DEFAULT_TYPE   HTTP_CONTENT_TYPE("text/plain")
 
+/** Server identification followed by the encoding of a precompressed file */
+#define HTTP_HDR_SERVER_GZIP    "Server: "HTTPD_SERVER_AGENT"\r\nContent-Encoding: gzip\r\nVary: Accept-Encoding\r\n"
+/** Server identification of an uncompressed file that has a precompressed variant */
+#define HTTP_HDR_SERVER_VARY    "Server: "HTTPD_SERVER_AGENT"\r\nVary: Accept-Encoding\r\n"
+
 /** A list of extension-to-HTTP header strings (see outdated RFC 1700 MEDIA TYPES
  * and http://www.iana.org/assignments/media-types for registered content types
  * and subtypes) */
@@ -182,6 +182,13 @@ struct tcp_pcb **const tcp_pcb_lists[] = {&tcp_listen_pcbs.pcbs, &tcp_bound_pcbs
          &tcp_active_pcbs, &tcp_tw_pcbs
 };
 
+#if LWIP_TCP_PCB_HASH
+/** Hash table of the PCBs on tcp_active_pcbs, see tcp_pcb_hash() */
+struct tcp_pcb *tcp_active_hash[LWIP_TCP_PCB_HASH_SIZE];
+/** Hash table of the PCBs on tcp_listen_pcbs, indexed by local port */
+struct tcp_pcb_listen *tcp_listen_hash[LWIP_TCP_PCB_HASH_SIZE];
+#endif /* LWIP_TCP_PCB_HASH */
+
 u8_t tcp_active_pcbs_changed;
 
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
@@ -1393,6 +1400,7 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_active_pcbs", tcp_active_pcbs == pcb);
         tcp_active_pcbs = pcb->next;
       }
+      TCP_HASH_RMV(pcb);
 
       if (pcb_reset) {
         tcp_rst(pcb, pcb->snd_nxt, pcb->rcv_nxt, &pcb->local_ip, &pcb->remote_ip,
@@ -2117,6 +2125,92 @@ tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval)
   pcb->pollinterval = interval;
 }
 
+#if LWIP_TCP_PCB_HASH
+/**
+ * Calculates the bucket of an active PCB in tcp_active_hash.
+ * The local address is left out, a connection is identified by the remote
+ * address and the ports in practice.
+ *
+ * @param remote_ip remote IP address of the connection
+ * @param remote_port remote port of the connection (host byte order)
+ * @param local_port local port of the connection (host byte order)
+ * @return index into tcp_active_hash
+ */
+u16_t
+tcp_pcb_hash(const ip_addr_t *remote_ip, u16_t remote_port, u16_t local_port)
+{
+  u32_t h = 0;
+
+#if LWIP_IPV6
+  if (IP_IS_V6(remote_ip)) {
+    const ip6_addr_t *ip6addr = ip_2_ip6(remote_ip);
+    h = ip6addr->addr[0] ^ ip6addr->addr[1] ^ ip6addr->addr[2] ^ ip6addr->addr[3];
+  }
+#endif /* LWIP_IPV6 */
+#if LWIP_IPV4
+  if (!IP_IS_V6(remote_ip)) {
+    h = ip4_addr_get_u32(ip_2_ip4(remote_ip));
+  }
+#endif /* LWIP_IPV4 */
+
+  h ^= ((u32_t)remote_port << 16) | local_port;
+  h ^= h >> 16;
+  h ^= h >> 8;
+  return (u16_t)(h % LWIP_TCP_PCB_HASH_SIZE);
+}
+
+/**
+ * Adds a PCB to the hash table of the list it has been registered with.
+ * Called by TCP_REG, PCBs on other lists than tcp_active_pcbs and
+ * tcp_listen_pcbs are not hashed.
+ *
+ * @param pcbs the PCB list the PCB has been registered with
+ * @param pcb the PCB to hash
+ */
+void
+tcp_pcb_hash_insert(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **bucket;
+
+  if (pcbs == &tcp_active_pcbs) {
+    bucket = &tcp_active_hash[tcp_pcb_hash(&pcb->remote_ip, pcb->remote_port, pcb->local_port)];
+  } else if (pcbs == &tcp_listen_pcbs.pcbs) {
+    bucket = (struct tcp_pcb **)&tcp_listen_hash[TCP_PCB_HASH_LISTEN(pcb->local_port)];
+  } else {
+    return;
+  }
+
+  pcb->hash_next = *bucket;
+  pcb->hash_bucket = bucket;
+  *bucket = pcb;
+}
+
+/**
+ * Removes a PCB from its hash table, does nothing if the PCB is not hashed.
+ * Called by TCP_RMV.
+ *
+ * @param pcb the PCB to remove
+ */
+void
+tcp_pcb_hash_remove(struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **pp;
+
+  if (pcb->hash_bucket == NULL) {
+    return;
+  }
+
+  for (pp = pcb->hash_bucket; *pp != NULL; pp = &(*pp)->hash_next) {
+    if (*pp == pcb) {
+      *pp = pcb->hash_next;
+      break;
+    }
+  }
+  pcb->hash_next = NULL;
+  pcb->hash_bucket = NULL;
+}
+#endif /* LWIP_TCP_PCB_HASH */
+
 /**
  * Purges a TCP PCB. Removes any buffered data and frees the buffer memory
  * (pcb->ooseq, pcb->unsent and pcb->unacked are freed).
@@ -247,7 +247,12 @@ tcp_input(struct pbuf *p, struct netif *inp)
      for an active connection. */
   prev = NULL;
 
+#if LWIP_TCP_PCB_HASH
+  for (pcb = tcp_active_hash[tcp_pcb_hash(ip_current_src_addr(), tcphdr->src, tcphdr->dest)];
+       pcb != NULL; pcb = pcb->hash_next) {
+#else /* LWIP_TCP_PCB_HASH */
   for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* LWIP_TCP_PCB_HASH */
     LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
     LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
     LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
@@ -267,7 +272,8 @@ tcp_input(struct pbuf *p, struct netif *inp)
          lookups will be faster (we exploit locality in TCP segment
          arrivals). */
       LWIP_ASSERT("tcp_input: pcb->next != pcb (before cache)", pcb->next != pcb);
-      if (prev != NULL) {
+      /* (with LWIP_TCP_PCB_HASH, prev is the predecessor in the hash bucket) */
+      if (!LWIP_TCP_PCB_HASH && (prev != NULL)) {
         prev->next = pcb->next;
         pcb->next = tcp_active_pcbs;
         tcp_active_pcbs = pcb;
@@ -315,7 +321,11 @@ tcp_input(struct pbuf *p, struct netif *inp)
     /* Finally, if we still did not get a match, we check all PCBs that
        are LISTENing for incoming connections. */
     prev = NULL;
+#if LWIP_TCP_PCB_HASH
+    for (lpcb = tcp_listen_hash[TCP_PCB_HASH_LISTEN(tcphdr->dest)]; lpcb != NULL; lpcb = lpcb->hash_next) {
+#else /* LWIP_TCP_PCB_HASH */
     for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+#endif /* LWIP_TCP_PCB_HASH */
       /* check if PCB is bound to specific netif */
       if ((lpcb->netif_idx != NETIF_NO_INDEX) &&
           (lpcb->netif_idx != netif_get_index(ip_data.current_input_netif))) {
@@ -361,7 +371,8 @@ tcp_input(struct pbuf *p, struct netif *inp)
       /* Move this PCB to the front of the list so that subsequent
          lookups will be faster (we exploit locality in TCP segment
          arrivals). */
-      if (prev != NULL) {
+      /* (with LWIP_TCP_PCB_HASH, prev is the predecessor in the hash bucket) */
+      if (!LWIP_TCP_PCB_HASH && (prev != NULL)) {
         ((struct tcp_pcb_listen *)prev)->next = lpcb->next;
         /* our successor is the remainder of the listening list */
         lpcb->next = tcp_listen_pcbs.listen_pcbs;
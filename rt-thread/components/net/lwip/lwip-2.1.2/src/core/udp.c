@@ -79,6 +79,11 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* The list of UDP PCBs */
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
+#if LWIP_UDP_PCB_HASH
+/* Hash table of the PCBs on udp_pcbs, indexed by local port */
+static struct udp_pcb *udp_pcb_hash[LWIP_UDP_PCB_HASH_SIZE];
+#define UDP_PCB_HASH(port) ((port) % LWIP_UDP_PCB_HASH_SIZE)
+#endif /* LWIP_UDP_PCB_HASH */
 
 /**
  * Initialize this module.
@@ -91,6 +96,37 @@ udp_init(void)
 #endif /* LWIP_RAND */
 }
 
+#if LWIP_UDP_PCB_HASH
+/**
+ * Add a pcb to the bucket of its local port, the pcb must be on udp_pcbs.
+ */
+static void
+udp_hash_insert(struct udp_pcb *pcb)
+{
+  struct udp_pcb **bucket = &udp_pcb_hash[UDP_PCB_HASH(pcb->local_port)];
+
+  pcb->hash_next = *bucket;
+  *bucket = pcb;
+}
+
+/**
+ * Remove a pcb from the bucket of its local port.
+ */
+static void
+udp_hash_remove(struct udp_pcb *pcb)
+{
+  struct udp_pcb **pp;
+
+  for (pp = &udp_pcb_hash[UDP_PCB_HASH(pcb->local_port)]; *pp != NULL; pp = &(*pp)->hash_next) {
+    if (*pp == pcb) {
+      *pp = pcb->hash_next;
+      break;
+    }
+  }
+  pcb->hash_next = NULL;
+}
+#endif /* LWIP_UDP_PCB_HASH */
+
 /**
  * Allocate a new local UDP port.
  *
@@ -250,7 +286,11 @@ udp_input(struct pbuf *p, struct netif *inp)
    * 'Perfect match' pcbs (connected to the remote port & ip address) are
    * preferred. If no perfect match is found, the first unconnected pcb that
    * matches the local port and ip address gets the datagram. */
+#if LWIP_UDP_PCB_HASH
+  for (pcb = udp_pcb_hash[UDP_PCB_HASH(dest)]; pcb != NULL; pcb = pcb->hash_next) {
+#else /* LWIP_UDP_PCB_HASH */
   for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* LWIP_UDP_PCB_HASH */
     /* print the PCB local and remote address */
     LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
     ip_addr_debug_print_val(UDP_DEBUG, pcb->local_ip);
@@ -290,7 +330,8 @@ udp_input(struct pbuf *p, struct netif *inp)
           (ip_addr_isany_val(pcb->remote_ip) ||
            ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
         /* the first fully matching PCB */
-        if (prev != NULL) {
+        /* (with LWIP_UDP_PCB_HASH, prev is the predecessor in the hash bucket) */
+        if (!LWIP_UDP_PCB_HASH && (prev != NULL)) {
           /* move the pcb to the front of udp_pcbs so that is
              found faster next time */
           prev->next = pcb->next;
@@ -1012,6 +1053,12 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
   ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+#if LWIP_UDP_PCB_HASH
+  if (rebind) {
+    /* the bucket depends on the local port */
+    udp_hash_remove(pcb);
+  }
+#endif /* LWIP_UDP_PCB_HASH */
   pcb->local_port = port;
   mib2_udp_bind(pcb);
   /* pcb not active yet? */
@@ -1020,6 +1067,9 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
     pcb->next = udp_pcbs;
     udp_pcbs = pcb;
   }
+#if LWIP_UDP_PCB_HASH
+  udp_hash_insert(pcb);
+#endif /* LWIP_UDP_PCB_HASH */
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to "));
   ip_addr_debug_print_val(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, pcb->local_ip);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, (", port %"U16_F")\n", pcb->local_port));
@@ -1112,6 +1162,9 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
   /* PCB not yet on the list, add PCB now */
   pcb->next = udp_pcbs;
   udp_pcbs = pcb;
+#if LWIP_UDP_PCB_HASH
+  udp_hash_insert(pcb);
+#endif /* LWIP_UDP_PCB_HASH */
   return ERR_OK;
 }
 
@@ -1200,6 +1253,10 @@ udp_remove(struct udp_pcb *pcb)
       }
     }
   }
+#if LWIP_UDP_PCB_HASH
+  /* a pcb that has never been bound is in no bucket, nothing is done then */
+  udp_hash_remove(pcb);
+#endif /* LWIP_UDP_PCB_HASH */
   memp_free(MEMP_UDP_PCB, pcb);
 }
 
@@ -54,6 +54,14 @@ struct fsdata_chksum {
 #define FS_FILE_FLAGS_HEADER_PERSISTENT   0x02
 #define FS_FILE_FLAGS_HEADER_HTTPVER_1_1  0x04
 #define FS_FILE_FLAGS_SSI                 0x08
+/** File data is gzip-compressed, sent with "Content-Encoding: gzip" (dynamic headers only) */
+#define FS_FILE_FLAGS_CONTENT_GZIP        0x10
+/** Set by httpd before fs_open() when the client sent "Accept-Encoding: gzip":
+ * a custom file system may then open a gzip-compressed variant of the file */
+#define FS_FILE_FLAGS_ACCEPT_GZIP         0x20
+/** The file has variants by encoding, the response is sent with
+ * "Vary: Accept-Encoding" for the caches (dynamic headers only) */
+#define FS_FILE_FLAGS_VARY_ENCODING       0x40
 
 /** Define FS_FILE_EXTENSION_T_DEFINED if you have typedef'ed to your private
  * pointer type (defaults to 'void' so the default usage is 'void*')
@@ -248,6 +248,25 @@
 #define LWIP_HTTPD_SUPPORT_11_KEEPALIVE     0
 #endif
 
+/** Set this to 1 to keep the requests received while a response is being sent
+ * on a persistent connection (HTTP pipelining) and to serve them in order,
+ * instead of dropping them. Requires LWIP_HTTPD_SUPPORT_11_KEEPALIVE.
+ */
+#if !defined LWIP_HTTPD_SUPPORT_PIPELINING || defined __DOXYGEN__
+#define LWIP_HTTPD_SUPPORT_PIPELINING       0
+#endif
+
+#if LWIP_HTTPD_SUPPORT_PIPELINING && !LWIP_HTTPD_SUPPORT_11_KEEPALIVE
+#error "LWIP_HTTPD_SUPPORT_PIPELINING needs LWIP_HTTPD_SUPPORT_11_KEEPALIVE"
+#endif
+
+/** Maximum number of (TCP payload-) bytes of pipelined requests kept per
+    connection, further data is refused (TCP flow control) until the queued
+    requests have been served */
+#if !defined LWIP_HTTPD_PIPELINE_BUFSIZE || defined __DOXYGEN__
+#define LWIP_HTTPD_PIPELINE_BUFSIZE         1023
+#endif
+
 /** Set this to 1 to support HTTP request coming in in multiple packets/pbufs */
 #if !defined LWIP_HTTPD_SUPPORT_REQUESTLIST || defined __DOXYGEN__
 #define LWIP_HTTPD_SUPPORT_REQUESTLIST      1
@@ -1200,6 +1200,22 @@
 #if !defined LWIP_NETBUF_RECVINFO || defined __DOXYGEN__
 #define LWIP_NETBUF_RECVINFO            0
 #endif
+
+/**
+ * LWIP_UDP_PCB_HASH==1: Demultiplex incoming datagrams through a hash table
+ * of the bound pcbs indexed by local port instead of walking udp_pcbs.
+ * Costs one pointer per pcb plus the table.
+ */
+#if !defined LWIP_UDP_PCB_HASH || defined __DOXYGEN__
+#define LWIP_UDP_PCB_HASH               0
+#endif
+
+/**
+ * LWIP_UDP_PCB_HASH_SIZE: Number of buckets of the UDP pcb hash table.
+ */
+#if !defined LWIP_UDP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define LWIP_UDP_PCB_HASH_SIZE          16
+#endif
 /**
  * @}
  */
@@ -1479,6 +1495,23 @@
 #define LWIP_TCP_PCB_NUM_EXT_ARGS       0
 #endif
 
+/**
+ * LWIP_TCP_PCB_HASH==1: Demultiplex incoming segments through hash tables of
+ * the active pcbs (indexed by remote address and ports) and of the listening
+ * pcbs (indexed by local port) instead of walking the pcb lists.
+ * Costs two pointers per pcb plus the tables.
+ */
+#if !defined LWIP_TCP_PCB_HASH || defined __DOXYGEN__
+#define LWIP_TCP_PCB_HASH               0
+#endif
+
+/**
+ * LWIP_TCP_PCB_HASH_SIZE: Number of buckets of each TCP pcb hash table.
+ */
+#if !defined LWIP_TCP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define LWIP_TCP_PCB_HASH_SIZE          16
+#endif
+
 /** LWIP_ALTCP==1: enable the altcp API.
  * altcp is an abstraction layer that prevents applications linking against the
  * tcp.h functions but provides the same functionality. It is used to e.g. add
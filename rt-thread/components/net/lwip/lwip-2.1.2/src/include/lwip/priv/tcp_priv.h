@@ -339,6 +339,24 @@ extern struct tcp_pcb *tcp_active_pcbs;  /* List of all TCP PCBs that are in a
               data. */
 extern struct tcp_pcb *tcp_tw_pcbs;      /* List of all TCP PCBs in TIME-WAIT. */
 
+#if LWIP_TCP_PCB_HASH
+/* Hash tables of the pcbs on tcp_active_pcbs and tcp_listen_pcbs. */
+extern struct tcp_pcb *tcp_active_hash[LWIP_TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb_listen *tcp_listen_hash[LWIP_TCP_PCB_HASH_SIZE];
+
+#define TCP_PCB_HASH_LISTEN(port)  ((port) % LWIP_TCP_PCB_HASH_SIZE)
+
+u16_t tcp_pcb_hash(const ip_addr_t *remote_ip, u16_t remote_port, u16_t local_port);
+void  tcp_pcb_hash_insert(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+void  tcp_pcb_hash_remove(struct tcp_pcb *pcb);
+
+#define TCP_HASH_REG(pcbs, npcb)   tcp_pcb_hash_insert(pcbs, npcb)
+#define TCP_HASH_RMV(npcb)         tcp_pcb_hash_remove(npcb)
+#else /* LWIP_TCP_PCB_HASH */
+#define TCP_HASH_REG(pcbs, npcb)
+#define TCP_HASH_RMV(npcb)
+#endif /* LWIP_TCP_PCB_HASH */
+
 #define NUM_TCP_PCB_LISTS_NO_TIME_WAIT  3
 #define NUM_TCP_PCB_LISTS               4
 extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
@@ -367,6 +385,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                             (npcb)->next = *(pcbs); \
                             LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
                             *(pcbs) = (npcb); \
+                            TCP_HASH_REG(pcbs, npcb); \
                             LWIP_ASSERT("TCP_REG: tcp_pcbs sane", tcp_pcbs_sane()); \
               tcp_timer_needed(); \
                             } while(0)
@@ -383,6 +402,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                                } \
                             } \
                             (npcb)->next = NULL; \
+                            TCP_HASH_RMV(npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
                             LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removed %p from %p\n", (void *)(npcb), (void *)(*(pcbs)))); \
                             } while(0)
@@ -393,6 +413,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
   do {                                             \
     (npcb)->next = *pcbs;                          \
     *(pcbs) = (npcb);                              \
+    TCP_HASH_REG(pcbs, npcb);                      \
     tcp_timer_needed();                            \
   } while (0)
 
@@ -413,6 +434,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
       }                                            \
     }                                              \
     (npcb)->next = NULL;                           \
+    TCP_HASH_RMV(npcb);                            \
   } while(0)
 
 #endif /* LWIP_DEBUG */
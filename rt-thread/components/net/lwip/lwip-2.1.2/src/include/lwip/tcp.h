@@ -209,8 +209,16 @@ typedef u16_t tcpflags_t;
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
+#if LWIP_TCP_PCB_HASH
+#define TCP_PCB_HASH_MEMBERS(type) type *hash_next; /* for the hash bucket chain */ \
+                                   type **hash_bucket; /* the bucket, NULL if not hashed */
+#else
+#define TCP_PCB_HASH_MEMBERS(type)
+#endif
+
 #define TCP_PCB_COMMON(type) \
   type *next; /* for the linked list */ \
+  TCP_PCB_HASH_MEMBERS(type) \
   void *callback_arg; \
   TCP_PCB_EXTARGS \
   enum tcp_state state; /* TCP state */ \
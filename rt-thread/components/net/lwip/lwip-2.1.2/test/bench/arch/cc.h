@@ -0,0 +1,13 @@
+#ifndef LWIP_BENCH_CC_H
+#define LWIP_BENCH_CC_H
+
+/* host (gcc, glibc) port for the benchmarks */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LWIP_PLATFORM_DIAG(x)   do { printf x; } while (0)
+#define LWIP_PLATFORM_ASSERT(x) do { printf("Assertion \"%s\" failed at line %d in %s\n", \
+                                     x, __LINE__, __FILE__); abort(); } while (0)
+#define LWIP_RAND()             ((u32_t)rand())
+
+#endif /* LWIP_BENCH_CC_H */
@@ -0,0 +1,398 @@
+/*
+ * Load test of httpd serving the files with port/httpd_dfs.c: HTTPD_BENCH_CONNS
+ * keep-alive connections replayed through ip4_input() request a small page
+ * (with a precompressed variant) and a larger file in turns, half of them
+ * accepting gzip. Reports the requests per second, the RAM used per
+ * connection (heap, pools and the shared file buffers) and checks that the
+ * negotiated responses carry "Vary: Accept-Encoding".
+ */
+
+#include "lwip/init.h"
+#include "lwip/tcp.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/stats.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/apps/httpd.h"
+#include "httpd_dfs.h"
+#include "rtthread.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if !LWIP_STATS
+#error "build with -DLWIP_STATS=1, the RAM is read from the stats"
+#endif
+
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS      20
+#endif
+#ifndef HTTPD_BENCH_CONNS
+#define HTTPD_BENCH_CONNS 32
+#endif
+#ifndef HTTPD_BENCH_BATCH
+#define HTTPD_BENCH_BATCH RT_LWIP_HTTPD_DFS_BUF_NUM
+#endif
+#if (HTTPD_BENCH_CONNS % 4) && (BENCH_ROUNDS % 4)
+#error "the 4 requests are sent in turns, make the connections or the rounds a multiple of 4"
+#endif
+#define BENCH_LOCAL_PORT  80
+#define BENCH_PEER_PORT   10000
+#define BENCH_PAGE_LEN    900
+#define BENCH_GZ_LEN      300
+#define BENCH_BIG_LEN     (16 * 1024)
+
+/* the client side of a connection */
+struct bench_peer {
+  u32_t snd_nxt;    /* next sequence number sent by the peer */
+  u32_t rcv_nxt;    /* next sequence number expected from httpd */
+  u32_t acked;      /* last acknowledged */
+  u32_t requests;   /* requests sent */
+  u32_t responses;  /* response headers received */
+  u32_t left;       /* body bytes left of the current response */
+  u32_t closed;     /* FIN received */
+  u16_t hdr_len;
+  char hdr[512];    /* the response header being received */
+};
+
+char httpd_bench_root[256];
+
+static struct netif bench_netif;
+static ip4_addr_t local_addr, peer_addr;
+static struct bench_peer peers[HTTPD_BENCH_CONNS];
+static u32_t vary_page, vary_gz, vary_big, gzip_sent;
+static int buf_used, buf_peak;
+
+u32_t
+sys_now(void)
+{
+  return 0;
+}
+
+char *
+httpd_bench_buf_alloc(int size)
+{
+  char *buf = httpd_dfs_buf_alloc(size);
+
+  if ((buf != NULL) && (++buf_used > buf_peak)) {
+    buf_peak = buf_used;
+  }
+  return buf;
+}
+
+void
+httpd_bench_buf_free(char *buf)
+{
+  buf_used--;
+  httpd_dfs_buf_free(buf);
+}
+
+/* RAM in use: the heap, the pools and the file buffers. The TCP timer
+   registered with the first connection is left out, it stays */
+static u32_t
+bench_ram(void)
+{
+  u32_t ram = lwip_stats.mem.used;
+  int i;
+
+  for (i = 0; i < MEMP_MAX; i++) {
+    if (i == MEMP_SYS_TIMEOUT) {
+      continue;
+    }
+    ram += (u32_t)lwip_stats.memp[i]->used * memp_pools[i]->size;
+  }
+  return ram + (u32_t)buf_used * RT_LWIP_HTTPD_DFS_BUF_SIZE;
+}
+
+static double
+bench_ms(const struct timespec *t0)
+{
+  struct timespec t1;
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0->tv_sec) * 1e3 + (t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+/* a response header is complete */
+static void
+bench_response(struct bench_peer *peer)
+{
+  const char *cl = strstr(peer->hdr, "Content-Length: ");
+  u32_t body;
+
+  LWIP_ASSERT("Content-Length", cl != NULL);
+  body = (u32_t)atoi(cl + 16);
+  peer->responses++;
+  peer->left = body;
+  if (strstr(peer->hdr, "Content-Encoding: gzip") != NULL) {
+    gzip_sent++;
+  }
+  if (strstr(peer->hdr, "Vary: Accept-Encoding") != NULL) {
+    if (body == BENCH_BIG_LEN) {
+      vary_big++;
+    } else if (body == BENCH_GZ_LEN) {
+      vary_gz++;
+    } else {
+      vary_page++;
+    }
+  }
+}
+
+/* follow the sequence numbers and parse the responses, the headers come in
+   several segments */
+static err_t
+bench_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+  struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+  struct tcp_hdr *tcphdr;
+  struct bench_peer *peer;
+  u16_t hlen, port, len, off;
+  u32_t seqno;
+  char data[TCP_MSS];
+
+  LWIP_UNUSED_ARG(netif);
+  LWIP_UNUSED_ARG(ipaddr);
+  hlen = IPH_HL_BYTES(iphdr);
+  tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + hlen);
+  port = lwip_ntohs(tcphdr->dest);
+  LWIP_ASSERT("peer port", (port >= BENCH_PEER_PORT) && (port < BENCH_PEER_PORT + HTTPD_BENCH_CONNS));
+  peer = &peers[port - BENCH_PEER_PORT];
+  seqno = lwip_ntohl(tcphdr->seqno);
+  hlen = (u16_t)(hlen + TCPH_HDRLEN_BYTES(tcphdr));
+  len = (u16_t)(p->tot_len - hlen);
+  if (TCPH_FLAGS(tcphdr) & TCP_SYN) {
+    peer->rcv_nxt = seqno + 1;
+    return ERR_OK;
+  }
+  if (seqno != peer->rcv_nxt) {
+    /* retransmission */
+    return ERR_OK;
+  }
+  LWIP_ASSERT("segment size", len <= sizeof(data));
+  pbuf_copy_partial(p, data, len, hlen);
+  for (off = 0; off < len; ) {
+    if (peer->left) {
+      u16_t n = (u16_t)LWIP_MIN(peer->left, (u32_t)(len - off));
+
+      peer->left -= n;
+      off = (u16_t)(off + n);
+      continue;
+    }
+    LWIP_ASSERT("header size", peer->hdr_len < sizeof(peer->hdr) - 1);
+    peer->hdr[peer->hdr_len++] = data[off++];
+    peer->hdr[peer->hdr_len] = 0;
+    if ((peer->hdr_len >= 4) && (strcmp(peer->hdr + peer->hdr_len - 4, "\r\n\r\n") == 0)) {
+      bench_response(peer);
+      peer->hdr_len = 0;
+    }
+  }
+  peer->rcv_nxt += len;
+  if (TCPH_FLAGS(tcphdr) & TCP_FIN) {
+    peer->rcv_nxt++;
+    peer->closed = 1;
+  }
+  return ERR_OK;
+}
+
+static err_t
+bench_netif_init(struct netif *netif)
+{
+  netif->output = bench_output;
+  netif->mtu = 1500;
+  netif->flags = NETIF_FLAG_LINK_UP;
+  return ERR_OK;
+}
+
+static void
+bench_tcp_input(int i, u8_t flags, const char *data)
+{
+  struct bench_peer *peer = &peers[i];
+  u16_t data_len = (u16_t)(data ? strlen(data) : 0);
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)(IP_HLEN + TCP_HLEN + data_len), PBUF_POOL);
+  struct ip_hdr *iphdr;
+  struct tcp_hdr *tcphdr;
+
+  LWIP_ASSERT("out of pbufs", p != NULL && p->next == NULL);
+  iphdr = (struct ip_hdr *)p->payload;
+  memset(iphdr, 0, IP_HLEN + TCP_HLEN);
+  IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+  IPH_LEN_SET(iphdr, lwip_htons(p->tot_len));
+  IPH_TTL_SET(iphdr, 64);
+  IPH_PROTO_SET(iphdr, IP_PROTO_TCP);
+  ip4_addr_copy(iphdr->src, peer_addr);
+  ip4_addr_copy(iphdr->dest, local_addr);
+  tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+  tcphdr->src = lwip_htons((u16_t)(BENCH_PEER_PORT + i));
+  tcphdr->dest = PP_HTONS(BENCH_LOCAL_PORT);
+  tcphdr->seqno = lwip_htonl(peer->snd_nxt);
+  tcphdr->ackno = lwip_htonl((flags & TCP_ACK) ? peer->rcv_nxt : 0);
+  TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN / 4, flags);
+  tcphdr->wnd = PP_HTONS(TCP_WND);
+  if (data_len) {
+    memcpy((u8_t *)tcphdr + TCP_HLEN, data, data_len);
+  }
+  peer->snd_nxt += data_len + ((flags & (TCP_SYN | TCP_FIN)) ? 1 : 0);
+  if (flags & TCP_ACK) {
+    peer->acked = peer->rcv_nxt;
+  }
+  ip4_input(p, &bench_netif);
+}
+
+/* acknowledge what httpd sent until all the responses are complete */
+static int
+bench_pump(void)
+{
+  int i, acked, pending;
+
+  do {
+    acked = pending = 0;
+    for (i = 0; i < HTTPD_BENCH_CONNS; i++) {
+      struct bench_peer *peer = &peers[i];
+
+      if (peer->acked != peer->rcv_nxt) {
+        bench_tcp_input(i, TCP_ACK, NULL);
+        acked = 1;
+      }
+      if (peer->closed) {
+        return -1;
+      }
+      if ((peer->responses < peer->requests) || peer->left || peer->hdr_len) {
+        pending = 1;
+      }
+    }
+  } while (pending && acked);
+  return pending ? -1 : 0;
+}
+
+static int
+bench_file(const char *name, u32_t len, char c)
+{
+  char path[300];
+  FILE *f;
+
+  snprintf(path, sizeof(path), "%s/%s", httpd_bench_root, name);
+  f = fopen(path, "wb");
+  if (f == NULL) {
+    return -1;
+  }
+  while (len--) {
+    fputc(c, f);
+  }
+  return fclose(f);
+}
+
+static void
+bench_cleanup(void)
+{
+  char path[300];
+
+  snprintf(path, sizeof(path), "rm -rf %s", httpd_bench_root);
+  if (system(path) != 0) {
+    printf("remove %s failed\n", httpd_bench_root);
+  }
+}
+
+#define BENCH_CHECK(x) do { if (!(x)) { printf("check failed: %s\n", #x); bench_cleanup(); return 1; } } while (0)
+
+extern int (*const rti_httpd_dfs_init)(void);
+
+int
+main(void)
+{
+  static const char *const req[] = {
+    "GET /index.html HTTP/1.1\r\nHost: bench\r\nConnection: keep-alive\r\nAccept-Encoding: gzip, deflate\r\n\r\n",
+    "GET /index.html HTTP/1.1\r\nHost: bench\r\nConnection: keep-alive\r\n\r\n",
+    "GET /big.bin HTTP/1.1\r\nHost: bench\r\nConnection: keep-alive\r\nAccept-Encoding: gzip\r\n\r\n",
+    "GET /big.bin HTTP/1.1\r\nHost: bench\r\nConnection: keep-alive\r\n\r\n",
+  };
+  ip4_addr_t netmask, gw;
+  struct timespec t0;
+  u32_t ram_base, ram_idle, ram_peak, n;
+  double ms;
+  int i, r, b;
+
+  snprintf(httpd_bench_root, sizeof(httpd_bench_root), "/tmp/httpd_bench.XXXXXX");
+  if (mkdtemp(httpd_bench_root) == NULL) {
+    printf("mkdtemp failed\n");
+    return 1;
+  }
+  BENCH_CHECK(bench_file("index.html", BENCH_PAGE_LEN, 'p') == 0);
+  BENCH_CHECK(bench_file("index.html.gz", BENCH_GZ_LEN, 'z') == 0);
+  BENCH_CHECK(bench_file("big.bin", BENCH_BIG_LEN, 'b') == 0);
+
+  lwip_init();
+  IP4_ADDR(&local_addr, 192, 168, 0, 1);
+  IP4_ADDR(&peer_addr, 192, 168, 0, 2);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, 192, 168, 0, 254);
+  netif_add(&bench_netif, &local_addr, &netmask, &gw, NULL, bench_netif_init, ip4_input);
+  netif_set_default(&bench_netif);
+  netif_set_up(&bench_netif);
+  BENCH_CHECK(rti_httpd_dfs_init() == 0);
+
+  printf("%d connections, %d rounds, %d requests at once, %d file buffers of %d bytes\n",
+         HTTPD_BENCH_CONNS, BENCH_ROUNDS, HTTPD_BENCH_BATCH, RT_LWIP_HTTPD_DFS_BUF_NUM,
+         RT_LWIP_HTTPD_DFS_BUF_SIZE);
+
+  ram_base = bench_ram();
+  for (i = 0; i < HTTPD_BENCH_CONNS; i++) {
+    peers[i].snd_nxt = 1000;
+    bench_tcp_input(i, TCP_SYN, NULL);
+    bench_tcp_input(i, TCP_ACK, NULL);
+  }
+  ram_idle = bench_ram() - ram_base;
+  ram_peak = ram_idle;
+
+  /* every connection sends a request per round, as many at once as there
+     are file buffers: the others would wait for the poll timer of httpd */
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (r = 0; r < BENCH_ROUNDS; r++) {
+    for (b = 0; b < HTTPD_BENCH_CONNS; b += HTTPD_BENCH_BATCH) {
+      for (i = b; (i < b + HTTPD_BENCH_BATCH) && (i < HTTPD_BENCH_CONNS); i++) {
+        peers[i].requests++;
+        bench_tcp_input(i, TCP_ACK | TCP_PSH, req[(i + r) % 4]);
+      }
+      if (bench_ram() - ram_base > ram_peak) {
+        ram_peak = bench_ram() - ram_base;
+      }
+      BENCH_CHECK(bench_pump() == 0);
+    }
+  }
+  ms = bench_ms(&t0);
+  n = BENCH_ROUNDS * HTTPD_BENCH_CONNS;
+  for (i = 0; i < HTTPD_BENCH_CONNS; i++) {
+    BENCH_CHECK(peers[i].responses == BENCH_ROUNDS);
+  }
+  BENCH_CHECK(buf_used == 0);
+
+  printf("requests:         %8.3f ms, %.0f requests/s\n", ms, n * 1e3 / ms);
+  printf("ram idle:         %8u bytes per connection\n", (unsigned)(ram_idle / HTTPD_BENCH_CONNS));
+  printf("ram peak:         %8u bytes per connection (%d file buffers)\n",
+         (unsigned)(ram_peak / HTTPD_BENCH_CONNS), buf_peak);
+
+  /* index.html has a gzip variant, the caches are told by both responses */
+  BENCH_CHECK(gzip_sent == n / 4);
+  BENCH_CHECK(vary_gz == n / 4);
+  BENCH_CHECK(vary_page == n / 4);
+  BENCH_CHECK(vary_big == 0);
+
+  /* the clients close, httpd closes in turn and the memory is back */
+  for (i = 0; i < HTTPD_BENCH_CONNS; i++) {
+    bench_tcp_input(i, TCP_FIN | TCP_ACK, NULL);
+  }
+  for (i = 0; i < HTTPD_BENCH_CONNS; i++) {
+    BENCH_CHECK(peers[i].closed);
+    bench_tcp_input(i, TCP_ACK, NULL);
+  }
+  BENCH_CHECK(tcp_active_pcbs == NULL);
+  BENCH_CHECK(bench_ram() == ram_base);
+
+  bench_cleanup();
+  return 0;
+}
@@ -0,0 +1,63 @@
+#ifndef LWIP_HDR_LWIPOPTS_H
+#define LWIP_HDR_LWIPOPTS_H
+
+/* Options of the host benchmarks, the stack runs without an OS */
+#define NO_SYS                          1
+#define SYS_LIGHTWEIGHT_PROT            0
+#define LWIP_NETCONN                    0
+#define LWIP_SOCKET                     0
+#define LWIP_IPV6                       0
+#ifndef LWIP_STATS
+#define LWIP_STATS                      0
+#endif
+
+#ifndef BENCH_CONNS
+#define BENCH_CONNS                     500
+#endif
+
+/* the pools hold pointers of the 64-bit host */
+#define MEM_ALIGNMENT                   8
+#define MEM_SIZE                        (256 * 1024)
+#define MEMP_NUM_TCP_PCB                (BENCH_CONNS + 8)
+#define MEMP_NUM_TCP_PCB_LISTEN         2
+#define MEMP_NUM_UDP_PCB                (BENCH_CONNS + 8)
+#define MEMP_NUM_TCP_SEG                (BENCH_CONNS + 64)
+#define MEMP_NUM_PBUF                   64
+#define PBUF_POOL_SIZE                  64
+#define TCP_MSS                         1460
+#define TCP_WND                         (4 * TCP_MSS)
+#define TCP_SND_BUF                     (4 * TCP_MSS)
+
+/* the replayed packets carry no checksums */
+#define CHECKSUM_CHECK_IP               0
+#define CHECKSUM_CHECK_TCP              0
+#define CHECKSUM_CHECK_UDP              0
+#define CHECKSUM_GEN_IP                 0
+#define CHECKSUM_GEN_TCP                0
+#define CHECKSUM_GEN_UDP                0
+
+/* set from the Makefile */
+#ifndef LWIP_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               1
+#endif
+#ifndef LWIP_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               LWIP_TCP_PCB_HASH
+#endif
+#ifndef LWIP_TCP_PCB_HASH_SIZE
+#define LWIP_TCP_PCB_HASH_SIZE          64
+#endif
+#define LWIP_UDP_PCB_HASH_SIZE          LWIP_TCP_PCB_HASH_SIZE
+
+/* httpd as configured by the port (port/lwipopts.h) serving the files with
+   port/httpd_dfs.c, the file buffers are counted by httpd_bench */
+#define LWIP_HTTPD_DYNAMIC_HEADERS      1
+#define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 1
+#define LWIP_HTTPD_SUPPORT_PIPELINING   1
+#define LWIP_HTTPD_CUSTOM_FILES         1
+#define LWIP_HTTPD_DYNAMIC_FILE_READ    1
+char *httpd_bench_buf_alloc(int size);
+void httpd_bench_buf_free(char *buf);
+#define HTTP_ALLOC_FILE_BUF(size)       httpd_bench_buf_alloc(size)
+#define HTTP_FREE_FILE_BUF(x)           httpd_bench_buf_free(x)
+
+#endif /* LWIP_HDR_LWIPOPTS_H */
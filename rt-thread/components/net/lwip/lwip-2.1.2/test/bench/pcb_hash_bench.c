@@ -0,0 +1,288 @@
+/*
+ * Replays the traffic of BENCH_CONNS TCP connections and as many bound UDP
+ * pcbs through ip4_input() and reports the time spent in each phase:
+ * handshakes, data segments in random connection order, datagrams and the
+ * passive closes. Built once with and once without the pcb hash tables, see
+ * the Makefile.
+ */
+
+#include "lwip/init.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/prot/ip4.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/prot/udp.h"
+#include "lwip/priv/tcp_priv.h"
+
+#include <string.h>
+#include <time.h>
+
+#ifndef BENCH_ROUNDS
+#define BENCH_ROUNDS      20
+#endif
+#define BENCH_DATA_LEN    64
+#define BENCH_LOCAL_PORT  80
+#define BENCH_PEER_PORT   10000
+#define BENCH_UDP_PORT    20000
+
+/* the remote end of a connection */
+struct bench_peer {
+  u32_t snd_nxt;    /* next sequence number sent by the peer */
+  u32_t rcv_nxt;    /* next sequence number expected from lwIP */
+  struct tcp_pcb *pcb;
+  u32_t rx_segs;
+  u32_t closed;
+};
+
+static struct netif bench_netif;
+static ip4_addr_t local_addr, peer_addr;
+static struct bench_peer peers[BENCH_CONNS];
+static u32_t udp_rx[BENCH_CONNS];
+static u32_t accepted, tx_segs;
+static u32_t lcg = 12345;
+
+u32_t
+sys_now(void)
+{
+  return 0;
+}
+
+static u32_t
+bench_rand(void)
+{
+  lcg = lcg * 1103515245u + 12345u;
+  return lcg >> 8;
+}
+
+static double
+bench_ms(const struct timespec *t0)
+{
+  struct timespec t1;
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0->tv_sec) * 1e3 + (t1.tv_nsec - t0->tv_nsec) / 1e6;
+}
+
+/* track the sequence numbers lwIP sends to each peer */
+static err_t
+bench_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+  struct ip_hdr *iphdr = (struct ip_hdr *)p->payload;
+  struct tcp_hdr *tcphdr;
+  u16_t hlen, port, len;
+  u32_t seqno;
+  struct bench_peer *peer;
+
+  LWIP_UNUSED_ARG(netif);
+  LWIP_UNUSED_ARG(ipaddr);
+  tx_segs++;
+  if (IPH_PROTO(iphdr) != IP_PROTO_TCP) {
+    return ERR_OK;
+  }
+  hlen = IPH_HL_BYTES(iphdr);
+  tcphdr = (struct tcp_hdr *)((u8_t *)p->payload + hlen);
+  port = lwip_ntohs(tcphdr->dest);
+  if ((port < BENCH_PEER_PORT) || (port >= BENCH_PEER_PORT + BENCH_CONNS)) {
+    return ERR_OK;
+  }
+  peer = &peers[port - BENCH_PEER_PORT];
+  seqno = lwip_ntohl(tcphdr->seqno);
+  len = (u16_t)(p->tot_len - hlen - TCPH_HDRLEN_BYTES(tcphdr));
+  if (TCPH_FLAGS(tcphdr) & (TCP_SYN | TCP_FIN)) {
+    len++;
+  }
+  if (TCP_SEQ_GT(seqno + len, peer->rcv_nxt) || (TCPH_FLAGS(tcphdr) & TCP_SYN)) {
+    peer->rcv_nxt = seqno + len;
+  }
+  return ERR_OK;
+}
+
+static err_t
+bench_netif_init(struct netif *netif)
+{
+  netif->output = bench_output;
+  netif->mtu = 1500;
+  netif->flags = NETIF_FLAG_LINK_UP;
+  return ERR_OK;
+}
+
+/* pass an IPv4 packet from the peer with the given transport header and payload */
+static void
+bench_input(u8_t proto, const void *hdr, u16_t hdr_len, u16_t data_len)
+{
+  struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)(IP_HLEN + hdr_len + data_len), PBUF_POOL);
+  struct ip_hdr *iphdr;
+
+  LWIP_ASSERT("out of pbufs", p != NULL && p->next == NULL);
+  iphdr = (struct ip_hdr *)p->payload;
+  memset(iphdr, 0, IP_HLEN);
+  IPH_VHL_SET(iphdr, 4, IP_HLEN / 4);
+  IPH_LEN_SET(iphdr, lwip_htons(p->tot_len));
+  IPH_TTL_SET(iphdr, 64);
+  IPH_PROTO_SET(iphdr, proto);
+  ip4_addr_copy(iphdr->src, peer_addr);
+  ip4_addr_copy(iphdr->dest, local_addr);
+  memcpy((u8_t *)p->payload + IP_HLEN, hdr, hdr_len);
+  memset((u8_t *)p->payload + IP_HLEN + hdr_len, 'x', data_len);
+  ip4_input(p, &bench_netif);
+}
+
+static void
+bench_tcp_input(int i, u8_t flags, u16_t data_len)
+{
+  struct bench_peer *peer = &peers[i];
+  struct tcp_hdr tcphdr;
+
+  memset(&tcphdr, 0, sizeof(tcphdr));
+  tcphdr.src = lwip_htons((u16_t)(BENCH_PEER_PORT + i));
+  tcphdr.dest = lwip_htons(BENCH_LOCAL_PORT);
+  tcphdr.seqno = lwip_htonl(peer->snd_nxt);
+  tcphdr.ackno = lwip_htonl((flags & TCP_ACK) ? peer->rcv_nxt : 0);
+  TCPH_HDRLEN_FLAGS_SET(&tcphdr, TCP_HLEN / 4, flags);
+  tcphdr.wnd = PP_HTONS(TCP_WND);
+  bench_input(IP_PROTO_TCP, &tcphdr, TCP_HLEN, data_len);
+  peer->snd_nxt += data_len + ((flags & (TCP_SYN | TCP_FIN)) ? 1 : 0);
+}
+
+static void
+bench_udp_input(int i)
+{
+  struct udp_hdr udphdr;
+
+  udphdr.src = PP_HTONS(5000);
+  udphdr.dest = lwip_htons((u16_t)(BENCH_UDP_PORT + i));
+  udphdr.len = lwip_htons(UDP_HLEN + BENCH_DATA_LEN);
+  udphdr.chksum = 0;
+  bench_input(IP_PROTO_UDP, &udphdr, UDP_HLEN, BENCH_DATA_LEN);
+}
+
+static err_t
+bench_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+  struct bench_peer *peer = (struct bench_peer *)arg;
+
+  LWIP_UNUSED_ARG(err);
+  if (p == NULL) {
+    peer->closed = 1;
+    return tcp_close(pcb);
+  }
+  peer->rx_segs++;
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+  return ERR_OK;
+}
+
+static err_t
+bench_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+  struct bench_peer *peer = &peers[newpcb->remote_port - BENCH_PEER_PORT];
+
+  LWIP_UNUSED_ARG(arg);
+  LWIP_UNUSED_ARG(err);
+  peer->pcb = newpcb;
+  tcp_arg(newpcb, peer);
+  tcp_recv(newpcb, bench_recv);
+  accepted++;
+  return ERR_OK;
+}
+
+static void
+bench_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(addr);
+  LWIP_UNUSED_ARG(port);
+  udp_rx[(size_t)arg]++;
+  pbuf_free(p);
+}
+
+#define BENCH_CHECK(x) do { if (!(x)) { printf("check failed: %s\n", #x); return 1; } } while (0)
+
+int
+main(void)
+{
+  struct tcp_pcb *lpcb;
+  struct udp_pcb *upcb;
+  ip4_addr_t netmask, gw;
+  struct timespec t0;
+  double ms;
+  int i, r, n;
+
+  lwip_init();
+  IP4_ADDR(&local_addr, 192, 168, 0, 1);
+  IP4_ADDR(&peer_addr, 192, 168, 0, 2);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gw, 192, 168, 0, 254);
+  netif_add(&bench_netif, &local_addr, &netmask, &gw, NULL, bench_netif_init, ip4_input);
+  netif_set_default(&bench_netif);
+  netif_set_up(&bench_netif);
+
+  printf("%d connections, %d rounds, %s, %d buckets\n", BENCH_CONNS, BENCH_ROUNDS,
+         LWIP_TCP_PCB_HASH ? "hash" : "list", LWIP_TCP_PCB_HASH ? LWIP_TCP_PCB_HASH_SIZE : 0);
+
+  lpcb = tcp_new();
+  BENCH_CHECK(lpcb != NULL && tcp_bind(lpcb, IP4_ADDR_ANY, BENCH_LOCAL_PORT) == ERR_OK);
+  lpcb = tcp_listen(lpcb);
+  BENCH_CHECK(lpcb != NULL);
+  tcp_accept(lpcb, bench_accept);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 0; i < BENCH_CONNS; i++) {
+    peers[i].snd_nxt = 1000;
+    bench_tcp_input(i, TCP_SYN, 0);
+    bench_tcp_input(i, TCP_ACK, 0);
+  }
+  ms = bench_ms(&t0);
+  BENCH_CHECK(accepted == BENCH_CONNS);
+  printf("tcp handshakes:   %8.3f ms\n", ms);
+
+  n = BENCH_ROUNDS * BENCH_CONNS;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (r = 0; r < n; r++) {
+    bench_tcp_input((int)(bench_rand() % BENCH_CONNS), TCP_ACK | TCP_PSH, BENCH_DATA_LEN);
+  }
+  ms = bench_ms(&t0);
+  for (i = 0, r = 0; i < BENCH_CONNS; i++) {
+    r += (int)peers[i].rx_segs;
+  }
+  BENCH_CHECK(r == n);
+  printf("tcp segments:     %8.3f ms, %.0f ns per segment\n", ms, ms * 1e6 / n);
+
+  for (i = 0; i < BENCH_CONNS; i++) {
+    upcb = udp_new();
+    BENCH_CHECK(upcb != NULL && udp_bind(upcb, IP4_ADDR_ANY, (u16_t)(BENCH_UDP_PORT + i)) == ERR_OK);
+    udp_recv(upcb, bench_udp_recv, (void *)(size_t)i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (r = 0; r < n; r++) {
+    bench_udp_input((int)(bench_rand() % BENCH_CONNS));
+  }
+  ms = bench_ms(&t0);
+  for (i = 0, r = 0; i < BENCH_CONNS; i++) {
+    r += (int)udp_rx[i];
+  }
+  BENCH_CHECK(r == n);
+  printf("udp datagrams:    %8.3f ms, %.0f ns per datagram\n", ms, ms * 1e6 / n);
+
+  /* the peers close, lwIP closes in turn and the peers acknowledge */
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 0; i < BENCH_CONNS; i++) {
+    bench_tcp_input(i, TCP_FIN | TCP_ACK, 0);
+  }
+  for (i = 0; i < BENCH_CONNS; i++) {
+    bench_tcp_input(i, TCP_ACK, 0);
+  }
+  ms = bench_ms(&t0);
+  for (i = 0; i < BENCH_CONNS; i++) {
+    BENCH_CHECK(peers[i].closed);
+  }
+  BENCH_CHECK(tcp_active_pcbs == NULL);
+  printf("tcp closes:       %8.3f ms\n", ms);
+  printf("%u packets sent\n", (unsigned)tx_segs);
+
+  tcp_close(lpcb);
+  return 0;
+}
@@ -0,0 +1,6 @@
+#ifndef LWIP_BENCH_DFS_H
+#define LWIP_BENCH_DFS_H
+
+#define DFS_PATH_MAX    256
+
+#endif /* LWIP_BENCH_DFS_H */
@@ -0,0 +1,7 @@
+#ifndef LWIP_BENCH_DFS_FILE_H
+#define LWIP_BENCH_DFS_FILE_H
+
+/* not supported by the host files, they are read into the buffers */
+#define RT_FIOGETADDR   0x52540001U
+
+#endif /* LWIP_BENCH_DFS_FILE_H */
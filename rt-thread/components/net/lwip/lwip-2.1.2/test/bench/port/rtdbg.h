@@ -0,0 +1,7 @@
+#ifndef LWIP_BENCH_RTDBG_H
+#define LWIP_BENCH_RTDBG_H
+
+#define LOG_D(...)
+#define LOG_E(...)  do { printf(__VA_ARGS__); printf("\n"); } while (0)
+
+#endif /* LWIP_BENCH_RTDBG_H */
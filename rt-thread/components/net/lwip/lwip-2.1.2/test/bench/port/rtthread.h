@@ -0,0 +1,37 @@
+#ifndef LWIP_BENCH_RTTHREAD_H
+#define LWIP_BENCH_RTTHREAD_H
+
+/* The parts of rtthread.h used by the lwIP files of this port (netif.c and
+   dns.c include it) and by port/httpd_dfs.c, on top of the host libc */
+#include <stdio.h>
+#include <stdint.h>
+
+typedef uint16_t  rt_uint16_t;
+typedef uint32_t  rt_uint32_t;
+typedef intptr_t  rt_base_t;
+
+#define RT_NULL   NULL
+#define RT_EOK    0
+#define RT_ERROR  1
+
+#define rt_snprintf snprintf
+#define rt_kprintf  printf
+
+/* the benchmark calls the exported init functions itself */
+#define INIT_APP_EXPORT(fn) int (*const rti_##fn)(void) = fn
+
+/* port/httpd_dfs.c, served from a directory the benchmark creates */
+#define RT_LWIP_HTTPD_USING_DFS
+#define RT_LWIP_HTTPD_DFS_GZIP
+extern char httpd_bench_root[];
+#define RT_LWIP_HTTPD_ROOT          httpd_bench_root
+#ifndef RT_LWIP_HTTPD_DFS_BUF_SIZE
+#define RT_LWIP_HTTPD_DFS_BUF_SIZE  1460
+#endif
+#ifndef RT_LWIP_HTTPD_DFS_BUF_NUM
+#define RT_LWIP_HTTPD_DFS_BUF_NUM   4
+#endif
+/* NO_SYS, the callback runs at once */
+#define tcpip_callback(fn, ctx)     ((fn)(ctx), ERR_OK)
+
+#endif /* LWIP_BENCH_RTTHREAD_H */
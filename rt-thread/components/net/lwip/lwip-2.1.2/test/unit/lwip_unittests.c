@@ -5,6 +5,7 @@
 #include "udp/test_udp.h"
 #include "tcp/test_tcp.h"
 #include "tcp/test_tcp_oos.h"
+#include "tcp/test_tcp_hash.h"
 #include "core/test_def.h"
 #include "core/test_mem.h"
 #include "core/test_netif.h"
@@ -67,6 +68,7 @@ int main(void)
     udp_suite,
     tcp_suite,
     tcp_oos_suite,
+    tcp_hash_suite,
     def_suite,
     mem_suite,
     netif_suite,
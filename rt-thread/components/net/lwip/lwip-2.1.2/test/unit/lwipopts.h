@@ -68,6 +68,18 @@
 #define LWIP_MDNS_RESPONDER             1
 #define LWIP_NUM_NETIF_CLIENT_DATA      (LWIP_MDNS_RESPONDER)
 
+/* Demultiplex through the pcb hash tables, small ones so that the buckets are
+   shared. Build with -DLWIP_TCP_PCB_HASH=0 -DLWIP_UDP_PCB_HASH=0 to test the
+   list walks instead. */
+#ifndef LWIP_TCP_PCB_HASH
+#define LWIP_TCP_PCB_HASH               1
+#endif
+#define LWIP_TCP_PCB_HASH_SIZE          2
+#ifndef LWIP_UDP_PCB_HASH
+#define LWIP_UDP_PCB_HASH               1
+#endif
+#define LWIP_UDP_PCB_HASH_SIZE          2
+
 /* Minimal changes to opt.h required for etharp unit tests: */
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
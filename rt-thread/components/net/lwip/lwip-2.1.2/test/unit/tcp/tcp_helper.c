@@ -159,15 +159,16 @@ tcp_set_state(struct tcp_pcb* pcb, enum tcp_state state, const ip_addr_t* local_
   pcb->snd_lbb = iss;
   
   if (state == ESTABLISHED) {
-    TCP_REG(&tcp_active_pcbs, pcb);
     ip_addr_copy(pcb->local_ip, *local_ip);
     pcb->local_port = local_port;
     ip_addr_copy(pcb->remote_ip, *remote_ip);
     pcb->remote_port = remote_port;
+    /* register after setting up the addresses and ports, the pcb is hashed by them */
+    TCP_REG(&tcp_active_pcbs, pcb);
   } else if(state == LISTEN) {
-    TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
     ip_addr_copy(pcb->local_ip, *local_ip);
     pcb->local_port = local_port;
+    TCP_REG(&tcp_listen_pcbs.pcbs, pcb);
   } else if(state == TIME_WAIT) {
     TCP_REG(&tcp_tw_pcbs, pcb);
     ip_addr_copy(pcb->local_ip, *local_ip);
@@ -0,0 +1,431 @@
+#include "test_tcp_hash.h"
+
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/stats.h"
+#include "tcp_helper.h"
+
+#if !LWIP_STATS || !TCP_STATS || !MEMP_STATS
+#error "This tests needs TCP- and MEMP-statistics enabled"
+#endif
+
+/* The tests run with and without LWIP_TCP_PCB_HASH: the segments must be
+   demultiplexed the same either way. With the hash tables, their contents
+   are checked against the pcb lists after every step. */
+
+#define TEST_NUM_PCBS 4
+
+static u32_t accept_calls;
+static struct tcp_pcb *accepted_pcb;
+
+#if LWIP_TCP_PCB_HASH
+/** Count the pcbs in the buckets of a hash table */
+static int
+tcp_hash_count(struct tcp_pcb **table)
+{
+  struct tcp_pcb *pcb;
+  int i, n = 0;
+
+  for (i = 0; i < LWIP_TCP_PCB_HASH_SIZE; i++) {
+    for (pcb = table[i]; pcb != NULL; pcb = pcb->hash_next) {
+      EXPECT(pcb->hash_bucket == &table[i]);
+      n++;
+    }
+  }
+  return n;
+}
+
+/** Check that a pcb is in the bucket it's hashed to */
+static int
+tcp_hash_contains(struct tcp_pcb **bucket, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb *p;
+
+  for (p = *bucket; p != NULL; p = p->hash_next) {
+    if (p == pcb) {
+      return 1;
+    }
+  }
+  return 0;
+}
+#endif /* LWIP_TCP_PCB_HASH */
+
+/** Check that exactly the pcbs on tcp_active_pcbs and tcp_listen_pcbs are hashed */
+static void
+check_tcp_hash(void)
+{
+#if LWIP_TCP_PCB_HASH
+  struct tcp_pcb *pcb;
+  struct tcp_pcb **bucket;
+  int n;
+
+  for (pcb = tcp_active_pcbs, n = 0; pcb != NULL; pcb = pcb->next, n++) {
+    bucket = &tcp_active_hash[tcp_pcb_hash(&pcb->remote_ip, pcb->remote_port, pcb->local_port)];
+    EXPECT(pcb->hash_bucket == bucket);
+    EXPECT(tcp_hash_contains(bucket, pcb));
+  }
+  EXPECT(tcp_hash_count(tcp_active_hash) == n);
+
+  for (pcb = tcp_listen_pcbs.pcbs, n = 0; pcb != NULL; pcb = pcb->next, n++) {
+    bucket = (struct tcp_pcb **)&tcp_listen_hash[TCP_PCB_HASH_LISTEN(pcb->local_port)];
+    EXPECT(pcb->hash_bucket == bucket);
+    EXPECT(tcp_hash_contains(bucket, pcb));
+  }
+  EXPECT(tcp_hash_count((struct tcp_pcb **)tcp_listen_hash) == n);
+
+  for (pcb = tcp_bound_pcbs; pcb != NULL; pcb = pcb->next) {
+    EXPECT(pcb->hash_bucket == NULL);
+  }
+  for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
+    EXPECT(pcb->hash_bucket == NULL);
+  }
+#endif /* LWIP_TCP_PCB_HASH */
+}
+
+static int
+tcp_list_contains(struct tcp_pcb *list, struct tcp_pcb *pcb)
+{
+  for (; list != NULL; list = list->next) {
+    if (list == pcb) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static err_t
+test_tcp_hash_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
+{
+  LWIP_UNUSED_ARG(arg);
+  EXPECT_RETX(err == ERR_OK, ERR_OK);
+  accept_calls++;
+  accepted_pcb = newpcb;
+  return ERR_OK;
+}
+
+/** Create a segment from test_remote_ip to test_local_ip */
+static struct pbuf *
+test_tcp_hash_segment(u16_t remote_port, u16_t local_port, void *data, size_t data_len,
+                      u32_t seqno, u32_t ackno, u8_t headerflags)
+{
+  ip_addr_t remote_ip = test_remote_ip;
+  ip_addr_t local_ip = test_local_ip;
+
+  return tcp_create_segment(&remote_ip, &local_ip, remote_port, local_port,
+                            data, data_len, seqno, ackno, headerflags);
+}
+
+/** Pass one byte to the pcb, returns the number of segments sent in reply */
+static u32_t
+test_tcp_hash_rx_byte(struct tcp_pcb *pcb, struct netif *netif, struct test_tcp_txcounters *txcounters)
+{
+  char data = 0x0f;
+  u32_t tx_calls = txcounters->num_tx_calls;
+  struct pbuf *p = tcp_create_rx_segment(pcb, &data, 1, 0, 0, TCP_ACK);
+
+  EXPECT_RETX(p != NULL, 0);
+  test_tcp_input(p, netif);
+  return txcounters->num_tx_calls - tx_calls;
+}
+
+/* Setups/teardown functions */
+static struct netif *old_netif_list;
+static struct netif *old_netif_default;
+
+static void
+tcp_hash_setup(void)
+{
+  old_netif_list = netif_list;
+  old_netif_default = netif_default;
+  netif_list = NULL;
+  netif_default = NULL;
+  accept_calls = 0;
+  accepted_pcb = NULL;
+  tcp_remove_all();
+  lwip_check_ensure_no_alloc(SKIP_POOL(MEMP_SYS_TIMEOUT));
+}
+
+static void
+tcp_hash_teardown(void)
+{
+  netif_list = NULL;
+  netif_default = NULL;
+  tcp_remove_all();
+  check_tcp_hash();
+  /* restore netif_list for next tests (e.g. loopif) */
+  netif_list = old_netif_list;
+  netif_default = old_netif_default;
+  lwip_check_ensure_no_alloc(SKIP_POOL(MEMP_SYS_TIMEOUT));
+}
+
+
+/* Test functions */
+
+/** Connect several pcbs to the same remote host and check that the segments
+ * reach the right one while they share the buckets */
+START_TEST(test_tcp_hash_connect)
+{
+  struct netif netif;
+  struct test_tcp_txcounters txcounters;
+  struct test_tcp_counters counters[TEST_NUM_PCBS];
+  struct tcp_pcb *pcbs[TEST_NUM_PCBS];
+  struct pbuf *p;
+  err_t err;
+  int i, j;
+  LWIP_UNUSED_ARG(_i);
+
+  test_tcp_init_netif(&netif, &txcounters, &test_local_ip, &test_netmask);
+
+  for (i = 0; i < TEST_NUM_PCBS; i++) {
+    memset(&counters[i], 0, sizeof(counters[i]));
+    pcbs[i] = test_tcp_new_counters_pcb(&counters[i]);
+    EXPECT_RET(pcbs[i] != NULL);
+    err = tcp_bind(pcbs[i], &test_local_ip, (u16_t)(TEST_LOCAL_PORT + i));
+    EXPECT_RET(err == ERR_OK);
+    check_tcp_hash();
+    err = tcp_connect(pcbs[i], &test_remote_ip, TEST_REMOTE_PORT, NULL);
+    EXPECT_RET(err == ERR_OK);
+    EXPECT_RET(pcbs[i]->state == SYN_SENT);
+    EXPECT(tcp_list_contains(tcp_active_pcbs, pcbs[i]));
+    check_tcp_hash();
+  }
+  EXPECT(txcounters.num_tx_calls == TEST_NUM_PCBS);
+
+  /* complete the handshakes in reverse order */
+  for (i = TEST_NUM_PCBS - 1; i >= 0; i--) {
+    p = tcp_create_segment(&pcbs[i]->remote_ip, &pcbs[i]->local_ip, pcbs[i]->remote_port,
+                           pcbs[i]->local_port, NULL, 0, 12345, pcbs[i]->snd_nxt, TCP_SYN | TCP_ACK);
+    EXPECT_RET(p != NULL);
+    test_tcp_input(p, &netif);
+    EXPECT(pcbs[i]->state == ESTABLISHED);
+    for (j = 0; j < i; j++) {
+      EXPECT(pcbs[j]->state == SYN_SENT);
+    }
+  }
+  check_tcp_hash();
+
+  for (i = 0; i < TEST_NUM_PCBS; i++) {
+    test_tcp_hash_rx_byte(pcbs[i], &netif, &txcounters);
+    for (j = 0; j < TEST_NUM_PCBS; j++) {
+      EXPECT(counters[j].recv_calls == (u32_t)(j <= i));
+      EXPECT(counters[j].err_calls == 0);
+    }
+  }
+}
+END_TEST
+
+/** Listen on ports sharing a bucket, accept a connection and close the listener */
+START_TEST(test_tcp_hash_listen)
+{
+  struct netif netif;
+  struct test_tcp_txcounters txcounters;
+  struct tcp_pcb *pcb, *lpcb[2];
+  struct pbuf *p;
+  const u16_t ports[2] = {1234, 1234 + 2 * LWIP_TCP_PCB_HASH_SIZE};
+  err_t err;
+  int i;
+  LWIP_UNUSED_ARG(_i);
+
+  test_tcp_init_netif(&netif, &txcounters, &test_local_ip, &test_netmask);
+
+  for (i = 0; i < 2; i++) {
+    pcb = tcp_new();
+    EXPECT_RET(pcb != NULL);
+    err = tcp_bind(pcb, &netif.ip_addr, ports[i]);
+    EXPECT_RET(err == ERR_OK);
+    lpcb[i] = tcp_listen(pcb);
+    EXPECT_RET(lpcb[i] != NULL);
+    tcp_accept(lpcb[i], test_tcp_hash_accept);
+    check_tcp_hash();
+  }
+
+  /* SYN to the second listener */
+  p = test_tcp_hash_segment(TEST_REMOTE_PORT, ports[1], NULL, 0, 12345, 0, TCP_SYN);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(txcounters.num_tx_calls == 1);
+  pcb = tcp_active_pcbs;
+  EXPECT_RET(pcb != NULL);
+  EXPECT(pcb->state == SYN_RCVD);
+  EXPECT(pcb->local_port == ports[1]);
+  EXPECT(pcb->listener == (struct tcp_pcb_listen *)lpcb[1]);
+  check_tcp_hash();
+
+  /* the ACK completing the handshake finds the new pcb */
+  p = test_tcp_hash_segment(TEST_REMOTE_PORT, ports[1], NULL, 0, pcb->rcv_nxt, pcb->snd_nxt, TCP_ACK);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(accept_calls == 1);
+  EXPECT(accepted_pcb == pcb);
+  EXPECT(pcb->state == ESTABLISHED);
+  check_tcp_hash();
+
+  /* a closed listener doesn't get the SYNs anymore, they are reset */
+  err = tcp_close(lpcb[1]);
+  EXPECT(err == ERR_OK);
+  check_tcp_hash();
+  txcounters.num_tx_calls = 0;
+  p = test_tcp_hash_segment(TEST_REMOTE_PORT + 1, ports[1], NULL, 0, 12345, 0, TCP_SYN);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(txcounters.num_tx_calls == 1);
+  EXPECT(accept_calls == 1);
+  EXPECT(MEMP_STATS_GET(used, MEMP_TCP_PCB) == 1);
+
+  /* while the other one in the bucket does */
+  p = test_tcp_hash_segment(TEST_REMOTE_PORT + 1, ports[0], NULL, 0, 12345, 0, TCP_SYN);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(txcounters.num_tx_calls == 2);
+  EXPECT(MEMP_STATS_GET(used, MEMP_TCP_PCB) == 2);
+  EXPECT(tcp_active_pcbs != NULL && tcp_active_pcbs->local_port == ports[0]);
+  check_tcp_hash();
+
+  tcp_close(lpcb[0]);
+}
+END_TEST
+
+/** Close a connection actively, it leaves the hash table in TIME-WAIT */
+START_TEST(test_tcp_hash_time_wait)
+{
+  struct netif netif;
+  struct test_tcp_txcounters txcounters;
+  struct test_tcp_counters counters, other_counters;
+  struct tcp_pcb *pcb, *other;
+  struct pbuf *p;
+  char data = 0x0f;
+  err_t err;
+  int i;
+  LWIP_UNUSED_ARG(_i);
+
+  test_tcp_init_netif(&netif, &txcounters, &test_local_ip, &test_netmask);
+  memset(&counters, 0, sizeof(counters));
+  memset(&other_counters, 0, sizeof(other_counters));
+
+  pcb = test_tcp_new_counters_pcb(&counters);
+  EXPECT_RET(pcb != NULL);
+  tcp_set_state(pcb, ESTABLISHED, &test_local_ip, &test_remote_ip, TEST_LOCAL_PORT, TEST_REMOTE_PORT);
+  other = test_tcp_new_counters_pcb(&other_counters);
+  EXPECT_RET(other != NULL);
+  tcp_set_state(other, ESTABLISHED, &test_local_ip, &test_remote_ip, TEST_LOCAL_PORT, TEST_REMOTE_PORT + 1);
+  check_tcp_hash();
+
+  err = tcp_close(pcb);
+  EXPECT_RET(err == ERR_OK);
+  EXPECT_RET(pcb->state == FIN_WAIT_1);
+  EXPECT(txcounters.num_tx_calls == 1);
+
+  /* FIN+ACK acknowledging our FIN */
+  p = tcp_create_rx_segment(pcb, NULL, 0, 0, 1, TCP_FIN | TCP_ACK);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT_RET(pcb->state == TIME_WAIT);
+  EXPECT(tcp_list_contains(tcp_tw_pcbs, pcb));
+  EXPECT(!tcp_list_contains(tcp_active_pcbs, pcb));
+  check_tcp_hash();
+
+  /* a retransmitted FIN is answered from TIME-WAIT */
+  txcounters.num_tx_calls = 0;
+  p = tcp_create_rx_segment(pcb, NULL, 0, (u32_t)-1, 1, TCP_FIN | TCP_ACK);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(txcounters.num_tx_calls == 1);
+  EXPECT(pcb->state == TIME_WAIT);
+
+  /* the other connection in the table isn't disturbed */
+  test_tcp_hash_rx_byte(other, &netif, &txcounters);
+  EXPECT(other_counters.recv_calls == 1);
+
+  /* TIME-WAIT expires, the segments of the connection get reset */
+  for (i = 0; (tcp_tw_pcbs != NULL) && (i < 2 * TCP_MSL / TCP_SLOW_INTERVAL + 2); i++) {
+    tcp_slowtmr();
+  }
+  EXPECT(tcp_tw_pcbs == NULL);
+  EXPECT(MEMP_STATS_GET(used, MEMP_TCP_PCB) == 1);
+  check_tcp_hash();
+
+  txcounters.num_tx_calls = 0;
+  p = test_tcp_hash_segment(TEST_REMOTE_PORT, TEST_LOCAL_PORT, &data, 1, 1000, 1000, TCP_ACK);
+  EXPECT_RET(p != NULL);
+  test_tcp_input(p, &netif);
+  EXPECT(txcounters.num_tx_calls == 1);
+  EXPECT(counters.recv_calls == 0);
+  EXPECT(other_counters.recv_calls == 1);
+}
+END_TEST
+
+/** Remove pcbs by tcp_abort() and by tcp_slowtmr(), the others keep receiving */
+START_TEST(test_tcp_hash_remove)
+{
+  struct netif netif;
+  struct test_tcp_txcounters txcounters;
+  struct test_tcp_counters counters[TEST_NUM_PCBS];
+  struct tcp_pcb *pcbs[TEST_NUM_PCBS];
+  struct tcp_pcb *bound;
+  struct pbuf *p;
+  char data = 0x0f;
+  int i;
+  LWIP_UNUSED_ARG(_i);
+
+  test_tcp_init_netif(&netif, &txcounters, &test_local_ip, &test_netmask);
+
+  for (i = 0; i < TEST_NUM_PCBS; i++) {
+    memset(&counters[i], 0, sizeof(counters[i]));
+    pcbs[i] = test_tcp_new_counters_pcb(&counters[i]);
+    EXPECT_RET(pcbs[i] != NULL);
+    tcp_set_state(pcbs[i], ESTABLISHED, &test_local_ip, &test_remote_ip, TEST_LOCAL_PORT,
+                  (u16_t)(TEST_REMOTE_PORT + i));
+  }
+  check_tcp_hash();
+
+  /* a bound pcb isn't hashed */
+  bound = tcp_new();
+  EXPECT_RET(bound != NULL);
+  EXPECT_RET(tcp_bind(bound, &test_local_ip, TEST_LOCAL_PORT + 1) == ERR_OK);
+  check_tcp_hash();
+  tcp_abort(bound);
+
+  tcp_abort(pcbs[0]);
+  EXPECT(counters[0].err_calls == 1);
+  check_tcp_hash();
+
+  /* stuck in LAST-ACK, tcp_slowtmr unlinks it by hand */
+  pcbs[2]->state = LAST_ACK;
+  pcbs[2]->tmr = tcp_ticks;
+  for (i = 0; (counters[2].err_calls == 0) && (i < 2 * TCP_MSL / TCP_SLOW_INTERVAL + 2); i++) {
+    tcp_slowtmr();
+  }
+  EXPECT(counters[2].err_calls == 1);
+  EXPECT(counters[2].last_err == ERR_ABRT);
+  EXPECT(MEMP_STATS_GET(used, MEMP_TCP_PCB) == TEST_NUM_PCBS - 2);
+  check_tcp_hash();
+
+  test_tcp_hash_rx_byte(pcbs[1], &netif, &txcounters);
+  test_tcp_hash_rx_byte(pcbs[3], &netif, &txcounters);
+  EXPECT(counters[1].recv_calls == 1);
+  EXPECT(counters[3].recv_calls == 1);
+
+  /* the removed connections get reset */
+  for (i = 0; i < TEST_NUM_PCBS; i += 2) {
+    txcounters.num_tx_calls = 0;
+    p = test_tcp_hash_segment((u16_t)(TEST_REMOTE_PORT + i), TEST_LOCAL_PORT, &data, 1, 1000, 1000, TCP_ACK);
+    EXPECT_RET(p != NULL);
+    test_tcp_input(p, &netif);
+    EXPECT(txcounters.num_tx_calls == 1);
+    EXPECT(counters[i].recv_calls == 0);
+  }
+}
+END_TEST
+
+
+/** Create the suite including all tests for this module */
+Suite *
+tcp_hash_suite(void)
+{
+  testfunc tests[] = {
+    TESTFUNC(test_tcp_hash_connect),
+    TESTFUNC(test_tcp_hash_listen),
+    TESTFUNC(test_tcp_hash_time_wait),
+    TESTFUNC(test_tcp_hash_remove)
+  };
+  return create_suite("TCP_HASH", tests, sizeof(tests)/sizeof(testfunc), tcp_hash_setup, tcp_hash_teardown);
+}
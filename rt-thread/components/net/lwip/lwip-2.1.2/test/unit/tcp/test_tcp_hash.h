@@ -0,0 +1,8 @@
+#ifndef LWIP_HDR_TEST_TCP_HASH_H
+#define LWIP_HDR_TEST_TCP_HASH_H
+
+#include "../lwip_check.h"
+
+Suite *tcp_hash_suite(void);
+
+#endif
@@ -169,7 +169,8 @@ static void test_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
 }
 
 static struct pbuf *
-test_udp_create_test_packet(u16_t length, u16_t port, u32_t dst_addr)
+test_udp_create_test_packet_from(u16_t length, u16_t src_port, u16_t dst_port,
+                                 u32_t src_addr, u32_t dst_addr)
 {
   err_t err;
   u8_t ret;
@@ -192,13 +193,15 @@ test_udp_create_test_packet(u16_t length, u16_t port, u32_t dst_addr)
   fail_unless(!ret);
   uh = (struct udp_hdr *)p->payload;
   uh->chksum = 0;
-  uh->dest = uh->src = lwip_htons(port);
+  uh->src = lwip_htons(src_port);
+  uh->dest = lwip_htons(dst_port);
   uh->len = lwip_htons(p->tot_len);
   /* add IPv4 header */
   ret = pbuf_add_header(p, sizeof(struct ip_hdr));
   fail_unless(!ret);
   ih = (struct ip_hdr *)p->payload;
   memset(ih, 0, sizeof(*ih));
+  ih->src.addr = src_addr;
   ih->dest.addr = dst_addr;
   ih->_len = lwip_htons(p->tot_len);
   ih->_ttl = 32;
@@ -208,6 +211,38 @@ test_udp_create_test_packet(u16_t length, u16_t port, u32_t dst_addr)
   return p;
 }
 
+static struct pbuf *
+test_udp_create_test_packet(u16_t length, u16_t port, u32_t dst_addr)
+{
+  return test_udp_create_test_packet_from(length, port, port, 0, dst_addr);
+}
+
+/* pass a datagram to netif1 and return which of the counters got it */
+static int
+test_udp_rx_from(u16_t src_port, u16_t dst_port, u32_t src_addr,
+                 struct test_udp_rxdata *ctrs, int num_ctrs)
+{
+  struct pbuf *p;
+  err_t err;
+  int i, rx = -1;
+
+  for (i = 0; i < num_ctrs; i++) {
+    ctrs[i].rx_cnt = 0;
+  }
+  p = test_udp_create_test_packet_from(16, src_port, dst_port, src_addr, test_ipaddr1.addr);
+  EXPECT_RETX(p != NULL, -2);
+  err = ip4_input(p, &test_netif1);
+  fail_unless(err == ERR_OK);
+  for (i = 0; i < num_ctrs; i++) {
+    if (ctrs[i].rx_cnt != 0) {
+      fail_unless(rx == -1);
+      fail_unless(ctrs[i].rx_cnt == 1);
+      rx = i;
+    }
+  }
+  return rx;
+}
+
 /* bind 2 pcbs to specific netif IP and test which one gets broadcasts */
 START_TEST(test_udp_broadcast_rx_with_2_netifs)
 {
@@ -335,13 +370,107 @@ START_TEST(test_udp_broadcast_rx_with_2_netifs)
 }
 END_TEST
 
+/* bind pcbs to ports sharing a bucket of LWIP_UDP_PCB_HASH, rebind and remove them */
+START_TEST(test_udp_bind_rebind_remove)
+{
+  struct udp_pcb *pcbs[3];
+  struct test_udp_rxdata ctrs[3];
+  const u16_t port = 5000;
+  const u16_t step = 2 * LWIP_UDP_PCB_HASH_SIZE;
+  err_t err;
+  int i;
+  LWIP_UNUSED_ARG(_i);
+
+  for (i = 0; i < 3; i++) {
+    pcbs[i] = udp_new();
+    EXPECT_RET(pcbs[i] != NULL);
+    memset(&ctrs[i], 0, sizeof(ctrs[i]));
+    ctrs[i].pcb = pcbs[i];
+    udp_recv(pcbs[i], test_recv, &ctrs[i]);
+    err = udp_bind(pcbs[i], NULL, (u16_t)(port + i * step));
+    fail_unless(err == ERR_OK);
+  }
+  for (i = 0; i < 3; i++) {
+    fail_unless(test_udp_rx_from(1, (u16_t)(port + i * step), 0, ctrs, 3) == i);
+  }
+
+  /* rebind into the same bucket and into another one */
+  err = udp_bind(pcbs[0], NULL, (u16_t)(port + 3 * step));
+  fail_unless(err == ERR_OK);
+  fail_unless(test_udp_rx_from(1, port, 0, ctrs, 3) == -1);
+  fail_unless(test_udp_rx_from(1, (u16_t)(port + 3 * step), 0, ctrs, 3) == 0);
+  err = udp_bind(pcbs[0], NULL, port + 1);
+  fail_unless(err == ERR_OK);
+  fail_unless(test_udp_rx_from(1, (u16_t)(port + 3 * step), 0, ctrs, 3) == -1);
+  fail_unless(test_udp_rx_from(1, port + 1, 0, ctrs, 3) == 0);
+
+  /* the old port can be bound again */
+  err = udp_bind(pcbs[1], NULL, port);
+  fail_unless(err == ERR_OK);
+  fail_unless(test_udp_rx_from(1, port, 0, ctrs, 3) == 1);
+  fail_unless(test_udp_rx_from(1, (u16_t)(port + step), 0, ctrs, 3) == -1);
+
+  udp_remove(pcbs[1]);
+  fail_unless(test_udp_rx_from(1, port, 0, ctrs, 3) == -1);
+  fail_unless(test_udp_rx_from(1, (u16_t)(port + 2 * step), 0, ctrs, 3) == 2);
+  fail_unless(test_udp_rx_from(1, port + 1, 0, ctrs, 3) == 0);
+}
+END_TEST
+
+/* a connected pcb only gets the datagrams of its peer */
+START_TEST(test_udp_connect_disconnect)
+{
+  struct udp_pcb *pcb;
+  struct test_udp_rxdata ctr;
+  ip_addr_t remote;
+  u32_t remote_addr;
+  u16_t local_port;
+  err_t err;
+  LWIP_UNUSED_ARG(_i);
+
+  IP_ADDR4(&remote, 192, 168, 0, 2);
+  remote_addr = ip_2_ip4(&remote)->addr;
+
+  pcb = udp_new();
+  EXPECT_RET(pcb != NULL);
+  memset(&ctr, 0, sizeof(ctr));
+  ctr.pcb = pcb;
+  udp_recv(pcb, test_recv, &ctr);
+
+  /* connecting an unbound pcb binds it */
+  err = udp_connect(pcb, &remote, 7);
+  fail_unless(err == ERR_OK);
+  local_port = pcb->local_port;
+  fail_unless(local_port != 0);
+  fail_unless(test_udp_rx_from(7, local_port, remote_addr, &ctr, 1) == 0);
+  fail_unless(test_udp_rx_from(8, local_port, remote_addr, &ctr, 1) == -1);
+  fail_unless(test_udp_rx_from(7, local_port, 0, &ctr, 1) == -1);
+
+  udp_disconnect(pcb);
+  fail_unless(test_udp_rx_from(8, local_port, remote_addr, &ctr, 1) == 0);
+
+  err = udp_connect(pcb, &remote, 9);
+  fail_unless(err == ERR_OK);
+  fail_unless(pcb->local_port == local_port);
+  fail_unless(test_udp_rx_from(9, local_port, remote_addr, &ctr, 1) == 0);
+
+  /* rebinding a connected pcb */
+  err = udp_bind(pcb, NULL, (u16_t)(local_port + 1));
+  fail_unless(err == ERR_OK);
+  fail_unless(test_udp_rx_from(9, local_port, remote_addr, &ctr, 1) == -1);
+  fail_unless(test_udp_rx_from(9, (u16_t)(local_port + 1), remote_addr, &ctr, 1) == 0);
+}
+END_TEST
+
 /** Create the suite including all tests for this module */
 Suite *
 udp_suite(void)
 {
   testfunc tests[] = {
     TESTFUNC(test_udp_new_remove),
-    TESTFUNC(test_udp_broadcast_rx_with_2_netifs)
+    TESTFUNC(test_udp_broadcast_rx_with_2_netifs),
+    TESTFUNC(test_udp_bind_rebind_remove),
+    TESTFUNC(test_udp_connect_disconnect)
   };
   return create_suite("UDP", tests, sizeof(tests)/sizeof(testfunc), udp_setup, udp_teardown);
 }
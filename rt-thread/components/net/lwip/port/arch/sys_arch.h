@@ -47,6 +47,9 @@
 
 #include "arch/cc.h"
 #include <rtthread.h>
+#ifdef RT_LWIP_USING_FAST_SEM
+#include <ipc/fastlock.h>
+#endif /* RT_LWIP_USING_FAST_SEM */
 
 #define SYS_MBOX_NULL RT_NULL
 #define SYS_SEM_NULL  RT_NULL
@@ -59,9 +62,17 @@ typedef rt_uint32_t sys_prot_t;
 #define SYS_LWIP_SEM_NAME "sem"
 #define SYS_LWIP_MUTEX_NAME "mu"
 
+#ifdef RT_LWIP_USING_FAST_SEM
+typedef struct rt_fast_sem *sys_sem_t;
+#else
 typedef rt_sem_t sys_sem_t;
+#endif /* RT_LWIP_USING_FAST_SEM */
 typedef rt_mutex_t sys_mutex_t;
 typedef rt_mailbox_t  sys_mbox_t;
 typedef rt_thread_t sys_thread_t;
 
+/* tcpip core lock, used if LWIP_TCPIP_CORE_LOCKING */
+void sys_lock_tcpip_core(void);
+void sys_unlock_tcpip_core(void);
+
 #endif /* __ARCH_SYS_ARCH_H__ */
@@ -63,6 +63,7 @@
 #include <lwip/dhcp.h>
 #include <lwip/netifapi.h>
 #include <lwip/inet.h>
+#include <lwip/ip.h>
 #include <netif/etharp.h>
 #include <netif/ethernetif.h>
 
@@ -113,6 +114,30 @@ static struct rt_thread eth_tx_thread;
         static char eth_rx_thread_mb_pool[RT_LWIP_ETHTHREAD_MBOX_SIZE * sizeof(rt_ubase_t)];
         static char eth_rx_thread_stack[RT_LWIP_ETHTHREAD_STACKSIZE];
     #endif
+
+    /* the maximum number of packets received or input in a round */
+    #ifndef RT_LWIP_ETH_RX_BUDGET
+        #define RT_LWIP_ETH_RX_BUDGET       16
+    #endif
+
+    #if !LWIP_TCPIP_CORE_LOCKING_INPUT
+    /*
+     * Rx queue from the Rx thread to the tcpip thread, one tcpip message inputs
+     * a batch of packets instead of one message for each packet.
+     * It's written by the Rx thread only and read by the tcpip thread only.
+     */
+    #define ETH_RX_QUEUE_SIZE               (RT_LWIP_ETH_RX_BUDGET * 4)
+
+    struct eth_rx_entry
+    {
+        struct eth_device *dev;
+        struct pbuf *p;
+    };
+
+    static struct eth_rx_entry eth_rx_queue[ETH_RX_QUEUE_SIZE];
+    static volatile rt_uint32_t eth_rx_queue_head, eth_rx_queue_tail;
+    static volatile rt_bool_t eth_rx_queue_scheduled;
+    #endif /* !LWIP_TCPIP_CORE_LOCKING_INPUT */
 #endif
 
 #ifdef RT_USING_NETDEV
@@ -732,6 +757,152 @@ static void eth_tx_thread_entry(void *parameter)
 #endif
 
 #ifndef LWIP_NO_RX_THREAD
+/* input a packet to the stack in the tcpip thread or with the tcpip core locked, as tcpip_input() does */
+static void eth_rx_stack_input(struct eth_device *device, struct pbuf *p)
+{
+    struct netif *netif = device->netif;
+    err_t err;
+
+    if (netif->input != tcpip_input)
+    {
+        err = netif->input(p, netif);
+    }
+#if LWIP_ETHERNET
+    else if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET))
+    {
+        err = ethernet_input(p, netif);
+    }
+#endif /* LWIP_ETHERNET */
+    else
+    {
+        err = ip_input(p, netif);
+    }
+
+    if (err != ERR_OK)
+    {
+        LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
+        pbuf_free(p);
+    }
+}
+
+#if !LWIP_TCPIP_CORE_LOCKING_INPUT
+/* input a batch of the queued packets in the tcpip thread */
+static void eth_rx_queue_input(void *arg)
+{
+    rt_base_t level;
+    rt_bool_t more;
+
+    do
+    {
+        int budget = RT_LWIP_ETH_RX_BUDGET;
+
+        while (budget-- > 0 && eth_rx_queue_tail != eth_rx_queue_head)
+        {
+            struct eth_rx_entry *entry = &eth_rx_queue[eth_rx_queue_tail % ETH_RX_QUEUE_SIZE];
+
+            eth_rx_stack_input(entry->dev, entry->p);
+            eth_rx_queue_tail++;
+        }
+
+        level = rt_hw_interrupt_disable();
+        more = (eth_rx_queue_tail != eth_rx_queue_head);
+        eth_rx_queue_scheduled = more;
+        rt_hw_interrupt_enable(level);
+
+        /* leave the rest to the next message, so the timers and the API calls are not starved */
+    }
+    while (more && tcpip_callback_with_block(eth_rx_queue_input, RT_NULL, 0) != ERR_OK);
+}
+
+static rt_bool_t eth_rx_queue_put(struct eth_device *device, struct pbuf *p)
+{
+    struct eth_rx_entry *entry;
+
+    if (eth_rx_queue_head - eth_rx_queue_tail >= ETH_RX_QUEUE_SIZE)
+    {
+        return RT_FALSE;
+    }
+
+    entry = &eth_rx_queue[eth_rx_queue_head % ETH_RX_QUEUE_SIZE];
+    entry->dev = device;
+    entry->p = p;
+    eth_rx_queue_head++;
+
+    return RT_TRUE;
+}
+
+static void eth_rx_queue_schedule(void)
+{
+    rt_base_t level;
+    rt_bool_t post = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (!eth_rx_queue_scheduled && eth_rx_queue_tail != eth_rx_queue_head)
+    {
+        eth_rx_queue_scheduled = RT_TRUE;
+        post = RT_TRUE;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (post && tcpip_callback_with_block(eth_rx_queue_input, RT_NULL, 1) != ERR_OK)
+    {
+        level = rt_hw_interrupt_disable();
+        eth_rx_queue_scheduled = RT_FALSE;
+        rt_hw_interrupt_enable(level);
+    }
+}
+#endif /* !LWIP_TCPIP_CORE_LOCKING_INPUT */
+
+/* receive a batch of packets from the device, return the number of them */
+static int eth_rx_poll(struct eth_device *device)
+{
+    struct pbuf *p;
+    int count = 0;
+
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+    /* lock the core once for the batch */
+    LOCK_TCPIP_CORE();
+#endif
+
+    while (count < RT_LWIP_ETH_RX_BUDGET)
+    {
+        p = device->eth_rx(&(device->parent));
+        if (p == RT_NULL)
+        {
+            break;
+        }
+        count++;
+
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+        eth_rx_stack_input(device, p);
+#else
+        if (!eth_rx_queue_put(device, p))
+        {
+            device->rx_drops++;
+            pbuf_free(p);
+        }
+#endif
+    }
+
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+    UNLOCK_TCPIP_CORE();
+#else
+    eth_rx_queue_schedule();
+#endif
+
+    if (count > 0)
+    {
+        device->rx_batches++;
+        device->rx_packets += count;
+        if (count > device->rx_max_batch)
+        {
+            device->rx_max_batch = count;
+        }
+    }
+
+    return count;
+}
+
 /* Ethernet Rx Thread */
 static void eth_rx_thread_entry(void *parameter)
 {
@@ -742,7 +913,7 @@ static void eth_rx_thread_entry(void *parameter)
         if (rt_mb_recv(&eth_rx_thread_mb, (rt_ubase_t *)&device, RT_WAITING_FOREVER) == RT_EOK)
         {
             rt_base_t level;
-            struct pbuf *p;
+            rt_bool_t rx_int;
 
             /* check link status */
             if (device->link_changed)
@@ -760,28 +931,27 @@ static void eth_rx_thread_entry(void *parameter)
                     netifapi_netif_set_link_down(device->netif);
             }
 
+            if (device->eth_rx == RT_NULL) continue;
+
+            /* keep the Rx interrupt masked while polling under load, if the driver supports it */
+            rx_int = (rt_device_control(&(device->parent), NIOCTL_RXINT, (void *)RT_FALSE) == RT_EOK);
+
             level = rt_hw_interrupt_disable();
             /* 'rx_notice' will be modify in the interrupt or here */
             device->rx_notice = RT_FALSE;
             rt_hw_interrupt_enable(level);
 
-            /* receive all of buffer */
-            while (1)
+            /* receive all of buffer, a full batch means more packets are pending */
+            while (eth_rx_poll(device) == RT_LWIP_ETH_RX_BUDGET)
             {
-                if (device->eth_rx == RT_NULL) break;
+                /* let the tcpip thread and the same priority threads run */
+                rt_thread_yield();
+            }
 
-                p = device->eth_rx(&(device->parent));
-                if (p != RT_NULL)
-                {
-                    /* notify to upper layer */
-                    if (device->netif->input(p, device->netif) != ERR_OK)
-                    {
-                        LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: Input error\n"));
-                        pbuf_free(p);
-                        p = NULL;
-                    }
-                }
-                else break;
+            /* the driver raises the interrupt for the packets received before unmasking */
+            if (rx_int)
+            {
+                rt_device_control(&(device->parent), NIOCTL_RXINT, (void *)RT_TRUE);
             }
         }
         else
@@ -947,6 +1117,15 @@ void list_if(void)
         rt_kprintf("ip address: %s\n", ipaddr_ntoa(&(netif->ip_addr)));
         rt_kprintf("gw address: %s\n", ipaddr_ntoa(&(netif->gw)));
         rt_kprintf("net mask  : %s\n", ipaddr_ntoa(&(netif->netmask)));
+#ifndef LWIP_NO_RX_THREAD
+        if (netif->linkoutput == ethernetif_linkoutput)
+        {
+            struct eth_device *device = (struct eth_device *)netif->state;
+
+            rt_kprintf("rx batch  : %d packets in %d rounds, max %d, dropped %d\n",
+                       device->rx_packets, device->rx_batches, device->rx_max_batch, device->rx_drops);
+        }
+#endif /* LWIP_NO_RX_THREAD */
 #if LWIP_IPV6
         {
             ip6_addr_t *addr;
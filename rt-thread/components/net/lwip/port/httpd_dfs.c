@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * lwIP httpd custom file system: serves the files of RT_LWIP_HTTPD_ROOT.
+ *
+ * The files in the addressable memory (romfs) are sent straight from there,
+ * the others are read into the buffers of a pool shared by all connections.
+ * The precompressed "<file>.gz" is preferred and sent with
+ * "Content-Encoding: gzip" if present and the client accepts gzip, both
+ * variants are sent with "Vary: Accept-Encoding".
+ */
+
+#include <rtthread.h>
+
+#ifdef RT_LWIP_HTTPD_USING_DFS
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <dfs.h>
+#include <dfs_file.h>
+
+#include <lwip/opt.h>
+#include <lwip/memp.h>
+#include <lwip/tcpip.h>
+#include <lwip/apps/fs.h>
+#include <lwip/apps/httpd.h>
+#include "httpd_dfs.h"
+
+#define DBG_TAG    "httpd.dfs"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+LWIP_MEMPOOL_DECLARE(HTTPD_DFS_BUF, RT_LWIP_HTTPD_DFS_BUF_NUM, RT_LWIP_HTTPD_DFS_BUF_SIZE, "HTTPD_DFS_BUF")
+
+static struct
+{
+    rt_uint32_t opened;         /* files opened */
+    rt_uint32_t xip;            /* files sent from the memory directly */
+    rt_uint32_t gzip;           /* precompressed files */
+    rt_uint16_t buf_used;       /* read buffers in use */
+    rt_uint16_t buf_peak;       /* maximum read buffers in use */
+    rt_uint32_t buf_miss;       /* read buffer requests failed or shrunk */
+} httpd_dfs_stat;
+
+/* only used in the tcpip thread */
+static char httpd_dfs_path[DFS_PATH_MAX];
+
+char *httpd_dfs_buf_alloc(int size)
+{
+    char *buf;
+
+    /* a failed request is retried by httpd with the half size */
+    if (size > RT_LWIP_HTTPD_DFS_BUF_SIZE)
+    {
+        httpd_dfs_stat.buf_miss++;
+        return RT_NULL;
+    }
+
+    buf = (char *)LWIP_MEMPOOL_ALLOC(HTTPD_DFS_BUF);
+    if (buf == RT_NULL)
+    {
+        httpd_dfs_stat.buf_miss++;
+        return RT_NULL;
+    }
+
+    if (++httpd_dfs_stat.buf_used > httpd_dfs_stat.buf_peak)
+    {
+        httpd_dfs_stat.buf_peak = httpd_dfs_stat.buf_used;
+    }
+
+    return buf;
+}
+
+void httpd_dfs_buf_free(char *buf)
+{
+    httpd_dfs_stat.buf_used--;
+    LWIP_MEMPOOL_FREE(HTTPD_DFS_BUF, buf);
+}
+
+static int httpd_dfs_stat_file(const char *name, const char *suffix, struct stat *st)
+{
+    if (rt_snprintf(httpd_dfs_path, sizeof(httpd_dfs_path), "%s%s%s",
+                    RT_LWIP_HTTPD_ROOT, name, suffix) >= (int)sizeof(httpd_dfs_path))
+    {
+        return -1;
+    }
+
+    if (stat(httpd_dfs_path, st) < 0 || S_ISDIR(st->st_mode))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int fs_open_custom(struct fs_file *file, const char *name)
+{
+    struct stat st;
+    const void *addr;
+    u8_t flags = FS_FILE_FLAGS_HEADER_PERSISTENT;
+    int fd;
+
+    if (name[0] != '/' || strstr(name, "..") != RT_NULL)
+    {
+        return 0;
+    }
+
+#ifdef RT_LWIP_HTTPD_DFS_GZIP
+    /* with a "<file>.gz" the response depends on "Accept-Encoding", httpd
+       sets FS_FILE_FLAGS_ACCEPT_GZIP from it and sends "Vary" */
+    if (httpd_dfs_stat_file(name, ".gz", &st) == 0)
+    {
+        flags |= FS_FILE_FLAGS_VARY_ENCODING;
+        if (file->flags & FS_FILE_FLAGS_ACCEPT_GZIP)
+        {
+            flags |= FS_FILE_FLAGS_CONTENT_GZIP;
+        }
+    }
+    if (!(flags & FS_FILE_FLAGS_CONTENT_GZIP))
+#endif /* RT_LWIP_HTTPD_DFS_GZIP */
+    if (httpd_dfs_stat_file(name, "", &st) != 0)
+    {
+        return 0;
+    }
+
+    fd = open(httpd_dfs_path, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return 0;
+    }
+
+    httpd_dfs_stat.opened++;
+    if (flags & FS_FILE_FLAGS_CONTENT_GZIP)
+    {
+        httpd_dfs_stat.gzip++;
+    }
+
+    file->len = (int)st.st_size;
+    file->flags = flags;
+
+    if (ioctl(fd, RT_FIOGETADDR, &addr) == 0)
+    {
+        /* the content is addressable, httpd sends it without reading */
+        close(fd);
+        httpd_dfs_stat.xip++;
+        file->data = (const char *)addr;
+        file->index = file->len;
+        file->pextension = RT_NULL;
+    }
+    else
+    {
+        file->data = RT_NULL;
+        file->index = 0;
+        file->pextension = (fs_file_extension *)(rt_base_t)fd;
+    }
+
+    LOG_D("open %s, %d bytes%s", httpd_dfs_path, file->len, file->data ? " (xip)" : "");
+
+    return 1;
+}
+
+void fs_close_custom(struct fs_file *file)
+{
+    if (file->data == RT_NULL)
+    {
+        close((int)(rt_base_t)file->pextension);
+    }
+}
+
+int fs_read_custom(struct fs_file *file, char *buffer, int count)
+{
+    int len;
+
+    len = read((int)(rt_base_t)file->pextension, buffer, count);
+    if (len <= 0)
+    {
+        return FS_READ_EOF;
+    }
+
+    file->index += len;
+
+    return len;
+}
+
+static void httpd_dfs_start(void *arg)
+{
+    LWIP_UNUSED_ARG(arg);
+    httpd_init();
+}
+
+static int httpd_dfs_init(void)
+{
+    LWIP_MEMPOOL_INIT(HTTPD_DFS_BUF);
+
+    /* httpd uses the raw API, start it in the tcpip thread */
+    if (tcpip_callback(httpd_dfs_start, RT_NULL) != ERR_OK)
+    {
+        LOG_E("start httpd failed");
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+INIT_APP_EXPORT(httpd_dfs_init);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static int httpd_dfs(int argc, char **argv)
+{
+    rt_kprintf("root     : %s\n", RT_LWIP_HTTPD_ROOT);
+    rt_kprintf("opened   : %u (xip %u, gzip %u)\n",
+               httpd_dfs_stat.opened, httpd_dfs_stat.xip, httpd_dfs_stat.gzip);
+    rt_kprintf("buffer   : %u bytes x %u, used %u, peak %u, miss %u\n",
+               RT_LWIP_HTTPD_DFS_BUF_SIZE, RT_LWIP_HTTPD_DFS_BUF_NUM,
+               httpd_dfs_stat.buf_used, httpd_dfs_stat.buf_peak, httpd_dfs_stat.buf_miss);
+
+    return 0;
+}
+MSH_CMD_EXPORT(httpd_dfs, show the httpd file serving statistics);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_LWIP_HTTPD_USING_DFS */
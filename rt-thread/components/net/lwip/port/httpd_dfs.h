@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#ifndef __HTTPD_DFS_H__
+#define __HTTPD_DFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the file read buffers of httpd, served from a pool shared by all connections */
+char *httpd_dfs_buf_alloc(int size);
+void httpd_dfs_buf_free(char *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HTTPD_DFS_H__ */
@@ -316,6 +316,14 @@
     #define MEMP_NUM_TCP_PCB            RT_LWIP_TCP_PCB_NUM
 #endif
 
+/* look up the PCBs of the incoming packets by the hash tables */
+#ifdef RT_LWIP_PCB_HASH
+    #define LWIP_TCP_PCB_HASH           1
+    #define LWIP_UDP_PCB_HASH           1
+    #define LWIP_TCP_PCB_HASH_SIZE      RT_LWIP_PCB_HASH_SIZE
+    #define LWIP_UDP_PCB_HASH_SIZE      RT_LWIP_PCB_HASH_SIZE
+#endif
+
 /* the number of simultaneously queued TCP */
 #ifdef RT_LWIP_TCP_SEG_NUM
     #define MEMP_NUM_TCP_SEG            RT_LWIP_TCP_SEG_NUM
@@ -422,6 +430,24 @@
 #define TCPIP_THREAD_NAME           "tcpip"
 #define DEFAULT_TCP_RECVMBOX_SIZE   10
 
+/* tcpip core locking, the API calls lock the core instead of passing messages to the tcpip thread */
+#ifdef RT_LWIP_TCPIP_CORE_LOCKING
+    #define LWIP_TCPIP_CORE_LOCKING         1
+    #if defined(RT_USING_LWIP212) || defined(RT_USING_LWIP220)
+        #define LOCK_TCPIP_CORE()           sys_lock_tcpip_core()
+        #define UNLOCK_TCPIP_CORE()         sys_unlock_tcpip_core()
+    #endif
+    /* the received packets are input in the Rx thread, the core can't be locked in interrupt */
+    #if defined(RT_LWIP_TCPIP_CORE_LOCKING_INPUT) && !defined(LWIP_NO_RX_THREAD)
+        #define LWIP_TCPIP_CORE_LOCKING_INPUT   1
+    #else
+        #define LWIP_TCPIP_CORE_LOCKING_INPUT   0
+    #endif
+#else
+    #define LWIP_TCPIP_CORE_LOCKING         0
+    #define LWIP_TCPIP_CORE_LOCKING_INPUT   0
+#endif /* RT_LWIP_TCPIP_CORE_LOCKING */
+
 /* ---------- ARP options ---------- */
 #define LWIP_ARP                    1
 #define ARP_TABLE_SIZE              10
@@ -648,6 +674,21 @@
     #define SO_REUSE                        0
 #endif
 
+/* ---------- HTTP server options ---------- */
+#ifdef RT_LWIP_USING_HTTPD
+    #define LWIP_HTTPD_DYNAMIC_HEADERS      1
+    #define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 1
+    #define LWIP_HTTPD_SUPPORT_PIPELINING   1
+#ifdef RT_LWIP_HTTPD_USING_DFS
+    /* the files are opened from DFS and read into the buffers of a shared pool (httpd_dfs.c) */
+    #define LWIP_HTTPD_CUSTOM_FILES         1
+    #define LWIP_HTTPD_DYNAMIC_FILE_READ    1
+    #include "httpd_dfs.h"
+    #define HTTP_ALLOC_FILE_BUF(size)       httpd_dfs_buf_alloc(size)
+    #define HTTP_FREE_FILE_BUF(x)           httpd_dfs_buf_free(x)
+#endif /* RT_LWIP_HTTPD_USING_DFS */
+#endif /* RT_LWIP_USING_HTTPD */
+
 #if RT_USING_LWIP_VER_NUM >= 0x20000 /* >= v2.0.0 */
     #if RT_USING_LWIP_VER_NUM > 0x20102  /* >= v2.1.2 */
         #define MEMP_NUM_SYS_TIMEOUT   (LWIP_TCP + IP_REASSEMBLY + LWIP_ARP + (2*LWIP_DHCP) + LWIP_ACD + LWIP_IGMP + LWIP_DNS + PPP_NUM_TIMEOUTS + (LWIP_IPV6 * (1 + LWIP_IPV6_REASS + LWIP_IPV6_MLD + LWIP_IPV6_DHCP6)))
@@ -19,6 +19,8 @@ extern "C" {
 #include <rtthread.h>
 
 #define NIOCTL_GADDR        0x01
+/* mask (arg RT_FALSE) or unmask (arg RT_TRUE) the Rx interrupt while the Rx thread is polling, optional */
+#define NIOCTL_RXINT        0x02
 #ifndef RT_LWIP_ETH_MTU
 #define ETHERNET_MTU        1500
 #else
@@ -45,6 +47,12 @@ struct eth_device
     /* eth device interface */
     struct pbuf* (*eth_rx)(rt_device_t dev);
     rt_err_t (*eth_tx)(rt_device_t dev, struct pbuf* p);
+
+    /* Rx statistics of the Rx thread */
+    rt_uint32_t rx_batches;     /* number of polling rounds which received packets */
+    rt_uint32_t rx_packets;     /* number of packets received */
+    rt_uint32_t rx_max_batch;   /* maximum number of packets received in a round */
+    rt_uint32_t rx_drops;       /* number of packets dropped, the input queue is full */
 };
 
 int eth_system_device_init(void);
@@ -118,6 +118,21 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count)
     rt_snprintf(tname, RT_NAME_MAX, "%s%d", SYS_LWIP_SEM_NAME, counter);
     counter ++;
 
+#ifdef RT_LWIP_USING_FAST_SEM
+    tmpsem = (sys_sem_t)rt_malloc(sizeof(struct rt_fast_sem));
+    if (tmpsem == RT_NULL)
+    {
+        return ERR_MEM;
+    }
+    if (rt_fast_sem_init(tmpsem, tname, count) != RT_EOK)
+    {
+        rt_free(tmpsem);
+        return ERR_MEM;
+    }
+    *sem = tmpsem;
+
+    return ERR_OK;
+#else
     tmpsem = rt_sem_create(tname, count, RT_IPC_FLAG_FIFO);
     if (tmpsem == RT_NULL)
     {
@@ -129,6 +144,7 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count)
 
         return ERR_OK;
     }
+#endif /* RT_LWIP_USING_FAST_SEM */
 }
 
 /*
@@ -137,7 +153,12 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count)
 void sys_sem_free(sys_sem_t *sem)
 {
     RT_DEBUG_NOT_IN_INTERRUPT;
+#ifdef RT_LWIP_USING_FAST_SEM
+    rt_fast_sem_detach(*sem);
+    rt_free(*sem);
+#else
     rt_sem_delete(*sem);
+#endif /* RT_LWIP_USING_FAST_SEM */
 }
 
 /*
@@ -145,7 +166,11 @@ void sys_sem_free(sys_sem_t *sem)
  */
 void sys_sem_signal(sys_sem_t *sem)
 {
+#ifdef RT_LWIP_USING_FAST_SEM
+    rt_fast_sem_release(*sem);
+#else
     rt_sem_release(*sem);
+#endif /* RT_LWIP_USING_FAST_SEM */
 }
 
 /*
@@ -179,7 +204,11 @@ u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
             t = timeout / (1000 / RT_TICK_PER_SECOND);
     }
 
+#ifdef RT_LWIP_USING_FAST_SEM
+    ret = rt_fast_sem_take(*sem, t);
+#else
     ret = rt_sem_take(*sem, t);
+#endif /* RT_LWIP_USING_FAST_SEM */
 
     if (ret == -RT_ETIMEOUT)
     {
@@ -296,6 +325,28 @@ void sys_mutex_set_invalid(sys_mutex_t *mutex)
 }
 #endif
 
+/* ====================== TCPIP core lock ====================== */
+
+#if LWIP_TCPIP_CORE_LOCKING
+/*
+ * The lwIP API calls lock the core instead of posting a message to the tcpip thread.
+ * lock_tcpip_core is created by sys_mutex_new() in tcpip_init(), the rt_mutex inherits
+ * the priority of the waiting thread, so the tcpip thread isn't blocked for long by a
+ * low priority thread holding the core.
+ */
+void sys_lock_tcpip_core(void)
+{
+    /* the core can't be locked in interrupt, e.g. tcpip_input() with LWIP_TCPIP_CORE_LOCKING_INPUT */
+    RT_DEBUG_NOT_IN_INTERRUPT;
+    rt_mutex_take(lock_tcpip_core, RT_WAITING_FOREVER);
+}
+
+void sys_unlock_tcpip_core(void)
+{
+    rt_mutex_release(lock_tcpip_core);
+}
+#endif /* LWIP_TCPIP_CORE_LOCKING */
+
 /* ====================== Mailbox ====================== */
 
 /*
@@ -12,16 +12,60 @@
  */
 
 #include <rtthread.h>
+#include <rthw.h>
 
 #include <dfs.h>
 #include <dfs_net.h>
 
 #include <sys/socket.h>
 
+/*
+ * The SAL socket + 1 of the socket fds, 0 if unknown.
+ * send/recv look up the socket here without taking the dfs lock twice in fd_get/fd_put.
+ * The fds are numbered per fd table (per process with lwp), so an entry is valid only
+ * in the table which set it, the others look the fd up as usual.
+ */
+struct net_fd_socket
+{
+    struct dfs_fdtable *fdt;
+    int socket;
+};
+static struct net_fd_socket net_fd_socket[DFS_FD_MAX];
+
+void dfs_net_setsocket(int fd, int socket)
+{
+    rt_base_t level;
+    int idx = fd - DFS_FD_OFFSET;
+
+    if (idx >= 0 && idx < DFS_FD_MAX)
+    {
+        level = rt_hw_interrupt_disable();
+        net_fd_socket[idx].fdt = dfs_fdtable_get();
+        net_fd_socket[idx].socket = socket < 0 ? 0 : socket + 1;
+        rt_hw_interrupt_enable(level);
+    }
+}
+
 int dfs_net_getsocket(int fd)
 {
     int socket;
+    rt_base_t level;
     struct dfs_fd *_dfs_fd;
+    struct dfs_fdtable *fdt;
+    int idx = fd - DFS_FD_OFFSET;
+
+    if (idx >= 0 && idx < DFS_FD_MAX)
+    {
+        fdt = dfs_fdtable_get();
+        level = rt_hw_interrupt_disable();
+        socket = net_fd_socket[idx].fdt == fdt ? net_fd_socket[idx].socket : 0;
+        rt_hw_interrupt_enable(level);
+
+        if (socket > 0)
+        {
+            return socket - 1;
+        }
+    }
 
     _dfs_fd = fd_get(fd);
     if (_dfs_fd == NULL) return -1;
@@ -57,6 +101,16 @@ static int dfs_net_write(struct dfs_fd *file, const void *buf, size_t count)
 static int dfs_net_close(struct dfs_fd* file)
 {
     int socket = (int) file->data;
+    int idx;
+
+    /* the fd may be reused by a file after closing, the SAL socket is unique in all the fd tables */
+    for (idx = 0; idx < DFS_FD_MAX; idx++)
+    {
+        if (net_fd_socket[idx].socket == socket + 1)
+        {
+            net_fd_socket[idx].socket = 0;
+        }
+    }
 
     return sal_closesocket(socket);
 }
@@ -22,6 +22,13 @@ extern "C" {
 /* Set lwIP network interface device protocol family information  */
 int sal_lwip_netdev_set_pf_info(struct netdev *netdev);
 
+#ifdef SAL_USING_BENCH
+/* Start the lwiperf TCP server, report() is called with the result of every test */
+void *sal_lwip_iperf_start(int port, void (*report)(void *arg, int ok, uint32_t bytes, uint32_t ms, uint32_t kbps), void *arg);
+/* Stop the lwiperf TCP server */
+void sal_lwip_iperf_stop(void *session);
+#endif
+
 #endif /* SAL_USING_LWIP */
 
 #ifdef SAL_USING_AT
@@ -15,6 +15,13 @@
 #include <lwip/api.h>
 #include <lwip/init.h>
 #include <lwip/netif.h>
+#if LWIP_VERSION >= 0x2000000
+#include <lwip/priv/tcpip_priv.h>
+#endif
+#if LWIP_VERSION >= 0x20100ff
+#include <lwip/tcp.h>
+#include <lwip/priv/sockets_priv.h>
+#endif
 
 #ifdef SAL_USING_POSIX
 #include <poll.h>
@@ -41,11 +48,11 @@
 
 #ifdef SAL_USING_LWIP
 
+extern struct lwip_sock *lwip_tryget_socket(int s);
+
 #ifdef SAL_USING_POSIX
 
-#if LWIP_VERSION >= 0x20100ff
-#include <lwip/priv/sockets_priv.h>
-#else /* LWIP_VERSION < 0x20100ff */
+#if LWIP_VERSION < 0x20100ff
 /*
  * Re-define lwip socket
  *
@@ -77,9 +84,7 @@ struct lwip_sock {
 
     rt_wqueue_t wait_head;
 };
-#endif /* LWIP_VERSION >= 0x20100ff */
-
-extern struct lwip_sock *lwip_tryget_socket(int s);
+#endif /* LWIP_VERSION < 0x20100ff */
 
 static void event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len)
 {
@@ -289,10 +294,534 @@ static int inet_poll(struct dfs_fd *file, struct rt_pollreq *req)
 }
 #endif
 
+#if LWIP_VERSION >= 0x20100ff
+/* the time closesocket waits for the pending zero-copy sends to be acknowledged */
+#ifndef LWIP_ZC_CLOSE_TIMEOUT
+#define LWIP_ZC_CLOSE_TIMEOUT          3000
+#endif
+
+#define LWIP_ZC_SEQ_GEQ(a, b)          ((s32_t)((u32_t)(a) - (u32_t)(b)) >= 0)
+
+/* same as sal_zc_done_t */
+typedef void (*lwip_zc_done_t)(void *arg, int err);
+
+/* zero-copy send which is done when the peer acknowledges the sequence number */
+struct lwip_zc_tcp
+{
+    rt_list_t list;
+    struct netconn *conn;
+    u32_t seq;
+    lwip_zc_done_t done;
+    void *arg;
+};
+
+struct lwip_zc_call
+{
+    struct tcpip_api_call_data call;
+    struct lwip_zc_tcp *zc;
+    struct netconn *conn;
+    int how;
+    int pending;
+};
+
+/* pending zero-copy sends of all TCP connections, only accessed in the tcpip thread */
+static rt_list_t lwip_zc_tcp_list = RT_LIST_OBJECT_INIT(lwip_zc_tcp_list);
+/* the number of them, read without the tcpip thread to skip the calls when it's 0 */
+static volatile rt_uint32_t lwip_zc_tcp_count;
+static tcp_sent_fn lwip_zc_sent_fn;
+static tcp_err_fn lwip_zc_err_fn;
+
+/* complete the sends acknowledged on the connection, all of them if the pcb is gone */
+static void lwip_zc_tcp_complete(struct netconn *conn, struct tcp_pcb *pcb, int err)
+{
+    rt_list_t *node, *next;
+
+    for (node = lwip_zc_tcp_list.next; node != &lwip_zc_tcp_list; node = next)
+    {
+        struct lwip_zc_tcp *zc = rt_list_entry(node, struct lwip_zc_tcp, list);
+
+        next = node->next;
+        if (zc->conn == conn && (pcb == RT_NULL || LWIP_ZC_SEQ_GEQ(pcb->lastack, zc->seq)))
+        {
+            rt_list_remove(&zc->list);
+            lwip_zc_tcp_count--;
+            zc->done(zc->arg, err);
+            rt_free(zc);
+        }
+    }
+}
+
+static err_t lwip_zc_tcp_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    lwip_zc_tcp_complete((struct netconn *) arg, pcb, 0);
+
+    return lwip_zc_sent_fn ? lwip_zc_sent_fn(arg, pcb, len) : ERR_OK;
+}
+
+/* netconn clears its sent callback on SHUT_WR, follow the acknowledgements without it */
+static err_t lwip_zc_tcp_sent_shut(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    LWIP_UNUSED_ARG(len);
+    lwip_zc_tcp_complete((struct netconn *) arg, pcb, 0);
+
+    return ERR_OK;
+}
+
+static void lwip_zc_tcp_err(void *arg, err_t err)
+{
+    /* the pcb has been freed with its segments */
+    lwip_zc_tcp_complete((struct netconn *) arg, RT_NULL, err_to_errno(err));
+
+    if (lwip_zc_err_fn)
+    {
+        lwip_zc_err_fn(arg, err);
+    }
+}
+
+static err_t lwip_zc_tcp_add(struct tcpip_api_call_data *call)
+{
+    struct lwip_zc_call *msg = (struct lwip_zc_call *) call;
+    struct lwip_zc_tcp *zc = msg->zc;
+    struct tcp_pcb *pcb = msg->conn->pcb.tcp;
+
+    if (pcb == RT_NULL)
+    {
+        zc->done(zc->arg, ECONNRESET);
+        rt_free(zc);
+        return ERR_OK;
+    }
+
+    /* hook the netconn callbacks of the pcb to follow the acknowledgements */
+    if (pcb->sent != lwip_zc_tcp_sent)
+    {
+        lwip_zc_sent_fn = pcb->sent;
+        lwip_zc_err_fn = pcb->errf;
+        tcp_sent(pcb, lwip_zc_tcp_sent);
+        tcp_err(pcb, lwip_zc_tcp_err);
+    }
+
+    /* the data has been queued, it ends at the last byte of the send buffer */
+    zc->seq = pcb->snd_lbb;
+    rt_list_insert_before(&lwip_zc_tcp_list, &zc->list);
+    lwip_zc_tcp_count++;
+    lwip_zc_tcp_complete(msg->conn, pcb, 0);
+
+    return ERR_OK;
+}
+
+/* count the pending sends of a connection which the shutdown closes */
+static err_t lwip_zc_tcp_pending(struct tcpip_api_call_data *call)
+{
+    struct lwip_zc_call *msg = (struct lwip_zc_call *) call;
+    struct tcp_pcb *pcb = msg->conn->pcb.tcp;
+    rt_list_t *node;
+
+    msg->pending = 0;
+    if (pcb != RT_NULL)
+    {
+        /* the sent callback may be gone after SHUT_WR, complete the acknowledged sends here */
+        lwip_zc_tcp_complete(msg->conn, pcb, 0);
+
+        /* netconn closes the pcb on shutting down the second side only */
+        if ((msg->how == SHUT_RD && pcb->state != FIN_WAIT_1 && pcb->state != FIN_WAIT_2 && pcb->state != CLOSING) ||
+            (msg->how == SHUT_WR && !(pcb->flags & TF_RXCLOSED)))
+        {
+            return ERR_OK;
+        }
+    }
+
+    rt_list_for_each(node, &lwip_zc_tcp_list)
+    {
+        if (rt_list_entry(node, struct lwip_zc_tcp, list)->conn == msg->conn)
+        {
+            msg->pending++;
+        }
+    }
+
+    return ERR_OK;
+}
+
+static err_t lwip_zc_tcp_abort(struct tcpip_api_call_data *call)
+{
+    struct lwip_zc_call *msg = (struct lwip_zc_call *) call;
+
+    if (msg->conn->pcb.tcp != RT_NULL)
+    {
+        /* free the segments still referencing the buffers, the err callback completes them */
+        tcp_abort(msg->conn->pcb.tcp);
+    }
+    lwip_zc_tcp_complete(msg->conn, RT_NULL, ECONNABORTED);
+
+    return ERR_OK;
+}
+
+/* keep following the pending sends after SHUT_WR */
+static err_t lwip_zc_tcp_rehook(struct tcpip_api_call_data *call)
+{
+    struct lwip_zc_call *msg = (struct lwip_zc_call *) call;
+    struct tcp_pcb *pcb = msg->conn->pcb.tcp;
+    rt_list_t *node;
+
+    if (pcb == RT_NULL || pcb->sent != RT_NULL)
+    {
+        return ERR_OK;
+    }
+
+    lwip_zc_tcp_complete(msg->conn, pcb, 0);
+    rt_list_for_each(node, &lwip_zc_tcp_list)
+    {
+        if (rt_list_entry(node, struct lwip_zc_tcp, list)->conn == msg->conn)
+        {
+            tcp_sent(pcb, lwip_zc_tcp_sent_shut);
+            break;
+        }
+    }
+
+    return ERR_OK;
+}
+
+/* lwIP keeps sending the queued data after closing, wait for the buffers to be released */
+static void lwip_zc_tcp_flush(struct netconn *conn, int how)
+{
+    struct lwip_zc_call msg;
+    rt_tick_t timeout = rt_tick_get() + rt_tick_from_millisecond(LWIP_ZC_CLOSE_TIMEOUT);
+
+    if (lwip_zc_tcp_count == 0)
+    {
+        return;
+    }
+
+    msg.conn = conn;
+    msg.how = how;
+    while (tcpip_api_call(lwip_zc_tcp_pending, &msg.call) == ERR_OK && msg.pending > 0)
+    {
+        if ((rt_int32_t)(rt_tick_get() - timeout) >= 0)
+        {
+            tcpip_api_call(lwip_zc_tcp_abort, &msg.call);
+            break;
+        }
+        rt_thread_mdelay(10);
+    }
+}
+
+#if LWIP_SUPPORT_CUSTOM_PBUF
+/* zero-copy datagram, done when the stack frees the pbuf referencing the buffer */
+struct lwip_zc_pbuf
+{
+    struct pbuf_custom pc;
+    lwip_zc_done_t done;
+    void *arg;
+    int err;
+};
+
+static void lwip_zc_pbuf_free(struct pbuf *p)
+{
+    struct lwip_zc_pbuf *zc = (struct lwip_zc_pbuf *) p;
+
+    if (zc->done)
+    {
+        zc->done(zc->arg, zc->err);
+    }
+    rt_free(zc);
+}
+#endif /* LWIP_SUPPORT_CUSTOM_PBUF */
+
+static int inet_send_zc(int s, const void *data, size_t size, int flags, lwip_zc_done_t done, void *arg)
+{
+    struct lwip_sock *sock;
+    struct netconn *conn;
+    err_t err;
+
+    sock = lwip_tryget_socket(s);
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    conn = sock->conn;
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        struct lwip_zc_call msg;
+        size_t written = 0;
+        u8_t apiflags = NETCONN_NOCOPY;
+
+        msg.zc = (struct lwip_zc_tcp *) rt_malloc(sizeof(struct lwip_zc_tcp));
+        if (msg.zc == RT_NULL)
+        {
+            set_errno(ENOMEM);
+            return -1;
+        }
+
+        if (flags & MSG_DONTWAIT)
+        {
+            apiflags |= NETCONN_DONTBLOCK;
+        }
+        if (flags & MSG_MORE)
+        {
+            apiflags |= NETCONN_MORE;
+        }
+
+        /* the segments reference the buffer (PBUF_ROM) until they are acknowledged */
+        err = netconn_write_partly(conn, data, size, apiflags, &written);
+        if (written == 0)
+        {
+            rt_free(msg.zc);
+            set_errno(err_to_errno(err != ERR_OK ? err : ERR_WOULDBLOCK));
+            return -1;
+        }
+
+        msg.zc->conn = conn;
+        msg.zc->done = done;
+        msg.zc->arg = arg;
+        msg.conn = conn;
+        tcpip_api_call(lwip_zc_tcp_add, &msg.call);
+
+        return (int) written;
+    }
+    else
+    {
+#if LWIP_SUPPORT_CUSTOM_PBUF
+        struct lwip_zc_pbuf *zc;
+        struct netbuf *buf;
+        struct pbuf *p;
+
+        if (size > 0xFFFF)
+        {
+            set_errno(EMSGSIZE);
+            return -1;
+        }
+
+        buf = netbuf_new();
+        zc = (struct lwip_zc_pbuf *) rt_malloc(sizeof(struct lwip_zc_pbuf));
+        if (buf == RT_NULL || zc == RT_NULL)
+        {
+            netbuf_delete(buf);
+            rt_free(zc);
+            set_errno(ENOMEM);
+            return -1;
+        }
+
+        zc->pc.custom_free_function = lwip_zc_pbuf_free;
+        zc->done = RT_NULL;
+        zc->arg = arg;
+        zc->err = 0;
+        p = pbuf_alloced_custom(PBUF_RAW, (u16_t) size, PBUF_REF, &zc->pc, (void *) data, (u16_t) size);
+
+        /* hold a reference to complete it after the result is known */
+        pbuf_ref(p);
+        buf->p = buf->ptr = p;
+        err = netconn_send(conn, buf);
+        netbuf_delete(buf);
+
+        if (err == ERR_OK)
+        {
+            zc->done = done;
+        }
+        pbuf_free(p);
+
+        if (err != ERR_OK)
+        {
+            set_errno(err_to_errno(err));
+            return -1;
+        }
+
+        return (int) size;
+#else
+        int ret = lwip_send(s, data, size, flags);
+
+        /* the data has been copied */
+        if (ret >= 0)
+        {
+            done(arg, 0);
+        }
+
+        return ret;
+#endif /* LWIP_SUPPORT_CUSTOM_PBUF */
+    }
+}
+
+static int inet_recv_pbuf(int s, struct pbuf **p, int flags)
+{
+    struct lwip_sock *sock;
+    struct netconn *conn;
+    u8_t apiflags = (flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0;
+    err_t err;
+
+    sock = lwip_tryget_socket(s);
+    if (sock == RT_NULL)
+    {
+        set_errno(EBADF);
+        return -1;
+    }
+    conn = sock->conn;
+
+    if (NETCONNTYPE_GROUP(netconn_type(conn)) == NETCONN_TCP)
+    {
+        /* hand over the data left by a previous recv() first */
+        if (sock->lastdata.pbuf)
+        {
+            *p = sock->lastdata.pbuf;
+            sock->lastdata.pbuf = RT_NULL;
+            return (*p)->tot_len;
+        }
+
+        err = netconn_recv_tcp_pbuf_flags(conn, p, apiflags);
+        if (err == ERR_CLSD)
+        {
+            return 0;
+        }
+    }
+    else
+    {
+        struct netbuf *buf;
+
+        if (sock->lastdata.netbuf)
+        {
+            buf = sock->lastdata.netbuf;
+            sock->lastdata.netbuf = RT_NULL;
+            err = ERR_OK;
+        }
+        else
+        {
+            err = netconn_recv_udp_raw_netbuf_flags(conn, &buf, apiflags);
+        }
+
+        if (err == ERR_OK)
+        {
+            /* keep the pbuf chain, free the netbuf */
+            *p = buf->p;
+            buf->p = buf->ptr = RT_NULL;
+            netbuf_delete(buf);
+        }
+    }
+
+    if (err != ERR_OK)
+    {
+        *p = RT_NULL;
+        set_errno(err_to_errno(err));
+        return -1;
+    }
+
+    return (*p)->tot_len;
+}
+
+static int inet_closesocket(int s)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(s);
+
+    if (sock != RT_NULL && NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP)
+    {
+        lwip_zc_tcp_flush(sock->conn, SHUT_RDWR);
+    }
+
+    return lwip_close(s);
+}
+
+static int inet_shutdown(int s, int how)
+{
+    struct lwip_sock *sock = lwip_tryget_socket(s);
+    struct lwip_zc_call msg;
+    int ret;
+
+    if (sock == RT_NULL || NETCONNTYPE_GROUP(netconn_type(sock->conn)) != NETCONN_TCP)
+    {
+        return lwip_shutdown(s, how);
+    }
+
+    /* netconn releases the pcb when both sides are shut down, as on closing */
+    lwip_zc_tcp_flush(sock->conn, how);
+
+    ret = lwip_shutdown(s, how);
+    if (ret == 0 && how == SHUT_WR && lwip_zc_tcp_count > 0)
+    {
+        msg.conn = sock->conn;
+        tcpip_api_call(lwip_zc_tcp_rehook, &msg.call);
+    }
+
+    return ret;
+}
+#endif /* LWIP_VERSION >= 0x20100ff */
+
+#ifdef SAL_USING_BENCH
+#include <lwip/apps/lwiperf.h>
+
+struct lwip_iperf
+{
+    struct tcpip_api_call_data call;
+    void *session;
+    u16_t port;
+    void (*report)(void *arg, int ok, uint32_t bytes, uint32_t ms, uint32_t kbps);
+    void *arg;
+};
+
+static void lwip_iperf_report(void *arg, enum lwiperf_report_type report_type,
+                              const ip_addr_t *local_addr, u16_t local_port,
+                              const ip_addr_t *remote_addr, u16_t remote_port,
+                              u32_t bytes_transferred, u32_t ms_duration, u32_t bandwidth_kbitpsec)
+{
+    struct lwip_iperf *iperf = (struct lwip_iperf *) arg;
+
+    iperf->report(iperf->arg, report_type == LWIPERF_TCP_DONE_SERVER,
+                  bytes_transferred, ms_duration, bandwidth_kbitpsec);
+}
+
+/* lwiperf is a raw API application, start and stop it in the tcpip thread */
+static err_t lwip_iperf_start(struct tcpip_api_call_data *call)
+{
+    struct lwip_iperf *iperf = (struct lwip_iperf *) call;
+
+    iperf->session = lwiperf_start_tcp_server(IP_ADDR_ANY, iperf->port, lwip_iperf_report, iperf);
+
+    return iperf->session ? ERR_OK : ERR_MEM;
+}
+
+static err_t lwip_iperf_stop(struct tcpip_api_call_data *call)
+{
+    lwiperf_abort(((struct lwip_iperf *) call)->session);
+
+    return ERR_OK;
+}
+
+void *sal_lwip_iperf_start(int port, void (*report)(void *arg, int ok, uint32_t bytes, uint32_t ms, uint32_t kbps), void *arg)
+{
+    struct lwip_iperf *iperf = (struct lwip_iperf *) rt_calloc(1, sizeof(struct lwip_iperf));
+
+    if (iperf == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
+    iperf->port = (u16_t) port;
+    iperf->report = report;
+    iperf->arg = arg;
+    if (tcpip_api_call(lwip_iperf_start, &iperf->call) != ERR_OK)
+    {
+        rt_free(iperf);
+        return RT_NULL;
+    }
+
+    return iperf;
+}
+
+void sal_lwip_iperf_stop(void *session)
+{
+    if (session)
+    {
+        tcpip_api_call(lwip_iperf_stop, (struct tcpip_api_call_data *) session);
+        rt_free(session);
+    }
+}
+#endif /* SAL_USING_BENCH */
+
 static const struct sal_socket_ops lwip_socket_ops =
 {
     inet_socket,
+#if LWIP_VERSION >= 0x20100ff
+    inet_closesocket,
+#else
     lwip_close,
+#endif
     lwip_bind,
     lwip_listen,
     lwip_connect,
@@ -302,13 +831,28 @@ static const struct sal_socket_ops lwip_socket_ops =
     lwip_getsockopt,
     //TODO fix on 1.4.1
     lwip_setsockopt,
+#if LWIP_VERSION >= 0x20100ff
+    inet_shutdown,
+#else
     lwip_shutdown,
+#endif
     lwip_getpeername,
     inet_getsockname,
     inet_ioctlsocket,
 #ifdef SAL_USING_POSIX
     inet_poll,
 #endif
+#if LWIP_VERSION >= 0x20100ff
+    (int (*)(int, const struct msghdr *, int))lwip_sendmsg,
+    (int (*)(int, struct msghdr *, int))lwip_recvmsg,
+    inet_send_zc,
+    inet_recv_pbuf,
+#else
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+#endif
 };
 
 static const struct sal_netdb_ops lwip_netdb_ops =
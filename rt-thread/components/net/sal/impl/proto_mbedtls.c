@@ -9,6 +9,7 @@
  */
 
 #include <rtthread.h>
+#include <stdlib.h>
 
 #ifdef RT_USING_DFS
 #include <unistd.h>
@@ -20,6 +21,7 @@
 #include <sal_tls.h>
 #endif
 #include <netdb.h>
+#include <sal_socket.h>
 #include <sal_low_lvl.h>
 
 #include <netdev.h>
@@ -39,6 +41,202 @@
 #define SAL_MEBDTLS_BUFFER_LEN         1024
 #endif
 
+#ifndef SAL_TLS_SESSION_CACHE_NUM
+#define SAL_TLS_SESSION_CACHE_NUM      4
+#endif
+#ifndef SAL_TLS_SESSION_CACHE_TIMEOUT
+#define SAL_TLS_SESSION_CACHE_TIMEOUT  3600
+#endif
+#ifndef SAL_TLS_SESSION_HOST_LEN
+#define SAL_TLS_SESSION_HOST_LEN       64
+#endif
+
+#if (SAL_TLS_SESSION_CACHE_NUM > 0) && defined(MBEDTLS_SSL_CLI_C)
+#define SAL_TLS_USING_SESSION_CACHE
+
+/*
+ * the sessions of the recent servers, the next handshake resumes by the session ID or ticket.
+ * A resumed handshake skips the certificate verification, so the sessions are keyed by the
+ * verified server name (TLS_HOSTNAME) and port: one IP address may serve several names.
+ */
+struct sal_tls_session_cache
+{
+    char host[SAL_TLS_SESSION_HOST_LEN];
+    rt_uint16_t port;
+    rt_tick_t tick;                     /* the time the session was stored, 0 if unused */
+    mbedtls_ssl_session session;
+};
+
+/* the server and the cached session ID of a connecting session */
+struct sal_tls_session_peer
+{
+    const char *host;                   /* RT_NULL if the session is not cached */
+    rt_uint16_t port;
+    unsigned char id[32];
+    size_t id_len;
+};
+
+static struct sal_tls_session_cache session_cache[SAL_TLS_SESSION_CACHE_NUM];
+static struct rt_mutex session_cache_lock;
+
+static struct
+{
+    rt_uint32_t hit;                    /* handshakes offered a cached session */
+    rt_uint32_t miss;                   /* handshakes without a cached session */
+    rt_uint32_t resumed;                /* handshakes the server accepted the cached session */
+    rt_uint32_t stored;                 /* sessions stored */
+} session_cache_stat;
+
+static void sal_tls_session_drop(struct sal_tls_session_cache *entry)
+{
+    mbedtls_ssl_session_free(&entry->session);
+    entry->tick = 0;
+}
+
+/* find the session of the server, the expired ones are dropped. called with the lock held */
+static struct sal_tls_session_cache *sal_tls_session_find(const struct sal_tls_session_peer *peer)
+{
+    struct sal_tls_session_cache *found = RT_NULL;
+    int i;
+
+    for (i = 0; i < SAL_TLS_SESSION_CACHE_NUM; i++)
+    {
+        struct sal_tls_session_cache *entry = &session_cache[i];
+
+        if (entry->tick == 0)
+        {
+            continue;
+        }
+
+        if (rt_tick_get() - entry->tick >= rt_tick_from_millisecond(SAL_TLS_SESSION_CACHE_TIMEOUT * 1000))
+        {
+            sal_tls_session_drop(entry);
+        }
+        else if (entry->port == peer->port && rt_strcmp(entry->host, peer->host) == 0)
+        {
+            found = entry;
+        }
+    }
+
+    return found;
+}
+
+/* offer the cached session of the server to the handshake */
+static void sal_tls_session_load(MbedTLSSession *session, struct sal_tls_session_peer *peer)
+{
+    struct sal_tls_session_cache *entry;
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+
+    peer->host = RT_NULL;
+    peer->id_len = 0;
+    /* without a server name the certificate is not bound to a host, never resume */
+    if (session->host == RT_NULL || rt_strlen(session->host) >= SAL_TLS_SESSION_HOST_LEN)
+    {
+        return;
+    }
+    if (sal_getpeername(session->server_fd.fd, (struct sockaddr *)&addr, &len) < 0)
+    {
+        return;
+    }
+    /* the port is at the same place in sockaddr_in and sockaddr_in6 */
+    peer->port = ((struct sockaddr_in *)&addr)->sin_port;
+    peer->host = session->host;
+
+    rt_mutex_take(&session_cache_lock, RT_WAITING_FOREVER);
+    entry = sal_tls_session_find(peer);
+    if (entry && mbedtls_ssl_set_session(&session->ssl, &entry->session) == 0)
+    {
+        rt_memcpy(peer->id, entry->session.id, entry->session.id_len);
+        peer->id_len = entry->session.id_len;
+        session_cache_stat.hit++;
+    }
+    else
+    {
+        session_cache_stat.miss++;
+    }
+    rt_mutex_release(&session_cache_lock);
+}
+
+/* store the session of the completed handshake, it replaces the server's or the oldest one */
+static void sal_tls_session_save(MbedTLSSession *session, const struct sal_tls_session_peer *peer)
+{
+    struct sal_tls_session_cache *entry;
+    mbedtls_ssl_session saved;
+    int i;
+
+    if (peer->host == RT_NULL)
+    {
+        return;
+    }
+
+    mbedtls_ssl_session_init(&saved);
+    if (mbedtls_ssl_get_session(&session->ssl, &saved) != 0)
+    {
+        mbedtls_ssl_session_free(&saved);
+        return;
+    }
+
+    rt_mutex_take(&session_cache_lock, RT_WAITING_FOREVER);
+    /* the server echoes the offered session ID if it resumed the session */
+    if (peer->id_len > 0 && saved.id_len == peer->id_len && rt_memcmp(saved.id, peer->id, peer->id_len) == 0)
+    {
+        session_cache_stat.resumed++;
+    }
+
+    entry = sal_tls_session_find(peer);
+    for (i = 0; entry == RT_NULL && i < SAL_TLS_SESSION_CACHE_NUM; i++)
+    {
+        if (session_cache[i].tick == 0)
+        {
+            entry = &session_cache[i];
+        }
+    }
+    if (entry == RT_NULL)
+    {
+        entry = &session_cache[0];
+        for (i = 1; i < SAL_TLS_SESSION_CACHE_NUM; i++)
+        {
+            if (rt_tick_get() - session_cache[i].tick > rt_tick_get() - entry->tick)
+            {
+                entry = &session_cache[i];
+            }
+        }
+    }
+    if (entry->tick)
+    {
+        sal_tls_session_drop(entry);
+    }
+
+    /* the cache takes over the session buffers */
+    entry->session = saved;
+    rt_strncpy(entry->host, peer->host, sizeof(entry->host) - 1);
+    entry->port = peer->port;
+    entry->tick = rt_tick_get() ? rt_tick_get() : 1;
+    session_cache_stat.stored++;
+    rt_mutex_release(&session_cache_lock);
+}
+
+/* forget the session of the server, the next handshake is a full one */
+static void sal_tls_session_forget(const struct sal_tls_session_peer *peer)
+{
+    struct sal_tls_session_cache *entry;
+
+    if (peer->id_len == 0)
+    {
+        return;
+    }
+
+    rt_mutex_take(&session_cache_lock, RT_WAITING_FOREVER);
+    entry = sal_tls_session_find(peer);
+    if (entry)
+    {
+        sal_tls_session_drop(entry);
+    }
+    rt_mutex_release(&session_cache_lock);
+}
+#endif /* (SAL_TLS_SESSION_CACHE_NUM > 0) && defined(MBEDTLS_SSL_CLI_C) */
+
 static void *mebdtls_socket(int socket)
 {
     MbedTLSSession *session = RT_NULL;
@@ -153,6 +351,9 @@ int mbedtls_net_recv_cb( void *ctx, unsigned char *buf, size_t len)
 static int mbedtls_connect(void *sock)
 {
     MbedTLSSession *session = RT_NULL;
+#ifdef SAL_TLS_USING_SESSION_CACHE
+    struct sal_tls_session_peer peer;
+#endif
     int ret = 0;
 
     RT_ASSERT(sock);
@@ -169,10 +370,18 @@ static int mbedtls_connect(void *sock)
     /* Set the underlying BIO callbacks for write, read and read-with-timeout.  */
     mbedtls_ssl_set_bio(&session->ssl, &session->server_fd, mbedtls_net_send_cb, mbedtls_net_recv_cb, RT_NULL);
 
+#ifdef SAL_TLS_USING_SESSION_CACHE
+    /* Offer the session of the last connection to the peer */
+    sal_tls_session_load(session, &peer);
+#endif
+
     while ((ret = mbedtls_ssl_handshake(&session->ssl)) != 0)
     {
         if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
         {
+#ifdef SAL_TLS_USING_SESSION_CACHE
+            sal_tls_session_forget(&peer);
+#endif
             goto __exit;
         }
     }
@@ -186,6 +395,10 @@ static int mbedtls_connect(void *sock)
         goto __exit;
     }
 
+#ifdef SAL_TLS_USING_SESSION_CACHE
+    sal_tls_session_save(session, &peer);
+#endif
+
     return ret;
 
 __exit:
@@ -197,6 +410,34 @@ __exit:
     return ret;
 }
 
+/* the server name for SNI and the certificate verification, set before connect */
+static int mbedtls_set_hostname(void *sock, const void *hostname, size_t size)
+{
+    MbedTLSSession *session = (MbedTLSSession *) sock;
+    char *host;
+
+    if (session == RT_NULL || hostname == RT_NULL || size == 0)
+    {
+        return -1;
+    }
+
+    host = tls_calloc(1, size + 1);
+    if (host == RT_NULL)
+    {
+        return -1;
+    }
+    rt_memcpy(host, hostname, size);
+
+    /* freed by mbedtls_client_close() */
+    if (session->host)
+    {
+        tls_free(session->host);
+    }
+    session->host = host;
+
+    return 0;
+}
+
 static int mbedtls_closesocket(void *sock)
 {
     struct sal_socket *ssock;
@@ -229,6 +470,11 @@ static const struct sal_proto_tls_ops mbedtls_proto_ops=
     (int (*)(void *sock, const void *data, size_t size)) mbedtls_client_write,
     (int (*)(void *sock, void *mem, size_t len)) mbedtls_client_read,
     mbedtls_closesocket,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    mbedtls_set_hostname,
 };
 
 static const struct sal_proto_tls mbedtls_proto =
@@ -239,6 +485,10 @@ static const struct sal_proto_tls mbedtls_proto =
 
 int sal_mbedtls_proto_init(void)
 {
+#ifdef SAL_TLS_USING_SESSION_CACHE
+    rt_mutex_init(&session_cache_lock, "tls_sc", RT_IPC_FLAG_PRIO);
+#endif
+
     /* register MbedTLS protocol options to SAL */
     sal_proto_tls_register(&mbedtls_proto);
 
@@ -246,4 +496,145 @@ int sal_mbedtls_proto_init(void)
 }
 INIT_COMPONENT_EXPORT(sal_mbedtls_proto_init);
 
+#if defined(SAL_USING_BENCH) && defined(RT_USING_FINSH)
+#include <finsh.h>
+
+#define SAL_TLS_BENCH_CHUNK     1024
+
+/* connects to the server and returns the socket, the handshake time in ticks */
+static int sal_tls_bench_connect(const char *name, const struct sockaddr_in *addr, rt_tick_t *tick)
+{
+    int sock;
+
+    sock = sal_socket(AF_INET, SOCK_STREAM, PROTOCOL_TLS);
+    if (sock < 0)
+    {
+        return -1;
+    }
+    /* the sessions are cached by the server name */
+    if (sal_setsockopt(sock, SOL_TLS, TLS_HOSTNAME, name, rt_strlen(name)) < 0)
+    {
+        sal_closesocket(sock);
+        return -1;
+    }
+
+    *tick = rt_tick_get();
+    if (sal_connect(sock, (const struct sockaddr *)addr, sizeof(struct sockaddr_in)) < 0)
+    {
+        sal_closesocket(sock);
+        return -1;
+    }
+    *tick = rt_tick_get() - *tick;
+
+    return sock;
+}
+
+/*
+ * The TLS handshake time, the first one is full and the next ones are resumed
+ * from the session cache, and the bulk send throughput to the server.
+ */
+static void sal_tls_bench(int argc, char **argv)
+{
+    struct sockaddr_in addr;
+    struct hostent *host;
+    rt_tick_t tick, full = 0, resumed = 0;
+    rt_uint32_t count = 4, total = 64 * 1024, sent;
+    rt_uint8_t *buf;
+    int sock, i;
+
+    if (argc < 3)
+    {
+        rt_kprintf("Usage: sal_tls_bench <host> <port> [handshakes] [KB]\n");
+        return;
+    }
+    if (argc > 3)
+    {
+        count = atoi(argv[3]);
+    }
+    if (argc > 4)
+    {
+        total = atoi(argv[4]) * 1024;
+    }
+
+    host = gethostbyname(argv[1]);
+    if (host == RT_NULL)
+    {
+        rt_kprintf("Can't resolve %s.\n", argv[1]);
+        return;
+    }
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(atoi(argv[2]));
+    rt_memcpy(&addr.sin_addr, host->h_addr_list[0], sizeof(addr.sin_addr));
+
+    for (i = 0; i < (int)count; i++)
+    {
+        sock = sal_tls_bench_connect(argv[1], &addr, &tick);
+        if (sock < 0)
+        {
+            rt_kprintf("Handshake %d failed.\n", i);
+            return;
+        }
+        sal_closesocket(sock);
+
+        if (i == 0)
+        {
+            full = tick;
+        }
+        else
+        {
+            resumed += tick;
+        }
+    }
+    rt_kprintf("handshake: full %d ms", (int)(full * 1000 / RT_TICK_PER_SECOND));
+    if (count > 1)
+    {
+        rt_kprintf(", resumed %d ms", (int)(resumed * 1000 / RT_TICK_PER_SECOND / (count - 1)));
+    }
+    rt_kprintf("\n");
+
+#ifdef SAL_TLS_USING_SESSION_CACHE
+    rt_kprintf("session cache: hit %u, miss %u, resumed %u, stored %u\n", session_cache_stat.hit,
+               session_cache_stat.miss, session_cache_stat.resumed, session_cache_stat.stored);
+#endif
+
+    if (total == 0)
+    {
+        return;
+    }
+
+    buf = rt_malloc(SAL_TLS_BENCH_CHUNK);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("No memory for the benchmark.\n");
+        return;
+    }
+    rt_memset(buf, 0x5A, SAL_TLS_BENCH_CHUNK);
+
+    sock = sal_tls_bench_connect(argv[1], &addr, &tick);
+    if (sock < 0)
+    {
+        rt_kprintf("Handshake failed.\n");
+        rt_free(buf);
+        return;
+    }
+
+    tick = rt_tick_get();
+    for (sent = 0; sent < total; sent += SAL_TLS_BENCH_CHUNK)
+    {
+        if (sal_sendto(sock, buf, SAL_TLS_BENCH_CHUNK, 0, RT_NULL, 0) != SAL_TLS_BENCH_CHUNK)
+        {
+            break;
+        }
+    }
+    tick = rt_tick_get() - tick;
+    sal_closesocket(sock);
+    rt_free(buf);
+
+    rt_kprintf("bulk: %u KB sent, %u KB/s\n", sent / 1024,
+               (rt_uint32_t)((rt_uint64_t)sent * RT_TICK_PER_SECOND / 1024 / (tick ? tick : 1)));
+}
+MSH_CMD_EXPORT(sal_tls_bench, TLS handshake and throughput benchmark: sal_tls_bench <host> <port> [handshakes] [KB]);
+#endif /* SAL_USING_BENCH && RT_USING_FINSH */
+
 #endif /* SAL_USING_TLS */
@@ -20,6 +20,7 @@ extern "C" {
 
 const struct dfs_file_ops* dfs_net_get_fops(void);
 int dfs_net_getsocket(int fd);
+void dfs_net_setsocket(int fd, int socket);
 
 #ifdef __cplusplus
 }
@@ -45,6 +45,10 @@ typedef uint32_t socklen_t;
 #define SAL_SOCKET_OFFSET              0
 #endif
 
+struct sal_socket_ops;
+struct msghdr;
+struct pbuf;
+
 struct sal_socket
 {
     uint32_t magic;                    /* SAL socket magic word */
@@ -55,6 +59,7 @@ struct sal_socket
     int protocol;
 
     struct netdev *netdev;             /* SAL network interface device */
+    const struct sal_socket_ops *ops;  /* socket operations of the netdev, cached for the data path */
 
     void *user_data;                   /* user-specific data */
 #ifdef SAL_USING_TLS
@@ -82,6 +87,12 @@ struct sal_socket_ops
 #ifdef SAL_USING_POSIX
     int (*poll)       (struct dfs_fd *file, struct rt_pollreq *req);
 #endif
+    /* optional, SAL gathers/scatters the iovecs through sendto/recvfrom if not provided */
+    int (*sendmsg)    (int s, const struct msghdr *message, int flags);
+    int (*recvmsg)    (int s, struct msghdr *message, int flags);
+    /* optional, zero-copy data path */
+    int (*send_zc)    (int s, const void *data, size_t size, int flags, void (*done)(void *arg, int err), void *arg);
+    int (*recv_pbuf)  (int s, struct pbuf **p, int flags);
 };
 
 /* sal network database name resolving */
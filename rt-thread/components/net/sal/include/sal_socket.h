@@ -98,6 +98,10 @@ typedef uint16_t in_port_t;
 #define MSG_DONTWAIT    0x08    /* Nonblocking i/o for this operation only */
 #define MSG_MORE        0x10    /* Sender will send more */
 
+/* struct msghdr->msg_flags bit field values */
+#define MSG_TRUNC       0x04
+#define MSG_CTRUNC      0x08
+
 /* Options for level IPPROTO_IP */
 #define IP_TOS             1
 #define IP_TTL             2
@@ -194,6 +198,34 @@ struct sockaddr_storage
 #endif /* NETDEV_IPV6 */
 };
 
+#if !defined(iovec)
+struct iovec
+{
+    void  *iov_base;
+    size_t iov_len;
+};
+#endif
+
+/* members are the same as lwIP struct msghdr */
+struct msghdr
+{
+    void         *msg_name;
+    socklen_t     msg_namelen;
+    struct iovec *msg_iov;
+    int           msg_iovlen;
+    void         *msg_control;
+    socklen_t     msg_controllen;
+    int           msg_flags;
+};
+
+struct pbuf;
+
+/*
+ * Completion of a zero-copy send, the buffer is no longer referenced by the stack.
+ * err is 0 when the data was delivered (acknowledged for stream sockets), otherwise an errno value.
+ */
+typedef void (*sal_zc_done_t)(void *arg, int err);
+
 int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen);
 int sal_bind(int socket, const struct sockaddr *name, socklen_t namelen);
 int sal_shutdown(int socket, int how);
@@ -207,6 +239,10 @@ int sal_recvfrom(int socket, void *mem, size_t len, int flags,
       struct sockaddr *from, socklen_t *fromlen);
 int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
     const struct sockaddr *to, socklen_t tolen);
+int sal_recvmsg(int socket, struct msghdr *message, int flags);
+int sal_sendmsg(int socket, const struct msghdr *message, int flags);
+int sal_send_zc(int socket, const void *data, size_t size, int flags, sal_zc_done_t done, void *arg);
+int sal_recv_pbuf(int socket, struct pbuf **p, int flags);
 int sal_socket(int domain, int type, int protocol);
 int sal_closesocket(int socket);
 int sal_ioctlsocket(int socket, long cmd, void *arg);
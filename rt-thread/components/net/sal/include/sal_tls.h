@@ -31,6 +31,8 @@ extern "C" {
 #define TLS_PEER_VERIFY      3
 /* Socket option to set role for DTLS connection. */
 #define TLS_DTLS_ROLE        4
+/* Socket option to set the server name, sent as SNI and verified in the certificate. */
+#define TLS_HOSTNAME         5
 
 /* Protocol numbers for TLS protocols */
 #define PROTOCOL_TLS         256
@@ -50,6 +52,7 @@ struct sal_proto_tls_ops
     int (*set_ciphersurite)(void *sock, const void* ciphersurite, size_t size);   /* Set select ciphersuites */
     int (*set_peer_verify)(void *sock, const void* peer_verify, size_t size);     /* Set peer verification */
     int (*set_dtls_role)(void *sock, const void *dtls_role, size_t size);         /* Set role for DTLS */
+    int (*set_hostname)(void *sock, const void *hostname, size_t size);           /* Set server name */
 };
 
 struct sal_proto_tls
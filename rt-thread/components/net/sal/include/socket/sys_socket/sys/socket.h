@@ -35,9 +35,13 @@ int listen(int s, int backlog);
 int recv(int s, void *mem, size_t len, int flags);
 int recvfrom(int s, void *mem, size_t len, int flags,
       struct sockaddr *from, socklen_t *fromlen);
+int recvmsg(int s, struct msghdr *message, int flags);
 int send(int s, const void *dataptr, size_t size, int flags);
 int sendto(int s, const void *dataptr, size_t size, int flags,
     const struct sockaddr *to, socklen_t tolen);
+int sendmsg(int s, const struct msghdr *message, int flags);
+int send_zc(int s, const void *dataptr, size_t size, int flags, sal_zc_done_t done, void *arg);
+int recv_pbuf(int s, struct pbuf **p, int flags);
 int socket(int domain, int type, int protocol);
 int closesocket(int s);
 int ioctlsocket(int s, long cmd, void *arg);
@@ -53,8 +57,12 @@ int ioctlsocket(int s, long cmd, void *arg);
 #define listen(s, backlog)                                 sal_listen(s, backlog)
 #define recv(s, mem, len, flags)                           sal_recvfrom(s, mem, len, flags, NULL, NULL)
 #define recvfrom(s, mem, len, flags, from, fromlen)        sal_recvfrom(s, mem, len, flags, from, fromlen)
+#define recvmsg(s, message, flags)                         sal_recvmsg(s, message, flags)
 #define send(s, dataptr, size, flags)                      sal_sendto(s, dataptr, size, flags, NULL, NULL)
 #define sendto(s, dataptr, size, flags, to, tolen)         sal_sendto(s, dataptr, size, flags, to, tolen)
+#define sendmsg(s, message, flags)                         sal_sendmsg(s, message, flags)
+#define send_zc(s, dataptr, size, flags, done, arg)        sal_send_zc(s, dataptr, size, flags, done, arg)
+#define recv_pbuf(s, p, flags)                             sal_recv_pbuf(s, p, flags)
 #define socket(domain, type, protocol)                     sal_socket(domain, type, protocol)
 #define closesocket(s)                                     sal_closesocket(s)
 #define ioctlsocket(s, cmd, arg)                           sal_ioctlsocket(s, cmd, arg)
@@ -52,6 +52,7 @@ int accept(int s, struct sockaddr *addr, socklen_t *addrlen)
 
             /* set socket to the data of dfs_fd */
             d->data = (void *) new_socket;
+            dfs_net_setsocket(fd, new_socket);
 
             /* release the ref-count of fd */
             fd_put(d);
@@ -177,6 +178,14 @@ int recvfrom(int s, void *mem, size_t len, int flags,
 }
 RTM_EXPORT(recvfrom);
 
+int recvmsg(int s, struct msghdr *message, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_recvmsg(socket, message, flags);
+}
+RTM_EXPORT(recvmsg);
+
 int send(int s, const void *dataptr, size_t size, int flags)
 {
     int socket = dfs_net_getsocket(s);
@@ -194,6 +203,30 @@ int sendto(int s, const void *dataptr, size_t size, int flags,
 }
 RTM_EXPORT(sendto);
 
+int sendmsg(int s, const struct msghdr *message, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_sendmsg(socket, message, flags);
+}
+RTM_EXPORT(sendmsg);
+
+int send_zc(int s, const void *dataptr, size_t size, int flags, sal_zc_done_t done, void *arg)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_send_zc(socket, dataptr, size, flags, done, arg);
+}
+RTM_EXPORT(send_zc);
+
+int recv_pbuf(int s, struct pbuf **p, int flags)
+{
+    int socket = dfs_net_getsocket(s);
+
+    return sal_recv_pbuf(socket, p, flags);
+}
+RTM_EXPORT(recv_pbuf);
+
 int socket(int domain, int type, int protocol)
 {
     /* create a BSD socket */
@@ -227,6 +260,7 @@ int socket(int domain, int type, int protocol)
 
         /* set socket to the data of dfs_fd */
         d->data = (void *) socket;
+        dfs_net_setsocket(fd, socket);
     }
     else
     {
@@ -266,6 +300,7 @@ int closesocket(int s)
         return -1;
     }
 
+    dfs_net_setsocket(s, -1);
     if (sal_closesocket(socket) == 0)
     {
         error = 0;
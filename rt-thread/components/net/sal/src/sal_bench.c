@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rtthread.h>
+
+#if defined(SAL_USING_BENCH) && defined(RT_USING_FINSH)
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sal_low_lvl.h>
+#include <netdev.h>
+
+#ifdef SAL_USING_LWIP
+#include <af_inet.h>
+#endif
+
+#define SAL_BENCH_PORT                 5009
+#define SAL_BENCH_DEF_COUNT            2000
+#define SAL_BENCH_DEF_SIZE             64
+#define SAL_BENCH_MAX_SIZE             1400
+
+enum sal_bench_mode
+{
+    SAL_BENCH_SOCKET,                  /* send/recv through the BSD socket API */
+    SAL_BENCH_SAL,                     /* sal_sendto/sal_recvfrom on the SAL socket */
+    SAL_BENCH_MSG,                     /* sendmsg/recvmsg with two iovecs */
+};
+
+static const char *sal_bench_mode_name[] = {"socket", "sal", "msg"};
+
+static int sal_bench_run(enum sal_bench_mode mode, int tx, int rx, const struct sockaddr_in *addr,
+                         uint8_t *buf, size_t size, int count)
+{
+    struct iovec iov[2];
+    struct msghdr msg;
+    int tx_sock = tx, rx_sock = rx;
+    int i, ret = 0;
+
+#ifdef SAL_USING_POSIX
+    if (mode == SAL_BENCH_SAL)
+    {
+        extern int dfs_net_getsocket(int fd);
+
+        tx_sock = dfs_net_getsocket(tx);
+        rx_sock = dfs_net_getsocket(rx);
+    }
+#endif
+
+    iov[0].iov_base = buf;
+    iov[0].iov_len = size / 2;
+    iov[1].iov_base = buf + size / 2;
+    iov[1].iov_len = size - size / 2;
+
+    for (i = 0; i < count && ret >= 0; i++)
+    {
+        switch (mode)
+        {
+        case SAL_BENCH_SOCKET:
+            ret = sendto(tx, buf, size, 0, (const struct sockaddr *) addr, sizeof(*addr));
+            if (ret >= 0)
+            {
+                ret = recv(rx, buf, size, 0);
+            }
+            break;
+
+        case SAL_BENCH_SAL:
+            ret = sal_sendto(tx_sock, buf, size, 0, (const struct sockaddr *) addr, sizeof(*addr));
+            if (ret >= 0)
+            {
+                ret = sal_recvfrom(rx_sock, buf, size, 0, RT_NULL, RT_NULL);
+            }
+            break;
+
+        case SAL_BENCH_MSG:
+            rt_memset(&msg, 0, sizeof(msg));
+            msg.msg_name = (void *) addr;
+            msg.msg_namelen = sizeof(*addr);
+            msg.msg_iov = iov;
+            msg.msg_iovlen = 2;
+            ret = sendmsg(tx, &msg, 0);
+            if (ret >= 0)
+            {
+                msg.msg_name = RT_NULL;
+                msg.msg_namelen = 0;
+                ret = recvmsg(rx, &msg, 0);
+            }
+            break;
+        }
+    }
+
+    return ret < 0 ? -1 : i;
+}
+
+/*
+ * UDP ping-pong through the netdev's own address, so the packets loop back
+ * in lwIP (LWIP_NETIF_LOOPBACK) without touching the wire.
+ */
+static void sal_bench(int argc, char **argv)
+{
+    struct netdev *netdev = netdev_default;
+    struct sockaddr_in addr;
+    struct timeval timeout = {1, 0};
+    int count = SAL_BENCH_DEF_COUNT;
+    size_t size = SAL_BENCH_DEF_SIZE;
+    int tx = -1, rx = -1;
+    uint8_t *buf = RT_NULL;
+    int mode;
+
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        size = atoi(argv[2]);
+    }
+    if (count <= 0 || size == 0 || size > SAL_BENCH_MAX_SIZE)
+    {
+        rt_kprintf("Usage: sal_bench [count] [size(1~%d)]\n", SAL_BENCH_MAX_SIZE);
+        return;
+    }
+
+    if (netdev == RT_NULL || !netdev_is_up(netdev))
+    {
+        rt_kprintf("The default network interface device is not up.\n");
+        return;
+    }
+
+    buf = rt_malloc(size);
+    tx = socket(AF_INET, SOCK_DGRAM, 0);
+    rx = socket(AF_INET, SOCK_DGRAM, 0);
+    if (buf == RT_NULL || tx < 0 || rx < 0)
+    {
+        rt_kprintf("No memory for the benchmark.\n");
+        goto __exit;
+    }
+    rt_memset(buf, 0x5A, size);
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SAL_BENCH_PORT);
+    addr.sin_addr.s_addr = INADDR_ANY;
+    if (bind(rx, (struct sockaddr *) &addr, sizeof(addr)) < 0)
+    {
+        rt_kprintf("Bind port %d failed.\n", SAL_BENCH_PORT);
+        goto __exit;
+    }
+    setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, (void *) &timeout, sizeof(timeout));
+
+    addr.sin_addr.s_addr = inet_addr(inet_ntoa(netdev->ip_addr));
+
+    rt_kprintf("%s: %d UDP round trips of %d bytes\n", netdev->name, count, (int) size);
+#ifdef SAL_USING_LWIP
+#ifdef RT_LWIP_TCPIP_CORE_LOCKING
+    rt_kprintf("lwIP API calls lock the tcpip core\n");
+#else
+    rt_kprintf("lwIP API calls pass messages to the tcpip thread\n");
+#endif
+#endif /* SAL_USING_LWIP */
+    for (mode = SAL_BENCH_SOCKET; mode <= SAL_BENCH_MSG; mode++)
+    {
+        rt_tick_t tick = rt_tick_get();
+        int done = sal_bench_run((enum sal_bench_mode) mode, tx, rx, &addr, buf, size, count);
+
+        tick = rt_tick_get() - tick;
+        if (done < 0)
+        {
+            rt_kprintf("%-8s failed\n", sal_bench_mode_name[mode]);
+            continue;
+        }
+        if (tick == 0)
+        {
+            tick = 1;
+        }
+
+        /* a round trip is two socket calls */
+        rt_kprintf("%-8s %6d ms, %8d calls/s, %6d us/round trip\n", sal_bench_mode_name[mode],
+                   (int) (tick * 1000 / RT_TICK_PER_SECOND),
+                   (int) ((rt_uint64_t) done * 2 * RT_TICK_PER_SECOND / tick),
+                   (int) ((rt_uint64_t) tick * 1000000 / RT_TICK_PER_SECOND / (done ? done : 1)));
+    }
+
+__exit:
+    if (tx >= 0)
+    {
+        closesocket(tx);
+    }
+    if (rx >= 0)
+    {
+        closesocket(rx);
+    }
+    rt_free(buf);
+}
+MSH_CMD_EXPORT(sal_bench, socket calls microbenchmark: sal_bench [count] [size]);
+
+#ifdef SAL_USING_LWIP
+
+#define SAL_BENCH_IPERF_PORT           5001
+#define SAL_BENCH_IPERF_DEF_SIZE       (4 * 1024)      /* KB */
+#define SAL_BENCH_IPERF_CHUNK          (4 * 1024)
+
+struct sal_bench_iperf
+{
+    struct rt_semaphore report;
+    struct rt_semaphore done;
+    int ok;
+    uint32_t bytes;
+    uint32_t ms;
+    uint32_t kbps;
+};
+
+static void sal_bench_iperf_report(void *arg, int ok, uint32_t bytes, uint32_t ms, uint32_t kbps)
+{
+    struct sal_bench_iperf *iperf = (struct sal_bench_iperf *) arg;
+
+    iperf->ok = ok;
+    iperf->bytes = bytes;
+    iperf->ms = ms;
+    iperf->kbps = kbps;
+    rt_sem_release(&iperf->report);
+}
+
+static void sal_bench_zc_done(void *arg, int err)
+{
+    rt_sem_release(&((struct sal_bench_iperf *) arg)->done);
+}
+
+/* stream the data to the lwiperf server, copied by send() or referenced by send_zc() */
+static int sal_bench_iperf_client(struct sal_bench_iperf *iperf, const struct sockaddr_in *addr,
+                                  const uint8_t *buf, size_t total, rt_bool_t zc)
+{
+    size_t sent = 0;
+    int submitted = 0;
+    int s, ret = 0;
+
+    s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s < 0)
+    {
+        return -1;
+    }
+
+    if (connect(s, (const struct sockaddr *) addr, sizeof(*addr)) < 0)
+    {
+        closesocket(s);
+        return -1;
+    }
+
+    while (sent < total)
+    {
+        size_t offset = sent % SAL_BENCH_IPERF_CHUNK;
+        size_t len = SAL_BENCH_IPERF_CHUNK - offset;
+
+        if (len > total - sent)
+        {
+            len = total - sent;
+        }
+
+        if (zc)
+        {
+            /* the buffer is never changed, so it can be referenced by several sends */
+            ret = send_zc(s, buf + offset, len, 0, sal_bench_zc_done, iperf);
+            submitted += (ret > 0);
+        }
+        else
+        {
+            ret = send(s, buf + offset, len, 0);
+        }
+        if (ret <= 0)
+        {
+            break;
+        }
+        sent += ret;
+    }
+
+    /* the buffer is referenced until the data is acknowledged */
+    while (submitted-- > 0)
+    {
+        rt_sem_take(&iperf->done, RT_WAITING_FOREVER);
+    }
+
+    closesocket(s);
+
+    return ret <= 0 ? -1 : 0;
+}
+
+/*
+ * TCP throughput of send() and send_zc() to the lwiperf server, through the
+ * netdev's own address so the data loops back in lwIP.
+ */
+static void sal_bench_zc(int argc, char **argv)
+{
+    static const char *name[] = {"send", "send_zc"};
+    struct netdev *netdev = netdev_default;
+    struct sal_bench_iperf *iperf;
+    struct sockaddr_in addr;
+    size_t total = SAL_BENCH_IPERF_DEF_SIZE * 1024;
+    void *session = RT_NULL;
+    uint8_t *buf;
+    int zc;
+
+    if (argc > 1)
+    {
+        total = atoi(argv[1]) * 1024;
+    }
+    if (total == 0)
+    {
+        rt_kprintf("Usage: sal_bench_zc [size(KB)]\n");
+        return;
+    }
+
+    if (netdev == RT_NULL || !netdev_is_up(netdev))
+    {
+        rt_kprintf("The default network interface device is not up.\n");
+        return;
+    }
+
+    iperf = rt_calloc(1, sizeof(struct sal_bench_iperf));
+    /* all zero, the iperf settings header of the stream asks for no reverse test */
+    buf = rt_calloc(1, SAL_BENCH_IPERF_CHUNK);
+    if (iperf == RT_NULL || buf == RT_NULL)
+    {
+        rt_kprintf("No memory for the benchmark.\n");
+        goto __exit;
+    }
+    rt_sem_init(&iperf->report, "zc_rpt", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&iperf->done, "zc_done", 0, RT_IPC_FLAG_FIFO);
+
+    session = sal_lwip_iperf_start(SAL_BENCH_IPERF_PORT, sal_bench_iperf_report, iperf);
+    if (session == RT_NULL)
+    {
+        rt_kprintf("Start the lwiperf server failed.\n");
+        goto __detach;
+    }
+
+    rt_memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(SAL_BENCH_IPERF_PORT);
+    addr.sin_addr.s_addr = inet_addr(inet_ntoa(netdev->ip_addr));
+
+    rt_kprintf("%s: %d KB to lwiperf\n", netdev->name, (int) (total / 1024));
+    for (zc = 0; zc < 2; zc++)
+    {
+        rt_tick_t tick = rt_tick_get();
+
+        if (sal_bench_iperf_client(iperf, &addr, buf, total, zc) < 0 ||
+            rt_sem_take(&iperf->report, rt_tick_from_millisecond(5000)) != RT_EOK || !iperf->ok)
+        {
+            rt_kprintf("%-8s failed\n", name[zc]);
+            continue;
+        }
+
+        tick = rt_tick_get() - tick;
+        rt_kprintf("%-8s %6d ms, server %8d kbit/s (%d bytes in %d ms)\n", name[zc],
+                   (int) (tick * 1000 / RT_TICK_PER_SECOND),
+                   (int) iperf->kbps, (int) iperf->bytes, (int) iperf->ms);
+    }
+
+    sal_lwip_iperf_stop(session);
+
+__detach:
+    rt_sem_detach(&iperf->report);
+    rt_sem_detach(&iperf->done);
+__exit:
+    rt_free(buf);
+    rt_free(iperf);
+}
+MSH_CMD_EXPORT(sal_bench_zc, zero-copy TCP throughput to lwiperf: sal_bench_zc [size(KB)]);
+
+#endif /* SAL_USING_LWIP */
+
+#endif /* SAL_USING_BENCH && RT_USING_FINSH */
@@ -12,6 +12,7 @@
 #include <rtthread.h>
 #include <rthw.h>
 #include <sys/time.h>
+#include <sys/errno.h>
 
 #include <sal_socket.h>
 #include <sal_netdb.h>
@@ -80,6 +81,14 @@ do {
     }                                                                             \
 }while(0)                                                                         \
 
+#define SAL_SOCKET_OPS_VALID(sock, skt_ops, name)                                 \
+do {                                                                              \
+    (skt_ops) = (sock)->ops;                                                      \
+    if ((skt_ops) == RT_NULL || (skt_ops)->name == RT_NULL){                      \
+        return -1;                                                                \
+    }                                                                             \
+}while(0)                                                                         \
+
 #define SAL_NETDEV_IS_UP(netdev)                                                  \
 do {                                                                              \
     if (!netdev_is_up(netdev)) {                                                  \
@@ -338,6 +347,12 @@ struct sal_socket *sal_get_socket(int socket)
         return RT_NULL;
     }
 
+    /* the socket is closed */
+    if (st->sockets[socket] == RT_NULL)
+    {
+        return RT_NULL;
+    }
+
     /* check socket structure valid or not */
     RT_ASSERT(st->sockets[socket]->magic == SAL_SOCKET_MAGIC);
 
@@ -447,6 +462,7 @@ static int socket_init(int family, int type, int protocol, struct sal_socket **r
         if (pf != RT_NULL && pf->skt_ops && (pf->family == family || pf->sec_family == family))
         {
             sock->netdev = netdv_def;
+            sock->ops = pf->skt_ops;
             flag = RT_TRUE;
         }
     }
@@ -462,6 +478,8 @@ static int socket_init(int family, int type, int protocol, struct sal_socket **r
         }
 
         sock->netdev = netdev;
+        pf = (struct sal_proto_family *) netdev->sal_user_data;
+        sock->ops = pf ? pf->skt_ops : RT_NULL;
     }
 
     return 0;
@@ -549,6 +567,7 @@ static int socket_new(void)
     sock->socket = idx + SAL_SOCKET_OFFSET;
     sock->magic = SAL_SOCKET_MAGIC;
     sock->netdev = RT_NULL;
+    sock->ops = RT_NULL;
     sock->user_data = RT_NULL;
 #ifdef SAL_USING_TLS
     sock->user_data_tls = RT_NULL;
@@ -575,6 +594,7 @@ static void socket_delete(int socket)
     RT_ASSERT(sock != RT_NULL);
     sock->magic = 0;
     sock->netdev = RT_NULL;
+    sock->ops = RT_NULL;
     socket_free(st, idx);
     sal_unlock();
 }
@@ -623,6 +643,7 @@ int sal_accept(int socket, struct sockaddr *addr, socklen_t *addrlen)
 
         /* new socket create by accept should have the same netdev with server*/
         new_sock->netdev = sock->netdev;
+        new_sock->ops = sock->ops;
         /* socket structure user_data used to store the acquired new socket */
         new_sock->user_data = (void *) new_socket;
 
@@ -690,6 +711,7 @@ int sal_bind(int socket, const struct sockaddr *name, socklen_t namelen)
                 return -1;
             }
             sock->netdev = new_netdev;
+            sock->ops = input_pf->skt_ops;
             sock->user_data = (void *) new_socket;
         }
     }
@@ -808,6 +830,10 @@ int sal_setsockopt(int socket, int level, int optname, const void *optval, sockl
             SAL_SOCKOPT_PROTO_TLS_EXEC(sock, set_dtls_role, optval, optlen);
             break;
 
+        case TLS_HOSTNAME:
+            SAL_SOCKOPT_PROTO_TLS_EXEC(sock, set_hostname, optval, optlen);
+            break;
+
         default:
             return -1;
         }
@@ -871,15 +897,15 @@ int sal_recvfrom(int socket, void *mem, size_t len, int flags,
                  struct sockaddr *from, socklen_t *fromlen)
 {
     struct sal_socket *sock;
-    struct sal_proto_family *pf;
+    const struct sal_socket_ops *skt_ops;
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
 
     /* check the network interface is up status  */
     SAL_NETDEV_IS_UP(sock->netdev);
-    /* check the network interface socket opreation */
-    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, recvfrom);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, recvfrom);
 
 #ifdef SAL_USING_TLS
     if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, recv))
@@ -894,10 +920,10 @@ int sal_recvfrom(int socket, void *mem, size_t len, int flags,
     }
     else
     {
-        return pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
+        return skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
     }
 #else
-    return pf->skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
+    return skt_ops->recvfrom((int) sock->user_data, mem, len, flags, from, fromlen);
 #endif
 }
 
@@ -905,15 +931,15 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
                const struct sockaddr *to, socklen_t tolen)
 {
     struct sal_socket *sock;
-    struct sal_proto_family *pf;
+    const struct sal_socket_ops *skt_ops;
 
     /* get the socket object by socket descriptor */
     SAL_SOCKET_OBJ_GET(sock, socket);
 
     /* check the network interface is up status  */
     SAL_NETDEV_IS_UP(sock->netdev);
-    /* check the network interface socket opreation */
-    SAL_NETDEV_SOCKETOPS_VALID(sock->netdev, pf, sendto);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, sendto);
 
 #ifdef SAL_USING_TLS
     if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, send))
@@ -928,13 +954,246 @@ int sal_sendto(int socket, const void *dataptr, size_t size, int flags,
     }
     else
     {
-        return pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+        return skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
     }
 #else
-    return pf->skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
+    return skt_ops->sendto((int) sock->user_data, dataptr, size, flags, to, tolen);
 #endif
 }
 
+static int sal_msghdr_len(const struct msghdr *message, size_t *len)
+{
+    int i;
+
+    *len = 0;
+    if (message == RT_NULL || message->msg_iovlen < 0 ||
+        (message->msg_iov == RT_NULL && message->msg_iovlen > 0))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < message->msg_iovlen; i++)
+    {
+        *len += message->msg_iov[i].iov_len;
+    }
+
+    return 0;
+}
+
+int sal_recvmsg(int socket, struct msghdr *message, int flags)
+{
+    struct sal_socket *sock;
+    const struct sal_socket_ops *skt_ops;
+    size_t len, offset;
+    uint8_t *buf;
+    int ret, i;
+
+    if (sal_msghdr_len(message, &len) < 0)
+    {
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, recvfrom);
+
+#ifdef SAL_USING_TLS
+    if (skt_ops->recvmsg && !SAL_SOCKOPS_PROTO_TLS_VALID(sock, recv))
+#else
+    if (skt_ops->recvmsg)
+#endif
+    {
+        return skt_ops->recvmsg((int) sock->user_data, message, flags);
+    }
+
+    message->msg_flags = 0;
+    message->msg_controllen = 0;
+
+    if (message->msg_iovlen <= 1)
+    {
+        return sal_recvfrom(socket, message->msg_iovlen ? message->msg_iov[0].iov_base : RT_NULL, len, flags,
+                            (struct sockaddr *) message->msg_name, &message->msg_namelen);
+    }
+
+    /* receive to a bounce buffer and scatter it to the iovecs */
+    buf = rt_malloc(len);
+    if (buf == RT_NULL)
+    {
+        return -1;
+    }
+
+    ret = sal_recvfrom(socket, buf, len, flags, (struct sockaddr *) message->msg_name, &message->msg_namelen);
+    for (i = 0, offset = 0; ret > 0 && offset < (size_t) ret; i++)
+    {
+        size_t copy_len = message->msg_iov[i].iov_len;
+
+        if (copy_len > (size_t) ret - offset)
+        {
+            copy_len = (size_t) ret - offset;
+        }
+        rt_memcpy(message->msg_iov[i].iov_base, buf + offset, copy_len);
+        offset += copy_len;
+    }
+    rt_free(buf);
+
+    return ret;
+}
+
+int sal_sendmsg(int socket, const struct msghdr *message, int flags)
+{
+    struct sal_socket *sock;
+    const struct sal_socket_ops *skt_ops;
+    size_t len, offset;
+    uint8_t *buf;
+    int ret, i;
+
+    if (sal_msghdr_len(message, &len) < 0)
+    {
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, sendto);
+
+#ifdef SAL_USING_TLS
+    if (skt_ops->sendmsg && !SAL_SOCKOPS_PROTO_TLS_VALID(sock, send))
+#else
+    if (skt_ops->sendmsg)
+#endif
+    {
+        return skt_ops->sendmsg((int) sock->user_data, message, flags);
+    }
+
+    if (message->msg_iovlen <= 1)
+    {
+        return sal_sendto(socket, message->msg_iovlen ? message->msg_iov[0].iov_base : RT_NULL, len, flags,
+                          (const struct sockaddr *) message->msg_name, message->msg_namelen);
+    }
+
+    if (sock->type == SOCK_STREAM)
+    {
+        /* a stream has no message boundaries, send the iovecs one by one */
+        for (i = 0, offset = 0; i < message->msg_iovlen; i++)
+        {
+            if (message->msg_iov[i].iov_len == 0)
+            {
+                continue;
+            }
+
+            ret = sal_sendto(socket, message->msg_iov[i].iov_base, message->msg_iov[i].iov_len, flags, RT_NULL, 0);
+            if (ret < 0)
+            {
+                return offset ? (int) offset : ret;
+            }
+
+            offset += ret;
+            if ((size_t) ret < message->msg_iov[i].iov_len)
+            {
+                break;
+            }
+        }
+
+        return (int) offset;
+    }
+
+    /* gather the iovecs to a bounce buffer to send them as one datagram */
+    buf = rt_malloc(len);
+    if (buf == RT_NULL)
+    {
+        return -1;
+    }
+
+    for (i = 0, offset = 0; i < message->msg_iovlen; i++)
+    {
+        rt_memcpy(buf + offset, message->msg_iov[i].iov_base, message->msg_iov[i].iov_len);
+        offset += message->msg_iov[i].iov_len;
+    }
+
+    ret = sal_sendto(socket, buf, len, flags, (const struct sockaddr *) message->msg_name, message->msg_namelen);
+    rt_free(buf);
+
+    return ret;
+}
+
+/*
+ * Send the data without copying it, the buffer must not be changed until done() is called.
+ * done() is called once for every call which doesn't fail, it may run in the protocol stack thread.
+ */
+int sal_send_zc(int socket, const void *data, size_t size, int flags, sal_zc_done_t done, void *arg)
+{
+    struct sal_socket *sock;
+    const struct sal_socket_ops *skt_ops;
+
+    if (data == RT_NULL || size == 0 || done == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, send_zc);
+
+#ifdef SAL_USING_TLS
+    /* the TLS records are encrypted to a new buffer */
+    if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, send))
+    {
+        rt_set_errno(-EOPNOTSUPP);
+        return -1;
+    }
+#endif
+
+    return skt_ops->send_zc((int) sock->user_data, data, size, flags, done, arg);
+}
+
+/*
+ * Receive the data in the protocol stack buffer chain, the caller owns *p and
+ * releases it by pbuf_free(). Return the length of the chain, 0 on connection closed.
+ */
+int sal_recv_pbuf(int socket, struct pbuf **p, int flags)
+{
+    struct sal_socket *sock;
+    const struct sal_socket_ops *skt_ops;
+
+    if (p == RT_NULL)
+    {
+        rt_set_errno(-EINVAL);
+        return -1;
+    }
+    *p = RT_NULL;
+
+    /* get the socket object by socket descriptor */
+    SAL_SOCKET_OBJ_GET(sock, socket);
+
+    /* check the network interface is up status  */
+    SAL_NETDEV_IS_UP(sock->netdev);
+    /* check the cached socket opreation, it's the data path */
+    SAL_SOCKET_OPS_VALID(sock, skt_ops, recv_pbuf);
+
+#ifdef SAL_USING_TLS
+    if (SAL_SOCKOPS_PROTO_TLS_VALID(sock, recv))
+    {
+        rt_set_errno(-EOPNOTSUPP);
+        return -1;
+    }
+#endif
+
+    return skt_ops->recv_pbuf((int) sock->user_data, p, flags);
+}
+
 int sal_socket(int domain, int type, int protocol)
 {
     int retval;
@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/* The mbedTLS options proto_mbedtls.c tests, the library is simulated by the test */
+
+#define MBEDTLS_SSL_CLI_C
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/* The configuration of the host build */
+
+#ifndef RT_CONFIG_H__
+#define RT_CONFIG_H__
+
+#define RT_NAME_MAX 8
+#define RT_ALIGN_SIZE 8
+#define RT_THREAD_PRIORITY_32
+#define RT_THREAD_PRIORITY_MAX 32
+#define RT_TICK_PER_SECOND 1000
+#define RT_USING_SEMAPHORE
+#define RT_USING_MUTEX
+#define RT_USING_EVENT
+#define RT_USING_MAILBOX
+#define RT_USING_MESSAGEQUEUE
+#define RT_USING_HEAP
+#define RT_USING_DEVICE
+#define RT_KSERVICE_USING_STDLIB
+#define RT_KSERVICE_USING_STDLIB_MEMORY
+
+#define RT_USING_NETDEV
+#define NETDEV_IPV4 1
+#define NETDEV_IPV6 0
+#define RT_USING_SAL
+#define SAL_USING_TLS
+#ifndef SAL_TLS_SESSION_CACHE_NUM
+#define SAL_TLS_SESSION_CACHE_NUM 4
+#endif
+#define SAL_TLS_SESSION_CACHE_TIMEOUT 3600
+
+#endif
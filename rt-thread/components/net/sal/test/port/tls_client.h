@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The parts of the mbedtls package proto_mbedtls.c uses. The SSL context and
+ * the session only hold what the test's handshake needs: the session ID and
+ * the session offered to the server.
+ */
+
+#ifndef __TLS_CLIENT_H__
+#define __TLS_CLIENT_H__
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#define MBEDTLS_ERR_SSL_WANT_READ       -0x6900
+#define MBEDTLS_ERR_SSL_WANT_WRITE      -0x6880
+#define MBEDTLS_ERR_NET_CONN_RESET      -0x0050
+#define MBEDTLS_ERR_NET_SEND_FAILED     -0x004E
+#define MBEDTLS_ERR_NET_RECV_FAILED     -0x004C
+
+typedef struct
+{
+    size_t id_len;
+    unsigned char id[32];
+} mbedtls_ssl_session;
+
+typedef struct
+{
+    const mbedtls_ssl_session *offered;
+    mbedtls_ssl_session session;
+} mbedtls_ssl_context;
+
+typedef struct
+{
+    int fd;
+} mbedtls_net_context;
+
+typedef int mbedtls_ssl_send_t(void *ctx, const unsigned char *buf, size_t len);
+typedef int mbedtls_ssl_recv_t(void *ctx, unsigned char *buf, size_t len);
+typedef int mbedtls_ssl_recv_timeout_t(void *ctx, unsigned char *buf, size_t len, unsigned int timeout);
+
+typedef struct MbedTLSSession
+{
+    char *host;
+    char *port;
+    unsigned char *buffer;
+    size_t buffer_len;
+    mbedtls_ssl_context ssl;
+    mbedtls_net_context server_fd;
+} MbedTLSSession;
+
+#define tls_calloc  calloc
+#define tls_free    free
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session);
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl, mbedtls_ssl_session *session);
+int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl);
+unsigned int mbedtls_ssl_get_verify_result(const mbedtls_ssl_context *ssl);
+int mbedtls_x509_crt_verify_info(char *buf, size_t size, const char *prefix, unsigned int flags);
+void mbedtls_ssl_set_bio(mbedtls_ssl_context *ssl, void *p_bio, mbedtls_ssl_send_t *f_send,
+                         mbedtls_ssl_recv_t *f_recv, mbedtls_ssl_recv_timeout_t *f_recv_timeout);
+
+int mbedtls_client_init(MbedTLSSession *session, void *entropy, size_t entropyLen);
+int mbedtls_client_context(MbedTLSSession *session);
+int mbedtls_client_close(MbedTLSSession *session);
+int mbedtls_client_read(MbedTLSSession *session, unsigned char *buf, size_t len);
+int mbedtls_client_write(MbedTLSSession *session, const unsigned char *buf, size_t len);
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * Tests of the TLS session cache of proto_mbedtls.c on the build host. The
+ * handshakes are simulated: the server resumes the offered session unless
+ * told not to, otherwise it hands out a new session ID. The connections are
+ * made through the protocol ops the SAL calls, the cache must offer the
+ * session of a server name and port only, forget it on a failed handshake,
+ * expire it and evict the oldest one when it's full.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../impl/proto_mbedtls.c"
+
+/* the servers of the first cases are cached at once */
+#if SAL_TLS_SESSION_CACHE_NUM < 4
+#error "the test needs SAL_TLS_SESSION_CACHE_NUM 4 at least"
+#endif
+
+#define TEST_TIMEOUT    rt_tick_from_millisecond(SAL_TLS_SESSION_CACHE_TIMEOUT * 1000)
+
+static const struct sal_proto_tls *test_proto;
+static rt_tick_t test_tick = 1000;
+/* the server the socket is connected to */
+static rt_uint32_t test_ip;
+static rt_uint16_t test_port;
+/* the behaviour of the next handshake */
+static int test_refuse, test_fail;
+/* the ID of the session offered to the last handshake, 0 if none */
+static rt_uint32_t test_offered;
+static rt_uint32_t test_next_id = 1;
+static int failed;
+
+rt_tick_t rt_tick_get(void)
+{
+    return test_tick;
+}
+
+rt_tick_t rt_tick_from_millisecond(rt_int32_t ms)
+{
+    return (rt_tick_t)ms * RT_TICK_PER_SECOND / 1000;
+}
+
+rt_err_t rt_mutex_init(rt_mutex_t mutex, const char *name, rt_uint8_t flag)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
+{
+    return RT_EOK;
+}
+
+rt_err_t rt_mutex_release(rt_mutex_t mutex)
+{
+    return RT_EOK;
+}
+
+int sal_proto_tls_register(const struct sal_proto_tls *pt)
+{
+    test_proto = pt;
+    return 0;
+}
+
+struct sal_socket *sal_get_socket(int socket)
+{
+    return RT_NULL;
+}
+
+int sal_getpeername(int socket, struct sockaddr *name, socklen_t *namelen)
+{
+    struct sockaddr_in *addr = (struct sockaddr_in *)name;
+
+    rt_memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(test_port);
+    addr->sin_addr.s_addr = test_ip;
+    *namelen = sizeof(*addr);
+    return 0;
+}
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session)
+{
+    rt_memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
+{
+    rt_memset(session, 0, sizeof(*session));
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl, const mbedtls_ssl_session *session)
+{
+    ssl->offered = session;
+    return 0;
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl, mbedtls_ssl_session *session)
+{
+    *session = ssl->session;
+    return 0;
+}
+
+int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl)
+{
+    test_offered = 0;
+    if (ssl->offered)
+    {
+        rt_memcpy(&test_offered, ssl->offered->id, sizeof(test_offered));
+    }
+    if (test_fail)
+    {
+        return -1;
+    }
+
+    /* the server echoes the ID of the session it resumes */
+    if (ssl->offered && !test_refuse)
+    {
+        ssl->session = *ssl->offered;
+    }
+    else
+    {
+        ssl->session.id_len = sizeof(test_next_id);
+        rt_memcpy(ssl->session.id, &test_next_id, sizeof(test_next_id));
+        test_next_id++;
+    }
+    return 0;
+}
+
+unsigned int mbedtls_ssl_get_verify_result(const mbedtls_ssl_context *ssl)
+{
+    return 0;
+}
+
+int mbedtls_x509_crt_verify_info(char *buf, size_t size, const char *prefix, unsigned int flags)
+{
+    return 0;
+}
+
+void mbedtls_ssl_set_bio(mbedtls_ssl_context *ssl, void *p_bio, mbedtls_ssl_send_t *f_send,
+                         mbedtls_ssl_recv_t *f_recv, mbedtls_ssl_recv_timeout_t *f_recv_timeout)
+{
+}
+
+int mbedtls_client_init(MbedTLSSession *session, void *entropy, size_t entropyLen)
+{
+    return 0;
+}
+
+int mbedtls_client_context(MbedTLSSession *session)
+{
+    return 0;
+}
+
+int mbedtls_client_close(MbedTLSSession *session)
+{
+    tls_free(session->host);
+    tls_free(session->buffer);
+    tls_free(session);
+    return 0;
+}
+
+int mbedtls_client_read(MbedTLSSession *session, unsigned char *buf, size_t len)
+{
+    return 0;
+}
+
+int mbedtls_client_write(MbedTLSSession *session, const unsigned char *buf, size_t len)
+{
+    return 0;
+}
+
+/* connects to the server, returns the ID of the offered session, 0 if none or -1 on error */
+static int test_connect(const char *host, rt_uint32_t ip, rt_uint16_t port)
+{
+    void *session;
+
+    test_ip = ip;
+    test_port = port;
+    test_tick++;
+
+    session = test_proto->ops->socket(3);
+    if (session == RT_NULL)
+    {
+        return -1;
+    }
+    if (host && test_proto->ops->set_hostname(session, host, rt_strlen(host)) != 0)
+    {
+        mbedtls_client_close(session);
+        return -1;
+    }
+    /* a failed connect closes the session */
+    if (test_proto->ops->connect(session) != 0)
+    {
+        return test_fail ? 0 : -1;
+    }
+    mbedtls_client_close(session);
+
+    return (int)test_offered;
+}
+
+#define TEST_CHECK(x)                                                       \
+    do                                                                      \
+    {                                                                       \
+        if (!(x))                                                           \
+        {                                                                   \
+            printf("check failed: %s, line %d\n", #x, __LINE__);            \
+            failed++;                                                       \
+        }                                                                   \
+    } while (0)
+
+int main(void)
+{
+    char name[SAL_TLS_SESSION_HOST_LEN + 1];
+    int id, i;
+
+    sal_mbedtls_proto_init();
+
+    /* the second connection to the name and port resumes the session */
+    id = test_connect("a.example", 1, 443);
+    TEST_CHECK(id == 0);
+    id = test_connect("a.example", 1, 443);
+    TEST_CHECK(id > 0 && session_cache_stat.resumed == 1);
+    /* another name at the same address and another port aren't resumed */
+    TEST_CHECK(test_connect("b.example", 1, 443) == 0);
+    TEST_CHECK(test_connect("a.example", 1, 8443) == 0);
+    TEST_CHECK(test_connect("a.example.evil", 1, 443) == 0);
+    /* the name moved to another address is */
+    TEST_CHECK(test_connect("a.example", 2, 443) == id);
+    TEST_CHECK(test_connect("b.example", 1, 443) > 0);
+
+    /* without a name or with a name too long the session isn't cached */
+    i = session_cache_stat.stored;
+    TEST_CHECK(test_connect(RT_NULL, 1, 443) == 0);
+    TEST_CHECK(test_connect(RT_NULL, 1, 443) == 0);
+    rt_memset(name, 'n', SAL_TLS_SESSION_HOST_LEN);
+    name[SAL_TLS_SESSION_HOST_LEN] = '\0';
+    TEST_CHECK(test_connect(name, 1, 443) == 0);
+    TEST_CHECK(test_connect(name, 1, 443) == 0);
+    TEST_CHECK((int)session_cache_stat.stored == i);
+
+    /* the server refuses the session, the new one replaces it */
+    i = session_cache_stat.resumed;
+    test_refuse = 1;
+    TEST_CHECK(test_connect("a.example", 1, 443) == id);
+    test_refuse = 0;
+    TEST_CHECK((int)session_cache_stat.resumed == i);
+    id = test_connect("a.example", 1, 443);
+    TEST_CHECK(id > 0 && (int)session_cache_stat.resumed == i + 1);
+
+    /* a failed handshake forgets the session */
+    test_fail = 1;
+    TEST_CHECK(test_connect("a.example", 1, 443) == 0 && test_offered != 0);
+    test_fail = 0;
+    TEST_CHECK(test_connect("a.example", 1, 443) == 0);
+    TEST_CHECK(test_connect("a.example", 1, 443) > 0);
+
+    /* the sessions expire */
+    test_tick += TEST_TIMEOUT;
+    TEST_CHECK(test_connect("a.example", 1, 443) == 0);
+    TEST_CHECK(test_connect("b.example", 1, 443) == 0);
+    TEST_CHECK(test_connect("a.example", 1, 443) > 0);
+
+    /* a full cache replaces the oldest session */
+    test_tick += TEST_TIMEOUT;
+    for (i = 0; i <= SAL_TLS_SESSION_CACHE_NUM; i++)
+    {
+        snprintf(name, sizeof(name), "c%d.example", i);
+        TEST_CHECK(test_connect(name, 1, 443) == 0);
+    }
+    for (i = SAL_TLS_SESSION_CACHE_NUM; i > 0; i--)
+    {
+        snprintf(name, sizeof(name), "c%d.example", i);
+        TEST_CHECK(test_connect(name, 1, 443) > 0);
+    }
+    TEST_CHECK(test_connect("c0.example", 1, 443) == 0);
+
+    printf("hit %u, miss %u, resumed %u, stored %u\n", session_cache_stat.hit, session_cache_stat.miss,
+           session_cache_stat.resumed, session_cache_stat.stored);
+    printf("%s\n", failed ? "FAILED" : "OK");
+    return failed != 0;
+}
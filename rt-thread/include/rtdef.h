@@ -415,6 +415,9 @@ struct rt_object
     void      *module_id;                               /**< id of application module */
 #endif /* RT_USING_MODULE */
     rt_list_t  list;                                    /**< list node of kernel object */
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object *hash_next;                        /**< next object in the name hash bucket */
+#endif /* RT_USING_OBJECT_HASH */
 };
 typedef struct rt_object *rt_object_t;                  /**< Type for kernel objects. */
 
@@ -634,6 +637,30 @@ struct rt_cpu
 
 #endif /* RT_USING_SMP */
 
+struct rt_ipc_prio_index;
+
+#ifdef RT_USING_SCHED_EDF
+/**
+ * Earliest deadline first parameters and statistics of a periodic thread
+ */
+struct rt_sched_edf
+{
+    rt_tick_t   period;                                 /**< release period, 0 if the thread isn't attached */
+    rt_tick_t   budget;                                 /**< execution ticks reserved for each job */
+    rt_tick_t   deadline;                               /**< deadline relative to the release */
+    rt_tick_t   release;                                /**< release tick of the current job */
+    rt_tick_t   abs_deadline;                           /**< absolute deadline of the current job */
+    rt_tick_t   used;                                   /**< ticks used by the current job */
+    rt_uint32_t util;                                   /**< reserved utilization, in 1/65536 */
+    rt_uint8_t  priority;                               /**< priority before the thread is attached */
+
+    rt_uint32_t jobs;                                   /**< completed jobs */
+    rt_uint32_t misses;                                 /**< jobs completed after their deadline */
+    rt_uint32_t overruns;                               /**< jobs that used more than their budget */
+    rt_tick_t   max_lateness;                           /**< maximum ticks a job completed late */
+};
+#endif /* RT_USING_SCHED_EDF */
+
 /**
  * Thread structure
  */
@@ -657,6 +684,9 @@ struct rt_thread
     void       *parameter;                              /**< parameter */
     void       *stack_addr;                             /**< stack address */
     rt_uint32_t stack_size;                             /**< stack size */
+#ifdef RT_USING_STACK_WATERMARK
+    rt_uint32_t stack_clean;                            /**< untouched bytes at the end of stack */
+#endif /* RT_USING_STACK_WATERMARK */
 
     /* error code */
     rt_err_t    error;                                  /**< error code */
@@ -687,6 +717,11 @@ struct rt_thread
     rt_object_t pending_object;
 #endif
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    struct rt_ipc_prio_index *pend_index;               /**< index of the suspend list the thread is in */
+    rt_uint8_t  pend_priority;                          /**< priority the thread is indexed with */
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+
 #ifdef RT_USING_EVENT
     /* thread event */
     rt_uint32_t event_set;
@@ -707,6 +742,10 @@ struct rt_thread
     rt_ubase_t  init_tick;                              /**< thread's initialized tick */
     rt_ubase_t  remaining_tick;                         /**< remaining tick */
 
+#ifdef RT_USING_SCHED_EDF
+    struct rt_sched_edf edf;                            /**< earliest deadline first parameters */
+#endif /* RT_USING_SCHED_EDF */
+
 #ifdef RT_USING_CPU_USAGE
     rt_uint64_t  duration_tick;                         /**< cpu usage tick */
 #endif /* RT_USING_CPU_USAGE */
@@ -748,6 +787,18 @@ typedef struct rt_thread *rt_thread_t;
 #define RT_WAITING_FOREVER              -1              /**< Block forever until get resource. */
 #define RT_WAITING_NO                   0               /**< Non-block. */
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+/**
+ * Index of a priority ordered suspend list
+ */
+struct rt_ipc_prio_index
+{
+    rt_list_t       *list;                              /**< the indexed suspend list */
+    rt_uint32_t      bitmap;                            /**< priorities of the pended threads */
+    struct rt_thread *tail[RT_THREAD_PRIORITY_MAX];     /**< last pended thread of each priority */
+};
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+
 /**
  * Base structure of IPC object
  */
@@ -756,6 +807,9 @@ struct rt_ipc_object
     struct rt_object parent;                            /**< inherit from rt_object */
 
     rt_list_t        suspend_thread;                    /**< threads pended on this resource */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    struct rt_ipc_prio_index suspend_index;             /**< index of the suspend list */
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 };
 
 #ifdef RT_USING_SEMAPHORE
@@ -828,6 +882,9 @@ struct rt_mailbox
     rt_uint16_t          out_offset;                    /**< output offset of the message buffer */
 
     rt_list_t            suspend_sender_thread;         /**< sender thread suspended on this mailbox */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    struct rt_ipc_prio_index suspend_sender_index;      /**< index of the sender suspend list */
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 };
 typedef struct rt_mailbox *rt_mailbox_t;
 #endif /* RT_USING_MAILBOX */
@@ -852,6 +909,9 @@ struct rt_messagequeue
     void                *msg_queue_free;                /**< pointer indicated the free node of queue */
 
     rt_list_t            suspend_sender_thread;         /**< sender thread suspended on this message queue */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    struct rt_ipc_prio_index suspend_sender_index;      /**< index of the sender suspend list */
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 };
 typedef struct rt_messagequeue *rt_mq_t;
 #endif /* RT_USING_MESSAGEQUEUE */
@@ -878,6 +938,25 @@ struct rt_memory
     rt_size_t               max;                    /**< maximum usage */
 };
 typedef struct rt_memory *rt_mem_t;
+
+#ifdef RT_USING_MEMPROF
+#define RT_MEMPROF_HIST_NUM             8               /**< <= 16, <= 32, ... <= 1024, > 1024 bytes */
+
+/**
+ * heap profiler statistics of an allocation call site
+ */
+struct rt_memprof_site
+{
+    void                   *caller;                     /**< return address of the allocation */
+    rt_uint32_t             alloc_count;                /**< numbers of allocation */
+    rt_uint32_t             free_count;                 /**< numbers of release */
+    rt_uint32_t             fail_count;                 /**< numbers of failed allocation */
+    rt_uint32_t             live_bytes;                 /**< bytes allocated and not released */
+    rt_uint32_t             max_live_bytes;             /**< maximum of live bytes */
+    rt_uint32_t             max_time;                   /**< maximum time of allocation */
+    rt_uint32_t             hist[RT_MEMPROF_HIST_NUM];  /**< histogram of allocation size */
+};
+#endif /* RT_USING_MEMPROF */
 #endif /* RT_USING_HEAP */
 
 /*
@@ -953,8 +1032,29 @@ struct rt_mempool
     rt_size_t        block_free_count;                  /**< numbers of free memory block */
 
     rt_list_t        suspend_thread;                    /**< threads pended on this resource */
+
+#ifdef RT_USING_MEMPOOL_STATS
+    rt_size_t        max_used;                          /**< maximum used blocks */
+    rt_uint32_t      fail_count;                        /**< numbers of failed allocation */
+    rt_uint32_t      wait_count;                        /**< numbers of allocation waited */
+    rt_tick_t        wait_tick;                         /**< total ticks of allocation waited */
+#endif /* RT_USING_MEMPOOL_STATS */
 };
 typedef struct rt_mempool *rt_mp_t;
+
+#ifdef RT_USING_MEMPOOL_CACHE
+/**
+ * thread local cache of memory pool, it shall be used by one thread only
+ */
+struct rt_mp_cache
+{
+    rt_mp_t          mp;                                /**< the memory pool cached */
+    rt_uint8_t      *block_list;                        /**< cached free blocks list */
+    rt_uint16_t      count;                             /**< numbers of cached block */
+    rt_uint16_t      size;                              /**< maximum cached blocks */
+};
+typedef struct rt_mp_cache *rt_mp_cache_t;
+#endif /* RT_USING_MEMPOOL_CACHE */
 #endif /* RT_USING_MEMPOOL */
 
 /**@}*/
@@ -160,6 +160,19 @@ rt_err_t rt_thread_control(rt_thread_t thread, int cmd, void *arg);
 rt_err_t rt_thread_suspend(rt_thread_t thread);
 rt_err_t rt_thread_resume(rt_thread_t thread);
 
+#ifdef RT_USING_SCHED_EDF
+rt_err_t rt_thread_edf_attach(rt_thread_t thread, rt_tick_t period, rt_tick_t budget, rt_tick_t deadline);
+rt_err_t rt_thread_edf_detach(rt_thread_t thread);
+rt_err_t rt_thread_edf_wait(void);
+void rt_sched_edf_exit(rt_thread_t thread);
+#endif /* RT_USING_SCHED_EDF */
+
+#ifdef RT_USING_STACK_WATERMARK
+void rt_thread_stack_scan(rt_size_t budget);
+rt_size_t rt_thread_stack_max_used(rt_thread_t thread);
+void rt_thread_stack_watermark_exit(rt_thread_t thread);
+#endif /* RT_USING_STACK_WATERMARK */
+
 #ifdef RT_USING_SIGNALS
 void rt_thread_alloc_sig(rt_thread_t tid);
 void rt_thread_free_sig(rt_thread_t tid);
@@ -250,6 +263,13 @@ rt_err_t rt_mp_delete(rt_mp_t mp);
 void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time);
 void rt_mp_free(void *block);
 
+#ifdef RT_USING_MEMPOOL_CACHE
+rt_err_t rt_mp_cache_init(struct rt_mp_cache *cache, rt_mp_t mp, rt_uint16_t size);
+void *rt_mp_cache_alloc(struct rt_mp_cache *cache, rt_int32_t time);
+void rt_mp_cache_free(struct rt_mp_cache *cache, void *block);
+void rt_mp_cache_flush(struct rt_mp_cache *cache);
+#endif /* RT_USING_MEMPOOL_CACHE */
+
 #ifdef RT_USING_HOOK
 void rt_mp_alloc_sethook(void (*hook)(struct rt_mempool *mp, void *block));
 void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block));
@@ -284,6 +304,29 @@ void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size));
 void rt_free_sethook(void (*hook)(void *ptr));
 #endif
 
+#ifdef RT_USING_MEMPROF
+/*
+ * heap profiler interface
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define RT_MEMPROF_CALLER()     __builtin_return_address(0)
+#elif defined(__CC_ARM)
+#define RT_MEMPROF_CALLER()     ((void *)__return_address())
+#else
+#define RT_MEMPROF_CALLER()     RT_NULL
+#endif
+
+rt_uint32_t rt_memprof_clock(void);
+void rt_memprof_malloc(void *ptr, rt_size_t size, void *caller, rt_uint32_t time);
+void rt_memprof_realloc(void *rmem, void *nptr, rt_size_t newsize, void *caller, rt_uint32_t time);
+void rt_memprof_free(void *ptr);
+void rt_memprof_retag(void *ptr, void *caller);
+rt_err_t rt_memprof_site_get(int index, struct rt_memprof_site *site);
+rt_size_t rt_memprof_thread_live(rt_thread_t thread, rt_size_t *blocks);
+void rt_memprof_reset(void);
+rt_size_t rt_memprof_dump(void *buf, rt_size_t size);
+#endif /* RT_USING_MEMPROF */
+
 #endif
 
 #ifdef RT_USING_SMALL_MEM
@@ -338,6 +381,10 @@ void rt_slab_free(rt_slab_t m, void *ptr);
 
 /**@{*/
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+void rt_ipc_prio_remove(struct rt_thread *thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+
 #ifdef RT_USING_SEMAPHORE
 /*
  * semaphore interface
@@ -451,6 +498,10 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
                     void      *buffer,
                     rt_size_t  size,
                     rt_int32_t timeout);
+rt_err_t rt_mq_alloc(rt_mq_t mq, void **buffer, rt_int32_t timeout);
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer);
+rt_err_t rt_mq_fetch(rt_mq_t mq, void **buffer, rt_int32_t timeout);
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer);
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
 #endif
 
@@ -226,6 +226,12 @@ static void usage_fault_track(void)
         rt_kprintf("NOCP ");
     }
 
+    if (SCB_CFSR_UFSR & (1 << 4))
+    {
+        /* [4]:STKOF, the stack pointer went below the PSPLIM or MSPLIM */
+        rt_kprintf("STKOF ");
+    }
+
     if (SCB_CFSR_UFSR & (1 << 8))
     {
         /* [8]:UNALIGNED */
@@ -427,7 +433,8 @@ void rt_hw_hard_fault_exception(struct exception_info *exception_info)
 
 void TaskSwitch_StackCheck(void)
 {
-    volatile rt_uint32_t end_of_stack_val = (rt_uint32_t) rt_thread_self()->stack_addr;
+    /* PSPLIM[2:0] are RES0, round up so the limit stays inside the stack */
+    volatile rt_uint32_t end_of_stack_val = RT_ALIGN((rt_uint32_t) rt_thread_self()->stack_addr, 8);
     __asm volatile("MSR psplim, %0" : : "r"(end_of_stack_val));
 }
 
@@ -107,6 +107,12 @@ void rt_tick_increase(void)
     /* check time slice */
     thread = rt_thread_self();
 
+#ifdef RT_USING_SCHED_EDF
+    /* account the budget of the current job */
+    if (thread->edf.period != 0)
+        thread->edf.used ++;
+#endif /* RT_USING_SCHED_EDF */
+
     -- thread->remaining_tick;
     if (thread->remaining_tick == 0)
     {
@@ -280,6 +280,10 @@ static void idle_thread_entry(void *parameter)
         rt_defunct_execute();
 #endif /* RT_USING_SMP */
 
+#ifdef RT_USING_STACK_WATERMARK
+        rt_thread_stack_scan(RT_STACK_WATERMARK_SCAN_SIZE);
+#endif /* RT_USING_STACK_WATERMARK */
+
 #ifdef RT_USING_PM
         void rt_system_power_manager(void);
         rt_system_power_manager();
@@ -71,6 +71,115 @@ extern void (*rt_object_put_hook)(struct rt_object *object);
 
 /**@{*/
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+/* the suspend list index of an IPC object, or RT_NULL when the option is disabled */
+#define _IPC_INDEX(index)       (&(index))
+
+/**
+ * @brief    This function will initialize the index of a priority ordered suspend list.
+ *
+ * @param    index is a pointer to the index.
+ *
+ * @param    list is a pointer to the indexed suspend list.
+ */
+rt_inline void _ipc_prio_index_init(struct rt_ipc_prio_index *index, rt_list_t *list)
+{
+    rt_memset(index, 0x0, sizeof(struct rt_ipc_prio_index));
+    index->list = list;
+}
+
+/**
+ * @brief    This function will find the last set bit of a priority bitmap.
+ *
+ * @param    value is the bitmap, it shall not be zero.
+ *
+ * @return   Return the index of the highest set bit, which is the lowest priority in the bitmap.
+ */
+rt_inline rt_uint8_t _ipc_prio_fls(rt_uint32_t value)
+{
+    rt_uint8_t bit = 0;
+
+    if (value & 0xffff0000UL) { value >>= 16; bit += 16; }
+    if (value & 0xff00UL)     { value >>= 8;  bit += 8;  }
+    if (value & 0xf0UL)       { value >>= 4;  bit += 4;  }
+    if (value & 0xcUL)        { value >>= 2;  bit += 2;  }
+    if (value & 0x2UL)        {               bit += 1;  }
+
+    return bit;
+}
+
+/**
+ * @brief    This function will insert a thread into a priority ordered suspend list by its index.
+ *
+ * @note     The thread is put after the last pended thread with the same or a higher priority,
+ *           so the threads of the same priority stay in the first-in-first-out order.
+ *
+ * @param    index is a pointer to the index of the suspend list.
+ *
+ * @param    thread is a pointer to the thread to be inserted.
+ */
+rt_inline void _ipc_prio_insert(struct rt_ipc_prio_index *index, struct rt_thread *thread)
+{
+    rt_uint8_t priority = thread->current_priority;
+    rt_uint32_t mask;
+
+    RT_ASSERT(priority < 32);
+
+    mask = index->bitmap & (0xffffffffUL >> (31 - priority));
+    if (mask)
+    {
+        rt_list_insert_after(&(index->tail[_ipc_prio_fls(mask)]->tlist), &(thread->tlist));
+    }
+    else
+    {
+        rt_list_insert_after(index->list, &(thread->tlist));
+    }
+
+    index->tail[priority] = thread;
+    index->bitmap |= 1UL << priority;
+    thread->pend_index = index;
+    thread->pend_priority = priority;
+}
+
+/**
+ * @brief    This function will drop a thread from the index of the suspend list it pends on.
+ *
+ * @note     It shall be called with interrupt disabled before the thread is removed from the
+ *           suspend list. Nothing is done if the thread is not indexed.
+ *
+ * @param    thread is a pointer to the thread.
+ */
+void rt_ipc_prio_remove(struct rt_thread *thread)
+{
+    struct rt_ipc_prio_index *index = thread->pend_index;
+    rt_uint8_t priority;
+
+    if (index == RT_NULL)
+        return;
+
+    priority = thread->pend_priority;
+    if (index->tail[priority] == thread)
+    {
+        struct rt_thread *prev = rt_list_entry(thread->tlist.prev, struct rt_thread, tlist);
+
+        /* the previous thread is the new tail if it is of the same priority */
+        if (thread->tlist.prev != index->list &&
+            prev->pend_index == index && prev->pend_priority == priority)
+        {
+            index->tail[priority] = prev;
+        }
+        else
+        {
+            index->tail[priority] = RT_NULL;
+            index->bitmap &= ~(1UL << priority);
+        }
+    }
+    thread->pend_index = RT_NULL;
+}
+#else
+#define _IPC_INDEX(index)       RT_NULL
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+
 /**
  * @brief    This function will initialize an IPC object, such as semaphore, mutex, messagequeue and mailbox.
  *
@@ -87,6 +196,9 @@ rt_inline rt_err_t _ipc_object_init(struct rt_ipc_object *ipc)
 {
     /* initialize ipc object */
     rt_list_init(&(ipc->suspend_thread));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    _ipc_prio_index_init(&(ipc->suspend_index), &(ipc->suspend_thread));
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 
     return RT_EOK;
 }
@@ -97,6 +209,8 @@ rt_inline rt_err_t _ipc_object_init(struct rt_ipc_object *ipc)
  *
  * @param    list is a pointer to a suspended thread list of the IPC object.
  *
+ * @param    index is a pointer to the index of the suspended thread list, or RT_NULL if it has no index.
+ *
  * @param    thread is a pointer to the thread object to be suspended.
  *
  * @param    flag is a flag for the thread object to be suspended. It determines how the thread is suspended.
@@ -121,9 +235,10 @@ rt_inline rt_err_t _ipc_object_init(struct rt_ipc_object *ipc)
  *           rt_sem_take(),  rt_mutex_take(),  rt_event_recv(),   rt_mb_send_wait(),
  *           rt_mb_recv(),   rt_mq_recv(),     rt_mq_send_wait()
  */
-rt_inline rt_err_t _ipc_list_suspend(rt_list_t        *list,
-                                     struct rt_thread *thread,
-                                     rt_uint8_t        flag)
+rt_inline rt_err_t _ipc_list_suspend(rt_list_t                *list,
+                                     struct rt_ipc_prio_index *index,
+                                     struct rt_thread         *thread,
+                                     rt_uint8_t                flag)
 {
     /* suspend thread */
     rt_thread_suspend(thread);
@@ -139,6 +254,14 @@ rt_inline rt_err_t _ipc_list_suspend(rt_list_t        *list,
             struct rt_list_node *n;
             struct rt_thread *sthread;
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+            if (index != RT_NULL)
+            {
+                _ipc_prio_insert(index, thread);
+                break;
+            }
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+
             /* find a suitable position */
             for (n = list->next; n != list; n = n->next)
             {
@@ -536,6 +659,7 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t timeout)
 
             /* suspend thread */
             _ipc_list_suspend(&(sem->parent.suspend_thread),
+                                _IPC_INDEX(sem->parent.suspend_index),
                                 thread,
                                 sem->parent.parent.flag);
 
@@ -766,8 +890,12 @@ rt_inline void _thread_update_priority(struct rt_thread *thread, rt_uint8_t prio
             struct rt_mutex* pending_mutex = (struct rt_mutex *)pending_obj;
 
             /* re-insert thread to suspended thread list */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+            rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
             rt_list_remove(&(thread->tlist));
             _ipc_list_suspend(&(pending_mutex->parent.suspend_thread),
+                                _IPC_INDEX(pending_mutex->parent.suspend_index),
                                 thread,
                                 pending_mutex->parent.parent.flag);
 
@@ -899,6 +1027,9 @@ void rt_mutex_drop_thread(rt_mutex_t mutex, rt_thread_t thread)
     rt_uint8_t priority;
     rt_bool_t need_update = RT_FALSE;
 
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
     rt_list_remove(&(thread->tlist));
 
     /* should change the priority of mutex owner thread */
@@ -1188,6 +1319,7 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t timeout)
 
                 /* suspend current thread */
                 _ipc_list_suspend(&(mutex->parent.suspend_thread),
+                                    _IPC_INDEX(mutex->parent.suspend_index),
                                     thread,
                                     mutex->parent.parent.flag);
                 /* set pending object in thread to this mutex */
@@ -1396,6 +1528,9 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
                     next_thread->name));
 
             /* remove the thread from the suspended list of mutex */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+            rt_ipc_prio_remove(next_thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
             rt_list_remove(&(next_thread->tlist));
 
             /* set new owner and put mutex into taken list of thread */
@@ -1889,6 +2024,7 @@ rt_err_t rt_event_recv(rt_event_t   event,
 
         /* put thread to suspended thread list */
         _ipc_list_suspend(&(event->parent.suspend_thread),
+                            _IPC_INDEX(event->parent.suspend_index),
                             thread,
                             event->parent.parent.flag);
 
@@ -2050,6 +2186,9 @@ rt_err_t rt_mb_init(rt_mailbox_t mb,
 
     /* initialize an additional list of sender suspend thread */
     rt_list_init(&(mb->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    _ipc_prio_index_init(&(mb->suspend_sender_index), &(mb->suspend_sender_thread));
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 
     return RT_EOK;
 }
@@ -2160,6 +2299,9 @@ rt_mailbox_t rt_mb_create(const char *name, rt_size_t size, rt_uint8_t flag)
 
     /* initialize an additional list of sender suspend thread */
     rt_list_init(&(mb->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    _ipc_prio_index_init(&(mb->suspend_sender_index), &(mb->suspend_sender_thread));
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 
     return mb;
 }
@@ -2283,6 +2425,7 @@ rt_err_t rt_mb_send_wait(rt_mailbox_t mb,
 
         /* suspend current thread */
         _ipc_list_suspend(&(mb->suspend_sender_thread),
+                            _IPC_INDEX(mb->suspend_sender_index),
                             thread,
                             mb->parent.parent.flag);
 
@@ -2538,6 +2681,7 @@ rt_err_t rt_mb_recv(rt_mailbox_t mb, rt_ubase_t *value, rt_int32_t timeout)
 
         /* suspend current thread */
         _ipc_list_suspend(&(mb->parent.suspend_thread),
+                            _IPC_INDEX(mb->parent.suspend_index),
                             thread,
                             mb->parent.parent.flag);
 
@@ -2778,6 +2922,9 @@ rt_err_t rt_mq_init(rt_mq_t     mq,
 
     /* initialize an additional list of sender suspend thread */
     rt_list_init(&(mq->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    _ipc_prio_index_init(&(mq->suspend_sender_index), &(mq->suspend_sender_thread));
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 
     return RT_EOK;
 }
@@ -2912,6 +3059,9 @@ rt_mq_t rt_mq_create(const char *name,
 
     /* initialize an additional list of sender suspend thread */
     rt_list_init(&(mq->suspend_sender_thread));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    _ipc_prio_index_init(&(mq->suspend_sender_index), &(mq->suspend_sender_thread));
+#endif /* RT_USING_IPC_PRIO_QUEUE */
 
     return mq;
 }
@@ -2964,71 +3114,34 @@ RTM_EXPORT(rt_mq_delete);
 
 
 /**
- * @brief    This function will send a message to the messagequeue object. If
- *           there is a thread suspended on the messagequeue, the thread will be
- *           resumed.
+ * @brief    This function will take a free message from the pool of the messagequeue object,
+ *           the thread shall wait for a free message up to the specified time.
  *
- * @note     When using this function to send a message, if the messagequeue is
- *           fully used, the current thread will wait for a timeout. If reaching
- *           the timeout and there is still no space available, the sending
- *           thread will be resumed and an error code will be returned. By
- *           contrast, the rt_mq_send() function will return an error code
- *           immediately without waiting when the messagequeue if fully used.
- *
- * @see      rt_mq_send()
- *
- * @param    mq is a pointer to the messagequeue object to be sent.
- *
- * @param    buffer is the content of the message.
+ * @param    mq is a pointer to the messagequeue object.
  *
- * @param    size is the length of the message(Unit: Byte).
+ * @param    msg is a pointer to store the free message.
  *
  * @param    timeout is a timeout period (unit: an OS tick).
  *
- * @return   Return the operation status. When the return value is RT_EOK, the
- *           operation is successful. If the return value is any other values,
- *           it means that the messagequeue detach failed.
- *
- * @warning  This function can be called in interrupt context and thread
- * context.
+ * @return   Return the operation status. When the return value is RT_EOK, the message is taken
+ *           from the free list. -RT_EFULL is returned if no message is free in time.
  */
-rt_err_t rt_mq_send_wait(rt_mq_t     mq,
-                         const void *buffer,
-                         rt_size_t   size,
-                         rt_int32_t  timeout)
+static rt_err_t _mq_msg_alloc(rt_mq_t mq, struct rt_mq_message **msg, rt_int32_t timeout)
 {
     rt_base_t level;
-    struct rt_mq_message *msg;
     rt_uint32_t tick_delta;
     struct rt_thread *thread;
 
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
-    /* current context checking */
-    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
-
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
-
     /* initialize delta tick */
     tick_delta = 0;
     /* get current thread */
     thread = rt_thread_self();
 
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
-
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
-    /* get a free list, there must be an empty item */
-    msg = (struct rt_mq_message *)mq->msg_queue_free;
     /* for non-blocking call */
-    if (msg == RT_NULL && timeout == 0)
+    if (mq->msg_queue_free == RT_NULL && timeout == 0)
     {
         /* enable interrupt */
         rt_hw_interrupt_enable(level);
@@ -3037,7 +3150,7 @@ rt_err_t rt_mq_send_wait(rt_mq_t     mq,
     }
 
     /* message queue is full */
-    while ((msg = (struct rt_mq_message *)mq->msg_queue_free) == RT_NULL)
+    while (mq->msg_queue_free == RT_NULL)
     {
         /* reset error number in thread */
         thread->error = RT_EOK;
@@ -3053,6 +3166,7 @@ rt_err_t rt_mq_send_wait(rt_mq_t     mq,
 
         /* suspend current thread */
         _ipc_list_suspend(&(mq->suspend_sender_thread),
+                            _IPC_INDEX(mq->suspend_sender_index),
                             thread,
                             mq->parent.parent.flag);
 
@@ -3099,15 +3213,31 @@ rt_err_t rt_mq_send_wait(rt_mq_t     mq,
     }
 
     /* move free list pointer */
-    mq->msg_queue_free = msg->next;
+    *msg = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = (*msg)->next;
 
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
 
+    return RT_EOK;
+}
+
+/**
+ * @brief    This function will link a filled message to the tail of the messagequeue object,
+ *           and resume a thread waiting for the message.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    msg is a pointer to the message taken by _mq_msg_alloc().
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the message is queued.
+ */
+static rt_err_t _mq_msg_send(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    rt_base_t level;
+
     /* the msg is the new tailer of list, the next shall be NULL */
     msg->next = RT_NULL;
-    /* copy buffer */
-    rt_memcpy(msg + 1, buffer, size);
 
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
@@ -3153,6 +3283,225 @@ rt_err_t rt_mq_send_wait(rt_mq_t     mq,
 
     return RT_EOK;
 }
+
+/**
+ * @brief    This function will take the message at the head of the messagequeue object,
+ *           the thread shall wait for a message up to the specified time.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    msg is a pointer to store the received message.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the message is taken
+ *           off the queue. -RT_ETIMEOUT is returned if no message arrives in time.
+ */
+static rt_err_t _mq_msg_recv(rt_mq_t mq, struct rt_mq_message **msg, rt_int32_t timeout)
+{
+    struct rt_thread *thread;
+    rt_base_t level;
+    rt_uint32_t tick_delta;
+
+    /* initialize delta tick */
+    tick_delta = 0;
+    /* get current thread */
+    thread = rt_thread_self();
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    /* for non-blocking call */
+    if (mq->entry == 0 && timeout == 0)
+    {
+        rt_hw_interrupt_enable(level);
+
+        return -RT_ETIMEOUT;
+    }
+
+    /* message queue is empty */
+    while (mq->entry == 0)
+    {
+        /* reset error number in thread */
+        thread->error = RT_EOK;
+
+        /* no waiting, return timeout */
+        if (timeout == 0)
+        {
+            /* enable interrupt */
+            rt_hw_interrupt_enable(level);
+
+            thread->error = -RT_ETIMEOUT;
+
+            return -RT_ETIMEOUT;
+        }
+
+        /* suspend current thread */
+        _ipc_list_suspend(&(mq->parent.suspend_thread),
+                            _IPC_INDEX(mq->parent.suspend_index),
+                            thread,
+                            mq->parent.parent.flag);
+
+        /* has waiting time, start thread timer */
+        if (timeout > 0)
+        {
+            /* get the start tick of timer */
+            tick_delta = rt_tick_get();
+
+            RT_DEBUG_LOG(RT_DEBUG_IPC, ("set thread:%s to timer list\n",
+                                        thread->name));
+
+            /* reset the timeout of thread timer and start it */
+            rt_timer_control(&(thread->thread_timer),
+                             RT_TIMER_CTRL_SET_TIME,
+                             &timeout);
+            rt_timer_start(&(thread->thread_timer));
+        }
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        /* re-schedule */
+        rt_schedule();
+
+        /* recv message */
+        if (thread->error != RT_EOK)
+        {
+            /* return error */
+            return thread->error;
+        }
+
+        /* disable interrupt */
+        level = rt_hw_interrupt_disable();
+
+        /* if it's not waiting forever and then re-calculate timeout tick */
+        if (timeout > 0)
+        {
+            tick_delta = rt_tick_get() - tick_delta;
+            timeout -= tick_delta;
+            if (timeout < 0)
+                timeout = 0;
+        }
+    }
+
+    /* get message from queue */
+    *msg = (struct rt_mq_message *)mq->msg_queue_head;
+
+    /* move message queue head */
+    mq->msg_queue_head = (*msg)->next;
+    /* reach queue tail, set to NULL */
+    if (mq->msg_queue_tail == *msg)
+        mq->msg_queue_tail = RT_NULL;
+
+    /* decrease message entry */
+    if(mq->entry > 0)
+    {
+        mq->entry --;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * @brief    This function will put a message back to the pool of the messagequeue object,
+ *           and resume a thread waiting for a free message.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    msg is a pointer to the message to be freed.
+ */
+static void _mq_msg_free(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    rt_base_t level;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+    /* put message to free list */
+    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = msg;
+
+    /* resume suspended thread */
+    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
+    {
+        _ipc_list_resume(&(mq->suspend_sender_thread));
+
+        /* enable interrupt */
+        rt_hw_interrupt_enable(level);
+
+        rt_schedule();
+
+        return;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief    This function will send a message to the messagequeue object. If
+ *           there is a thread suspended on the messagequeue, the thread will be
+ *           resumed.
+ *
+ * @note     When using this function to send a message, if the messagequeue is
+ *           fully used, the current thread will wait for a timeout. If reaching
+ *           the timeout and there is still no space available, the sending
+ *           thread will be resumed and an error code will be returned. By
+ *           contrast, the rt_mq_send() function will return an error code
+ *           immediately without waiting when the messagequeue if fully used.
+ *
+ * @see      rt_mq_send()
+ *
+ * @param    mq is a pointer to the messagequeue object to be sent.
+ *
+ * @param    buffer is the content of the message.
+ *
+ * @param    size is the length of the message(Unit: Byte).
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the
+ *           operation is successful. If the return value is any other values,
+ *           it means that the messagequeue detach failed.
+ *
+ * @warning  This function can be called in interrupt context and thread
+ * context.
+ */
+rt_err_t rt_mq_send_wait(rt_mq_t     mq,
+                         const void *buffer,
+                         rt_size_t   size,
+                         rt_int32_t  timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    /* get a free message, wait for one if the message queue is full */
+    result = _mq_msg_alloc(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
+
+    /* copy buffer */
+    rt_memcpy(msg + 1, buffer, size);
+
+    return _mq_msg_send(mq, msg);
+}
 RTM_EXPORT(rt_mq_send_wait)
 
 
@@ -3316,10 +3665,8 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
                     rt_size_t  size,
                     rt_int32_t timeout)
 {
-    struct rt_thread *thread;
-    rt_base_t level;
     struct rt_mq_message *msg;
-    rt_uint32_t tick_delta;
+    rt_err_t result;
 
     /* parameter check */
     RT_ASSERT(mq != RT_NULL);
@@ -3330,137 +3677,195 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     /* current context checking */
     RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-    /* initialize delta tick */
-    tick_delta = 0;
-    /* get current thread */
-    thread = rt_thread_self();
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
 
-    /* disable interrupt */
-    level = rt_hw_interrupt_disable();
+    /* get the head message, wait for one if the message queue is empty */
+    result = _mq_msg_recv(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
 
-    /* for non-blocking call */
-    if (mq->entry == 0 && timeout == 0)
-    {
-        rt_hw_interrupt_enable(level);
+    /* copy message */
+    rt_memcpy(buffer, msg + 1, size > mq->msg_size ? mq->msg_size : size);
 
-        return -RT_ETIMEOUT;
-    }
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
 
-    /* message queue is empty */
-    while (mq->entry == 0)
-    {
-        /* reset error number in thread */
-        thread->error = RT_EOK;
+    /* put message to free list */
+    _mq_msg_free(mq, msg);
 
-        /* no waiting, return timeout */
-        if (timeout == 0)
-        {
-            /* enable interrupt */
-            rt_hw_interrupt_enable(level);
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_recv);
 
-            thread->error = -RT_ETIMEOUT;
+/**
+ * @brief    This function will get the message of a buffer returned by rt_mq_alloc() or rt_mq_fetch().
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the message buffer.
+ *
+ * @return   Return the message of the buffer.
+ */
+rt_inline struct rt_mq_message *_mq_buffer_msg(rt_mq_t mq, void *buffer)
+{
+    struct rt_mq_message *msg = (struct rt_mq_message *)buffer - 1;
 
-            return -RT_ETIMEOUT;
-        }
+    /* the buffer shall be one of the messages in the pool */
+    RT_ASSERT((rt_uint8_t *)msg >= (rt_uint8_t *)mq->msg_pool);
+    RT_ASSERT(((rt_uint8_t *)msg - (rt_uint8_t *)mq->msg_pool) % (mq->msg_size + sizeof(struct rt_mq_message)) == 0);
+    RT_ASSERT(((rt_uint8_t *)msg - (rt_uint8_t *)mq->msg_pool) / (mq->msg_size + sizeof(struct rt_mq_message)) < mq->max_msgs);
 
-        /* suspend current thread */
-        _ipc_list_suspend(&(mq->parent.suspend_thread),
-                            thread,
-                            mq->parent.parent.flag);
+    return msg;
+}
 
-        /* has waiting time, start thread timer */
-        if (timeout > 0)
-        {
-            /* get the start tick of timer */
-            tick_delta = rt_tick_get();
 
-            RT_DEBUG_LOG(RT_DEBUG_IPC, ("set thread:%s to timer list\n",
-                                        thread->name));
+/**
+ * @brief    This function will allocate a message buffer from the pool of the messagequeue object,
+ *           so the sender fills the message in place instead of copying it in.
+ *
+ * @note     The buffer is owned by the caller until it is queued by rt_mq_commit(), or given back
+ *           by rt_mq_release(). If the pool is empty, the thread waits for a free buffer as
+ *           rt_mq_send_wait() does.
+ *
+ * @see      rt_mq_commit()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to store the message buffer of msg_size bytes.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           -RT_EFULL is returned if no buffer is free in time.
+ *
+ * @warning  This function can be called in interrupt context with a zero timeout.
+ */
+rt_err_t rt_mq_alloc(rt_mq_t mq, void **buffer, rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t result;
 
-            /* reset the timeout of thread timer and start it */
-            rt_timer_control(&(thread->thread_timer),
-                             RT_TIMER_CTRL_SET_TIME,
-                             &timeout);
-            rt_timer_start(&(thread->thread_timer));
-        }
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
 
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-        /* re-schedule */
-        rt_schedule();
+    result = _mq_msg_alloc(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
 
-        /* recv message */
-        if (thread->error != RT_EOK)
-        {
-            /* return error */
-            return thread->error;
-        }
+    *buffer = msg + 1;
 
-        /* disable interrupt */
-        level = rt_hw_interrupt_disable();
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_alloc);
 
-        /* if it's not waiting forever and then re-calculate timeout tick */
-        if (timeout > 0)
-        {
-            tick_delta = rt_tick_get() - tick_delta;
-            timeout -= tick_delta;
-            if (timeout < 0)
-                timeout = 0;
-        }
-    }
 
-    /* get message from queue */
-    msg = (struct rt_mq_message *)mq->msg_queue_head;
+/**
+ * @brief    This function will queue a message buffer filled in place to the messagequeue object.
+ *           If there is a thread suspended on the messagequeue, the thread will be resumed.
+ *
+ * @note     The ownership of the buffer passes to the messagequeue, the sender shall not touch it any more.
+ *
+ * @see      rt_mq_alloc()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the message buffer returned by rt_mq_alloc().
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
 
-    /* move message queue head */
-    mq->msg_queue_head = msg->next;
-    /* reach queue tail, set to NULL */
-    if (mq->msg_queue_tail == msg)
-        mq->msg_queue_tail = RT_NULL;
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
 
-    /* decrease message entry */
-    if(mq->entry > 0)
-    {
-        mq->entry --;
-    }
+    return _mq_msg_send(mq, _mq_buffer_msg(mq, buffer));
+}
+RTM_EXPORT(rt_mq_commit);
 
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
 
-    /* copy message */
-    rt_memcpy(buffer, msg + 1, size > mq->msg_size ? mq->msg_size : size);
+/**
+ * @brief    This function will receive the buffer of the head message from the messagequeue object,
+ *           so the receiver reads the message in place instead of copying it out.
+ *
+ * @note     The buffer is owned by the receiver until it is given back by rt_mq_release(). If there
+ *           is no message, the thread waits for one as rt_mq_recv() does.
+ *
+ * @see      rt_mq_release()
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is a pointer to store the message buffer.
+ *
+ * @param    timeout is a timeout period (unit: an OS tick).
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *           -RT_ETIMEOUT is returned if no message arrives in time.
+ */
+rt_err_t rt_mq_fetch(rt_mq_t mq, void **buffer, rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t result;
 
-    /* disable interrupt */
-    level = rt_hw_interrupt_disable();
-    /* put message to free list */
-    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
-    mq->msg_queue_free = msg;
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
 
-    /* resume suspended thread */
-    if (!rt_list_isempty(&(mq->suspend_sender_thread)))
-    {
-        _ipc_list_resume(&(mq->suspend_sender_thread));
+    /* current context checking */
+    RT_DEBUG_SCHEDULER_AVAILABLE(timeout != 0);
 
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
 
-        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+    result = _mq_msg_recv(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
 
-        rt_schedule();
+    *buffer = msg + 1;
 
-        return RT_EOK;
-    }
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
 
-    /* enable interrupt */
-    rt_hw_interrupt_enable(level);
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_fetch);
 
-    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+/**
+ * @brief    This function will give a message buffer back to the pool of the messagequeue object.
+ *           If there is a thread waiting for a free buffer, the thread will be resumed.
+ *
+ * @note     It releases the buffer of a received message when the receiver is done with it, or a
+ *           buffer allocated by rt_mq_alloc() that is not committed.
+ *
+ * @param    mq is a pointer to the messagequeue object.
+ *
+ * @param    buffer is the message buffer returned by rt_mq_fetch() or rt_mq_alloc().
+ *
+ * @return   Return the operation status. When the return value is RT_EOK, the operation is successful.
+ *
+ * @warning  This function can be called in interrupt context and thread context.
+ */
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    _mq_msg_free(mq, _mq_buffer_msg(mq, buffer));
 
     return RT_EOK;
 }
-RTM_EXPORT(rt_mq_recv);
+RTM_EXPORT(rt_mq_release);
 
 
 /**
@@ -162,6 +162,225 @@ int *_rt_errno(void)
 RTM_EXPORT(_rt_errno);
 
 #ifndef RT_KSERVICE_USING_STDLIB_MEMORY
+#ifdef RT_KSERVICE_USING_FAST_MEMORY
+#ifdef RT_KSERVICE_USING_MVE_MEMORY
+#ifndef __ARM_FEATURE_MVE
+#error "RT_KSERVICE_USING_MVE_MEMORY needs the MVE enabled in the compiler, e.g. -march=armv8.1-m.main+mve"
+#endif /* __ARM_FEATURE_MVE */
+#include <arm_mve.h>
+
+/*
+ * The Helium (MVE) variants move 32 bytes a loop with two vector registers,
+ * and the tail with a predicated access. The byte loads and stores have no
+ * alignment requirement. Each loop loads both vectors before storing them, so
+ * the forward copy is safe for an overlapping destination below the source,
+ * and the backward copy for one above it.
+ */
+static void _memory_fill(char *d, unsigned char c, rt_ubase_t n)
+{
+    uint8x16_t v = vdupq_n_u8(c);
+
+    for (; n >= 32; n -= 32, d += 32)
+    {
+        vst1q_u8((uint8_t *)d, v);
+        vst1q_u8((uint8_t *)d + 16, v);
+    }
+    for (; n > 0; n = n > 16 ? n - 16 : 0, d += 16)
+        vstrbq_p_u8((uint8_t *)d, v, vctp8q(n));
+}
+
+static void _memory_copy_forward(char *d, const char *s, rt_ubase_t n)
+{
+    uint8x16_t v0, v1;
+
+    for (; n >= 32; n -= 32, d += 32, s += 32)
+    {
+        v0 = vld1q_u8((const uint8_t *)s);
+        v1 = vld1q_u8((const uint8_t *)s + 16);
+        vst1q_u8((uint8_t *)d, v0);
+        vst1q_u8((uint8_t *)d + 16, v1);
+    }
+    for (; n > 0; n = n > 16 ? n - 16 : 0, d += 16, s += 16)
+    {
+        mve_pred16_t p = vctp8q(n);
+
+        vstrbq_p_u8((uint8_t *)d, vldrbq_z_u8((const uint8_t *)s, p), p);
+    }
+}
+
+/* d and s point to the end of the areas */
+static void _memory_copy_backward(char *d, const char *s, rt_ubase_t n)
+{
+    uint8x16_t v0, v1;
+
+    for (; n >= 32; n -= 32)
+    {
+        d -= 32;
+        s -= 32;
+        v1 = vld1q_u8((const uint8_t *)s + 16);
+        v0 = vld1q_u8((const uint8_t *)s);
+        vst1q_u8((uint8_t *)d + 16, v1);
+        vst1q_u8((uint8_t *)d, v0);
+    }
+    if (n >= 16)
+    {
+        d -= 16;
+        s -= 16;
+        n -= 16;
+        vst1q_u8((uint8_t *)d, vld1q_u8((const uint8_t *)s));
+    }
+    if (n > 0)
+    {
+        mve_pred16_t p = vctp8q(n);
+
+        /* the rest is at the start of the areas */
+        d -= n;
+        s -= n;
+        vstrbq_p_u8((uint8_t *)d, vldrbq_z_u8((const uint8_t *)s, p), p);
+    }
+}
+#else
+
+/*
+ * The portable variants align the destination with a byte loop, then move 8
+ * words a loop. If the source is aligned differently, the words are read from
+ * the aligned addresses of the source and shifted into place, which never
+ * reads outside the words holding the source bytes. A byte is 8 bits here.
+ * Each word of the source is read before the destination word at the same
+ * index is written, so the forward copy is safe for an overlapping destination
+ * below the source, and the backward copy for one above it.
+ */
+#define _MEM_WORD           (sizeof(rt_ubase_t))
+#define _MEM_BLOCK          (_MEM_WORD * 8)
+#define _MEM_ALIGNMENT(p)   ((rt_ubase_t)(p) & (_MEM_WORD - 1))
+
+#ifdef ARCH_CPU_BIG_ENDIAN
+#define _MEM_MERGE(lo, hi, shift)   (((lo) << (shift)) | ((hi) >> (_MEM_WORD * 8 - (shift))))
+#else
+#define _MEM_MERGE(lo, hi, shift)   (((lo) >> (shift)) | ((hi) << (_MEM_WORD * 8 - (shift))))
+#endif /* ARCH_CPU_BIG_ENDIAN */
+
+static void _memory_fill(char *d, unsigned char c, rt_ubase_t n)
+{
+    rt_ubase_t *dw, buffer;
+    unsigned int i;
+
+    if (n >= _MEM_WORD * 2)
+    {
+        for (; _MEM_ALIGNMENT(d) != 0; n --)
+            *d++ = (char)c;
+
+        for (i = 0; i < _MEM_WORD; i++)
+            *(((unsigned char *)&buffer) + i) = c;
+
+        for (dw = (rt_ubase_t *)d; n >= _MEM_BLOCK; n -= _MEM_BLOCK, dw += 8)
+        {
+            dw[0] = buffer; dw[1] = buffer; dw[2] = buffer; dw[3] = buffer;
+            dw[4] = buffer; dw[5] = buffer; dw[6] = buffer; dw[7] = buffer;
+        }
+        for (; n >= _MEM_WORD; n -= _MEM_WORD)
+            *dw++ = buffer;
+
+        d = (char *)dw;
+    }
+
+    while (n--)
+        *d++ = (char)c;
+}
+
+static void _memory_copy_forward(char *d, const char *s, rt_ubase_t n)
+{
+    rt_ubase_t *dw, lo, hi;
+    const rt_ubase_t *sw;
+    unsigned int shift;
+
+    if (n >= _MEM_WORD * 2)
+    {
+        for (; _MEM_ALIGNMENT(d) != 0; n --)
+            *d++ = *s++;
+
+        dw = (rt_ubase_t *)d;
+        shift = _MEM_ALIGNMENT(s) * 8;
+        if (shift == 0)
+        {
+            for (sw = (const rt_ubase_t *)s; n >= _MEM_BLOCK; n -= _MEM_BLOCK, dw += 8, sw += 8)
+            {
+                dw[0] = sw[0]; dw[1] = sw[1]; dw[2] = sw[2]; dw[3] = sw[3];
+                dw[4] = sw[4]; dw[5] = sw[5]; dw[6] = sw[6]; dw[7] = sw[7];
+            }
+            for (; n >= _MEM_WORD; n -= _MEM_WORD)
+                *dw++ = *sw++;
+        }
+        else
+        {
+            sw = (const rt_ubase_t *)(s - shift / 8);
+            for (lo = *sw++; n >= _MEM_WORD; n -= _MEM_WORD, lo = hi)
+            {
+                hi = *sw++;
+                *dw++ = _MEM_MERGE(lo, hi, shift);
+            }
+            sw --;
+        }
+
+        d = (char *)dw;
+        s = (const char *)sw + shift / 8;
+    }
+
+    while (n--)
+        *d++ = *s++;
+}
+
+/* d and s point to the end of the areas */
+static void _memory_copy_backward(char *d, const char *s, rt_ubase_t n)
+{
+    rt_ubase_t *dw, lo, hi;
+    const rt_ubase_t *sw;
+    unsigned int shift;
+
+    if (n >= _MEM_WORD * 2)
+    {
+        for (; _MEM_ALIGNMENT(d) != 0; n --)
+            *--d = *--s;
+
+        dw = (rt_ubase_t *)d;
+        shift = _MEM_ALIGNMENT(s) * 8;
+        if (shift == 0)
+        {
+            for (sw = (const rt_ubase_t *)s; n >= _MEM_BLOCK; n -= _MEM_BLOCK)
+            {
+                dw -= 8;
+                sw -= 8;
+                dw[7] = sw[7]; dw[6] = sw[6]; dw[5] = sw[5]; dw[4] = sw[4];
+                dw[3] = sw[3]; dw[2] = sw[2]; dw[1] = sw[1]; dw[0] = sw[0];
+            }
+            for (; n >= _MEM_WORD; n -= _MEM_WORD)
+                *--dw = *--sw;
+        }
+        else
+        {
+            sw = (const rt_ubase_t *)(s - shift / 8);
+            for (hi = *sw; n >= _MEM_WORD; n -= _MEM_WORD, hi = lo)
+            {
+                lo = *--sw;
+                *--dw = _MEM_MERGE(lo, hi, shift);
+            }
+        }
+
+        d = (char *)dw;
+        s = (const char *)sw + shift / 8;
+    }
+
+    while (n--)
+        *--d = *--s;
+}
+
+#undef _MEM_WORD
+#undef _MEM_BLOCK
+#undef _MEM_ALIGNMENT
+#undef _MEM_MERGE
+#endif /* RT_KSERVICE_USING_MVE_MEMORY */
+#endif /* RT_KSERVICE_USING_FAST_MEMORY */
+
 /**
  * This function will set the content of memory to specified value.
  *
@@ -182,6 +401,10 @@ RT_WEAK void *rt_memset(void *s, int c, rt_ubase_t count)
     while (count--)
         *xs++ = c;
 
+    return s;
+#elif defined(RT_KSERVICE_USING_FAST_MEMORY)
+    _memory_fill((char *)s, (unsigned char)c, count);
+
     return s;
 #else
 #define LBLOCKSIZE      (sizeof(rt_ubase_t))
@@ -271,6 +494,10 @@ RT_WEAK void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
             tmp[len - 1] = s[len - 1];
     }
 
+    return dst;
+#elif defined(RT_KSERVICE_USING_FAST_MEMORY)
+    _memory_copy_forward((char *)dst, (const char *)src, count);
+
     return dst;
 #else
 
@@ -342,6 +569,14 @@ RTM_EXPORT(rt_memcpy);
  */
 void *rt_memmove(void *dest, const void *src, rt_size_t n)
 {
+#ifdef RT_KSERVICE_USING_FAST_MEMORY
+    if ((const char *)src < (char *)dest && (char *)dest < (const char *)src + n)
+        _memory_copy_backward((char *)dest + n, (const char *)src + n, n);
+    else
+        _memory_copy_forward((char *)dest, (const char *)src, n);
+
+    return dest;
+#else
     char *tmp = (char *)dest, *s = (char *)src;
 
     if (s < tmp && tmp < s + n)
@@ -359,6 +594,7 @@ void *rt_memmove(void *dest, const void *src, rt_size_t n)
     }
 
     return dest;
+#endif /* RT_KSERVICE_USING_FAST_MEMORY */
 }
 RTM_EXPORT(rt_memmove);
 
@@ -648,33 +884,77 @@ RTM_EXPORT(rt_show_version);
 /* private function */
 #define _ISDIGIT(c)  ((unsigned)((c) - '0') < 10)
 
+/* the digit pairs of 00 ~ 99, to convert two decimal digits with one division */
+static const char _digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 /**
- * This function will duplicate a string.
+ * This function will convert a number to the digits in reverse order.
+ *
+ * @param  tmp is the buffer of the digits.
+ *
+ * @param  num is the number to be converted.
  *
- * @param  n is the string to be duplicated.
+ * @param  base is the base of the number: 2, 8, 10 or 16.
  *
- * @param  base is support divide instructions value.
+ * @param  large is non-zero to use 'ABCDEF' instead of 'abcdef'.
  *
- * @return the duplicated string pointer.
+ * @return the number of the digits.
  */
 #ifdef RT_KPRINTF_USING_LONGLONG
-rt_inline int divide(long long *n, int base)
+static int _number_to_digits(char *tmp, unsigned long long num, int base, int large)
 #else
-rt_inline int divide(long *n, int base)
+static int _number_to_digits(char *tmp, unsigned long num, int base, int large)
 #endif /* RT_KPRINTF_USING_LONGLONG */
 {
-    int res;
+    const char *digits = large ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned long value;
+    int i = 0, pair, shift;
 
-    /* optimized for processor which does not support divide instructions. */
+    if (base == 10)
+    {
 #ifdef RT_KPRINTF_USING_LONGLONG
-    res = (int)(((unsigned long long)*n) % base);
-    *n = (long long)(((unsigned long long)*n) / base);
-#else
-    res = (int)(((unsigned long)*n) % base);
-    *n = (long)(((unsigned long)*n) / base);
-#endif
+        /* the long long division is slow, go on with long once the number fits */
+        while (num > (unsigned long)-1)
+        {
+            pair = (int)(num % 100) * 2;
+            num /= 100;
+            tmp[i++] = _digit_pairs[pair + 1];
+            tmp[i++] = _digit_pairs[pair];
+        }
+#endif /* RT_KPRINTF_USING_LONGLONG */
+        value = (unsigned long)num;
+        while (value >= 100)
+        {
+            pair = (int)(value % 100) * 2;
+            value /= 100;
+            tmp[i++] = _digit_pairs[pair + 1];
+            tmp[i++] = _digit_pairs[pair];
+        }
+        if (value >= 10)
+        {
+            tmp[i++] = _digit_pairs[value * 2 + 1];
+            tmp[i++] = _digit_pairs[value * 2];
+        }
+        else
+        {
+            tmp[i++] = digits[value];
+        }
+    }
+    else
+    {
+        /* the other bases are powers of 2, the digits are masked and shifted out */
+        shift = (base == 16) ? 4 : (base == 8) ? 3 : 1;
+        do
+        {
+            tmp[i++] = digits[(int)num & (base - 1)];
+            num >>= shift;
+        } while (num != 0);
+    }
 
-    return res;
+    return i;
 }
 
 rt_inline int skip_atoi(const char **s)
@@ -715,14 +995,10 @@ static char *print_number(char *buf,
     char tmp[32];
 #endif /* RT_KPRINTF_USING_LONGLONG */
     int precision_bak = precision;
-    const char *digits;
-    static const char small_digits[] = "0123456789abcdef";
-    static const char large_digits[] = "0123456789ABCDEF";
     int i, size;
 
     size = s;
 
-    digits = (type & LARGE) ? large_digits : small_digits;
     if (type & LEFT)
         type &= ~ZEROPAD;
 
@@ -753,14 +1029,11 @@ static char *print_number(char *buf,
     }
 #endif /* RT_PRINTF_SPECIAL */
 
-    i = 0;
-    if (num == 0)
-        tmp[i++] = '0';
-    else
-    {
-        while (num != 0)
-            tmp[i++] = digits[divide(&num, base)];
-    }
+#ifdef RT_KPRINTF_USING_LONGLONG
+    i = _number_to_digits(tmp, (unsigned long long)num, base, type & LARGE);
+#else
+    i = _number_to_digits(tmp, (unsigned long)num, base, type & LARGE);
+#endif /* RT_KPRINTF_USING_LONGLONG */
 
 #ifdef RT_PRINTF_PRECISION
     if (i > precision)
@@ -886,6 +1159,8 @@ RT_WEAK int rt_vsnprintf(char *buf, rt_size_t size, const char *fmt, va_list arg
     int i, len;
     char *str, *end, c;
     const char *s;
+    char tmp[12];               /* the digits of the fast path */
+    rt_uint32_t value;
 
     rt_uint8_t base;            /* the base of number */
     rt_uint8_t flags;           /* flags to print number */
@@ -910,9 +1185,50 @@ RT_WEAK int rt_vsnprintf(char *buf, rt_size_t size, const char *fmt, va_list arg
     {
         if (*fmt != '%')
         {
-            if (str < end)
-                *str = *fmt;
-            ++ str;
+            /* copy the run of plain characters up to the next '%' */
+            while (1)
+            {
+                if (str < end) *str = *fmt;
+                ++ str;
+                if (fmt[1] == '%' || fmt[1] == '\0')
+                    break;
+                ++ fmt;
+            }
+            continue;
+        }
+
+        /* the fast path of %d, %u, %x and %s without flags, width, precision or qualifier */
+        c = fmt[1];
+        if (c == 's')
+        {
+            ++ fmt;
+            s = va_arg(args, char *);
+            if (!s) s = "(NULL)";
+
+            for (; *s; ++ s)
+            {
+                if (str < end) *str = *s;
+                ++ str;
+            }
+            continue;
+        }
+        else if (c == 'd' || c == 'u' || c == 'x')
+        {
+            ++ fmt;
+            value = va_arg(args, rt_uint32_t);
+            if (c == 'd' && (rt_int32_t)value < 0)
+            {
+                if (str < end) *str = '-';
+                ++ str;
+                value = 0U - value;
+            }
+
+            len = _number_to_digits(tmp, value, c == 'x' ? 16 : 10, 0);
+            while (len-- > 0)
+            {
+                if (str < end) *str = tmp[len];
+                ++ str;
+            }
             continue;
         }
 
@@ -1504,6 +1820,9 @@ RT_WEAK void *rt_malloc(rt_size_t size)
 {
     rt_base_t level;
     void *ptr;
+#ifdef RT_USING_MEMPROF
+    rt_uint32_t start = rt_memprof_clock();
+#endif /* RT_USING_MEMPROF */
 
     /* Enter critical zone */
     level = _heap_lock();
@@ -1511,6 +1830,10 @@ RT_WEAK void *rt_malloc(rt_size_t size)
     ptr = _MEM_MALLOC(size);
     /* Exit critical zone */
     _heap_unlock(level);
+#ifdef RT_USING_MEMPROF
+    /* record the allocation by its call site */
+    rt_memprof_malloc(ptr, size, RT_MEMPROF_CALLER(), rt_memprof_clock() - start);
+#endif /* RT_USING_MEMPROF */
     /* call 'rt_malloc' hook */
     RT_OBJECT_HOOK_CALL(rt_malloc_hook, (ptr, size));
     return ptr;
@@ -1530,11 +1853,18 @@ RT_WEAK void *rt_realloc(void *rmem, rt_size_t newsize)
 {
     rt_base_t level;
     void *nptr;
+#ifdef RT_USING_MEMPROF
+    rt_uint32_t start = rt_memprof_clock();
+#endif /* RT_USING_MEMPROF */
 
     /* Enter critical zone */
     level = _heap_lock();
     /* Change the size of previously allocated memory block */
     nptr = _MEM_REALLOC(rmem, newsize);
+#ifdef RT_USING_MEMPROF
+    /* record in the critical zone, the old block may be reused once it is left */
+    rt_memprof_realloc(rmem, nptr, newsize, RT_MEMPROF_CALLER(), rt_memprof_clock() - start);
+#endif /* RT_USING_MEMPROF */
     /* Exit critical zone */
     _heap_unlock(level);
     return nptr;
@@ -1564,6 +1894,9 @@ RT_WEAK void *rt_calloc(rt_size_t count, rt_size_t size)
     if (p)
     {
         rt_memset(p, 0, count * size);
+#ifdef RT_USING_MEMPROF
+        rt_memprof_retag(p, RT_MEMPROF_CALLER());
+#endif /* RT_USING_MEMPROF */
     }
     return p;
 }
@@ -1583,6 +1916,9 @@ RT_WEAK void rt_free(void *rmem)
     RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
     /* NULL check */
     if (rmem == RT_NULL) return;
+#ifdef RT_USING_MEMPROF
+    rt_memprof_free(rmem);
+#endif /* RT_USING_MEMPROF */
     /* Enter critical zone */
     level = _heap_lock();
     _MEM_FREE(rmem);
@@ -1674,6 +2010,10 @@ RT_WEAK void *rt_malloc_align(rt_size_t size, rt_size_t align)
     ptr = rt_malloc(align_size);
     if (ptr != RT_NULL)
     {
+#ifdef RT_USING_MEMPROF
+        rt_memprof_retag(ptr, RT_MEMPROF_CALLER());
+#endif /* RT_USING_MEMPROF */
+
         /* the allocated memory block is aligned */
         if (((rt_ubase_t)ptr & (align - 1)) == 0)
         {
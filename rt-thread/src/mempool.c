@@ -119,6 +119,13 @@ rt_err_t rt_mp_init(struct rt_mempool *mp,
     /* initialize suspended thread list */
     rt_list_init(&(mp->suspend_thread));
 
+#ifdef RT_USING_MEMPOOL_STATS
+    mp->max_used   = 0;
+    mp->fail_count = 0;
+    mp->wait_count = 0;
+    mp->wait_tick  = 0;
+#endif /* RT_USING_MEMPOOL_STATS */
+
     /* initialize free block list */
     block_ptr = (rt_uint8_t *)mp->start_address;
     for (offset = 0; offset < mp->block_total_count; offset ++)
@@ -237,6 +244,13 @@ rt_mp_t rt_mp_create(const char *name,
     /* initialize suspended thread list */
     rt_list_init(&(mp->suspend_thread));
 
+#ifdef RT_USING_MEMPOOL_STATS
+    mp->max_used   = 0;
+    mp->fail_count = 0;
+    mp->wait_count = 0;
+    mp->wait_tick  = 0;
+#endif /* RT_USING_MEMPOOL_STATS */
+
     /* initialize free block list */
     block_ptr = (rt_uint8_t *)mp->start_address;
     for (offset = 0; offset < mp->block_total_count; offset ++)
@@ -332,11 +346,20 @@ void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
+#ifdef RT_USING_MEMPOOL_STATS
+    if (mp->block_free_count == 0 && time != 0)
+        mp->wait_count ++;
+#endif /* RT_USING_MEMPOOL_STATS */
+
     while (mp->block_free_count == 0)
     {
         /* memory block is unavailable. */
         if (time == 0)
         {
+#ifdef RT_USING_MEMPOOL_STATS
+            mp->fail_count ++;
+#endif /* RT_USING_MEMPOOL_STATS */
+
             /* enable interrupt */
             rt_hw_interrupt_enable(level);
 
@@ -353,10 +376,11 @@ void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
         rt_thread_suspend(thread);
         rt_list_insert_after(&(mp->suspend_thread), &(thread->tlist));
 
+        /* get the start tick of sleep */
+        before_sleep = rt_tick_get();
+
         if (time > 0)
         {
-            /* get the start tick of timer */
-            before_sleep = rt_tick_get();
 
             /* init thread timer and start it */
             rt_timer_control(&(thread->thread_timer),
@@ -371,6 +395,18 @@ void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
         /* do a schedule */
         rt_schedule();
 
+#ifdef RT_USING_MEMPOOL_STATS
+        /* the pool is gone if the error is other than a timeout */
+        if (thread->error == RT_EOK || thread->error == -RT_ETIMEOUT)
+        {
+            level = rt_hw_interrupt_disable();
+            mp->wait_tick += rt_tick_get() - before_sleep;
+            if (thread->error != RT_EOK)
+                mp->fail_count ++;
+            rt_hw_interrupt_enable(level);
+        }
+#endif /* RT_USING_MEMPOOL_STATS */
+
         if (thread->error != RT_EOK)
             return RT_NULL;
 
@@ -387,6 +423,11 @@ void *rt_mp_alloc(rt_mp_t mp, rt_int32_t time)
     /* memory block is available. decrease the free block counter */
     mp->block_free_count--;
 
+#ifdef RT_USING_MEMPOOL_STATS
+    if (mp->block_total_count - mp->block_free_count > mp->max_used)
+        mp->max_used = mp->block_total_count - mp->block_free_count;
+#endif /* RT_USING_MEMPOOL_STATS */
+
     /* get block from block list */
     block_ptr = mp->block_list;
     RT_ASSERT(block_ptr != RT_NULL);
@@ -465,6 +506,229 @@ void rt_mp_free(void *block)
 }
 RTM_EXPORT(rt_mp_free);
 
+#ifdef RT_USING_MEMPOOL_CACHE
+/*
+ * move at most n blocks from the memory pool to the cache, in one
+ * critical section
+ */
+static void _mp_cache_refill(struct rt_mp_cache *cache, rt_size_t n)
+{
+    struct rt_mempool *mp = cache->mp;
+    rt_uint8_t *block_ptr;
+    rt_base_t level;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (n > mp->block_free_count)
+        n = mp->block_free_count;
+    mp->block_free_count -= n;
+    cache->count += n;
+
+#ifdef RT_USING_MEMPOOL_STATS
+    if (mp->block_total_count - mp->block_free_count > mp->max_used)
+        mp->max_used = mp->block_total_count - mp->block_free_count;
+#endif /* RT_USING_MEMPOOL_STATS */
+
+    while (n --)
+    {
+        block_ptr = mp->block_list;
+        RT_ASSERT(block_ptr != RT_NULL);
+
+        mp->block_list = *(rt_uint8_t **)block_ptr;
+        *(rt_uint8_t **)block_ptr = cache->block_list;
+        cache->block_list = block_ptr;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/*
+ * move n blocks from the cache back to the memory pool, in one critical
+ * section, and wake up as many suspended threads
+ */
+static void _mp_cache_drain(struct rt_mp_cache *cache, rt_size_t n)
+{
+    struct rt_mempool *mp = cache->mp;
+    struct rt_thread *thread;
+    rt_uint8_t *first, *last;
+    rt_size_t i;
+    rt_base_t level;
+    rt_bool_t need_schedule = RT_FALSE;
+
+    if (n == 0)
+        return;
+
+    /* the cache is private, unlink the blocks before locking the pool */
+    first = last = cache->block_list;
+    for (i = 1; i < n; i ++)
+        last = *(rt_uint8_t **)last;
+    cache->block_list = *(rt_uint8_t **)last;
+    cache->count -= n;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    mp->block_free_count += n;
+    *(rt_uint8_t **)last = mp->block_list;
+    mp->block_list = first;
+
+    while (n -- && !rt_list_isempty(&(mp->suspend_thread)))
+    {
+        /* get the suspended thread */
+        thread = rt_list_entry(mp->suspend_thread.next,
+                               struct rt_thread,
+                               tlist);
+
+        /* set error */
+        thread->error = RT_EOK;
+
+        /* resume thread */
+        rt_thread_resume(thread);
+        need_schedule = RT_TRUE;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+}
+
+/**
+ * @brief This function will initialize a thread local cache of a memory pool.
+ *
+ * @note  The blocks are moved between the cache and the pool half a cache at a time. The cache
+ *        holds the blocks away from the other threads, it shall be flushed before the thread
+ *        exits or the pool is detached.
+ *
+ * @param cache is the cache to be initialized.
+ *
+ * @param mp is the memory pool object.
+ *
+ * @param size is the maximum blocks held by the cache.
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_mp_cache_init(struct rt_mp_cache *cache, rt_mp_t mp, rt_uint16_t size)
+{
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+    RT_ASSERT(mp != RT_NULL);
+    RT_ASSERT(size > 0);
+
+    cache->mp = mp;
+    cache->block_list = RT_NULL;
+    cache->count = 0;
+    cache->size = size;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mp_cache_init);
+
+/**
+ * @brief This function will allocate a block from the cache of a memory pool. The cache is
+ *        refilled from the pool if it is empty.
+ *
+ * @param cache is the cache of memory pool.
+ *
+ * @param time is the maximum waiting time for allocating memory when the pool is empty too.
+ *             - 0 for not waiting, allocating memory immediately.
+ *
+ * @return the allocated memory block or RT_NULL on allocated failed.
+ *
+ * @warning The cache can ONLY be used by the thread it belongs to.
+ */
+void *rt_mp_cache_alloc(struct rt_mp_cache *cache, rt_int32_t time)
+{
+    rt_uint8_t *block_ptr;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+
+    if (cache->count == 0)
+    {
+        _mp_cache_refill(cache, (cache->size + 1) / 2);
+
+        /* the pool is empty, wait on it */
+        if (cache->count == 0)
+            return rt_mp_alloc(cache->mp, time);
+    }
+
+    /* get block from the cache */
+    block_ptr = cache->block_list;
+    cache->block_list = *(rt_uint8_t **)block_ptr;
+    cache->count --;
+
+    /* point to memory pool */
+    *(rt_uint8_t **)block_ptr = (rt_uint8_t *)cache->mp;
+
+    RT_OBJECT_HOOK_CALL(rt_mp_alloc_hook,
+                        (cache->mp, (rt_uint8_t *)(block_ptr + sizeof(rt_uint8_t *))));
+
+    return (rt_uint8_t *)(block_ptr + sizeof(rt_uint8_t *));
+}
+RTM_EXPORT(rt_mp_cache_alloc);
+
+/**
+ * @brief This function will release a memory block to the cache of its memory pool. Half of
+ *        the cache is returned to the pool if the cache is full.
+ *
+ * @param cache is the cache of memory pool.
+ *
+ * @param block the address of memory block to be released.
+ *
+ * @warning The cache can ONLY be used by the thread it belongs to.
+ */
+void rt_mp_cache_free(struct rt_mp_cache *cache, void *block)
+{
+    rt_uint8_t **block_ptr;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+    if (block == RT_NULL) return;
+
+    /* get the control block of pool which the block belongs to */
+    block_ptr = (rt_uint8_t **)((rt_uint8_t *)block - sizeof(rt_uint8_t *));
+    if ((struct rt_mempool *)*block_ptr != cache->mp)
+    {
+        /* a block of another pool */
+        rt_mp_free(block);
+        return;
+    }
+
+    RT_OBJECT_HOOK_CALL(rt_mp_free_hook, (cache->mp, block));
+
+    if (cache->count >= cache->size)
+        _mp_cache_drain(cache, (cache->size + 1) / 2);
+
+    /* link the block into the cache */
+    *block_ptr = cache->block_list;
+    cache->block_list = (rt_uint8_t *)block_ptr;
+    cache->count ++;
+
+    /* a suspended thread can't wait for the cached blocks */
+    if (!rt_list_isempty(&(cache->mp->suspend_thread)))
+        _mp_cache_drain(cache, cache->count);
+}
+RTM_EXPORT(rt_mp_cache_free);
+
+/**
+ * @brief This function will return all the blocks of the cache to its memory pool.
+ *
+ * @param cache is the cache of memory pool.
+ */
+void rt_mp_cache_flush(struct rt_mp_cache *cache)
+{
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+
+    _mp_cache_drain(cache, cache->count);
+}
+RTM_EXPORT(rt_mp_cache_flush);
+#endif /* RT_USING_MEMPOOL_CACHE */
+
 /**@}*/
 
 #endif /* RT_USING_MEMPOOL */
@@ -0,0 +1,654 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+/*
+ * The heap profiler records each allocation of the system heap by its call
+ * site. The live blocks are kept in a hash table by address, with their size,
+ * site and owner thread, so a release is charged back to the site that made
+ * the block. The sites keep the counters, the live bytes and a size histogram,
+ * and the recent allocations and releases are kept in a ring of events.
+ *
+ * The tables are fixed size: a block that doesn't fit in the table is counted
+ * as untracked, and the sites that don't fit are charged to site 0.
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_MEMPROF
+
+#ifdef RT_USING_CPUTIME
+#include <drivers/cputime.h>
+#endif /* RT_USING_CPUTIME */
+
+#if (RT_MEMPROF_BLOCK_NUM & (RT_MEMPROF_BLOCK_NUM - 1)) != 0
+#error "RT_MEMPROF_BLOCK_NUM shall be a power of 2"
+#endif
+#if (RT_MEMPROF_SITE_NUM & (RT_MEMPROF_SITE_NUM - 1)) != 0
+#error "RT_MEMPROF_SITE_NUM shall be a power of 2"
+#endif
+
+/* log2 of a power of 2 below 65536, folded at compile time */
+#define MEMPROF_LOG2_2(n)       ((n) >> 1 ? 1 : 0)
+#define MEMPROF_LOG2_4(n)       ((n) >> 2 ? 2 + MEMPROF_LOG2_2((n) >> 2) : MEMPROF_LOG2_2(n))
+#define MEMPROF_LOG2_8(n)       ((n) >> 4 ? 4 + MEMPROF_LOG2_4((n) >> 4) : MEMPROF_LOG2_4(n))
+#define MEMPROF_LOG2(n)         ((n) >> 8 ? 8 + MEMPROF_LOG2_8((n) >> 8) : MEMPROF_LOG2_8(n))
+
+#define MEMPROF_SITE_BITS       MEMPROF_LOG2(RT_MEMPROF_SITE_NUM)
+#define MEMPROF_BLOCK_BITS      MEMPROF_LOG2(RT_MEMPROF_BLOCK_NUM)
+
+#define MEMPROF_MAGIC           0x4652504d          /* "MPRF" */
+#define MEMPROF_VERSION         1
+#define MEMPROF_FREE            0x80000000UL        /* the release flag in the size of an event */
+
+struct memprof_block
+{
+    void                *ptr;
+    rt_uint32_t          size;
+    rt_uint32_t          site;
+    struct rt_thread    *thread;
+};
+
+struct memprof_event
+{
+    rt_uint32_t          tick;
+    rt_uint32_t          ptr;
+    rt_uint32_t          size;                      /* MEMPROF_FREE for the release */
+    rt_uint16_t          site;
+    rt_uint16_t          time;                      /* time of the allocation, saturated */
+};
+
+static struct rt_memprof_site _sites[RT_MEMPROF_SITE_NUM];
+static struct memprof_block _blocks[RT_MEMPROF_BLOCK_NUM];
+static struct memprof_event _ring[RT_MEMPROF_RING_SIZE];
+static rt_uint32_t _ring_count;
+static rt_uint32_t _block_count;
+static rt_uint32_t _untracked;
+static rt_uint32_t _unknown_free;
+
+/* Fibonacci hashing, the high bits of the product are the well mixed ones */
+rt_inline rt_uint32_t _memprof_hash(rt_ubase_t key, int bits)
+{
+    return ((rt_uint32_t)(key >> 2) * 2654435761u) >> (32 - bits);
+}
+
+/* the histogram bucket: <= 16, <= 32, ... <= 1024, > 1024 bytes */
+rt_inline int _memprof_bucket(rt_size_t size)
+{
+    int bucket = 0;
+
+    for (size = (size - 1) >> 4; size != 0 && bucket < RT_MEMPROF_HIST_NUM - 1; size >>= 1)
+        bucket ++;
+
+    return bucket;
+}
+
+static rt_uint32_t _memprof_site(void *caller)
+{
+    rt_uint32_t index, i;
+
+    index = _memprof_hash((rt_ubase_t)caller, MEMPROF_SITE_BITS);
+    for (i = 0; i < RT_MEMPROF_SITE_NUM; i ++)
+    {
+        /* site 0 is the overflow site */
+        if (index != 0)
+        {
+            if (_sites[index].caller == caller)
+                return index;
+            if (_sites[index].caller == RT_NULL)
+            {
+                _sites[index].caller = caller;
+                return index;
+            }
+        }
+        index = (index + 1) & (RT_MEMPROF_SITE_NUM - 1);
+    }
+
+    return 0;
+}
+
+static struct memprof_block *_memprof_find(void *ptr)
+{
+    rt_uint32_t index, i;
+
+    index = _memprof_hash((rt_ubase_t)ptr, MEMPROF_BLOCK_BITS);
+    for (i = 0; i < RT_MEMPROF_BLOCK_NUM; i ++)
+    {
+        if (_blocks[index].ptr == ptr)
+            return &_blocks[index];
+        if (_blocks[index].ptr == RT_NULL)
+            break;
+        index = (index + 1) & (RT_MEMPROF_BLOCK_NUM - 1);
+    }
+
+    return RT_NULL;
+}
+
+/* remove a block by shifting back the entries of its probe sequence */
+static void _memprof_remove(struct memprof_block *block)
+{
+    rt_uint32_t hole, index, home;
+
+    hole = block - _blocks;
+    index = hole;
+    while (1)
+    {
+        index = (index + 1) & (RT_MEMPROF_BLOCK_NUM - 1);
+        if (_blocks[index].ptr == RT_NULL)
+            break;
+
+        /* move the entry to the hole if its home isn't in (hole, index] */
+        home = _memprof_hash((rt_ubase_t)_blocks[index].ptr, MEMPROF_BLOCK_BITS);
+        if (((index - home) & (RT_MEMPROF_BLOCK_NUM - 1)) >= ((index - hole) & (RT_MEMPROF_BLOCK_NUM - 1)))
+        {
+            _blocks[hole] = _blocks[index];
+            hole = index;
+        }
+    }
+    _blocks[hole].ptr = RT_NULL;
+    _block_count --;
+}
+
+static void _memprof_event(void *ptr, rt_uint32_t size, rt_uint32_t site, rt_uint32_t time)
+{
+    struct memprof_event *event;
+
+    event = &_ring[_ring_count % RT_MEMPROF_RING_SIZE];
+    event->tick = (rt_uint32_t)rt_tick_get();
+    event->ptr = (rt_uint32_t)(rt_ubase_t)ptr;
+    event->size = size;
+    event->site = (rt_uint16_t)site;
+    event->time = time > 0xffff ? 0xffff : (rt_uint16_t)time;
+    _ring_count ++;
+}
+
+static void _memprof_alloc(void *ptr, rt_size_t size, void *caller, rt_uint32_t time)
+{
+    struct rt_memprof_site *site;
+    rt_uint32_t index, i;
+
+    index = _memprof_site(caller);
+    site = &_sites[index];
+    if (time > site->max_time)
+        site->max_time = time;
+
+    if (ptr == RT_NULL)
+    {
+        site->fail_count ++;
+        return;
+    }
+
+    site->alloc_count ++;
+    site->hist[_memprof_bucket(size)] ++;
+    _memprof_event(ptr, size, index, time);
+
+    /* keep the table at most 3/4 full for short probe sequences, an untracked
+     * block isn't charged to the live bytes as its release can't be matched */
+    if (_block_count >= RT_MEMPROF_BLOCK_NUM / 4 * 3)
+    {
+        _untracked ++;
+        return;
+    }
+
+    i = _memprof_hash((rt_ubase_t)ptr, MEMPROF_BLOCK_BITS);
+    while (_blocks[i].ptr != RT_NULL)
+        i = (i + 1) & (RT_MEMPROF_BLOCK_NUM - 1);
+
+    _blocks[i].ptr = ptr;
+    _blocks[i].size = size;
+    _blocks[i].site = index;
+    _blocks[i].thread = rt_thread_self();
+    _block_count ++;
+
+    site->live_bytes += size;
+    if (site->live_bytes > site->max_live_bytes)
+        site->max_live_bytes = site->live_bytes;
+}
+
+static void _memprof_free(void *ptr)
+{
+    struct memprof_block *block;
+    struct rt_memprof_site *site;
+
+    block = _memprof_find(ptr);
+    if (block == RT_NULL)
+    {
+        _unknown_free ++;
+        return;
+    }
+
+    site = &_sites[block->site];
+    site->free_count ++;
+    site->live_bytes -= block->size;
+    _memprof_event(ptr, block->size | MEMPROF_FREE, block->site, 0);
+    _memprof_remove(block);
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * @brief This function will read the clock used to time the allocations.
+ *
+ * @note  It reads the cputime if it is enabled, otherwise the OS tick. The board may
+ *        override it with a faster counter.
+ *
+ * @return the clock count.
+ */
+RT_WEAK rt_uint32_t rt_memprof_clock(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_gettime();
+#else
+    return (rt_uint32_t)rt_tick_get();
+#endif /* RT_USING_CPUTIME */
+}
+
+/**
+ * @brief This function will record an allocation of the heap.
+ *
+ * @note  Please do not invoke this function in user application.
+ *
+ * @param ptr is the allocated block, RT_NULL for a failed allocation.
+ *
+ * @param size is the requested size.
+ *
+ * @param caller is the return address of the allocation.
+ *
+ * @param time is the time the allocation takes, in the clock of rt_memprof_clock().
+ */
+void rt_memprof_malloc(void *ptr, rt_size_t size, void *caller, rt_uint32_t time)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    _memprof_alloc(ptr, size, caller, time);
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief This function will record a reallocation of the heap, as a release of the old block
+ *        and an allocation of the new one.
+ *
+ * @note  Please do not invoke this function in user application.
+ *
+ * @param rmem is the old block.
+ *
+ * @param nptr is the new block.
+ *
+ * @param newsize is the requested size.
+ *
+ * @param caller is the return address of the reallocation.
+ *
+ * @param time is the time the reallocation takes, in the clock of rt_memprof_clock().
+ */
+void rt_memprof_realloc(void *rmem, void *nptr, rt_size_t newsize, void *caller, rt_uint32_t time)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    /* the old block is kept if the reallocation fails */
+    if (rmem != RT_NULL && (nptr != RT_NULL || newsize == 0))
+        _memprof_free(rmem);
+    if (newsize != 0)
+        _memprof_alloc(nptr, newsize, caller, time);
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief This function will record a release of the heap.
+ *
+ * @note  Please do not invoke this function in user application.
+ *
+ * @param ptr is the block to be released.
+ */
+void rt_memprof_free(void *ptr)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    _memprof_free(ptr);
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief This function will charge a recorded block to another call site, for the allocators
+ *        built on rt_malloc such as rt_calloc.
+ *
+ * @note  Please do not invoke this function in user application.
+ *
+ * @param ptr is the allocated block.
+ *
+ * @param caller is the return address of the outer allocation.
+ */
+void rt_memprof_retag(void *ptr, void *caller)
+{
+    struct memprof_block *block;
+    struct rt_memprof_site *from, *to;
+    rt_uint32_t index;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+
+    block = _memprof_find(ptr);
+    if (block != RT_NULL)
+    {
+        index = _memprof_site(caller);
+        from = &_sites[block->site];
+        to = &_sites[index];
+
+        from->alloc_count --;
+        from->live_bytes -= block->size;
+        from->hist[_memprof_bucket(block->size)] --;
+
+        to->alloc_count ++;
+        to->live_bytes += block->size;
+        if (to->live_bytes > to->max_live_bytes)
+            to->max_live_bytes = to->live_bytes;
+        to->hist[_memprof_bucket(block->size)] ++;
+        block->site = index;
+
+        /* the event of the allocation is the latest one, unless an interrupt has come */
+        if (_ring[(_ring_count - 1) % RT_MEMPROF_RING_SIZE].ptr == (rt_uint32_t)(rt_ubase_t)ptr)
+            _ring[(_ring_count - 1) % RT_MEMPROF_RING_SIZE].site = (rt_uint16_t)index;
+    }
+
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief This function will get the statistics of a call site.
+ *
+ * @param index is the index of the site, 0 is the site of the allocations that don't fit
+ *        in the site table.
+ *
+ * @param site is the buffer of the statistics.
+ *
+ * @return RT_EOK if the site is in use, -RT_EEMPTY if it isn't, -RT_EINVAL for a wrong index.
+ */
+rt_err_t rt_memprof_site_get(int index, struct rt_memprof_site *site)
+{
+    rt_base_t level;
+
+    if (index < 0 || index >= RT_MEMPROF_SITE_NUM)
+        return -RT_EINVAL;
+
+    level = rt_hw_interrupt_disable();
+    *site = _sites[index];
+    rt_hw_interrupt_enable(level);
+
+    if (index != 0 && site->caller == RT_NULL)
+        return -RT_EEMPTY;
+
+    return RT_EOK;
+}
+
+/**
+ * @brief This function will get the live bytes and blocks the thread has allocated.
+ *
+ * @param thread is the owner thread, RT_NULL for the allocations in interrupt or before
+ *        the scheduler starts.
+ *
+ * @param blocks is the buffer of the number of live blocks, it can be RT_NULL.
+ *
+ * @return the live bytes.
+ */
+rt_size_t rt_memprof_thread_live(rt_thread_t thread, rt_size_t *blocks)
+{
+    rt_size_t bytes = 0, count = 0;
+    rt_base_t level;
+    int i;
+
+    level = rt_hw_interrupt_disable();
+    for (i = 0; i < RT_MEMPROF_BLOCK_NUM; i ++)
+    {
+        if (_blocks[i].ptr != RT_NULL && _blocks[i].thread == thread)
+        {
+            bytes += _blocks[i].size;
+            count ++;
+        }
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (blocks)
+        *blocks = count;
+
+    return bytes;
+}
+
+/**
+ * @brief This function will clear the records of the heap profiler.
+ *
+ * @note  The blocks live at the time are released as unknown blocks later.
+ */
+void rt_memprof_reset(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(_sites, 0, sizeof(_sites));
+    rt_memset(_blocks, 0, sizeof(_blocks));
+    _ring_count = 0;
+    _block_count = 0;
+    _untracked = 0;
+    _unknown_free = 0;
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * @brief This function will dump the heap profiler in the binary format, which is parsed by
+ *        tools/memprof.py. All the words are in the byte order of the target.
+ *
+ *        header:   magic, version, site number, histogram number, event number,
+ *                  total events, live blocks, untracked blocks, unknown releases
+ *        sites:    caller, allocations, releases, failures, live bytes, max live bytes,
+ *                  max time, histogram
+ *        events:   tick, address, size (bit 31 set for the release), site | time << 16,
+ *                  from the oldest one
+ *
+ * @param buf is the buffer of the dump, RT_NULL to get the size of the dump.
+ *
+ * @param size is the size of the buffer.
+ *
+ * @return the size of the dump, 0 if the buffer is too small.
+ */
+rt_size_t rt_memprof_dump(void *buf, rt_size_t size)
+{
+    rt_uint32_t *word = (rt_uint32_t *)buf;
+    rt_uint32_t events, first, i, j;
+    rt_size_t length;
+    rt_base_t level;
+
+    length = (9 + RT_MEMPROF_SITE_NUM * (7 + RT_MEMPROF_HIST_NUM) + RT_MEMPROF_RING_SIZE * 4) * sizeof(rt_uint32_t);
+    if (buf == RT_NULL)
+        return length;
+    if (size < length)
+        return 0;
+
+    level = rt_hw_interrupt_disable();
+
+    events = _ring_count < RT_MEMPROF_RING_SIZE ? _ring_count : RT_MEMPROF_RING_SIZE;
+    first = _ring_count - events;
+
+    *word ++ = MEMPROF_MAGIC;
+    *word ++ = MEMPROF_VERSION;
+    *word ++ = RT_MEMPROF_SITE_NUM;
+    *word ++ = RT_MEMPROF_HIST_NUM;
+    *word ++ = events;
+    *word ++ = _ring_count;
+    *word ++ = _block_count;
+    *word ++ = _untracked;
+    *word ++ = _unknown_free;
+
+    for (i = 0; i < RT_MEMPROF_SITE_NUM; i ++)
+    {
+        *word ++ = (rt_uint32_t)(rt_ubase_t)_sites[i].caller;
+        *word ++ = _sites[i].alloc_count;
+        *word ++ = _sites[i].free_count;
+        *word ++ = _sites[i].fail_count;
+        *word ++ = _sites[i].live_bytes;
+        *word ++ = _sites[i].max_live_bytes;
+        *word ++ = _sites[i].max_time;
+        for (j = 0; j < RT_MEMPROF_HIST_NUM; j ++)
+            *word ++ = _sites[i].hist[j];
+    }
+
+    for (i = 0; i < RT_MEMPROF_RING_SIZE; i ++)
+    {
+        struct memprof_event *event = &_ring[(first + i) % RT_MEMPROF_RING_SIZE];
+
+        if (i >= events)
+        {
+            *word ++ = 0; *word ++ = 0; *word ++ = 0; *word ++ = 0;
+            continue;
+        }
+        *word ++ = event->tick;
+        *word ++ = event->ptr;
+        *word ++ = event->size;
+        *word ++ = event->site | ((rt_uint32_t)event->time << 16);
+    }
+
+    rt_hw_interrupt_enable(level);
+
+    return length;
+}
+
+/**@}*/
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void _memprof_list_sites(void)
+{
+    struct rt_memprof_site site;
+    int i, j;
+
+    rt_kprintf("site       allocs   frees    fails    live     max live max time  <=16 <=32 <=64 <=128 <=256 <=512 <=1K >1K\n");
+    rt_kprintf("---------- -------- -------- -------- -------- -------- -------- ------------------------------------------\n");
+    for (i = 0; i < RT_MEMPROF_SITE_NUM; i ++)
+    {
+        if (rt_memprof_site_get(i, &site) != RT_EOK || site.alloc_count + site.fail_count == 0)
+            continue;
+
+        rt_kprintf("0x%08x %-8d %-8d %-8d %-8d %-8d %-8d", site.caller,
+                   site.alloc_count, site.free_count, site.fail_count,
+                   site.live_bytes, site.max_live_bytes, site.max_time);
+        for (j = 0; j < RT_MEMPROF_HIST_NUM; j ++)
+            rt_kprintf(" %d", site.hist[j]);
+        rt_kprintf("\n");
+    }
+    rt_kprintf("live blocks: %d, untracked: %d, unknown releases: %d\n",
+               _block_count, _untracked, _unknown_free);
+}
+
+static void _memprof_list_threads(void)
+{
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_thread *thread;
+    rt_size_t bytes, blocks;
+
+    rt_kprintf("%-*.s live     blocks\n", RT_NAME_MAX, "thread");
+    rt_kprintf("%-*.s -------- --------\n", RT_NAME_MAX, "--------");
+
+    /* the scheduler is locked for a stable thread list */
+    rt_enter_critical();
+    information = rt_object_get_information(RT_Object_Class_Thread);
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node  = node->next)
+    {
+        thread = rt_list_entry(node, struct rt_thread, list);
+        bytes = rt_memprof_thread_live(thread, &blocks);
+        if (blocks != 0)
+            rt_kprintf("%-*.*s %-8d %-8d\n", RT_NAME_MAX, RT_NAME_MAX, thread->name, bytes, blocks);
+    }
+    rt_exit_critical();
+
+    bytes = rt_memprof_thread_live(RT_NULL, &blocks);
+    if (blocks != 0)
+        rt_kprintf("%-*.s %-8d %-8d\n", RT_NAME_MAX, "(none)", bytes, blocks);
+}
+
+static void _memprof_list_events(void)
+{
+    rt_uint32_t events, first, i;
+    struct memprof_event event;
+    rt_base_t level;
+
+    rt_kprintf("tick       address    size     site       time\n");
+    rt_kprintf("---------- ---------- -------- ---------- -----\n");
+
+    level = rt_hw_interrupt_disable();
+    events = _ring_count < RT_MEMPROF_RING_SIZE ? _ring_count : RT_MEMPROF_RING_SIZE;
+    first = _ring_count - events;
+    rt_hw_interrupt_enable(level);
+
+    for (i = 0; i < events; i ++)
+    {
+        level = rt_hw_interrupt_disable();
+        event = _ring[(first + i) % RT_MEMPROF_RING_SIZE];
+        rt_hw_interrupt_enable(level);
+
+        rt_kprintf("%-10d 0x%08x %c%-7d 0x%08x %d\n", event.tick, event.ptr,
+                   (event.size & MEMPROF_FREE) ? '-' : '+', event.size & ~MEMPROF_FREE,
+                   _sites[event.site].caller, event.time);
+    }
+}
+
+/* dump in the hex lines prefixed by "MPRF:", which tools/memprof.py reads from a console log */
+static void _memprof_dump_hex(void)
+{
+    rt_uint32_t *buf;
+    rt_size_t length, i;
+
+    length = rt_memprof_dump(RT_NULL, 0);
+    buf = (rt_uint32_t *)rt_malloc(length);
+    if (buf == RT_NULL)
+    {
+        rt_kprintf("no memory for the dump\n");
+        return;
+    }
+
+    length = rt_memprof_dump(buf, length);
+    for (i = 0; i < length / sizeof(rt_uint32_t); i ++)
+    {
+        if (i % 8 == 0)
+            rt_kprintf("MPRF:");
+        rt_kprintf("%08x", buf[i]);
+        if (i % 8 == 7 || i == length / sizeof(rt_uint32_t) - 1)
+            rt_kprintf("\n");
+    }
+    rt_free(buf);
+}
+
+static int memprof(int argc, char **argv)
+{
+    if (argc == 1 || rt_strcmp(argv[1], "site") == 0)
+        _memprof_list_sites();
+    else if (rt_strcmp(argv[1], "thread") == 0)
+        _memprof_list_threads();
+    else if (rt_strcmp(argv[1], "event") == 0)
+        _memprof_list_events();
+    else if (rt_strcmp(argv[1], "dump") == 0)
+        _memprof_dump_hex();
+    else if (rt_strcmp(argv[1], "reset") == 0)
+        rt_memprof_reset();
+    else
+        rt_kprintf("Usage: memprof [site|thread|event|dump|reset]\n");
+
+    return 0;
+}
+MSH_CMD_EXPORT(memprof, heap profiler: memprof [site|thread|event|dump|reset]);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_USING_MEMPROF */
@@ -114,6 +114,25 @@ static struct rt_object_information _object_container[RT_Object_Info_Unknown] =
 #endif
 };
 
+#ifdef RT_USING_OBJECT_HASH
+#ifndef RT_OBJECT_HASH_SIZE
+#define RT_OBJECT_HASH_SIZE     64
+#endif
+#if (RT_OBJECT_HASH_SIZE & (RT_OBJECT_HASH_SIZE - 1)) != 0
+#error "RT_OBJECT_HASH_SIZE must be a power of 2"
+#endif
+
+/* the objects of the containers, chained by class and name */
+static struct rt_object *_object_hash[RT_OBJECT_HASH_SIZE];
+
+/* dlmodule renames the module objects after their allocation */
+#ifdef RT_USING_MODULE
+#define _OBJECT_HASHED(type)    ((type) != RT_Object_Class_Module)
+#else
+#define _OBJECT_HASHED(type)    RT_TRUE
+#endif /* RT_USING_MODULE */
+#endif /* RT_USING_OBJECT_HASH */
+
 #ifndef __on_rt_object_attach_hook
     #define __on_rt_object_attach_hook(obj)         __ON_HOOK_ARGS(rt_object_attach_hook, (obj))
 #endif
@@ -316,6 +335,54 @@ int rt_object_get_pointers(enum rt_object_class_type type, rt_object_t *pointers
 }
 RTM_EXPORT(rt_object_get_pointers);
 
+#ifdef RT_USING_OBJECT_HASH
+/* FNV-1a of the class and of the name as rt_strncmp compares it */
+static rt_uint32_t _object_hash_index(const char *name, rt_uint8_t type)
+{
+    rt_uint32_t hash = 2166136261u ^ type;
+    rt_size_t i;
+
+    for (i = 0; i < RT_NAME_MAX && name[i] != '\0'; i++)
+    {
+        hash = (hash ^ (rt_uint8_t)name[i]) * 16777619u;
+    }
+
+    return (hash ^ (hash >> 16)) & (RT_OBJECT_HASH_SIZE - 1);
+}
+
+/* must be called with the interrupt locked */
+static void _object_hash_insert(struct rt_object *object, rt_uint8_t type)
+{
+    rt_uint32_t index;
+
+    if (!_OBJECT_HASHED(type))
+        return;
+
+    index = _object_hash_index(object->name, type);
+    object->hash_next = _object_hash[index];
+    _object_hash[index] = object;
+}
+
+/* must be called with the interrupt locked */
+static void _object_hash_remove(struct rt_object *object, rt_uint8_t type)
+{
+    struct rt_object **pos;
+
+    if (!_OBJECT_HASHED(type))
+        return;
+
+    pos = &_object_hash[_object_hash_index(object->name, type)];
+    for (; *pos != RT_NULL; pos = &((*pos)->hash_next))
+    {
+        if (*pos == object)
+        {
+            *pos = object->hash_next;
+            break;
+        }
+    }
+}
+#endif /* RT_USING_OBJECT_HASH */
+
 /**
  * @brief This function will initialize an object and add it to object system
  *        management.
@@ -384,6 +451,9 @@ void rt_object_init(struct rt_object         *object,
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(object, type);
+#endif /* RT_USING_OBJECT_HASH */
     }
 
     /* unlock interrupt */
@@ -399,12 +469,18 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     rt_base_t level;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint8_t type;
+#endif /* RT_USING_OBJECT_HASH */
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    type = object->type & ~RT_Object_Class_Static;
+#endif /* RT_USING_OBJECT_HASH */
     /* reset object type */
     object->type = 0;
 
@@ -413,6 +489,9 @@ void rt_object_detach(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(object, type);
+#endif /* RT_USING_OBJECT_HASH */
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(level);
@@ -480,6 +559,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        _object_hash_insert(object, type);
+#endif /* RT_USING_OBJECT_HASH */
     }
 
     /* unlock interrupt */
@@ -497,6 +579,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     rt_base_t level;
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint8_t type;
+#endif /* RT_USING_OBJECT_HASH */
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
@@ -504,6 +589,9 @@ void rt_object_delete(rt_object_t object)
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    type = object->type;
+#endif /* RT_USING_OBJECT_HASH */
     /* reset object type */
     object->type = RT_Object_Class_Null;
 
@@ -512,6 +600,9 @@ void rt_object_delete(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    _object_hash_remove(object, type);
+#endif /* RT_USING_OBJECT_HASH */
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(level);
@@ -588,6 +679,28 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     /* enter critical */
     rt_enter_critical();
 
+#ifdef RT_USING_OBJECT_HASH
+    if (_OBJECT_HASHED(type))
+    {
+        /* only the bucket of the name is walked */
+        for (object = _object_hash[_object_hash_index(name, type)];
+                object != RT_NULL;
+                object = object->hash_next)
+        {
+            if ((object->type & ~RT_Object_Class_Static) == type &&
+                rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+            {
+                break;
+            }
+        }
+
+        /* leave critical */
+        rt_exit_critical();
+
+        return object;
+    }
+#endif /* RT_USING_OBJECT_HASH */
+
     /* try to find object */
     rt_list_for_each(node, &(information->object_list))
     {
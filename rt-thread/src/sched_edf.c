@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_SCHED_EDF
+
+#if RT_SCHED_EDF_PRIORITY >= RT_THREAD_PRIORITY_MAX
+#error "RT_SCHED_EDF_PRIORITY shall be less than RT_THREAD_PRIORITY_MAX"
+#endif
+
+/* the utilization reserved by the attached threads, in 1/65536 */
+static rt_uint32_t _edf_util;
+
+/**
+ * @addtogroup Thread
+ */
+
+/**@{*/
+
+/**
+ * @brief   This function will attach a periodic thread to the earliest deadline first scheduling.
+ *
+ * @note    The thread is moved to RT_SCHED_EDF_PRIORITY, where the ready thread with the earliest
+ *          deadline runs first. Its first job is released at once, and each job ends by
+ *          rt_thread_edf_wait(). The thread is admitted only if the sum of budget / deadline of
+ *          all the attached threads stays within RT_SCHED_EDF_UTIL_MAX percent.
+ *
+ * @param   thread is the thread to be attached.
+ *
+ * @param   period is the release period of the jobs (unit: an OS tick).
+ *
+ * @param   budget is the execution time reserved for each job (unit: an OS tick).
+ *
+ * @param   deadline is the deadline relative to the release (unit: an OS tick), 0 for the period.
+ *
+ * @return  Return the operation status. If the return value is RT_EOK, the thread is attached.
+ *          -RT_EFULL is returned if the thread isn't admitted.
+ */
+rt_err_t rt_thread_edf_attach(rt_thread_t thread, rt_tick_t period, rt_tick_t budget, rt_tick_t deadline)
+{
+    rt_base_t level;
+    rt_uint32_t util;
+    rt_uint8_t priority = RT_SCHED_EDF_PRIORITY;
+
+    /* parameter check */
+    RT_ASSERT(thread != RT_NULL);
+    RT_ASSERT(rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread);
+
+    if (deadline == 0)
+        deadline = period;
+    if (period == 0 || budget == 0 || budget > deadline || deadline > period)
+        return -RT_EINVAL;
+
+    /* the density test, it is exact for the deadlines equal to the periods */
+    util = (rt_uint32_t)(((rt_uint64_t)budget << 16) / deadline);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (thread->edf.period != 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_EBUSY;
+    }
+    if (_edf_util + util > (rt_uint32_t)(((rt_uint64_t)RT_SCHED_EDF_UTIL_MAX << 16) / 100))
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_EFULL;
+    }
+    _edf_util += util;
+
+    rt_memset(&(thread->edf), 0x0, sizeof(thread->edf));
+    thread->edf.period   = period;
+    thread->edf.budget   = budget;
+    thread->edf.deadline = deadline;
+    thread->edf.util     = util;
+    thread->edf.release  = rt_tick_get();
+    thread->edf.abs_deadline = thread->edf.release + deadline;
+
+    /* the priority a mutex restores to */
+    thread->edf.priority = thread->init_priority;
+    thread->init_priority = RT_SCHED_EDF_PRIORITY;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    /* a ready thread is queued again in the deadline order */
+    rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+    if (rt_thread_self() != RT_NULL)
+        rt_schedule();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_thread_edf_attach);
+
+/**
+ * @brief   This function will detach a thread from the earliest deadline first scheduling,
+ *          and restore its priority.
+ *
+ * @param   thread is the thread to be detached.
+ *
+ * @return  Return the operation status. If the return value is RT_EOK, the thread is detached.
+ */
+rt_err_t rt_thread_edf_detach(rt_thread_t thread)
+{
+    rt_base_t level;
+    rt_uint8_t priority;
+
+    /* parameter check */
+    RT_ASSERT(thread != RT_NULL);
+    RT_ASSERT(rt_object_get_type((rt_object_t)thread) == RT_Object_Class_Thread);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (thread->edf.period == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_ERROR;
+    }
+    _edf_util -= thread->edf.util;
+    thread->edf.period = 0;
+
+    priority = thread->edf.priority;
+    thread->init_priority = priority;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    rt_thread_control(thread, RT_THREAD_CTRL_CHANGE_PRIORITY, &priority);
+    if (rt_thread_self() != RT_NULL)
+        rt_schedule();
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_thread_edf_detach);
+
+/**
+ * @brief   This function will end the current job of the calling EDF thread, and let the thread
+ *          sleep until the release of the next job.
+ *
+ * @note    A job completed after its deadline counts a miss, a job that used more ticks than the
+ *          budget counts an overrun. If the next job is already released, the function doesn't
+ *          sleep, the thread runs on in the order of its new deadline.
+ *
+ * @return  Return the operation status. If the return value is RT_EOK, the next job is released.
+ */
+rt_err_t rt_thread_edf_wait(void)
+{
+    struct rt_thread *thread;
+    rt_base_t level;
+    rt_tick_t tick, late;
+    rt_err_t err;
+
+    thread = rt_thread_self();
+    RT_ASSERT(thread != RT_NULL);
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (thread->edf.period == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return -RT_ERROR;
+    }
+
+    /* account the completed job */
+    thread->edf.jobs ++;
+    late = rt_tick_get() - thread->edf.abs_deadline;
+    if ((rt_int32_t)late > 0)
+    {
+        thread->edf.misses ++;
+        if (late > thread->edf.max_lateness)
+            thread->edf.max_lateness = late;
+    }
+    if (thread->edf.used > thread->edf.budget)
+        thread->edf.overruns ++;
+    thread->edf.used = 0;
+
+    /* the next job */
+    tick = thread->edf.release;
+    thread->edf.release += thread->edf.period;
+    thread->edf.abs_deadline = thread->edf.release + thread->edf.deadline;
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+
+    err = rt_thread_delay_until(&tick, thread->edf.period);
+
+    /* a late job doesn't sleep, its new deadline may rank it behind a ready EDF thread */
+    rt_schedule();
+
+    return err;
+}
+RTM_EXPORT(rt_thread_edf_wait);
+
+/**
+ * @brief   This function will give back the utilization of an EDF thread that exits.
+ *
+ * @note    Please do not invoke this function in user application.
+ *
+ * @param   thread is the exiting thread.
+ */
+void rt_sched_edf_exit(rt_thread_t thread)
+{
+    rt_base_t level;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (thread->edf.period != 0)
+    {
+        _edf_util -= thread->edf.util;
+        thread->edf.period = 0;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**@}*/
+
+#endif /* RT_USING_SCHED_EDF */
@@ -126,6 +126,37 @@ static void _scheduler_stack_check(struct rt_thread *thread)
 }
 #endif /* RT_USING_OVERFLOW_CHECK */
 
+#ifdef RT_USING_SCHED_EDF
+/*
+ * whether thread a runs before thread b at the same priority: the earlier
+ * deadline first, the EDF threads before the others
+ */
+rt_inline rt_bool_t _scheduler_edf_before(struct rt_thread *a, struct rt_thread *b)
+{
+    if (a->edf.period == 0)
+        return RT_FALSE;
+    if (b->edf.period == 0)
+        return RT_TRUE;
+
+    return (rt_int32_t)(a->edf.abs_deadline - b->edf.abs_deadline) < 0;
+}
+
+/*
+ * insert an EDF thread to the ready list of its priority in deadline order
+ */
+static void _scheduler_edf_insert(rt_list_t *list, struct rt_thread *thread)
+{
+    rt_list_t *n;
+
+    for (n = list->next; n != list; n = n->next)
+    {
+        if (_scheduler_edf_before(thread, rt_list_entry(n, struct rt_thread, tlist)))
+            break;
+    }
+    rt_list_insert_before(n, &(thread->tlist));
+}
+#endif /* RT_USING_SCHED_EDF */
+
 /*
  * get the highest priority thread in ready queue
  */
@@ -447,10 +478,22 @@ void rt_schedule(void)
                 {
                     to_thread = rt_current_thread;
                 }
-                else if (rt_current_thread->current_priority == highest_ready_priority && (rt_current_thread->stat & RT_THREAD_STAT_YIELD_MASK) == 0)
+                else if (rt_current_thread->current_priority == highest_ready_priority && (rt_current_thread->stat & RT_THREAD_STAT_YIELD_MASK) == 0
+#ifdef RT_USING_SCHED_EDF
+                        /* a ready thread with an earlier deadline preempts */
+                        && !_scheduler_edf_before(to_thread, rt_current_thread)
+#endif /* RT_USING_SCHED_EDF */
+                        )
+                {
+                    to_thread = rt_current_thread;
+                }
+#ifdef RT_USING_SCHED_EDF
+                else if (rt_current_thread->current_priority == highest_ready_priority && _scheduler_edf_before(rt_current_thread, to_thread))
                 {
+                    /* the time slice doesn't rotate out the earliest deadline */
                     to_thread = rt_current_thread;
                 }
+#endif /* RT_USING_SCHED_EDF */
                 else
                 {
                     need_insert_from_thread = 1;
@@ -754,6 +797,14 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
 
     /* READY thread, insert to ready queue */
     thread->stat = RT_THREAD_READY | (thread->stat & ~RT_THREAD_STAT_MASK);
+#ifdef RT_USING_SCHED_EDF
+    /* EDF thread, inserting thread in the deadline order */
+    if (thread->edf.period != 0)
+    {
+        _scheduler_edf_insert(&(rt_thread_priority_table[thread->current_priority]), thread);
+    }
+    else
+#endif /* RT_USING_SCHED_EDF */
     /* there is no time slices left(YIELD), inserting thread before ready list*/
     if((thread->stat & RT_THREAD_STAT_YIELD_MASK) != 0)
     {
@@ -804,6 +855,9 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
                                       thread->current_priority));
 
     /* remove thread from ready list */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
     rt_list_remove(&(thread->tlist));
     if (thread->bind_cpu == RT_CPUS_NR)
     {
@@ -856,6 +910,9 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
                                       thread->current_priority));
 
     /* remove thread from ready list */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
     rt_list_remove(&(thread->tlist));
     if (rt_list_isempty(&(rt_thread_priority_table[thread->current_priority])))
     {
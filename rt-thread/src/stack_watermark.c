@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2006-2023, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_STACK_WATERMARK
+
+/*
+ * The thread stacks are filled with '#' at initialization. The scan walks from
+ * the far end of a stack towards its top, and the first byte that isn't '#'
+ * marks the deepest use. The scan stops at the last known mark, since the mark
+ * only moves towards the far end. A thread running between two steps of the
+ * scan may move its mark behind the scan, which is caught by the next pass.
+ */
+
+/* the thread being scanned and the offset of the scan from the far end */
+static struct rt_thread *_scan_thread = RT_NULL;
+static rt_uint32_t _scan_offset = 0;
+
+#define _STACK_FILL_WORD    ((rt_ubase_t)0x2323232323232323ULL)
+
+/*
+ * return the offset of the first touched byte in [from, to), counted from
+ * the far end of the stack, or to if they are all untouched
+ */
+static rt_uint32_t _stack_scan_range(struct rt_thread *thread, rt_uint32_t from, rt_uint32_t to)
+{
+#ifdef ARCH_CPU_STACK_GROWS_UPWARD
+    rt_uint8_t *ptr = (rt_uint8_t *)thread->stack_addr + thread->stack_size - 1 - from;
+
+    while (from < to && *ptr == '#')
+    {
+        ptr --;
+        from ++;
+    }
+#else
+    rt_uint8_t *ptr = (rt_uint8_t *)thread->stack_addr + from;
+
+    /* compare the bytes up to the word boundary, then a word at a time */
+    while (from < to && ((rt_ubase_t)ptr & (sizeof(rt_ubase_t) - 1)) != 0 && *ptr == '#')
+    {
+        ptr ++;
+        from ++;
+    }
+    if (((rt_ubase_t)ptr & (sizeof(rt_ubase_t) - 1)) == 0)
+    {
+        while (to - from >= sizeof(rt_ubase_t) && *(rt_ubase_t *)ptr == _STACK_FILL_WORD)
+        {
+            ptr += sizeof(rt_ubase_t);
+            from += sizeof(rt_ubase_t);
+        }
+    }
+    while (from < to && *ptr == '#')
+    {
+        ptr ++;
+        from ++;
+    }
+#endif /* ARCH_CPU_STACK_GROWS_UPWARD */
+
+    return from;
+}
+
+/**
+ * @addtogroup Thread
+ */
+
+/**@{*/
+
+/**
+ * @brief   This function will scan the thread stacks for their watermarks, at most the specified
+ *          bytes in one call. The scan continues where the last call stops, and moves to the next
+ *          thread when a stack is done.
+ *
+ * @note    It is invoked by the idle thread with RT_STACK_WATERMARK_SCAN_SIZE, and can be invoked
+ *          by other threads for a faster update.
+ *
+ * @param   budget is the bytes to be scanned.
+ */
+void rt_thread_stack_scan(rt_size_t budget)
+{
+    struct rt_object_information *information;
+    struct rt_thread *thread;
+    rt_list_t *node;
+    rt_uint32_t end, offset;
+
+    information = rt_object_get_information(RT_Object_Class_Thread);
+    RT_ASSERT(information != RT_NULL);
+
+    /* lock the scheduler, so the thread isn't detached under the scan */
+    rt_enter_critical();
+
+    while (budget > 0)
+    {
+        thread = _scan_thread;
+        if (thread == RT_NULL)
+        {
+            /* start a pass from the first thread */
+            node = information->object_list.next;
+            if (node == &(information->object_list))
+                break;
+
+            thread = rt_list_entry(node, struct rt_thread, list);
+            _scan_thread = thread;
+            _scan_offset = 0;
+        }
+
+        /* the stack of a closed thread may be released already */
+        if ((thread->stat & RT_THREAD_STAT_MASK) != RT_THREAD_CLOSE)
+        {
+            end = thread->stack_clean;
+            if (end - _scan_offset > budget)
+                end = _scan_offset + budget;
+            budget -= end - _scan_offset;
+
+            offset = _stack_scan_range(thread, _scan_offset, end);
+            if (offset < end)
+            {
+                /* a touched byte, the new watermark */
+                thread->stack_clean = offset;
+            }
+            else if (end < thread->stack_clean)
+            {
+                /* the budget runs out */
+                _scan_offset = end;
+                break;
+            }
+        }
+
+        /* this stack is done, move to the next thread */
+        node = thread->list.next;
+        if (node == &(information->object_list))
+            _scan_thread = RT_NULL;
+        else
+            _scan_thread = rt_list_entry(node, struct rt_thread, list);
+        _scan_offset = 0;
+
+        if (_scan_thread == RT_NULL)
+            break;
+    }
+
+    rt_exit_critical();
+}
+RTM_EXPORT(rt_thread_stack_scan);
+
+/**
+ * @brief   This function will get the maximum stack usage of a thread, which is found by the
+ *          last scan of its stack.
+ *
+ * @param   thread is the thread to be queried.
+ *
+ * @return  Return the maximum used bytes of the stack.
+ */
+rt_size_t rt_thread_stack_max_used(rt_thread_t thread)
+{
+    RT_ASSERT(thread != RT_NULL);
+
+    return thread->stack_size - thread->stack_clean;
+}
+RTM_EXPORT(rt_thread_stack_max_used);
+
+/**
+ * @brief   This function will stop the scan of an exiting thread.
+ *
+ * @note    Please do not invoke this function in user application.
+ *
+ * @param   thread is the exiting thread.
+ */
+void rt_thread_stack_watermark_exit(rt_thread_t thread)
+{
+    rt_base_t level;
+
+    /* disable interrupt */
+    level = rt_hw_interrupt_disable();
+
+    if (_scan_thread == thread)
+    {
+        _scan_thread = RT_NULL;
+        _scan_offset = 0;
+    }
+
+    /* enable interrupt */
+    rt_hw_interrupt_enable(level);
+}
+
+/**@}*/
+
+#endif /* RT_USING_STACK_WATERMARK */
@@ -108,6 +108,16 @@ static void _thread_exit(void)
     /* change stat */
     thread->stat = RT_THREAD_CLOSE;
 
+#ifdef RT_USING_SCHED_EDF
+    /* give back the reserved utilization */
+    rt_sched_edf_exit(thread);
+#endif /* RT_USING_SCHED_EDF */
+
+#ifdef RT_USING_STACK_WATERMARK
+    /* stop scanning the stack */
+    rt_thread_stack_watermark_exit(thread);
+#endif /* RT_USING_STACK_WATERMARK */
+
     /* insert to defunct thread list */
     rt_thread_defunct_enqueue(thread);
 
@@ -143,6 +153,9 @@ static void _thread_timeout(void *parameter)
     thread->error = -RT_ETIMEOUT;
 
     /* remove from suspend list */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
     rt_list_remove(&(thread->tlist));
 
     /* insert to schedule ready list */
@@ -166,6 +179,12 @@ static rt_err_t _thread_init(struct rt_thread *thread,
 {
     /* init thread list */
     rt_list_init(&(thread->tlist));
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    thread->pend_index = RT_NULL;
+#endif /* RT_USING_IPC_PRIO_QUEUE */
+#ifdef RT_USING_SCHED_EDF
+    rt_memset(&(thread->edf), 0x0, sizeof(thread->edf));
+#endif /* RT_USING_SCHED_EDF */
 
     thread->entry = (void *)entry;
     thread->parameter = parameter;
@@ -176,6 +195,9 @@ static rt_err_t _thread_init(struct rt_thread *thread,
 
     /* init thread stack */
     rt_memset(thread->stack_addr, '#', thread->stack_size);
+#ifdef RT_USING_STACK_WATERMARK
+    thread->stack_clean = thread->stack_size;
+#endif /* RT_USING_STACK_WATERMARK */
 #ifdef ARCH_CPU_STACK_GROWS_UPWARD
     thread->sp = (void *)rt_hw_stack_init(thread->entry, thread->parameter,
                                           (void *)((char *)thread->stack_addr),
@@ -427,6 +449,16 @@ rt_err_t rt_thread_detach(rt_thread_t thread)
     /* change stat */
     thread->stat = RT_THREAD_CLOSE;
 
+#ifdef RT_USING_SCHED_EDF
+    /* give back the reserved utilization */
+    rt_sched_edf_exit(thread);
+#endif /* RT_USING_SCHED_EDF */
+
+#ifdef RT_USING_STACK_WATERMARK
+    /* stop scanning the stack */
+    rt_thread_stack_watermark_exit(thread);
+#endif /* RT_USING_STACK_WATERMARK */
+
 #ifdef RT_USING_MUTEX
     if ((thread->pending_object) &&
         (rt_object_get_type(thread->pending_object) == RT_Object_Class_Mutex))
@@ -540,6 +572,16 @@ rt_err_t rt_thread_delete(rt_thread_t thread)
     /* change stat */
     thread->stat = RT_THREAD_CLOSE;
 
+#ifdef RT_USING_SCHED_EDF
+    /* give back the reserved utilization */
+    rt_sched_edf_exit(thread);
+#endif /* RT_USING_SCHED_EDF */
+
+#ifdef RT_USING_STACK_WATERMARK
+    /* stop scanning the stack */
+    rt_thread_stack_watermark_exit(thread);
+#endif /* RT_USING_STACK_WATERMARK */
+
 #ifdef RT_USING_MUTEX
     if ((thread->pending_object) &&
         (rt_object_get_type(thread->pending_object) == RT_Object_Class_Mutex))
@@ -939,6 +981,9 @@ rt_err_t rt_thread_resume(rt_thread_t thread)
     level = rt_hw_interrupt_disable();
 
     /* remove from suspend list */
+#ifdef RT_USING_IPC_PRIO_QUEUE
+    rt_ipc_prio_remove(thread);
+#endif /* RT_USING_IPC_PRIO_QUEUE */
     rt_list_remove(&(thread->tlist));
 
     rt_timer_stop(&thread->thread_timer);
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2006-2023, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+#
+# Analyze the dump of the heap profiler (RT_USING_MEMPROF).
+#
+# The input is a console log with the output of "memprof dump", or the raw
+# binary of rt_memprof_dump() read by a debugger:
+#
+#     python memprof.py console.log --elf rtthread.elf
+#
+
+import sys
+import struct
+import argparse
+import subprocess
+
+MAGIC = 0x4652504d
+FREE = 0x80000000
+HIST_TITLE = ['<=16', '<=32', '<=64', '<=128', '<=256', '<=512', '<=1K', '>1K']
+
+
+def load_words(name):
+    data = open(name, 'rb').read()
+
+    # the hex lines of "memprof dump" in a console log
+    words = []
+    for line in data.decode('latin-1').splitlines():
+        pos = line.find('MPRF:')
+        if pos < 0:
+            continue
+        text = line[pos + 5:].strip()
+        words += [int(text[i:i + 8], 16) for i in range(0, len(text) - 7, 8)]
+    if words:
+        return words
+
+    # the raw binary in the byte order of the target
+    for order in '<>':
+        if struct.unpack(order + 'I', data[:4])[0] == MAGIC:
+            return list(struct.unpack(order + '%dI' % (len(data) // 4), data[:len(data) // 4 * 4]))
+
+    sys.exit('no dump of the heap profiler found in %s' % name)
+
+
+def parse(words):
+    if words[0] != MAGIC:
+        sys.exit('bad magic 0x%08x' % words[0])
+    if words[1] != 1:
+        sys.exit('unsupported version %d' % words[1])
+
+    site_num, hist_num, events = words[2], words[3], words[4]
+    dump = {
+        'total_events': words[5],
+        'live_blocks': words[6],
+        'untracked': words[7],
+        'unknown_free': words[8],
+        'sites': [],
+        'events': [],
+    }
+
+    pos = 9
+    for index in range(site_num):
+        w = words[pos:pos + 7 + hist_num]
+        pos += 7 + hist_num
+        if w[0] == 0 and w[1] + w[3] == 0:
+            continue
+        dump['sites'].append({
+            'index': index, 'caller': w[0], 'allocs': w[1], 'frees': w[2],
+            'fails': w[3], 'live': w[4], 'max_live': w[5], 'max_time': w[6],
+            'hist': w[7:7 + hist_num],
+        })
+
+    for i in range(events):
+        w = words[pos + i * 4:pos + i * 4 + 4]
+        dump['events'].append({
+            'tick': w[0], 'ptr': w[1], 'size': w[2] & ~FREE, 'free': (w[2] & FREE) != 0,
+            'site': w[3] & 0xffff, 'time': w[3] >> 16,
+        })
+
+    return dump
+
+
+def resolve(dump, elf, addr2line):
+    names = {}
+    callers = [s['caller'] for s in dump['sites'] if s['caller']]
+    if not elf or not callers:
+        return names
+
+    # the return address points after the call, look up the call itself
+    args = [addr2line, '-f', '-C', '-s', '-e', elf] + ['0x%x' % ((c & ~1) - 2) for c in callers]
+    try:
+        out = subprocess.check_output(args).decode().splitlines()
+    except (OSError, subprocess.CalledProcessError) as e:
+        print('addr2line failed: %s' % e)
+        return names
+
+    for i, caller in enumerate(callers):
+        names[caller] = '%s %s' % (out[i * 2], out[i * 2 + 1])
+    return names
+
+
+def site_name(names, caller):
+    if caller == 0:
+        return '(other sites)'
+    return names.get(caller, '0x%08x' % caller)
+
+
+def report(dump, names, top):
+    sites = dump['sites']
+    by_index = dict((s['index'], s) for s in sites)
+
+    print('live blocks %d, untracked %d, unknown releases %d, events %d' %
+          (dump['live_blocks'], dump['untracked'], dump['unknown_free'], dump['total_events']))
+
+    print('\n== sites by live bytes ==')
+    print('%-40s %8s %8s %8s %8s %8s %8s' % ('site', 'live', 'max live', 'allocs', 'frees', 'fails', 'max time'))
+    for s in sorted(sites, key=lambda s: s['live'], reverse=True)[:top]:
+        print('%-40s %8d %8d %8d %8d %8d %8d' % (site_name(names, s['caller'])[:40], s['live'], s['max_live'],
+                                               s['allocs'], s['frees'], s['fails'], s['max_time']))
+
+    print('\n== size histogram of the busiest sites ==')
+    print('%-40s %s' % ('site', ' '.join('%6s' % t for t in HIST_TITLE)))
+    for s in sorted(sites, key=lambda s: s['allocs'], reverse=True)[:top]:
+        print('%-40s %s' % (site_name(names, s['caller'])[:40], ' '.join('%6d' % h for h in s['hist'])))
+
+    # the small blocks that live long between the short lived ones split the free space
+    print('\n== fragmentation suspects: small blocks kept alive ==')
+    suspects = []
+    for s in sites:
+        small = sum(s['hist'][:3])
+        if s['allocs'] and s['live'] and small * 2 >= s['allocs']:
+            suspects.append(s)
+    for s in sorted(suspects, key=lambda s: s['allocs'] - s['frees'], reverse=True)[:top]:
+        print('%-40s %d blocks alive of %d, %d bytes' % (site_name(names, s['caller'])[:40],
+                                                        s['allocs'] - s['frees'], s['allocs'], s['live']))
+
+    print('\n== slowest allocations in the recent events ==')
+    slow = [e for e in dump['events'] if not e['free']]
+    for e in sorted(slow, key=lambda e: e['time'], reverse=True)[:top]:
+        caller = by_index[e['site']]['caller'] if e['site'] in by_index else 0
+        print('tick %-10d time %-6d size %-6d 0x%08x %s' % (e['tick'], e['time'], e['size'], e['ptr'],
+                                                            site_name(names, caller)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='analyze the dump of the RT-Thread heap profiler')
+    parser.add_argument('dump', help='console log with "memprof dump", or the binary dump')
+    parser.add_argument('--elf', help='the image to resolve the call sites')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line', help='the addr2line of the toolchain')
+    parser.add_argument('--top', type=int, default=10, help='the number of rows in each table')
+    args = parser.parse_args()
+
+    dump = parse(load_words(args.dump))
+    report(dump, resolve(dump, args.elf, args.addr2line), args.top)
+
+
+if __name__ == '__main__':
+    main()
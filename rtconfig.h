@@ -205,6 +205,7 @@
 #define RT_LWIP_TCPTHREAD_PRIORITY 3
 #define RT_LWIP_TCPTHREAD_MBOX_SIZE 128
 #define RT_LWIP_TCPTHREAD_STACKSIZE 2048
+#define RT_LWIP_TCPIP_CORE_LOCKING
 #define LWIP_NO_RX_THREAD
 #define LWIP_NO_TX_THREAD
 #define RT_LWIP_ETHTHREAD_PRIORITY 5